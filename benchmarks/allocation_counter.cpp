@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "allocation_counter.h"
+
+#include <QtCore/QAtomicInt>
+
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+QAtomicInt g_allocations;
+// wraps around after 2^31 allocations, which is far more than any of the
+// benchmarks measures at a time
+
+void* allocate(std::size_t size)
+{
+    g_allocations.fetchAndAddRelaxed(1);
+
+    void* retVal = std::malloc(size ? size : 1);
+    if (!retVal)
+    {
+        throw std::bad_alloc();
+    }
+
+    return retVal;
+}
+}
+
+qint64 hAllocationCount()
+{
+    return static_cast<quint32>(g_allocations.fetchAndAddRelaxed(0));
+}
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <QtCore/QtGlobal>
+
+//
+// Returns the number of heap allocations made through the global operator new
+// since the program started. The counting operators are defined in
+// allocation_counter.cpp and they replace the ones of the C++ runtime.
+//
+qint64 hAllocationCount();
+
+#endif // ALLOCATION_COUNTER_H
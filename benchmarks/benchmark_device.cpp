@@ -0,0 +1,143 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark_device.h"
+
+#include <HUpnpCore/HDeviceInfo>
+#include <HUpnpCore/HServiceInfo>
+#include <HUpnpCore/HActionArguments>
+#include <HUpnpCore/HServerStateVariable>
+
+using namespace Herqq::Upnp;
+
+/*******************************************************************************
+ * HBenchmarkService
+ *******************************************************************************/
+HBenchmarkService::HBenchmarkService()
+{
+}
+
+HBenchmarkService::~HBenchmarkService()
+{
+}
+
+HServerService::HActionInvokes HBenchmarkService::createActionInvokes()
+{
+    HActionInvokes retVal;
+
+    retVal.insert(
+        "Echo", HActionInvoke(this, &HBenchmarkService::echoAction));
+
+    retVal.insert(
+        "Register", HActionInvoke(this, &HBenchmarkService::registerAction));
+
+    retVal.insert(
+        "Chargen", HActionInvoke(this, &HBenchmarkService::chargenAction));
+
+    return retVal;
+}
+
+qint32 HBenchmarkService::echoAction(
+    const HActionArguments& inArgs, HActionArguments* outArgs)
+{
+    (*outArgs)["MessageOut"].setValue(inArgs["MessageIn"].value().toString());
+    return UpnpSuccess;
+}
+
+qint32 HBenchmarkService::registerAction(
+    const HActionArguments& /*inArgs*/, HActionArguments* /*outArgs*/)
+{
+    HServerStateVariable* sv = stateVariables().value("RegisteredClientCount");
+    Q_ASSERT(sv);
+
+    bool ok = sv->setValue(sv->value().toUInt() + 1);
+    return ok ? UpnpSuccess : UpnpActionFailed;
+}
+
+qint32 HBenchmarkService::chargenAction(
+    const HActionArguments& inArgs, HActionArguments* outArgs)
+{
+    qint32 charCount = inArgs["Count"].value().toInt();
+    (*outArgs)["Characters"].setValue(QString(charCount, 'z'));
+    return UpnpSuccess;
+}
+
+/*******************************************************************************
+ * HBatchService
+ *******************************************************************************/
+HBatchService::HBatchService()
+{
+}
+
+HBatchService::~HBatchService()
+{
+}
+
+/*******************************************************************************
+ * HBenchmarkDevice
+ *******************************************************************************/
+HBenchmarkDevice::HBenchmarkDevice() :
+    HServerDevice()
+{
+}
+
+HBenchmarkDevice::~HBenchmarkDevice()
+{
+}
+
+/*******************************************************************************
+ * HBenchmarkModelCreator
+ *******************************************************************************/
+HBenchmarkModelCreator* HBenchmarkModelCreator::newInstance() const
+{
+    return new HBenchmarkModelCreator();
+}
+
+HServerDevice* HBenchmarkModelCreator::createDevice(const HDeviceInfo& info) const
+{
+    if (info.deviceType().toString() == "urn:herqq-org:device:HTestDevice:1" ||
+        info.deviceType().toString() == "urn:herqq-org:device:HBatchDevice:1")
+    {
+        return new HBenchmarkDevice();
+    }
+
+    return 0;
+}
+
+HServerService* HBenchmarkModelCreator::createService(
+    const HServiceInfo& serviceInfo, const HDeviceInfo&) const
+{
+    if (serviceInfo.serviceType().toString() ==
+        "urn:herqq-org:service:HTestService:1")
+    {
+        return new HBenchmarkService();
+    }
+    else if (serviceInfo.serviceType().toString() ==
+             "urn:herqq-org:service:HBatchService:1" ||
+             serviceInfo.serviceType().toString() ==
+             "urn:herqq-org:service:HLastChangeService:1")
+    {
+        return new HBatchService();
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_DEVICE_H
+#define BENCHMARK_DEVICE_H
+
+#include <HUpnpCore/HUpnp>
+#include <HUpnpCore/HServerDevice>
+#include <HUpnpCore/HServerService>
+#include <HUpnpCore/HDeviceModelCreator>
+
+//
+// The service hosted by every benchmark device. It implements the actions of
+// the HTestService description, but without any of the user interface hooks
+// found in the simple test application, so that the measurements are not
+// skewed by anything else than HUPnP itself.
+//
+class HBenchmarkService :
+    public Herqq::Upnp::HServerService
+{
+Q_OBJECT
+Q_DISABLE_COPY(HBenchmarkService)
+
+private:
+
+    virtual HActionInvokes createActionInvokes();
+
+public:
+
+    HBenchmarkService();
+    virtual ~HBenchmarkService();
+
+    qint32 echoAction(
+        const Herqq::Upnp::HActionArguments& inArgs,
+        Herqq::Upnp::HActionArguments* outArgs = 0);
+
+    qint32 registerAction(
+        const Herqq::Upnp::HActionArguments& inArgs,
+        Herqq::Upnp::HActionArguments* outArgs = 0);
+
+    qint32 chargenAction(
+        const Herqq::Upnp::HActionArguments& inArgs,
+        Herqq::Upnp::HActionArguments* outArgs = 0);
+};
+
+//
+// The services of the batched update and the notify parsing benchmarks.
+// These have no actions, only the evented state variables of the
+// HBatchService and the HLastChangeService descriptions.
+//
+class HBatchService :
+    public Herqq::Upnp::HServerService
+{
+Q_OBJECT
+Q_DISABLE_COPY(HBatchService)
+
+public:
+
+    HBatchService();
+    virtual ~HBatchService();
+};
+
+//
+//
+//
+class HBenchmarkDevice :
+    public Herqq::Upnp::HServerDevice
+{
+Q_OBJECT
+Q_DISABLE_COPY(HBenchmarkDevice)
+
+public:
+
+    HBenchmarkDevice();
+    virtual ~HBenchmarkDevice();
+};
+
+//
+// Creates the HBenchmarkDevice, HBenchmarkService and HBatchService instances
+// for the device host.
+//
+class HBenchmarkModelCreator :
+    public Herqq::Upnp::HDeviceModelCreator
+{
+protected:
+
+    virtual HBenchmarkModelCreator* newInstance() const;
+
+public:
+
+    virtual Herqq::Upnp::HServerDevice* createDevice(
+        const Herqq::Upnp::HDeviceInfo& info) const;
+
+    virtual Herqq::Upnp::HServerService* createService(
+        const Herqq::Upnp::HServiceInfo& serviceInfo,
+        const Herqq::Upnp::HDeviceInfo& deviceInfo) const;
+};
+
+#endif // BENCHMARK_DEVICE_H
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark_report.h"
+
+#include <QtCore/QtAlgorithms>
+
+namespace
+{
+QString quote(const QString& str)
+{
+    QString retVal;
+    retVal.reserve(str.size() + 2);
+    retVal.append('"');
+    for(qint32 i = 0; i < str.size(); ++i)
+    {
+        QChar ch = str.at(i);
+        switch(ch.unicode())
+        {
+        case '"' : retVal.append("\\\""); break;
+        case '\\': retVal.append("\\\\"); break;
+        case '\n': retVal.append("\\n"); break;
+        case '\r': retVal.append("\\r"); break;
+        case '\t': retVal.append("\\t"); break;
+        default:
+            if (ch.unicode() < 0x20)
+            {
+                retVal.append(
+                    QString("\\u%1").arg(ch.unicode(), 4, 16, QChar('0')));
+            }
+            else
+            {
+                retVal.append(ch);
+            }
+        }
+    }
+    retVal.append('"');
+    return retVal;
+}
+
+QString toJsonValue(const QVariant& value)
+{
+    switch(value.type())
+    {
+    case QVariant::Bool:
+        return value.toBool() ? "true" : "false";
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+        return value.toString();
+    case QVariant::Double:
+        return QString::number(value.toDouble(), 'f', 3);
+    default:
+        return quote(value.toString());
+    }
+}
+
+QString toJsonObject(
+    const QList<QPair<QString, QVariant> >& values, const QString& indent)
+{
+    QString retVal("{");
+    for(qint32 i = 0; i < values.size(); ++i)
+    {
+        retVal.append(i > 0 ? ",\n" : "\n");
+        retVal.append(indent).append("  ");
+        retVal.append(quote(values.at(i).first)).append(": ");
+        retVal.append(toJsonValue(values.at(i).second));
+    }
+    retVal.append("\n").append(indent).append("}");
+    return retVal;
+}
+
+double percentile(const QList<double>& sorted, double p)
+{
+    Q_ASSERT(!sorted.isEmpty());
+    qint32 index = qRound(p * (sorted.size() - 1));
+    return sorted.at(qBound(0, index, sorted.size() - 1));
+}
+}
+
+/*******************************************************************************
+ * HBenchmarkResult
+ *******************************************************************************/
+HBenchmarkResult::HBenchmarkResult(const QString& name) :
+    m_name(name), m_values()
+{
+}
+
+void HBenchmarkResult::set(const QString& key, const QVariant& value)
+{
+    m_values.append(qMakePair(key, value));
+}
+
+void HBenchmarkResult::setLatencies(
+    const QString& prefix, QList<double> samplesMs)
+{
+    set(QString("%1_samples").arg(prefix), samplesMs.size());
+    if (samplesMs.isEmpty())
+    {
+        return;
+    }
+
+    qSort(samplesMs);
+
+    double sum = 0;
+    foreach(double sample, samplesMs)
+    {
+        sum += sample;
+    }
+
+    set(QString("%1_min_ms").arg(prefix), samplesMs.first());
+    set(QString("%1_mean_ms").arg(prefix), sum / samplesMs.size());
+    set(QString("%1_p50_ms").arg(prefix), percentile(samplesMs, 0.50));
+    set(QString("%1_p90_ms").arg(prefix), percentile(samplesMs, 0.90));
+    set(QString("%1_p99_ms").arg(prefix), percentile(samplesMs, 0.99));
+    set(QString("%1_max_ms").arg(prefix), samplesMs.last());
+}
+
+/*******************************************************************************
+ * HBenchmarkReport
+ *******************************************************************************/
+HBenchmarkReport::HBenchmarkReport() :
+    m_parameters(), m_results(), m_metrics()
+{
+}
+
+void HBenchmarkReport::setParameter(const QString& key, const QVariant& value)
+{
+    m_parameters.append(qMakePair(key, value));
+}
+
+void HBenchmarkReport::setMetric(const QString& key, const QVariant& value)
+{
+    m_metrics.append(qMakePair(key, value));
+}
+
+void HBenchmarkReport::add(const HBenchmarkResult& result)
+{
+    m_results.append(result);
+}
+
+QByteArray HBenchmarkReport::toJson() const
+{
+    QString retVal("{\n");
+
+    retVal.append("  \"parameters\": ");
+    retVal.append(toJsonObject(m_parameters, "  "));
+    retVal.append(",\n  \"benchmarks\": {");
+
+    for(qint32 i = 0; i < m_results.size(); ++i)
+    {
+        const HBenchmarkResult& result = m_results.at(i);
+        retVal.append(i > 0 ? ",\n" : "\n");
+        retVal.append("    ").append(quote(result.name())).append(": ");
+        retVal.append(toJsonObject(result.values(), "    "));
+    }
+
+    retVal.append("\n  },\n  \"metrics\": ");
+    retVal.append(toJsonObject(m_metrics, "  "));
+    retVal.append("\n}\n");
+
+    return retVal.toUtf8();
+}
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+//
+// The results of a single benchmark, as an ordered list of name-value pairs.
+//
+class HBenchmarkResult
+{
+private:
+
+    QString m_name;
+    QList<QPair<QString, QVariant> > m_values;
+
+public:
+
+    explicit HBenchmarkResult(const QString& name);
+
+    inline QString name() const { return m_name; }
+
+    inline const QList<QPair<QString, QVariant> >& values() const
+    {
+        return m_values;
+    }
+
+    void set(const QString& key, const QVariant& value);
+
+    //
+    // Stores the min, mean, p50, p90, p99 and max of the specified samples,
+    // which are expected to be in milliseconds. The keys are prefixed with
+    // the specified prefix, e.g. "latency_p99_ms".
+    //
+    void setLatencies(const QString& prefix, QList<double> samplesMs);
+};
+
+//
+// The complete output of a benchmark run, which is written as JSON so that
+// the results of consecutive runs can be compared by scripts.
+//
+class HBenchmarkReport
+{
+private:
+
+    QList<QPair<QString, QVariant> > m_parameters;
+    QList<HBenchmarkResult> m_results;
+    QList<QPair<QString, QVariant> > m_metrics;
+
+public:
+
+    HBenchmarkReport();
+
+    void setParameter(const QString& key, const QVariant& value);
+    void setMetric(const QString& key, const QVariant& value);
+    void add(const HBenchmarkResult& result);
+
+    QByteArray toJson() const;
+};
+
+#endif // BENCHMARK_REPORT_H
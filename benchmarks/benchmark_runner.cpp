@@ -0,0 +1,3738 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark_runner.h"
+#include "benchmark_device.h"
+#include "benchmark_report.h"
+#include "allocation_counter.h"
+#include "hbenchmark_testservice.h"
+
+#include <HUpnpCore/HUdn>
+#include <HUpnpCore/HSsdp>
+#include <HUpnpCore/HLogSink>
+#include <HUpnpCore/HMetrics>
+#include <HUpnpCore/HEndpoint>
+#include <HUpnpCore/HServiceId>
+#include <HUpnpCore/HDeviceInfo>
+#include <HUpnpCore/HActionInfo>
+#include <HUpnpCore/HDeviceHost>
+#include <HUpnpCore/HClientDevice>
+#include <HUpnpCore/HActionCodec>
+#include <HUpnpCore/HClientAction>
+#include <HUpnpCore/HServerAction>
+#include <HUpnpCore/HServerDevice>
+#include <HUpnpCore/HControlPoint>
+#include <HUpnpCore/HClientService>
+#include <HUpnpCore/HServerService>
+#include <HUpnpCore/HClientActionOp>
+#include <HUpnpCore/HDiscoveryType>
+#include <HUpnpCore/HProductTokens>
+#include <HUpnpCore/HDiscoveryRequest>
+#include <HUpnpCore/HDiscoveryResponse>
+#include <HUpnpCore/HStateVariableInfo>
+#include <HUpnpCore/HStateVariableEvent>
+#include <HUpnpCore/HClientStateVariable>
+#include <HUpnpCore/HServerStateVariable>
+#include <HUpnpCore/HServerStateTransaction>
+#include <HUpnpCore/HDeviceHostConfiguration>
+#include <HUpnpCore/HControlPointConfiguration>
+#include <HUpnpCore/HDeviceModelSnapshot>
+
+#include <HUpnpCore/private/hlogger_p.h>
+
+#include "hddoc_parser_p.h"
+#include "hevent_messages_p.h"
+#include "hdeadline_scheduler_p.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QtDebug>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+#include <QtCore/QThread>
+#include <QtCore/QSemaphore>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QTimerEvent>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
+
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkAccessManager>
+
+#include <QtSoapMessage>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace Herqq::Upnp;
+
+namespace
+{
+const char* const TestServiceId = "urn:herqq-org:serviceId:HTestService";
+
+const char* const SoapEnvelopeNs = "http://schemas.xmlsoap.org/soap/envelope/";
+const char* const SoapEncodingNs = "http://schemas.xmlsoap.org/soap/encoding/";
+
+inline double toMs(qint64 nsecs)
+{
+    return nsecs / 1000000.0;
+}
+
+//
+// The LastChange values of an AVTransport and a RenderingControl of a
+// renderer playing a track, as captured from the events the renderer sent.
+// The metadata of the track is escaped within the AVTransport event, which
+// is why the event is escaped twice in the NOTIFY message.
+//
+const char* const AvTransportLastChange =
+    "<Event xmlns=\"urn:schemas-upnp-org:metadata-1-0/AVT/\">"
+    "<InstanceID val=\"0\">"
+    "<TransportState val=\"PLAYING\"/>"
+    "<TransportStatus val=\"OK\"/>"
+    "<PlaybackStorageMedium val=\"NETWORK\"/>"
+    "<CurrentPlayMode val=\"NORMAL\"/>"
+    "<TransportPlaySpeed val=\"1\"/>"
+    "<NumberOfTracks val=\"12\"/>"
+    "<CurrentTrack val=\"3\"/>"
+    "<CurrentTrackDuration val=\"0:04:12.000\"/>"
+    "<CurrentMediaDuration val=\"0:48:31.000\"/>"
+    "<CurrentTrackURI val=\"http://192.168.1.20:8200/MediaItems/1043.flac\"/>"
+    "<AVTransportURI val=\"http://192.168.1.20:8200/MediaItems/1043.flac\"/>"
+    "<CurrentTrackMetaData val=\"&lt;DIDL-Lite "
+    "xmlns=&quot;urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/&quot; "
+    "xmlns:dc=&quot;http://purl.org/dc/elements/1.1/&quot; "
+    "xmlns:upnp=&quot;urn:schemas-upnp-org:metadata-1-0/upnp/&quot;&gt;"
+    "&lt;item id=&quot;64$2$1$3&quot; parentID=&quot;64$2$1&quot; "
+    "restricted=&quot;1&quot;&gt;"
+    "&lt;dc:title&gt;Night Drive&lt;/dc:title&gt;"
+    "&lt;dc:creator&gt;The Herqq Ensemble&lt;/dc:creator&gt;"
+    "&lt;upnp:artist&gt;The Herqq Ensemble&lt;/upnp:artist&gt;"
+    "&lt;upnp:album&gt;Long Evenings&lt;/upnp:album&gt;"
+    "&lt;upnp:genre&gt;Jazz&lt;/upnp:genre&gt;"
+    "&lt;upnp:originalTrackNumber&gt;3&lt;/upnp:originalTrackNumber&gt;"
+    "&lt;upnp:albumArtURI&gt;http://192.168.1.20:8200/AlbumArt/211-1043.jpg"
+    "&lt;/upnp:albumArtURI&gt;"
+    "&lt;upnp:class&gt;object.item.audioItem.musicTrack&lt;/upnp:class&gt;"
+    "&lt;res protocolInfo=&quot;http-get:*:audio/x-flac:*&quot; "
+    "size=&quot;29812733&quot; duration=&quot;0:04:12.000&quot; "
+    "bitrate=&quot;118300&quot; sampleFrequency=&quot;44100&quot; "
+    "nrAudioChannels=&quot;2&quot;&gt;"
+    "http://192.168.1.20:8200/MediaItems/1043.flac&lt;/res&gt;"
+    "&lt;/item&gt;&lt;/DIDL-Lite&gt;\"/>"
+    "<AVTransportURIMetaData val=\"NOT_IMPLEMENTED\"/>"
+    "<NextAVTransportURI val=\"NOT_IMPLEMENTED\"/>"
+    "<NextAVTransportURIMetaData val=\"NOT_IMPLEMENTED\"/>"
+    "<CurrentTransportActions val=\"Play,Stop,Pause,Seek,Next,Previous\"/>"
+    "</InstanceID>"
+    "</Event>";
+
+const char* const RenderingControlLastChange =
+    "<Event xmlns=\"urn:schemas-upnp-org:metadata-1-0/RCS/\">"
+    "<InstanceID val=\"0\">"
+    "<Volume channel=\"Master\" val=\"36\"/>"
+    "<Volume channel=\"LF\" val=\"36\"/>"
+    "<Volume channel=\"RF\" val=\"36\"/>"
+    "<VolumeDB channel=\"Master\" val=\"-3584\"/>"
+    "<Mute channel=\"Master\" val=\"0\"/>"
+    "<Loudness channel=\"Master\" val=\"0\"/>"
+    "<PresetNameList val=\"FactoryDefaults,InstallationDefaults\"/>"
+    "</InstanceID>"
+    "</Event>";
+
+//
+// Returns the body of a NOTIFY message carrying the specified LastChange
+// value, in the form the AV services send them.
+//
+QByteArray lastChangePropertySet(const QString& lastChange)
+{
+    QByteArray body;
+
+    QXmlStreamWriter writer(&body);
+    writer.writeStartDocument();
+    writer.writeNamespace("urn:schemas-upnp-org:event-1-0", "e");
+    writer.writeStartElement("urn:schemas-upnp-org:event-1-0", "propertyset");
+    writer.writeStartElement("urn:schemas-upnp-org:event-1-0", "property");
+    writer.writeTextElement("LastChange", lastChange);
+    writer.writeEndElement();
+    writer.writeEndElement();
+    writer.writeEndDocument();
+
+    return body;
+}
+
+//
+// Returns the resident set size of the process in KiB, or -1 if it cannot
+// be determined on this platform.
+//
+qint64 residentSetSize()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly))
+    {
+        return -1;
+    }
+
+    for(;;)
+    {
+        QByteArray line = status.readLine();
+        if (line.isEmpty())
+        {
+            break;
+        }
+        else if (line.startsWith("VmRSS:"))
+        {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+
+    return -1;
+}
+
+HUdn newUdn()
+{
+    QString uuid = QUuid::createUuid().toString();
+    return HUdn(QString("uuid:%1").arg(uuid.mid(1, uuid.size() - 2)));
+}
+
+HClientService* testService(HControlPoint* cp, const HUdn& udn)
+{
+    HClientDevice* device = cp->device(udn);
+    return device ? device->serviceById(HServiceId(TestServiceId)) : 0;
+}
+
+//
+// Reads the snapshots of the device model of a control point in a loop
+// until it is stopped.
+//
+class HSnapshotReader :
+    public QThread
+{
+Q_DISABLE_COPY(HSnapshotReader)
+
+private:
+
+    const HControlPoint* m_controlPoint;
+    QAtomicInt m_stop;
+
+protected:
+
+    virtual void run()
+    {
+        qint32 lastVersion = -1;
+        while(!m_stop)
+        {
+            HDeviceModelSnapshot snapshot = m_controlPoint->snapshot();
+            if (snapshot.version() != lastVersion)
+            {
+                lastVersion = snapshot.version();
+                ++m_versionsSeen;
+            }
+
+            // every device and service is visited, but without copying
+            // the containers of the snapshot
+            const QList<HDeviceSnapshot>& devices = snapshot.devices();
+            for(qint32 i = 0; i < devices.size(); ++i)
+            {
+                const HDeviceSnapshot& device = devices[i];
+                if (!device.online() || device.locations().isEmpty())
+                {
+                    continue;
+                }
+
+                const QList<HServiceSnapshot>& services = device.services();
+                for(qint32 j = 0; j < services.size(); ++j)
+                {
+                    m_valuesRead += services[j].values().size();
+                }
+            }
+
+            ++m_reads;
+        }
+    }
+
+public:
+
+    qint64 m_reads;
+    qint64 m_valuesRead;
+    qint32 m_versionsSeen;
+
+    explicit HSnapshotReader(const HControlPoint* controlPoint) :
+        m_controlPoint(controlPoint), m_stop(0),
+        m_reads(0), m_valuesRead(0), m_versionsSeen(0)
+    {
+    }
+
+    void stop() { m_stop.fetchAndStoreRelaxed(1); }
+};
+
+//
+// Publishes a sequence of values to a state variable from its own thread.
+//
+class HValuePublisher :
+    public QThread
+{
+Q_DISABLE_COPY(HValuePublisher)
+
+private:
+
+    HServerStateVariable* m_stateVariable;
+    quint32 m_firstValue;
+    qint32 m_count;
+
+protected:
+
+    virtual void run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        for(qint32 i = 0; i < m_count; ++i)
+        {
+            if (!m_stateVariable->publishValue(m_firstValue + i))
+            {
+                ++m_failures;
+            }
+        }
+
+        m_elapsedNs = timer.nsecsElapsed();
+    }
+
+public:
+
+    qint64 m_elapsedNs;
+    qint32 m_failures;
+
+    HValuePublisher(
+        HServerStateVariable* stateVariable, quint32 firstValue,
+        qint32 count) :
+            m_stateVariable(stateVariable), m_firstValue(firstValue),
+            m_count(count), m_elapsedNs(0), m_failures(0)
+    {
+    }
+};
+
+//
+// Generates warnings in a loop from its own thread. The warnings are either
+// output through a call site of the HUPnP logging macros, which is subject
+// to rate limiting like the hot paths of the library, or each one of them
+// is passed to the log writer.
+//
+class HLogProducer :
+    public QThread
+{
+Q_DISABLE_COPY(HLogProducer)
+
+private:
+
+    qint32 m_count;
+    bool m_rateLimited;
+
+protected:
+
+    virtual void run()
+    {
+        HLOG(H_AT, H_FUN);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(qint32 i = 0; i < m_count; ++i)
+        {
+            if (m_rateLimited)
+            {
+                HLOG_WARN(QString("Ignoring invalid message [%1]").arg(i));
+            }
+            else
+            {
+                Herqq::HLogger::logWarning_(
+                    QString("Ignoring invalid message [%1]").arg(i));
+            }
+        }
+
+        m_elapsedNs = timer.nsecsElapsed();
+    }
+
+public:
+
+    qint64 m_elapsedNs;
+
+    HLogProducer(qint32 count, bool rateLimited) :
+        m_count(count), m_rateLimited(rateLimited), m_elapsedNs(0)
+    {
+    }
+};
+
+//
+// Counts the log records instead of writing them, so that the cost of
+// the output device is not part of the measurements.
+//
+class HCountingLogSink :
+    public HLogSink
+{
+public:
+
+    QAtomicInt m_records;
+
+    HCountingLogSink() : m_records(0) {}
+
+    virtual void write(const HLogRecord&)
+    {
+        m_records.ref();
+    }
+};
+
+//
+// Reads the processor time and the number of context switches of the
+// process, or returns false if they cannot be determined on this platform.
+// A thread that blocks and is woken up again causes a voluntary context
+// switch, so the latter counts the wake-ups of the process.
+//
+bool processUsage(qint64* cpuUs, qint64* contextSwitches)
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+    {
+        return false;
+    }
+
+    *cpuUs =
+        (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * Q_INT64_C(1000000) +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+
+    *contextSwitches = usage.ru_nvcsw;
+    return true;
+#else
+    Q_UNUSED(cpuUs)
+    Q_UNUSED(contextSwitches)
+    return false;
+#endif
+}
+
+//
+// Counts the timer events delivered to the objects it is installed on.
+//
+class HTimerEventCounter :
+    public QObject
+{
+public:
+
+    qint32 m_events;
+
+    HTimerEventCounter() : m_events(0) {}
+
+protected:
+
+    virtual bool eventFilter(QObject*, QEvent* event)
+    {
+        if (event->type() == QEvent::Timer)
+        {
+            ++m_events;
+        }
+        return false;
+    }
+};
+
+//
+// Simulates the announcements of a network of root devices. Every device
+// announces itself once per interval and the announcements are spread evenly
+// over the interval. The specified number of devices goes silent after
+// the first interval. Each announcement is passed to the device expiry
+// tracking under test.
+//
+class HAnnouncementSimulator :
+    public QObject
+{
+Q_DISABLE_COPY(HAnnouncementSimulator)
+
+private:
+
+    QBasicTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_announced;
+
+protected:
+
+    const qint32 m_deviceCount;
+    const qint32 m_silentCount;
+    const qint32 m_interval;
+
+    virtual void announce(qint32 device) = 0;
+
+    virtual void timerEvent(QTimerEvent* event)
+    {
+        if (event->timerId() != m_timer.timerId())
+        {
+            QObject::timerEvent(event);
+            return;
+        }
+
+        qint64 due = m_clock.elapsed() * m_deviceCount / m_interval;
+        for(; m_announced < due; ++m_announced)
+        {
+            qint32 device = static_cast<qint32>(m_announced % m_deviceCount);
+            if (device >= m_silentCount || m_announced < m_deviceCount)
+            {
+                announce(device);
+            }
+        }
+    }
+
+public:
+
+    HAnnouncementSimulator(qint32 deviceCount, qint32 silentCount, qint32 interval) :
+        m_timer(), m_clock(), m_announced(0),
+        m_deviceCount(deviceCount), m_silentCount(silentCount),
+        m_interval(interval)
+    {
+    }
+
+    // runs the simulation for the specified time in the calling thread
+    void run(qint32 tickInterval, qint32 duration)
+    {
+        m_clock.start();
+        m_timer.start(tickInterval, this);
+
+        while(m_clock.elapsed() < duration)
+        {
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+
+        m_timer.stop();
+    }
+
+    // the number of devices considered expired
+    virtual qint32 expiredCount() const = 0;
+};
+
+//
+// The device expiry tracking of a control point as it used to be: every root
+// and embedded device has a timer of its own and an announcement restarts
+// the timers of the entire device tree.
+//
+class HPerDeviceTimers :
+    public HAnnouncementSimulator
+{
+private:
+
+    QList<QTimer*> m_timers;
+    const qint32 m_timersPerDevice;
+
+protected:
+
+    virtual void announce(qint32 device)
+    {
+        for(qint32 i = 0; i < m_timersPerDevice; ++i)
+        {
+            m_timers.at(device * m_timersPerDevice + i)->start();
+        }
+    }
+
+public:
+
+    HPerDeviceTimers(
+        qint32 deviceCount, qint32 embeddedCount, qint32 silentCount,
+        qint32 interval, qint32 maxAge, QObject* eventCounter) :
+            HAnnouncementSimulator(deviceCount, silentCount, interval),
+            m_timers(), m_timersPerDevice(embeddedCount + 1)
+    {
+        for(qint32 i = 0; i < deviceCount * m_timersPerDevice; ++i)
+        {
+            QTimer* timer = new QTimer(this);
+            timer->setSingleShot(true);
+            timer->setInterval(maxAge);
+            timer->installEventFilter(eventCounter);
+            m_timers.append(timer);
+        }
+    }
+
+    virtual qint32 expiredCount() const
+    {
+        qint32 retVal = 0;
+        for(qint32 i = 0; i < m_deviceCount; ++i)
+        {
+            if (!m_timers.at(i * m_timersPerDevice)->isActive())
+            {
+                ++retVal;
+            }
+        }
+        return retVal;
+    }
+};
+
+//
+// The device expiry tracking of a control point: a single scheduler that
+// tracks the root devices only.
+//
+class HSchedulerTracking :
+    public HAnnouncementSimulator
+{
+private:
+
+    HDeadlineScheduler m_scheduler;
+    const qint32 m_maxAge;
+
+protected:
+
+    virtual void announce(qint32 device)
+    {
+        m_scheduler.schedule(
+            reinterpret_cast<void*>(static_cast<quintptr>(device + 1)), m_maxAge);
+    }
+
+public:
+
+    HSchedulerTracking(
+        qint32 deviceCount, qint32 silentCount, qint32 interval, qint32 maxAge,
+        QObject* eventCounter) :
+            HAnnouncementSimulator(deviceCount, silentCount, interval),
+            m_scheduler(), m_maxAge(maxAge)
+    {
+        m_scheduler.installEventFilter(eventCounter);
+    }
+
+    virtual qint32 expiredCount() const
+    {
+        return m_deviceCount - m_scheduler.count();
+    }
+};
+
+//
+// Returns the value of the specified header field, or an empty array if the
+// header does not contain the field.
+//
+QByteArray headerValue(const QByteArray& header, const QByteArray& name)
+{
+    QByteArray prefix = name.toLower().append(':');
+    foreach(const QByteArray& line, header.split('\n'))
+    {
+        if (line.toLower().startsWith(prefix))
+        {
+            return line.mid(prefix.size()).trimmed();
+        }
+    }
+
+    return QByteArray();
+}
+
+//
+// Reads an HTTP message from a socket that has no event loop. Returns the
+// header of the message, or an empty array if the message did not arrive
+// in time. The body is read, but it is not stored.
+//
+QByteArray readHttpMessage(QTcpSocket* socket, qint32 timeout)
+{
+    QByteArray data;
+
+    qint32 headerEnd = data.indexOf("\r\n\r\n");
+    while(headerEnd < 0)
+    {
+        if (!socket->bytesAvailable() && !socket->waitForReadyRead(timeout))
+        {
+            return QByteArray();
+        }
+
+        data.append(socket->readAll());
+        headerEnd = data.indexOf("\r\n\r\n");
+    }
+
+    QByteArray header = data.left(headerEnd + 4);
+    qint32 bodySize = data.size() - header.size();
+    qint32 contentLength = headerValue(header, "Content-Length").toInt();
+
+    while(bodySize < contentLength)
+    {
+        if (!socket->waitForReadyRead(timeout))
+        {
+            return QByteArray();
+        }
+
+        bodySize += socket->readAll().size();
+    }
+
+    return header;
+}
+
+//
+// Accepts the event messages sent to the subscriptions of the subscription
+// burst benchmark and acknowledges them, one at a time.
+//
+class HNotifySink :
+    public QThread
+{
+Q_DISABLE_COPY(HNotifySink)
+
+private:
+
+    QHostAddress m_address;
+    qint32 m_timeout;
+    QSemaphore m_listening;
+
+protected:
+
+    virtual void run()
+    {
+        QTcpServer server;
+        if (server.listen(m_address))
+        {
+            m_port = server.serverPort();
+        }
+
+        m_listening.release();
+
+        while(m_port && !m_stopped)
+        {
+            if (!server.waitForNewConnection(50))
+            {
+                continue;
+            }
+
+            QTcpSocket* socket = server.nextPendingConnection();
+            if (!readHttpMessage(socket, m_timeout).isEmpty())
+            {
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+                socket->waitForBytesWritten(m_timeout);
+                m_notifications.ref();
+            }
+
+            socket->disconnectFromHost();
+            delete socket;
+        }
+    }
+
+public:
+
+    quint16 m_port;
+    QAtomicInt m_notifications;
+    QAtomicInt m_stopped;
+
+    HNotifySink(const QHostAddress& address, qint32 timeout) :
+        m_address(address), m_timeout(timeout), m_listening(),
+        m_port(0), m_notifications(0), m_stopped(0)
+    {
+    }
+
+    // returns the port the sink listens to, or zero if it could not listen
+    quint16 waitUntilListening()
+    {
+        m_listening.acquire();
+        return m_port;
+    }
+};
+
+//
+// Sends a set of HTTP requests over connections of their own. Every request
+// is sent before any of the responses is read, which keeps all of them in
+// flight at the same time.
+//
+class HRequestBurst :
+    public QThread
+{
+Q_DISABLE_COPY(HRequestBurst)
+
+private:
+
+    QHostAddress m_host;
+    quint16 m_port;
+    QList<QByteArray> m_requests;
+    qint32 m_timeout;
+
+protected:
+
+    virtual void run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QList<QTcpSocket*> sockets;
+        for(qint32 i = 0; i < m_requests.size(); ++i)
+        {
+            QTcpSocket* socket = new QTcpSocket();
+            socket->connectToHost(m_host, m_port);
+            sockets.append(socket);
+        }
+
+        for(qint32 i = 0; i < sockets.size(); ++i)
+        {
+            QTcpSocket* socket = sockets.at(i);
+            if (socket->waitForConnected(m_timeout))
+            {
+                socket->write(m_requests.at(i));
+                socket->waitForBytesWritten(m_timeout);
+            }
+        }
+
+        foreach(QTcpSocket* socket, sockets)
+        {
+            QByteArray header = readHttpMessage(socket, m_timeout);
+            if (header.startsWith("HTTP/1.1 200"))
+            {
+                m_responses.append(header);
+            }
+            else
+            {
+                ++m_failures;
+            }
+        }
+
+        qDeleteAll(sockets);
+
+        m_elapsedNs = timer.nsecsElapsed();
+    }
+
+public:
+
+    QList<QByteArray> m_responses;
+    qint32 m_failures;
+    qint64 m_elapsedNs;
+
+    HRequestBurst(
+        const QHostAddress& host, quint16 port,
+        const QList<QByteArray>& requests, qint32 timeout) :
+            m_host(host), m_port(port), m_requests(requests),
+            m_timeout(timeout), m_responses(), m_failures(0), m_elapsedNs(0)
+    {
+    }
+
+    // waits for the requests to complete while the event loop of the
+    // calling thread keeps running
+    void waitWithEvents()
+    {
+        while(!wait(20))
+        {
+            QCoreApplication::processEvents();
+        }
+    }
+};
+}
+
+/*******************************************************************************
+ * HBenchmarkOptions
+ *******************************************************************************/
+HBenchmarkOptions::HBenchmarkOptions() :
+    deviceCount(10), subscriberCount(10), iterations(1000), concurrency(8),
+    timeout(15000), address(QHostAddress::LocalHost), farmSize(0),
+    parseIterations(10000), validationIterations(1000000),
+    lazyDeviceCount(200), expiryDeviceCount(300), burstSize(500)
+{
+}
+
+/*******************************************************************************
+ * HBenchmarkRunner
+ *******************************************************************************/
+HBenchmarkRunner::HBenchmarkRunner(
+    const HBenchmarkOptions& options, QObject* parent) :
+        QObject(parent),
+            m_options(options), m_descriptionsDir(), m_udns(),
+            m_deviceHost(0), m_controlPoint(0), m_nam(0), m_actions(),
+            m_echoArgs(), m_descriptionUrl(), m_wakeUpTimer(),
+            m_devicesOnline(0), m_subscriptions(0),
+            m_invocationsCompleted(0), m_invocationsFailed(0),
+            m_eventsReceived(0), m_searchResponses(0),
+            m_repliesCompleted(0), m_repliesFailed(0), m_bytesReceived(0),
+            m_issued(0), m_toIssue(0), m_expectedEventValue(),
+            m_lastSearchResponseNs(0), m_stateChanges(0),
+            m_modelsLoaded(0)
+{
+    // The wake-up timer guarantees that waitFor() gets to check for
+    // its timeout even when nothing else happens in the event loop.
+    m_wakeUpTimer.setInterval(20);
+}
+
+HBenchmarkRunner::~HBenchmarkRunner()
+{
+    delete m_nam;
+    delete m_controlPoint;
+    delete m_deviceHost;
+
+    if (!m_descriptionsDir.isEmpty())
+    {
+        QDir dir(m_descriptionsDir);
+        foreach(const QString& file, dir.entryList(QDir::Files))
+        {
+            dir.remove(file);
+        }
+        QDir::temp().rmdir(dir.dirName());
+    }
+}
+
+bool HBenchmarkRunner::createDescriptions(QString* errDescr)
+{
+    QString templateDir =
+        QString("%1/descriptions").arg(QCoreApplication::applicationDirPath());
+
+    QFile deviceTemplate(QString("%1/hupnp_testdevice.xml").arg(templateDir));
+    if (!deviceTemplate.open(QIODevice::ReadOnly))
+    {
+        *errDescr = QString("Could not open [%1]").arg(deviceTemplate.fileName());
+        return false;
+    }
+
+    QString description = QString::fromUtf8(deviceTemplate.readAll());
+
+    QString dirName = QString("hupnp_benchmarks_%1").arg(
+        QCoreApplication::applicationPid());
+
+    if (!QDir::temp().mkpath(dirName))
+    {
+        *errDescr = QString("Could not create [%1]").arg(dirName);
+        return false;
+    }
+
+    m_descriptionsDir = QDir::temp().filePath(dirName);
+
+    // the batch device is hosted by the batched_update and the
+    // notify_parsing benchmarks only
+    QStringList copies;
+    copies << "hupnp_testservice_scpd.xml" << "hupnp_batchdevice.xml"
+           << "hupnp_batchservice_scpd.xml"
+           << "hupnp_lastchangeservice_scpd.xml";
+
+    foreach(const QString& copy, copies)
+    {
+        if (!QFile::copy(
+            QString("%1/%2").arg(templateDir, copy),
+            QString("%1/%2").arg(m_descriptionsDir, copy)))
+        {
+            *errDescr = QString("Could not copy [%1]").arg(copy);
+            return false;
+        }
+    }
+
+    // Every hosted device has to have a unique UDN, which is why the template
+    // is copied once per device.
+    for(qint32 i = 0; i < m_options.deviceCount; ++i)
+    {
+        HUdn udn = newUdn();
+
+        QString copy = description;
+        copy.replace("uuid:5d794fc2-5c5e-4460-a023-f04a51363300", udn.toString());
+        copy.replace(
+            "HUPnP Test Device", QString("HUPnP Benchmark Device %1").arg(i));
+
+        QFile file(QString("%1/device_%2.xml").arg(
+            m_descriptionsDir, QString::number(i)));
+
+        if (!file.open(QIODevice::WriteOnly) || file.write(copy.toUtf8()) < 0)
+        {
+            *errDescr = QString("Could not write [%1]").arg(file.fileName());
+            return false;
+        }
+
+        m_udns.append(udn);
+    }
+
+    return true;
+}
+
+bool HBenchmarkRunner::waitFor(
+    const qint32& counter, qint32 target, qint32 timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (timeout < 0)
+    {
+        timeout = m_options.timeout;
+    }
+
+    m_wakeUpTimer.start();
+    while(counter < target && timer.elapsed() < timeout)
+    {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    m_wakeUpTimer.stop();
+
+    return counter >= target;
+}
+
+void HBenchmarkRunner::invokeNext()
+{
+    HClientAction* action = m_actions.at(m_issued % m_actions.size());
+    ++m_issued;
+    action->beginInvoke(m_echoArgs);
+}
+
+void HBenchmarkRunner::fetchNext()
+{
+    ++m_issued;
+    m_nam->get(QNetworkRequest(m_descriptionUrl));
+}
+
+void HBenchmarkRunner::rootDeviceOnline(HClientDevice* device)
+{
+    if (m_udns.contains(device->info().udn()))
+    {
+        ++m_devicesOnline;
+    }
+}
+
+void HBenchmarkRunner::subscriptionSucceeded(HClientService*)
+{
+    ++m_subscriptions;
+}
+
+void HBenchmarkRunner::invokeComplete(
+    HClientAction*, const HClientActionOp& op)
+{
+    if (op.returnValue() != UpnpSuccess)
+    {
+        ++m_invocationsFailed;
+    }
+
+    ++m_invocationsCompleted;
+
+    if (m_issued < m_toIssue)
+    {
+        invokeNext();
+    }
+}
+
+void HBenchmarkRunner::valueChanged(
+    const HClientStateVariable*, const HStateVariableEvent& event)
+{
+    if (!m_expectedEventValue.isValid())
+    {
+        return;
+    }
+
+    // the LastChange values of the notify parsing benchmark are strings,
+    // the values of the other benchmarks counters
+    bool expected = m_expectedEventValue.type() == QVariant::String ?
+        event.newValue().toString() == m_expectedEventValue.toString() :
+        event.newValue().toUInt() == m_expectedEventValue.toUInt();
+
+    if (expected)
+    {
+        ++m_eventsReceived;
+    }
+}
+
+void HBenchmarkRunner::serviceStateChanged(const HServerService*)
+{
+    ++m_stateChanges;
+}
+
+void HBenchmarkRunner::serviceModelLoaded(HClientService*)
+{
+    ++m_modelsLoaded;
+}
+
+void HBenchmarkRunner::discoveryResponseReceived(
+    const HDiscoveryResponse& response, const HEndpoint&)
+{
+    if (m_udns.contains(response.usn().udn()))
+    {
+        ++m_searchResponses;
+    }
+}
+
+void HBenchmarkRunner::replyFinished(QNetworkReply* reply)
+{
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        m_bytesReceived += reply->readAll().size();
+    }
+    else
+    {
+        ++m_repliesFailed;
+    }
+
+    reply->deleteLater();
+    ++m_repliesCompleted;
+
+    if (m_issued < m_toIssue)
+    {
+        fetchNext();
+    }
+}
+
+bool HBenchmarkRunner::runDiscovery(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("discovery");
+    result.set("devices", m_options.deviceCount);
+
+    // the benchmarks measure the network path unless stated otherwise
+    HControlPointConfiguration config;
+    config.setSubscribeToEvents(false);
+    config.setInProcessDevices(false);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+
+    m_controlPoint = new HControlPoint(config, this);
+
+    bool ok = connect(
+        m_controlPoint, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!m_controlPoint->init())
+    {
+        qWarning() << m_controlPoint->errorDescription();
+        return false;
+    }
+
+    ok = waitFor(m_devicesOnline, m_options.deviceCount);
+
+    result.set("all_discovered", ok);
+    result.set("discovered", m_devicesOnline);
+    result.set("time_to_discover_ms", toMs(timer.nsecsElapsed()));
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runActionLatency(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("action_latency");
+
+    m_actions.clear();
+    foreach(const HUdn& udn, m_udns)
+    {
+        HClientService* service = testService(m_controlPoint, udn);
+        HClientAction* action = service ? service->actions().value("Echo") : 0;
+        if (!action)
+        {
+            return false;
+        }
+
+        bool ok = connect(
+            action,
+            SIGNAL(invokeComplete(
+                Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)),
+            this,
+            SLOT(invokeComplete(
+                Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)));
+        Q_ASSERT(ok); Q_UNUSED(ok)
+
+        m_actions.append(action);
+    }
+
+    m_echoArgs = m_actions.first()->info().inputArguments();
+    m_echoArgs.setValue("MessageIn", QString("HUPnP benchmark"));
+
+    // The first invocation establishes the persistent connection,
+    // which should not be part of the measured round-trips.
+    m_issued = m_invocationsCompleted = m_invocationsFailed = m_toIssue = 0;
+    m_actions.first()->beginInvoke(m_echoArgs);
+    if (!waitFor(m_invocationsCompleted, 1))
+    {
+        return false;
+    }
+
+    QList<double> samples;
+    HClientAction* action = m_actions.first();
+    qint64 allocations = hAllocationCount();
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        qint32 target = m_invocationsCompleted + 1;
+        action->beginInvoke(m_echoArgs);
+        if (!waitFor(m_invocationsCompleted, target))
+        {
+            break;
+        }
+
+        samples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    allocations = hAllocationCount() - allocations;
+
+    result.set("failures", m_invocationsFailed);
+    result.setLatencies("round_trip", samples);
+
+    // both the client and the server side of the round-trips, as well as
+    // the event loop, allocate within this process
+    result.set(
+        "allocations_per_round_trip",
+        samples.isEmpty() ? 0.0 : allocations / static_cast<double>(samples.size()));
+    report->add(result);
+
+    return samples.size() == m_options.iterations && !m_invocationsFailed;
+}
+
+bool HBenchmarkRunner::runActionArguments(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("action_arguments");
+    result.set("iterations", m_options.iterations);
+
+    HServerDevice* device = m_deviceHost->device(m_udns.first());
+    HServerService* service =
+        device ? device->serviceById(HServiceId(TestServiceId)) : 0;
+    HServerAction* serverAction = service ? service->actions().value("Echo") : 0;
+    if (!serverAction)
+    {
+        return false;
+    }
+
+    HClientAction* clientAction = m_actions.first();
+    QString message("HUPnP benchmark");
+
+    // The argument handling of an invocation on the server side: the input
+    // arguments are filled in from the request and the output arguments
+    // are created by the action.
+    qint64 allocations = hAllocationCount();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint32 failures = 0;
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        HActionArguments inArgs = serverAction->info().inputArguments();
+        inArgs.setValue("MessageIn", message);
+
+        HActionArguments outArgs;
+        if (serverAction->invoke(inArgs, &outArgs) != UpnpSuccess)
+        {
+            ++failures;
+        }
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+    allocations = hAllocationCount() - allocations;
+
+    result.set("server_ns_per_invoke", elapsed / m_options.iterations);
+    result.set(
+        "server_allocations_per_invoke",
+        allocations / static_cast<double>(m_options.iterations));
+
+    // The argument handling of an invocation on the client side: the input
+    // arguments are stored in the operation and the output arguments are
+    // filled in from the response.
+    allocations = hAllocationCount();
+    timer.restart();
+
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        HClientActionOp op(m_echoArgs);
+
+        HActionArguments outArgs = clientAction->info().outputArguments();
+        outArgs.setValue("MessageOut", message);
+
+        op.setOutputArguments(outArgs);
+    }
+
+    elapsed = timer.nsecsElapsed();
+    allocations = hAllocationCount() - allocations;
+
+    result.set("client_ns_per_invoke", elapsed / m_options.iterations);
+    result.set(
+        "client_allocations_per_invoke",
+        allocations / static_cast<double>(m_options.iterations));
+
+    result.set("failures", failures);
+    report->add(result);
+
+    return !failures;
+}
+
+bool HBenchmarkRunner::runGeneratedStubs(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("generated_stubs");
+    result.set("iterations", m_options.iterations);
+
+    HClientAction* action = m_actions.first();
+    const HActionCodec* codec = HBenchmarkTestService::codec("Echo");
+    if (!codec || !codec->isCompatible(action->info()))
+    {
+        return false;
+    }
+
+    QString message("HUPnP benchmark");
+    QString serviceType = action->parentService()->info().serviceType().toString();
+
+    HActionArguments inArgs = action->info().inputArguments();
+    HActionArguments outArgs = action->info().outputArguments();
+
+    // The arguments of an invocation accessed by name and validated against
+    // their state variables, as done by code written against the dynamic API.
+    qint32 failures = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        if (!inArgs.setValue("MessageIn", message) ||
+            !outArgs.setValue("MessageOut", message) ||
+            outArgs.value("MessageOut").toString() != message)
+        {
+            ++failures;
+        }
+    }
+
+    result.set("dynamic_ns_per_invoke", timer.nsecsElapsed() / m_options.iterations);
+
+    // The same arguments accessed by position through the generated codec,
+    // which validates them with the checks compiled in from the description.
+    HBenchmarkTestService::EchoIn echoIn;
+    echoIn.MessageIn = message;
+    HBenchmarkTestService::EchoOut echoOut;
+    echoOut.MessageOut = message;
+
+    timer.restart();
+
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        if (!HBenchmarkTestService::EchoCodec::encode(echoIn, &inArgs) ||
+            !HBenchmarkTestService::EchoCodec::encode(echoOut, &outArgs) ||
+            !HBenchmarkTestService::EchoCodec::decode(outArgs, &echoOut) ||
+            echoOut.MessageOut != message)
+        {
+            ++failures;
+        }
+    }
+
+    result.set("generated_ns_per_invoke", timer.nsecsElapsed() / m_options.iterations);
+
+    // The SOAP request of an invocation encoded and its response decoded
+    // with the generic conversions of the dynamic API.
+    QByteArray response = QString(
+        "<?xml version=\"1.0\"?>"
+        "<s:Envelope xmlns:s=\"%1\" s:encodingStyle=\"%2\">"
+        "<s:Body><u:EchoResponse xmlns:u=\"%3\">"
+        "<MessageOut>%4</MessageOut>"
+        "</u:EchoResponse></s:Body></s:Envelope>").arg(
+            SoapEnvelopeNs, SoapEncodingNs, serviceType, message).toUtf8();
+
+    timer.restart();
+
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        QtSoapMessage request;
+        request.setMethod(QtSoapQName("Echo", serviceType));
+        request.addMethodArgument(
+            new QtSoapSimpleType(QtSoapQName("MessageIn"), message));
+
+        QByteArray body = request.toXmlString().toUtf8();
+
+        QtSoapMessage reply;
+        if (body.isEmpty() || !reply.setContent(response) ||
+            !outArgs.setValue(
+                "MessageOut", reply.method()["MessageOut"].value().toString()))
+        {
+            ++failures;
+        }
+    }
+
+    result.set("generic_soap_ns_per_invoke", timer.nsecsElapsed() / m_options.iterations);
+
+    // The same messages written and read by the generated codec.
+    timer.restart();
+
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        QByteArray body;
+        QXmlStreamWriter writer(&body);
+        writer.writeStartDocument();
+        writer.writeNamespace(SoapEnvelopeNs, "s");
+        writer.writeStartElement(SoapEnvelopeNs, "Envelope");
+        writer.writeAttribute(SoapEnvelopeNs, "encodingStyle", SoapEncodingNs);
+        writer.writeStartElement(SoapEnvelopeNs, "Body");
+        writer.writeNamespace(serviceType, "u");
+        writer.writeStartElement(serviceType, "Echo");
+        bool ok = codec->writeInputArguments(inArgs, writer);
+        writer.writeEndDocument();
+
+        // the envelope, the body and the response element
+        QXmlStreamReader reader(response);
+        for(qint32 j = 0; j < 3 && ok; ++j)
+        {
+            ok = reader.readNextStartElement();
+        }
+
+        if (!ok || !codec->readOutputArguments(reader, &outArgs))
+        {
+            ++failures;
+        }
+    }
+
+    result.set("codec_soap_ns_per_invoke", timer.nsecsElapsed() / m_options.iterations);
+
+    // The round-trips of the dynamic API, which encodes and decodes the
+    // SOAP messages generically.
+    if (!action->setCodec(0))
+    {
+        return false;
+    }
+
+    m_invocationsFailed = 0;
+
+    QList<double> samples;
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        timer.restart();
+
+        qint32 target = m_invocationsCompleted + 1;
+        action->beginInvoke(m_echoArgs);
+        if (!waitFor(m_invocationsCompleted, target))
+        {
+            break;
+        }
+
+        samples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    result.setLatencies("dynamic_round_trip", samples);
+    bool completed = samples.size() == m_options.iterations;
+
+    // The round-trips through the generated proxy, which sets the codecs
+    // to the actions of the service.
+    HBenchmarkTestServiceProxy proxy(action->parentService()->info().serviceType());
+    if (!proxy.setService(action->parentService()) || action->codec() != codec)
+    {
+        qWarning() << proxy.lastErrorDescription();
+        action->setCodec(0);
+        return false;
+    }
+
+    samples.clear();
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        timer.restart();
+
+        qint32 target = m_invocationsCompleted + 1;
+        HClientActionOp op = proxy.echo(echoIn);
+        if (op.returnValue() != UpnpInvocationInProgress ||
+            !waitFor(m_invocationsCompleted, target))
+        {
+            break;
+        }
+
+        samples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    // the rest of the benchmarks measure the dynamic API
+    foreach(HClientAction* serviceAction, action->parentService()->actions())
+    {
+        serviceAction->setCodec(0);
+    }
+
+    result.setLatencies("proxy_round_trip", samples);
+    result.set("failures", failures + m_invocationsFailed);
+    report->add(result);
+
+    return completed && samples.size() == m_options.iterations && !failures &&
+           !m_invocationsFailed;
+}
+
+bool HBenchmarkRunner::runActionThroughput(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("action_throughput");
+    result.set("concurrency", m_options.concurrency);
+    result.set("devices", m_actions.size());
+
+    m_issued = m_invocationsCompleted = m_invocationsFailed = 0;
+    m_toIssue = m_options.iterations;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // The completion of every invocation issues the next one until all
+    // of them are issued, which keeps the number of invocations in flight
+    // at the configured concurrency.
+    for(qint32 i = 0; i < qMin(m_options.concurrency, m_toIssue); ++i)
+    {
+        invokeNext();
+    }
+
+    bool ok = waitFor(m_invocationsCompleted, m_toIssue);
+    double elapsed = toMs(timer.nsecsElapsed());
+
+    m_toIssue = 0;
+
+    result.set("invocations", m_invocationsCompleted);
+    result.set("failures", m_invocationsFailed);
+    result.set("elapsed_ms", elapsed);
+    result.set(
+        "invocations_per_second",
+        elapsed > 0 ? m_invocationsCompleted * 1000.0 / elapsed : 0.0);
+
+    report->add(result);
+
+    return ok && !m_invocationsFailed;
+}
+
+bool HBenchmarkRunner::runEventFanOut(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("event_fanout");
+    result.set("subscribers", m_options.subscriberCount);
+
+    const HUdn& udn = m_udns.first();
+
+    HControlPointConfiguration config;
+    config.setAutoDiscovery(false);
+    config.setSubscribeToEvents(false);
+    config.setInProcessDevices(false);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+
+    // Each subscriber is a control point of its own, since a single control
+    // point subscribes to a service only once.
+    QList<HControlPoint*> subscribers;
+    qint32 onlineTarget = m_devicesOnline + m_options.subscriberCount;
+    for(qint32 i = 0; i < m_options.subscriberCount; ++i)
+    {
+        HControlPoint* cp = new HControlPoint(config, this);
+
+        bool ok = connect(
+            cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+            this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+        Q_ASSERT(ok); Q_UNUSED(ok)
+
+        ok = connect(
+            cp, SIGNAL(subscriptionSucceeded(Herqq::Upnp::HClientService*)),
+            this, SLOT(subscriptionSucceeded(Herqq::Upnp::HClientService*)));
+        Q_ASSERT(ok);
+
+        subscribers.append(cp);
+
+        if (!cp->init() || !cp->scan(HDiscoveryType(udn, true)))
+        {
+            qWarning() << cp->errorDescription();
+            qDeleteAll(subscribers);
+            return false;
+        }
+    }
+
+    bool ok = waitFor(m_devicesOnline, onlineTarget);
+
+    m_subscriptions = 0;
+    foreach(HControlPoint* cp, subscribers)
+    {
+        HClientService* service = testService(cp, udn);
+        if (!service)
+        {
+            ok = false;
+            break;
+        }
+
+        const HClientStateVariable* sv =
+            service->stateVariables().value("RegisteredClientCount");
+
+        connect(
+            sv,
+            SIGNAL(valueChanged(
+                const Herqq::Upnp::HClientStateVariable*,
+                Herqq::Upnp::HStateVariableEvent)),
+            this,
+            SLOT(valueChanged(
+                const Herqq::Upnp::HClientStateVariable*,
+                Herqq::Upnp::HStateVariableEvent)));
+
+        cp->subscribeEvents(service);
+    }
+
+    ok = ok && waitFor(m_subscriptions, m_options.subscriberCount);
+
+    HServerStateVariable* sv = ok ?
+        m_deviceHost->device(udn)->serviceById(
+            HServiceId(TestServiceId))->stateVariables().value(
+                "RegisteredClientCount") : 0;
+
+    QList<double> samples;
+    for(qint32 i = 0; sv && i < m_options.iterations; ++i)
+    {
+        quint32 value = sv->value().toUInt() + 1;
+
+        m_eventsReceived = 0;
+        m_expectedEventValue = value;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        sv->setValue(value);
+        if (!waitFor(m_eventsReceived, m_options.subscriberCount))
+        {
+            ok = false;
+            break;
+        }
+
+        samples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    m_expectedEventValue = QVariant();
+
+    result.set("subscriptions", m_subscriptions);
+    result.setLatencies("delivery_to_all", samples);
+    report->add(result);
+
+    qDeleteAll(subscribers);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runMulticastFanOut(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("multicast_fanout");
+
+    const HUdn& udn = m_udns.first();
+
+    HServerStateVariable* sv =
+        m_deviceHost->device(udn)->serviceById(
+            HServiceId(TestServiceId))->stateVariables().value("MulticastCount");
+
+    if (!sv)
+    {
+        return false;
+    }
+
+    HControlPointConfiguration config;
+    config.setAutoDiscovery(false);
+    config.setSubscribeToEvents(false);
+    config.setInProcessDevices(false);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+
+    // A multicast event is a single datagram regardless of the number of
+    // control points listening to it, which is why none of them subscribes.
+    // The listeners live in this process and receive the datagrams through
+    // the multicast loopback, which requires --address to be an address
+    // of an interface that supports multicast.
+    const qint32 listenerCounts[] = { 1, 50 };
+
+    bool ok = true;
+    for(qint32 i = 0; i < 2 && ok; ++i)
+    {
+        qint32 listeners = listenerCounts[i];
+
+        QList<HControlPoint*> controlPoints;
+        qint32 onlineTarget = m_devicesOnline + listeners;
+        for(qint32 j = 0; j < listeners; ++j)
+        {
+            HControlPoint* cp = new HControlPoint(config, this);
+
+            bool connected = connect(
+                cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+                this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+            Q_ASSERT(connected); Q_UNUSED(connected)
+
+            controlPoints.append(cp);
+
+            if (!cp->init() || !cp->scan(HDiscoveryType(udn, true)))
+            {
+                qWarning() << cp->errorDescription();
+                ok = false;
+                break;
+            }
+        }
+
+        ok = ok && waitFor(m_devicesOnline, onlineTarget);
+
+        for(qint32 j = 0; ok && j < controlPoints.size(); ++j)
+        {
+            HClientService* service = testService(controlPoints[j], udn);
+
+            const HClientStateVariable* listener = service ?
+                service->stateVariables().value("MulticastCount") : 0;
+
+            if (!listener)
+            {
+                ok = false;
+                break;
+            }
+
+            connect(
+                listener,
+                SIGNAL(valueChanged(
+                    const Herqq::Upnp::HClientStateVariable*,
+                    Herqq::Upnp::HStateVariableEvent)),
+                this,
+                SLOT(valueChanged(
+                    const Herqq::Upnp::HClientStateVariable*,
+                    Herqq::Upnp::HStateVariableEvent)));
+        }
+
+        // the send time covers the creation of the message and the
+        // datagram, the delivery time the reception by every listener
+        QList<double> sendSamples, deliverySamples;
+        for(qint32 j = 0; ok && j < m_options.iterations; ++j)
+        {
+            quint32 value = sv->value().toUInt() + 1;
+
+            m_eventsReceived = 0;
+            m_expectedEventValue = value;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            sv->setValue(value);
+            sendSamples.append(toMs(timer.nsecsElapsed()));
+
+            if (!waitFor(m_eventsReceived, listeners))
+            {
+                ok = false;
+                break;
+            }
+
+            deliverySamples.append(toMs(timer.nsecsElapsed()));
+        }
+
+        m_expectedEventValue = QVariant();
+
+        QString prefix = QString("listeners_%1").arg(listeners);
+        result.setLatencies(QString("%1_send").arg(prefix), sendSamples);
+        result.setLatencies(
+            QString("%1_delivery_to_all").arg(prefix), deliverySamples);
+
+        qDeleteAll(controlPoints);
+    }
+
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runActionCache(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("action_cache");
+    result.set("iterations", m_options.iterations);
+
+    const HUdn& udn = m_udns.first();
+
+    HControlPointConfiguration config;
+    config.setAutoDiscovery(false);
+    config.setSubscribeToEvents(false);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+    config.setIdempotentActions(QStringList() << "Echo");
+    config.setInProcessDevices(false);
+
+    HControlPoint cp(config);
+
+    bool ok = connect(
+        &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        &cp, SIGNAL(subscriptionSucceeded(Herqq::Upnp::HClientService*)),
+        this, SLOT(subscriptionSucceeded(Herqq::Upnp::HClientService*)));
+    Q_ASSERT(ok);
+
+    qint32 onlineTarget = m_devicesOnline + 1;
+    if (!cp.init() || !cp.scan(HDiscoveryType(udn, true)))
+    {
+        qWarning() << cp.errorDescription();
+        return false;
+    }
+
+    if (!waitFor(m_devicesOnline, onlineTarget))
+    {
+        return false;
+    }
+
+    HClientService* service = testService(&cp, udn);
+    HClientAction* action = service ? service->actions().value("Echo") : 0;
+    if (!action)
+    {
+        return false;
+    }
+
+    ok = connect(
+        action,
+        SIGNAL(invokeComplete(
+            Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)),
+        this,
+        SLOT(invokeComplete(
+            Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)));
+    Q_ASSERT(ok);
+
+    ok = connect(
+        service->stateVariables().value("RegisteredClientCount"),
+        SIGNAL(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)),
+        this,
+        SLOT(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)));
+    Q_ASSERT(ok);
+
+    // The cached results are invalidated by the events of the service.
+    m_subscriptions = 0;
+    if (!cp.subscribeEvents(service) || !waitFor(m_subscriptions, 1))
+    {
+        return false;
+    }
+
+    HServerStateVariable* sv =
+        m_deviceHost->device(udn)->serviceById(
+            HServiceId(TestServiceId))->stateVariables().value(
+                "RegisteredClientCount");
+
+    const QString hitsCounter("hupnp_action_cache_hits_total{action=\"Echo\"}");
+    const QString missesCounter("hupnp_action_cache_misses_total{action=\"Echo\"}");
+
+    HMetrics before = cp.metrics();
+
+    m_issued = m_invocationsCompleted = m_invocationsFailed = m_toIssue = 0;
+
+    // Every tenth invocation follows a change of the state of the service,
+    // which makes it go to the device.
+    QList<double> samples;
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        if (i > 0 && i % 10 == 0)
+        {
+            quint32 value = sv->value().toUInt() + 1;
+
+            m_eventsReceived = 0;
+            m_expectedEventValue = value;
+
+            sv->setValue(value);
+            if (!waitFor(m_eventsReceived, 1))
+            {
+                break;
+            }
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        qint32 target = m_invocationsCompleted + 1;
+        action->beginInvoke(m_echoArgs);
+        if (!waitFor(m_invocationsCompleted, target))
+        {
+            break;
+        }
+
+        samples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    m_expectedEventValue = QVariant();
+
+    HMetrics after = cp.metrics();
+    qint64 hits = after.counter(hitsCounter) - before.counter(hitsCounter);
+    qint64 misses = after.counter(missesCounter) - before.counter(missesCounter);
+
+    result.set("hits", hits);
+    result.set("misses", misses);
+    result.set(
+        "hit_rate", hits + misses > 0 ? hits / static_cast<double>(hits + misses) : 0.0);
+    result.set("round_trips_saved", hits);
+    result.set("failures", m_invocationsFailed);
+    result.setLatencies("invocation", samples);
+    report->add(result);
+
+    return samples.size() == m_options.iterations && !m_invocationsFailed;
+}
+
+bool HBenchmarkRunner::runInProcessInvoke(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("in_process_invoke");
+    result.set("iterations", m_options.iterations);
+
+    const HUdn& udn = m_udns.first();
+
+    // Unlike m_controlPoint, this control point finds the devices of
+    // m_deviceHost in this process and invokes their actions directly.
+    HControlPointConfiguration config;
+    config.setAutoDiscovery(false);
+    config.setSubscribeToEvents(false);
+    config.setInProcessDevices(true);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+
+    HControlPoint cp(config);
+
+    bool ok = connect(
+        &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    qint32 onlineTarget = m_devicesOnline + 1;
+    if (!cp.init() || !cp.scan(HDiscoveryType(udn, true)))
+    {
+        qWarning() << cp.errorDescription();
+        return false;
+    }
+
+    if (!waitFor(m_devicesOnline, onlineTarget))
+    {
+        return false;
+    }
+
+    HClientService* service = testService(&cp, udn);
+    HClientAction* inProcessAction =
+        service ? service->actions().value("Echo") : 0;
+
+    if (!inProcessAction)
+    {
+        return false;
+    }
+
+    ok = connect(
+        inProcessAction,
+        SIGNAL(invokeComplete(
+            Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)),
+        this,
+        SLOT(invokeComplete(
+            Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)));
+    Q_ASSERT(ok);
+
+    // The same action of the same device invoked through loopback and
+    // in process, one invocation at a time.
+    HClientAction* actions[2] = { m_actions.first(), inProcessAction };
+    QList<double> samples[2];
+
+    m_issued = m_invocationsCompleted = m_invocationsFailed = m_toIssue = 0;
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        for(qint32 j = 0; j < m_options.iterations; ++j)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            qint32 target = m_invocationsCompleted + 1;
+            actions[i]->beginInvoke(m_echoArgs);
+            if (!waitFor(m_invocationsCompleted, target))
+            {
+                break;
+            }
+
+            samples[i].append(toMs(timer.nsecsElapsed()));
+        }
+    }
+
+    double means[2] = { 0.0, 0.0 };
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        foreach(double sample, samples[i])
+        {
+            means[i] += sample;
+        }
+
+        if (!samples[i].isEmpty())
+        {
+            means[i] /= samples[i].size();
+        }
+    }
+
+    result.set("failures", m_invocationsFailed);
+    result.setLatencies("loopback", samples[0]);
+    result.setLatencies("in_process", samples[1]);
+    result.set("mean_speedup", means[1] > 0.0 ? means[0] / means[1] : 0.0);
+    report->add(result);
+
+    return samples[0].size() == m_options.iterations &&
+           samples[1].size() == m_options.iterations && !m_invocationsFailed;
+}
+
+bool HBenchmarkRunner::runLocalTransport(HBenchmarkReport* report)
+{
+#ifndef Q_OS_UNIX
+    // the local endpoints are Unix domain sockets
+    Q_UNUSED(report)
+    return true;
+#else
+    HBenchmarkResult result("local_transport");
+    result.set("iterations", m_options.iterations);
+
+    QString name = QString("hupnp_benchmarks_%1").arg(
+        QCoreApplication::applicationPid());
+
+    // A device host of its own, since enabling the local endpoint of
+    // m_deviceHost would change what the other benchmarks measure.
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+    hostConfig.setLocalServerName(QString("%1_host").arg(name));
+
+    HUdn udn = newUdn();
+
+    HDeviceConfiguration config;
+    config.setPathToDeviceDescription(
+        QString("%1/device_0.xml").arg(m_descriptionsDir));
+    config.setUdn(udn);
+    config.setFriendlyName("HUPnP Local Transport Device");
+    hostConfig.add(config);
+
+    HDeviceHost host;
+    if (!host.init(hostConfig))
+    {
+        qWarning() << host.errorDescription();
+        return false;
+    }
+
+    HServerStateVariable* sv =
+        host.device(udn)->serviceById(
+            HServiceId(TestServiceId))->stateVariables().value(
+                "RegisteredClientCount");
+
+    // rootDeviceOnline() counts only the devices listed in m_udns
+    m_udns.append(udn);
+
+    // The same device is used over TCP and then through the Unix domain
+    // sockets of both the device host and the control point, one invocation
+    // and one event at a time.
+    QList<double> invocations[2];
+    QList<double> events[2];
+
+    bool ok = true;
+    m_issued = m_invocationsCompleted = m_invocationsFailed = m_toIssue = 0;
+    for(qint32 i = 0; ok && i < 2; ++i)
+    {
+        HControlPointConfiguration cpConfig;
+        cpConfig.setAutoDiscovery(false);
+        cpConfig.setSubscribeToEvents(false);
+        cpConfig.setInProcessDevices(false);
+        cpConfig.setNetworkAddressesToUse(
+            QList<QHostAddress>() << m_options.address);
+
+        if (i == 0)
+        {
+            cpConfig.setUseLocalServers(false);
+        }
+        else
+        {
+            cpConfig.setLocalServerName(QString("%1_cp").arg(name));
+        }
+
+        HControlPoint cp(cpConfig);
+
+        ok = connect(
+            &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+            this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+        Q_ASSERT(ok); Q_UNUSED(ok)
+
+        ok = connect(
+            &cp, SIGNAL(subscriptionSucceeded(Herqq::Upnp::HClientService*)),
+            this, SLOT(subscriptionSucceeded(Herqq::Upnp::HClientService*)));
+        Q_ASSERT(ok);
+
+        qint32 onlineTarget = m_devicesOnline + 1;
+        if (!cp.init() || !cp.scan(HDiscoveryType(udn, true)))
+        {
+            qWarning() << cp.errorDescription();
+            ok = false;
+            break;
+        }
+
+        if (!waitFor(m_devicesOnline, onlineTarget))
+        {
+            ok = false;
+            break;
+        }
+
+        HClientService* service = testService(&cp, udn);
+        HClientAction* action = service ? service->actions().value("Echo") : 0;
+        if (!action)
+        {
+            ok = false;
+            break;
+        }
+
+        ok = connect(
+            action,
+            SIGNAL(invokeComplete(
+                Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)),
+            this,
+            SLOT(invokeComplete(
+                Herqq::Upnp::HClientAction*, Herqq::Upnp::HClientActionOp)));
+        Q_ASSERT(ok);
+
+        ok = connect(
+            service->stateVariables().value("RegisteredClientCount"),
+            SIGNAL(valueChanged(
+                const Herqq::Upnp::HClientStateVariable*,
+                Herqq::Upnp::HStateVariableEvent)),
+            this,
+            SLOT(valueChanged(
+                const Herqq::Upnp::HClientStateVariable*,
+                Herqq::Upnp::HStateVariableEvent)));
+        Q_ASSERT(ok);
+
+        m_subscriptions = 0;
+        if (!cp.subscribeEvents(service) || !waitFor(m_subscriptions, 1))
+        {
+            ok = false;
+            break;
+        }
+
+        for(qint32 j = 0; j < m_options.iterations; ++j)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            qint32 target = m_invocationsCompleted + 1;
+            action->beginInvoke(m_echoArgs);
+            if (!waitFor(m_invocationsCompleted, target))
+            {
+                break;
+            }
+
+            invocations[i].append(toMs(timer.nsecsElapsed()));
+        }
+
+        for(qint32 j = 0; j < m_options.iterations; ++j)
+        {
+            quint32 value = sv->value().toUInt() + 1;
+
+            m_eventsReceived = 0;
+            m_expectedEventValue = value;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            sv->setValue(value);
+            if (!waitFor(m_eventsReceived, 1))
+            {
+                break;
+            }
+
+            events[i].append(toMs(timer.nsecsElapsed()));
+        }
+
+        m_expectedEventValue = QVariant();
+    }
+
+    m_udns.removeAll(udn);
+
+    double means[2] = { 0.0, 0.0 };
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        foreach(double sample, invocations[i])
+        {
+            means[i] += sample;
+        }
+
+        if (!invocations[i].isEmpty())
+        {
+            means[i] /= invocations[i].size();
+        }
+    }
+
+    result.set("failures", m_invocationsFailed);
+    result.setLatencies("tcp_invocation", invocations[0]);
+    result.setLatencies("unix_invocation", invocations[1]);
+    result.setLatencies("tcp_event", events[0]);
+    result.setLatencies("unix_event", events[1]);
+    result.set(
+        "mean_invocation_speedup", means[1] > 0.0 ? means[0] / means[1] : 0.0);
+    report->add(result);
+
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        ok = ok &&
+             invocations[i].size() == m_options.iterations &&
+             events[i].size() == m_options.iterations;
+    }
+
+    return ok && !m_invocationsFailed;
+#endif
+}
+
+bool HBenchmarkRunner::runSnapshotReads(HBenchmarkReport* report)
+{
+    const qint32 readerCount = 8;
+    qint32 cycles = qMax(1, m_options.iterations / 10);
+
+    HBenchmarkResult result("snapshot_reads");
+    result.set("readers", readerCount);
+    result.set("churn_cycles", cycles);
+
+    // A control point of its own, since removing devices from m_controlPoint
+    // would invalidate the actions the other benchmarks use.
+    HControlPointConfiguration config;
+    config.setSubscribeToEvents(false);
+    config.setInProcessDevices(false);
+    config.setNetworkAddressesToUse(QList<QHostAddress>() << m_options.address);
+
+    HControlPoint cp(config);
+
+    bool ok = connect(
+        &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    qint32 onlineTarget = m_devicesOnline + m_options.deviceCount;
+    if (!cp.init())
+    {
+        qWarning() << cp.errorDescription();
+        return false;
+    }
+    else if (!waitFor(m_devicesOnline, onlineTarget))
+    {
+        return false;
+    }
+
+    qint32 firstVersion = cp.snapshotVersion();
+
+    QList<HSnapshotReader*> readers;
+    for(qint32 i = 0; i < readerCount; ++i)
+    {
+        readers.append(new HSnapshotReader(&cp));
+        readers.last()->start();
+    }
+
+    // Meanwhile, the devices leave and join the control point one at a time,
+    // each of which publishes a new snapshot at least twice.
+    QList<double> churn;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(qint32 i = 0; ok && i < cycles; ++i)
+    {
+        const HUdn& udn = m_udns.at(i % m_options.deviceCount);
+        HClientDevice* device = cp.device(udn);
+
+        QElapsedTimer churnTimer;
+        churnTimer.start();
+
+        onlineTarget = m_devicesOnline + 1;
+        ok = device && cp.removeRootDevice(device) &&
+             cp.scan(HDiscoveryType(udn, true)) &&
+             waitFor(m_devicesOnline, onlineTarget);
+
+        if (ok)
+        {
+            churn.append(toMs(churnTimer.nsecsElapsed()));
+        }
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    qint64 reads = 0;
+    qint64 valuesRead = 0;
+    qint32 minVersionsSeen = -1;
+    foreach(HSnapshotReader* reader, readers)
+    {
+        reader->stop();
+        reader->wait();
+
+        reads += reader->m_reads;
+        valuesRead += reader->m_valuesRead;
+        if (minVersionsSeen < 0 || reader->m_versionsSeen < minVersionsSeen)
+        {
+            minVersionsSeen = reader->m_versionsSeen;
+        }
+    }
+    qDeleteAll(readers);
+
+    double seconds = elapsed / 1000000000.0;
+
+    result.set("reads", reads);
+    result.set("reads_per_second", seconds > 0.0 ? reads / seconds : 0.0);
+    result.set(
+        "reads_per_second_per_reader",
+        seconds > 0.0 ? reads / seconds / readerCount : 0.0);
+    result.set(
+        "values_per_read", reads > 0 ? double(valuesRead) / reads : 0.0);
+    result.set("versions_published", cp.snapshotVersion() - firstVersion);
+    result.set("min_versions_seen", minVersionsSeen);
+    result.setLatencies("churn", churn);
+    report->add(result);
+
+    return ok && churn.size() == cycles;
+}
+
+bool HBenchmarkRunner::runStatePublication(HBenchmarkReport* report)
+{
+    const qint32 producerCount = 16;
+    qint32 publishes = m_options.iterations * 100;
+
+    HBenchmarkResult result("state_publication");
+    result.set("producers", producerCount);
+    result.set("publishes_per_producer", publishes);
+
+    HServerService* service =
+        m_deviceHost->device(m_udns.first())->serviceById(
+            HServiceId(TestServiceId));
+
+    HServerStateVariable* sv =
+        service->stateVariables().value("RegisteredClientCount");
+
+    bool ok = connect(
+        service, SIGNAL(stateChanged(const Herqq::Upnp::HServerService*)),
+        this, SLOT(serviceStateChanged(const Herqq::Upnp::HServerService*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_stateChanges = 0;
+
+    // Every producer publishes values of its own range to the same state
+    // variable, while this thread, which is the thread of the device host,
+    // collects them.
+    quint32 firstValue = sv->value().toUInt() + 1;
+
+    QList<HValuePublisher*> producers;
+    for(qint32 i = 0; i < producerCount; ++i)
+    {
+        producers.append(
+            new HValuePublisher(sv, firstValue + i * publishes, publishes));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    foreach(HValuePublisher* producer, producers)
+    {
+        producer->start();
+    }
+
+    bool finished = false;
+    while(!finished)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+
+        finished = true;
+        foreach(HValuePublisher* producer, producers)
+        {
+            finished = finished && producer->isFinished();
+        }
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    // the values published last are collected after the producers are done
+    QCoreApplication::processEvents();
+
+    qint32 failures = 0;
+    QList<double> publishNs;
+    foreach(HValuePublisher* producer, producers)
+    {
+        failures += producer->m_failures;
+        publishNs.append(double(producer->m_elapsedNs) / publishes);
+    }
+    qDeleteAll(producers);
+
+    disconnect(
+        service, SIGNAL(stateChanged(const Herqq::Upnp::HServerService*)),
+        this, SLOT(serviceStateChanged(const Herqq::Upnp::HServerService*)));
+
+    qint64 total = qint64(producerCount) * publishes;
+    double seconds = elapsed / 1000000000.0;
+
+    double meanPublishNs = 0.0;
+    foreach(double sample, publishNs)
+    {
+        meanPublishNs += sample;
+    }
+    meanPublishNs /= producerCount;
+
+    // the final value has to be the last value of one of the producers
+    quint32 lastValue = sv->value().toUInt();
+    bool lastValueOk = lastValue >= firstValue &&
+        (lastValue - firstValue) % publishes == quint32(publishes - 1);
+
+    result.set("failures", failures);
+    result.set("publishes_per_second", seconds > 0.0 ? total / seconds : 0.0);
+    result.set("mean_publish_ns", meanPublishNs);
+    result.set("events", m_stateChanges);
+    result.set(
+        "publishes_per_event",
+        m_stateChanges > 0 ? double(total) / m_stateChanges : 0.0);
+    result.set("last_value_ok", lastValueOk);
+    report->add(result);
+
+    return !failures && m_stateChanges > 0 && lastValueOk;
+}
+
+bool HBenchmarkRunner::runBatchedUpdate(HBenchmarkReport* report)
+{
+    const qint32 variableCount = 10;
+
+    HBenchmarkResult result("batched_update");
+    result.set("iterations", m_options.iterations);
+    result.set("variables", variableCount);
+
+    // A device host of its own, since the batch device would add to the
+    // descriptions the other benchmarks fetch.
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    HUdn udn = newUdn();
+
+    HDeviceConfiguration config;
+    config.setPathToDeviceDescription(
+        QString("%1/hupnp_batchdevice.xml").arg(m_descriptionsDir));
+    config.setUdn(udn);
+    hostConfig.add(config);
+
+    HDeviceHost host;
+    if (!host.init(hostConfig))
+    {
+        qWarning() << host.errorDescription();
+        return false;
+    }
+
+    HServiceId serviceId("urn:herqq-org:serviceId:HBatchService");
+    HServerService* service = host.device(udn)->serviceById(serviceId);
+
+    QStringList names;
+    for(qint32 i = 0; i < variableCount; ++i)
+    {
+        names.append(QString("Level%1").arg(i));
+    }
+
+    // the events are delivered over the network even though the device is
+    // hosted in this process
+    HControlPointConfiguration cpConfig;
+    cpConfig.setAutoDiscovery(false);
+    cpConfig.setSubscribeToEvents(false);
+    cpConfig.setInProcessDevices(false);
+    cpConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    HControlPoint cp(cpConfig);
+
+    bool ok = connect(
+        &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        &cp, SIGNAL(subscriptionSucceeded(Herqq::Upnp::HClientService*)),
+        this, SLOT(subscriptionSucceeded(Herqq::Upnp::HClientService*)));
+    Q_ASSERT(ok);
+
+    // rootDeviceOnline() counts only the devices listed in m_udns
+    m_udns.append(udn);
+
+    qint32 onlineTarget = m_devicesOnline + 1;
+    ok = cp.init() && cp.scan(HDiscoveryType(udn, true)) &&
+         waitFor(m_devicesOnline, onlineTarget);
+
+    m_udns.removeAll(udn);
+
+    HClientDevice* clientDevice = ok ? cp.device(udn) : 0;
+    HClientService* clientService =
+        clientDevice ? clientDevice->serviceById(serviceId) : 0;
+
+    if (!clientService)
+    {
+        return false;
+    }
+
+    // an update has been delivered when the last variable has its new value
+    ok = connect(
+        clientService->stateVariables().value(names.last()),
+        SIGNAL(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)),
+        this,
+        SLOT(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)));
+    Q_ASSERT(ok);
+
+    m_subscriptions = 0;
+    if (!cp.subscribeEvents(clientService) || !waitFor(m_subscriptions, 1))
+    {
+        return false;
+    }
+
+    ok = connect(
+        service, SIGNAL(stateChanged(const Herqq::Upnp::HServerService*)),
+        this, SLOT(serviceStateChanged(const Herqq::Upnp::HServerService*)));
+    Q_ASSERT(ok);
+
+    // The variables are first set one at a time and then in a transaction.
+    // The stateChanged() signals of the service and the NOTIFY messages
+    // queued for the subscriber are counted on the device host.
+    const char* const notifications = "hupnp_gena_notifications_total";
+
+    QList<double> updates[2];
+    QList<double> deliveries[2];
+    qint64 notifies[2] = { 0, 0 };
+    qint32 stateChanges[2] = { 0, 0 };
+
+    quint32 value = 0;
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        m_stateChanges = 0;
+        qint64 notifiesBefore = host.metrics().counter(notifications);
+
+        for(qint32 j = 0; j < m_options.iterations; ++j)
+        {
+            ++value;
+
+            m_eventsReceived = 0;
+            m_expectedEventValue = value;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            if (i == 0)
+            {
+                foreach(const QString& name, names)
+                {
+                    service->setValue(name, value);
+                }
+            }
+            else
+            {
+                HServerStateTransaction transaction(service);
+                foreach(const QString& name, names)
+                {
+                    transaction.setValue(name, value);
+                }
+
+                if (!transaction.commit())
+                {
+                    qWarning() << transaction.errorDescription();
+                    break;
+                }
+            }
+
+            updates[i].append(toMs(timer.nsecsElapsed()));
+
+            if (!waitFor(m_eventsReceived, 1))
+            {
+                break;
+            }
+
+            deliveries[i].append(toMs(timer.nsecsElapsed()));
+        }
+
+        notifies[i] = host.metrics().counter(notifications) - notifiesBefore;
+        stateChanges[i] = m_stateChanges;
+    }
+
+    m_expectedEventValue = QVariant();
+
+    double means[2] = { 0.0, 0.0 };
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        foreach(double sample, deliveries[i])
+        {
+            means[i] += sample;
+        }
+
+        if (!deliveries[i].isEmpty())
+        {
+            means[i] /= deliveries[i].size();
+        }
+    }
+
+    result.setLatencies("per_variable_update", updates[0]);
+    result.setLatencies("transaction_update", updates[1]);
+    result.setLatencies("per_variable_delivery", deliveries[0]);
+    result.setLatencies("transaction_delivery", deliveries[1]);
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        QString prefix = i == 0 ? "per_variable" : "transaction";
+        double count = deliveries[i].size();
+
+        result.set(
+            QString("%1_notifies_per_update").arg(prefix),
+            count > 0 ? notifies[i] / count : 0.0);
+        result.set(
+            QString("%1_state_changes_per_update").arg(prefix),
+            count > 0 ? stateChanges[i] / count : 0.0);
+    }
+    result.set(
+        "mean_delivery_speedup", means[1] > 0.0 ? means[0] / means[1] : 0.0);
+    report->add(result);
+
+    // a transaction has to result in exactly one event
+    return deliveries[0].size() == m_options.iterations &&
+           deliveries[1].size() == m_options.iterations &&
+           stateChanges[1] == m_options.iterations;
+}
+
+bool HBenchmarkRunner::runSearchResponse(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("msearch_response");
+    result.set("devices", m_options.deviceCount);
+
+    QList<HEndpoint> endpoints = m_deviceHost->runtimeStatus()->ssdpEndpoints();
+    if (endpoints.isEmpty())
+    {
+        return false;
+    }
+
+    HSsdp ssdp("__BENCHMARK__: ");
+    ssdp.setFilter(HSsdp::DiscoveryResponse);
+
+    bool ok = connect(
+        &ssdp,
+        SIGNAL(discoveryResponseReceived(
+            Herqq::Upnp::HDiscoveryResponse, Herqq::Upnp::HEndpoint)),
+        this,
+        SLOT(discoveryResponseReceived(
+            Herqq::Upnp::HDiscoveryResponse, Herqq::Upnp::HEndpoint)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    if (!ssdp.init(m_options.address))
+    {
+        return false;
+    }
+
+    HDiscoveryRequest request(
+        1, HDiscoveryType::createDiscoveryTypeForAllResources(),
+        HProductTokens("Linux/2.6 UPnP/1.1 HUPnPBenchmarks/1.0"));
+
+    // A response is sent for the root device, the UDN, the device type and
+    // the service type of every hosted device. The responses are spread
+    // over the MX period, which is why the number of rounds is kept small.
+    qint32 expected = m_options.deviceCount * 4;
+    qint32 rounds = qBound(1, m_options.iterations / 100, 10);
+
+    QList<double> firstSamples, allSamples;
+    for(qint32 i = 0; i < rounds; ++i)
+    {
+        m_searchResponses = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        if (ssdp.sendDiscoveryRequest(request, endpoints.first()) <= 0)
+        {
+            ok = false;
+            break;
+        }
+
+        if (!waitFor(m_searchResponses, 1))
+        {
+            ok = false;
+            break;
+        }
+        firstSamples.append(toMs(timer.nsecsElapsed()));
+
+        if (!waitFor(m_searchResponses, expected))
+        {
+            ok = false;
+            break;
+        }
+        allSamples.append(toMs(timer.nsecsElapsed()));
+    }
+
+    result.set("rounds", rounds);
+    result.set("responses_per_round", expected);
+    result.setLatencies("first_response", firstSamples);
+    result.setLatencies("all_responses", allSamples);
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runDescriptionServing(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("description_serving");
+    result.set("concurrency", m_options.concurrency);
+
+    HClientDevice* device = m_controlPoint->device(m_udns.first());
+    if (!device || device->locations().isEmpty())
+    {
+        return false;
+    }
+
+    m_descriptionUrl = device->locations().first();
+
+    m_nam = new QNetworkAccessManager();
+    bool ok = connect(
+        m_nam, SIGNAL(finished(QNetworkReply*)),
+        this, SLOT(replyFinished(QNetworkReply*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_issued = m_repliesCompleted = m_repliesFailed = 0;
+    m_bytesReceived = 0;
+    m_toIssue = m_options.iterations;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(qint32 i = 0; i < qMin(m_options.concurrency, m_toIssue); ++i)
+    {
+        fetchNext();
+    }
+
+    ok = waitFor(m_repliesCompleted, m_toIssue);
+    double elapsed = toMs(timer.nsecsElapsed());
+
+    m_toIssue = 0;
+
+    result.set("requests", m_repliesCompleted);
+    result.set("failures", m_repliesFailed);
+    result.set("bytes", m_bytesReceived);
+    result.set("elapsed_ms", elapsed);
+    result.set(
+        "requests_per_second",
+        elapsed > 0 ? m_repliesCompleted * 1000.0 / elapsed : 0.0);
+
+    report->add(result);
+
+    return ok && !m_repliesFailed;
+}
+
+bool HBenchmarkRunner::runDeviceFarm(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("device_farm");
+    result.set("devices", m_options.farmSize);
+
+    // Every device is created from the same template, which is why only
+    // the UDN and the friendly name differ between the configurations.
+    QString path = QString("%1/device_0.xml").arg(m_descriptionsDir);
+
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    HDeviceConfiguration config;
+    config.setPathToDeviceDescription(path);
+    config.setUdn(newUdn());
+    config.setFriendlyName("HUPnP Farm Device 0");
+    hostConfig.add(config);
+
+    qint64 rssBefore = residentSetSize();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    HDeviceHost host;
+    if (!host.init(hostConfig))
+    {
+        qWarning() << host.errorDescription();
+        return false;
+    }
+
+    result.set("init_ms", toMs(timer.nsecsElapsed()));
+
+    QList<double> samples;
+    for(qint32 i = 1; i < m_options.farmSize; ++i)
+    {
+        config.setUdn(newUdn());
+        config.setFriendlyName(QString("HUPnP Farm Device %1").arg(i));
+
+        QElapsedTimer addTimer;
+        addTimer.start();
+
+        if (!host.add(config))
+        {
+            qWarning() << host.errorDescription();
+            break;
+        }
+
+        samples.append(toMs(addTimer.nsecsElapsed()));
+    }
+
+    result.set("startup_ms", toMs(timer.nsecsElapsed()));
+    result.setLatencies("add", samples);
+
+    qint64 rssAfter = residentSetSize();
+    if (rssBefore >= 0 && rssAfter >= 0)
+    {
+        result.set("rss_increase_kib", rssAfter - rssBefore);
+        result.set(
+            "rss_per_device_kib",
+            (rssAfter - rssBefore) / static_cast<double>(m_options.farmSize));
+    }
+
+    report->add(result);
+
+    return samples.size() == m_options.farmSize - 1;
+}
+
+bool HBenchmarkRunner::runDescriptionParsing(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("description_parsing");
+    result.set("iterations", m_options.parseIterations);
+
+    QDir dir(
+        QString("%1/av_descriptions").arg(QCoreApplication::applicationDirPath()));
+
+    QStringList deviceDescriptions, serviceDescriptions;
+    foreach(const QString& fileName, dir.entryList(QStringList("*.xml"), QDir::Files))
+    {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Could not open" << file.fileName();
+            return false;
+        }
+
+        QString contents = QString::fromUtf8(file.readAll());
+        if (fileName.endsWith("_description.xml"))
+        {
+            deviceDescriptions.append(contents);
+        }
+        else
+        {
+            serviceDescriptions.append(contents);
+        }
+    }
+
+    if (deviceDescriptions.isEmpty() || serviceDescriptions.isEmpty())
+    {
+        qWarning() << "No AV descriptions found in" << dir.path();
+        return false;
+    }
+
+    HDocParser parser("__BENCHMARK__: ", LooseChecks);
+
+    qint64 deviceNs = 0, serviceNs = 0;
+    qint32 failures = 0;
+
+    for(qint32 i = 0; i < m_options.parseIterations; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        foreach(const QString& description, deviceDescriptions)
+        {
+            HParsedDevice device;
+            qint32 configId;
+            if (!parser.parseDeviceDescription(description, &device, &configId))
+            {
+                ++failures;
+            }
+        }
+
+        deviceNs += timer.nsecsElapsed();
+        timer.restart();
+
+        foreach(const QString& description, serviceDescriptions)
+        {
+            QList<HStateVariableInfo> stateVariables;
+            QList<HActionInfo> actions;
+            if (!parser.parseServiceDescription(
+                description, &stateVariables, &actions))
+            {
+                ++failures;
+            }
+        }
+
+        serviceNs += timer.nsecsElapsed();
+    }
+
+    if (failures)
+    {
+        qWarning() << parser.lastErrorDescription();
+    }
+
+    qint32 documents =
+        deviceDescriptions.size() + serviceDescriptions.size();
+
+    result.set("documents", documents);
+    result.set("failures", failures);
+    result.set("device_descriptions_ms", toMs(deviceNs));
+    result.set("service_descriptions_ms", toMs(serviceNs));
+    result.set(
+        "documents_per_second",
+        deviceNs + serviceNs > 0 ?
+            documents * m_options.parseIterations * 1000.0 /
+                toMs(deviceNs + serviceNs) : 0.0);
+
+    report->add(result);
+
+    return !failures;
+}
+
+bool HBenchmarkRunner::runNotifyParsing(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("notify_parsing");
+    result.set("iterations", m_options.parseIterations);
+
+    const qint32 eventCount = 2;
+    const char* const names[eventCount] =
+    {
+        "avtransport", "renderingcontrol"
+    };
+
+    const QString lastChanges[eventCount] =
+    {
+        QString::fromUtf8(AvTransportLastChange),
+        QString::fromUtf8(RenderingControlLastChange)
+    };
+
+    // The NOTIFY messages are first parsed the way the control point parses
+    // them when they arrive, without the network and the HTTP server.
+    QUrl callback("http://127.0.0.1:8080/");
+    HSid sid(QUuid::createUuid());
+
+    qint32 failures = 0;
+    for(qint32 i = 0; i < eventCount; ++i)
+    {
+        QByteArray body = lastChangePropertySet(lastChanges[i]);
+
+        HNotifyRequest first(callback, sid, 0, body);
+        if (!first.isValid(false) || first.variables().size() != 1 ||
+            first.variables().first().second != lastChanges[i])
+        {
+            qWarning() << "Could not parse the" << names[i] << "event";
+            return false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(qint32 j = 0; j < m_options.parseIterations; ++j)
+        {
+            HNotifyRequest req(callback, sid, j, body);
+            if (req.variables().size() != 1)
+            {
+                ++failures;
+            }
+        }
+
+        qint64 elapsedNs = timer.nsecsElapsed();
+
+        result.set(QString("%1_bytes").arg(names[i]), body.size());
+        result.set(
+            QString("%1_parse_us").arg(names[i]),
+            elapsedNs / 1000.0 / m_options.parseIterations);
+    }
+
+    // The values are then delivered to a control point, which parses them
+    // and updates the LastChange of its service with updateVariables().
+    // The batch device is hosted by a device host of its own, since it would
+    // add to the descriptions the other benchmarks fetch.
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    HUdn udn = newUdn();
+
+    HDeviceConfiguration config;
+    config.setPathToDeviceDescription(
+        QString("%1/hupnp_batchdevice.xml").arg(m_descriptionsDir));
+    config.setUdn(udn);
+    hostConfig.add(config);
+
+    HDeviceHost host;
+    if (!host.init(hostConfig))
+    {
+        qWarning() << host.errorDescription();
+        return false;
+    }
+
+    HServiceId serviceId("urn:herqq-org:serviceId:HLastChangeService");
+    HServerService* service = host.device(udn)->serviceById(serviceId);
+
+    HControlPointConfiguration cpConfig;
+    cpConfig.setAutoDiscovery(false);
+    cpConfig.setSubscribeToEvents(false);
+    cpConfig.setInProcessDevices(false);
+    cpConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    HControlPoint cp(cpConfig);
+
+    bool ok = connect(
+        &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+        this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        &cp, SIGNAL(subscriptionSucceeded(Herqq::Upnp::HClientService*)),
+        this, SLOT(subscriptionSucceeded(Herqq::Upnp::HClientService*)));
+    Q_ASSERT(ok);
+
+    // rootDeviceOnline() counts only the devices listed in m_udns
+    m_udns.append(udn);
+
+    qint32 onlineTarget = m_devicesOnline + 1;
+    ok = cp.init() && cp.scan(HDiscoveryType(udn, true)) &&
+         waitFor(m_devicesOnline, onlineTarget);
+
+    m_udns.removeAll(udn);
+
+    HClientDevice* clientDevice = ok ? cp.device(udn) : 0;
+    HClientService* clientService =
+        clientDevice ? clientDevice->serviceById(serviceId) : 0;
+
+    if (!clientService)
+    {
+        return false;
+    }
+
+    ok = connect(
+        clientService->stateVariables().value("LastChange"),
+        SIGNAL(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)),
+        this,
+        SLOT(valueChanged(
+            const Herqq::Upnp::HClientStateVariable*,
+            Herqq::Upnp::HStateVariableEvent)));
+    Q_ASSERT(ok);
+
+    m_subscriptions = 0;
+    if (!cp.subscribeEvents(clientService) || !waitFor(m_subscriptions, 1))
+    {
+        return false;
+    }
+
+    QList<double> deliveries;
+    for(qint32 i = 0; i < m_options.iterations; ++i)
+    {
+        // the events alternate, so that every value is a change
+        const QString& lastChange = lastChanges[i % eventCount];
+
+        m_eventsReceived = 0;
+        m_expectedEventValue = lastChange;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!service->setValue("LastChange", lastChange) ||
+            !waitFor(m_eventsReceived, 1))
+        {
+            break;
+        }
+
+        deliveries.append(toMs(timer.nsecsElapsed()));
+    }
+
+    m_expectedEventValue = QVariant();
+
+    result.set("failures", failures);
+    result.setLatencies("delivery", deliveries);
+    report->add(result);
+
+    return !failures && deliveries.size() == m_options.iterations;
+}
+
+bool HBenchmarkRunner::runValueValidation(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("value_validation");
+    result.set("iterations", m_options.validationIterations);
+
+    // The allowed value list is about as long as the longer lists of the
+    // AV services, such as the preset names of the RenderingControl.
+    QStringList allowedValues;
+    allowedValues << "STOPPED" << "PLAYING" << "TRANSITIONING" <<
+        "PAUSED_PLAYBACK" << "PAUSED_RECORDING" << "RECORDING" <<
+        "NO_MEDIA_PRESENT";
+
+    for(qint32 i = 0; i < 25; ++i)
+    {
+        allowedValues.append(QString("VENDOR_PRESET_%1").arg(i));
+    }
+
+    HStateVariableInfo stringInfo(
+        "TransportState", QVariant("STOPPED"), allowedValues);
+
+    HStateVariableInfo integerInfo(
+        "Volume", HUpnpDataTypes::ui2, 0u, 0u, 100u, 1u);
+
+    HStateVariableInfo rationalInfo(
+        "Gain", HUpnpDataTypes::r8, 0.0, -60.0, 12.0, 0.5);
+
+    if (!stringInfo.isValid() || !integerInfo.isValid() ||
+        !rationalInfo.isValid())
+    {
+        return false;
+    }
+
+    // The last allowed value is the worst case for a linear search. The
+    // last case has to be converted to the type of the state variable.
+    const qint32 caseCount = 4;
+    const char* const names[caseCount] =
+    {
+        "allowed_value", "integer_range", "rational_range", "converted_value"
+    };
+
+    const HStateVariableInfo* infos[caseCount] =
+    {
+        &stringInfo, &integerInfo, &rationalInfo, &integerInfo
+    };
+
+    const QVariant values[caseCount] =
+    {
+        QVariant(allowedValues.last()), QVariant(50u), QVariant(3.5),
+        QVariant(QString("50"))
+    };
+
+    qint32 failures = 0;
+    for(qint32 i = 0; i < caseCount; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        qint32 valid = 0;
+        for(qint32 j = 0; j < m_options.validationIterations; ++j)
+        {
+            if (infos[i]->isValidValue(values[i]))
+            {
+                ++valid;
+            }
+        }
+
+        qint64 elapsedNs = timer.nsecsElapsed();
+
+        failures += m_options.validationIterations - valid;
+        result.set(
+            QString("%1_ns").arg(names[i]),
+            elapsedNs / static_cast<double>(m_options.validationIterations));
+    }
+
+    // the linear search of the allowed values that was done before the
+    // validators were precompiled, for comparison
+    QString lastValue = allowedValues.last();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint32 found = 0;
+    for(qint32 j = 0; j < m_options.validationIterations; ++j)
+    {
+        if (allowedValues.indexOf(lastValue) >= 0)
+        {
+            ++found;
+        }
+    }
+
+    result.set(
+        "linear_search_ns",
+        timer.nsecsElapsed() / static_cast<double>(m_options.validationIterations));
+
+    result.set("failures", failures + m_options.validationIterations - found);
+
+    report->add(result);
+
+    return !failures;
+}
+
+bool HBenchmarkRunner::runLazyServiceModels(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("lazy_service_models");
+    result.set("devices", m_options.lazyDeviceCount);
+
+    // A device host of its own, which hosts devices created from a single
+    // template like in the device farm benchmark.
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    QList<HUdn> udns;
+    for(qint32 i = 0; i < m_options.lazyDeviceCount; ++i)
+    {
+        HDeviceConfiguration config;
+        config.setPathToDeviceDescription(
+            QString("%1/device_0.xml").arg(m_descriptionsDir));
+        config.setUdn(newUdn());
+        config.setFriendlyName(QString("HUPnP Lazy Device %1").arg(i));
+        hostConfig.add(config);
+
+        udns.append(config.udn());
+    }
+
+    HDeviceHost host;
+    if (!host.init(hostConfig))
+    {
+        qWarning() << host.errorDescription();
+        return false;
+    }
+
+    // The lazy mode is measured first. The memory the first control point
+    // releases may be reused by the second one, which can only make the
+    // increase measured for the eager mode smaller.
+    const char* const modes[] = { "lazy", "eager" };
+
+    bool ok = true;
+    for(qint32 i = 0; i < 2 && ok; ++i)
+    {
+        QString mode = modes[i];
+
+        HControlPointConfiguration cpConfig;
+        cpConfig.setAutoDiscovery(false);
+        cpConfig.setSubscribeToEvents(false);
+        cpConfig.setInProcessDevices(false);
+        cpConfig.setLazyServiceModels(i == 0);
+        cpConfig.setNetworkAddressesToUse(
+            QList<QHostAddress>() << m_options.address);
+
+        qint64 rssBefore = residentSetSize();
+
+        HControlPoint cp(cpConfig);
+
+        bool connected = connect(
+            &cp, SIGNAL(rootDeviceOnline(Herqq::Upnp::HClientDevice*)),
+            this, SLOT(rootDeviceOnline(Herqq::Upnp::HClientDevice*)));
+        Q_ASSERT(connected); Q_UNUSED(connected)
+
+        connected = connect(
+            &cp, SIGNAL(serviceModelLoaded(Herqq::Upnp::HClientService*)),
+            this, SLOT(serviceModelLoaded(Herqq::Upnp::HClientService*)));
+        Q_ASSERT(connected);
+
+        if (!cp.init())
+        {
+            qWarning() << cp.errorDescription();
+            return false;
+        }
+
+        // rootDeviceOnline() counts only the devices listed in m_udns
+        QList<HUdn> udnsBefore = m_udns;
+        m_udns.append(udns);
+
+        qint32 onlineTarget = m_devicesOnline + udns.size();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        foreach(const HUdn& udn, udns)
+        {
+            ok = cp.scan(HDiscoveryType(udn, true)) && ok;
+        }
+
+        ok = ok && waitFor(m_devicesOnline, onlineTarget);
+        qint64 onlineNs = timer.nsecsElapsed();
+
+        m_udns = udnsBefore;
+
+        result.set(QString("%1_all_discovered").arg(mode), ok);
+        result.set(QString("%1_time_to_online_ms").arg(mode), toMs(onlineNs));
+
+        qint64 rssAfter = residentSetSize();
+        if (rssBefore >= 0 && rssAfter >= 0)
+        {
+            result.set(
+                QString("%1_rss_increase_kib").arg(mode), rssAfter - rssBefore);
+        }
+
+        HClientService* service = ok ? testService(&cp, udns.first()) : 0;
+        if (!service)
+        {
+            ok = false;
+            break;
+        }
+
+        // In the lazy mode the model is requested and the service
+        // description retrieved and parsed before the first access.
+        timer.restart();
+        if (!service->isModelLoaded())
+        {
+            qint32 loadedTarget = m_modelsLoaded + 1;
+            ok = cp.prefetchServiceModel(service) &&
+                 waitFor(m_modelsLoaded, loadedTarget);
+        }
+        ok = ok && !service->actions().isEmpty();
+        result.set(
+            QString("%1_first_access_ms").arg(mode), toMs(timer.nsecsElapsed()));
+    }
+
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runLogging(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("logging");
+
+    const qint32 messagesPerThread = m_options.iterations * 100;
+    result.set("threads", m_options.concurrency);
+    result.set("messages_per_thread", messagesPerThread);
+
+    HLogLevel level = Herqq::HLogger::traceLevel();
+    SetLoggingLevel(Warning);
+
+    HCountingLogSink sink;
+    SetLogSink(&sink);
+
+    const char* const modes[] = { "dispatched", "rate_limited" };
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        QString mode = modes[i];
+
+        QList<HLogProducer*> producers;
+        for(qint32 j = 0; j < m_options.concurrency; ++j)
+        {
+            producers.append(new HLogProducer(messagesPerThread, i == 1));
+        }
+
+        foreach(HLogProducer* producer, producers)
+        {
+            producer->start();
+        }
+
+        qint64 producerNs = 0;
+        foreach(HLogProducer* producer, producers)
+        {
+            producer->wait();
+            producerNs += producer->m_elapsedNs;
+        }
+
+        qDeleteAll(producers);
+
+        // the time the writer needs to catch up with the producers
+        QElapsedTimer timer;
+        timer.start();
+        Herqq::HLogger::flush();
+
+        result.set(
+            QString("%1_flush_ms").arg(mode), toMs(timer.nsecsElapsed()));
+
+        result.set(
+            QString("%1_ns_per_message").arg(mode),
+            producerNs / static_cast<double>(
+                messagesPerThread * m_options.concurrency));
+    }
+
+    result.set("records_written", static_cast<qint32>(sink.m_records));
+
+    // The round-trip of an action invocation at the default level and with
+    // the debug output of both ends enabled.
+    bool ok = !m_actions.isEmpty();
+    const HLogLevel levels[] = { Warning, Debug };
+    const char* const levelNames[] = { "warning", "debug" };
+    for(qint32 i = 0; i < 2 && ok; ++i)
+    {
+        SetLoggingLevel(levels[i]);
+
+        m_issued = m_invocationsCompleted = m_invocationsFailed = m_toIssue = 0;
+
+        QList<double> samples;
+        HClientAction* action = m_actions.first();
+        for(qint32 j = 0; j < m_options.iterations; ++j)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            qint32 target = m_invocationsCompleted + 1;
+            action->beginInvoke(m_echoArgs);
+            if (!waitFor(m_invocationsCompleted, target))
+            {
+                ok = false;
+                break;
+            }
+
+            samples.append(toMs(timer.nsecsElapsed()));
+        }
+
+        ok = ok && !m_invocationsFailed;
+
+        result.setLatencies(
+            QString("round_trip_%1").arg(levelNames[i]), samples);
+    }
+
+    SetLoggingLevel(level);
+    Herqq::HLogger::flush();
+    SetLogSink(0);
+
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runDeviceExpiry(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("device_expiry");
+
+    // The time is compressed: a device announces itself every second
+    // instead of every few minutes and its announcements are valid for
+    // three intervals. A tenth of the devices goes silent and has to expire.
+    const qint32 embeddedCount = 3;
+    const qint32 interval = 1000;
+    const qint32 maxAge = 3 * interval;
+    const qint32 tickInterval = 50;
+    const qint32 duration = 6 * interval;
+    const qint32 silentCount = m_options.expiryDeviceCount / 10;
+
+    result.set("devices", m_options.expiryDeviceCount);
+    result.set("embedded_devices_per_root", embeddedCount);
+    result.set("silent_devices", silentCount);
+    result.set("duration_ms", duration);
+    result.set("ticks_per_second", 1000 / tickInterval);
+
+    bool ok = true;
+    const char* const modes[] = { "per_device_timers", "scheduler" };
+    for(qint32 i = 0; i < 2; ++i)
+    {
+        QString mode = modes[i];
+
+        HTimerEventCounter counter;
+        QScopedPointer<HAnnouncementSimulator> simulator(i == 0 ?
+            static_cast<HAnnouncementSimulator*>(new HPerDeviceTimers(
+                m_options.expiryDeviceCount, embeddedCount, silentCount,
+                interval, maxAge, &counter)) :
+            new HSchedulerTracking(
+                m_options.expiryDeviceCount, silentCount, interval, maxAge,
+                &counter));
+
+        qint64 cpuBefore = 0, switchesBefore = 0;
+        bool usageAvailable = processUsage(&cpuBefore, &switchesBefore);
+
+        simulator->run(tickInterval, duration);
+
+        qint64 cpuAfter = 0, switchesAfter = 0;
+        usageAvailable =
+            usageAvailable && processUsage(&cpuAfter, &switchesAfter);
+
+        double seconds = duration / 1000.0;
+
+        // the timer events spent on the expiration of devices, excluding
+        // the ticks of the simulated network
+        result.set(
+            QString("%1_expiry_wakeups_per_second").arg(mode),
+            counter.m_events / seconds);
+
+        if (usageAvailable)
+        {
+            result.set(
+                QString("%1_process_wakeups_per_second").arg(mode),
+                (switchesAfter - switchesBefore) / seconds);
+
+            result.set(
+                QString("%1_cpu_ms_per_second").arg(mode),
+                (cpuAfter - cpuBefore) / 1000.0 / seconds);
+        }
+
+        qint32 expired = simulator->expiredCount();
+        result.set(QString("%1_expired").arg(mode), expired);
+
+        ok = ok && expired == silentCount;
+    }
+
+    report->add(result);
+
+    return ok;
+}
+
+bool HBenchmarkRunner::runSubscriptionBurst(HBenchmarkReport* report)
+{
+    HBenchmarkResult result("subscription_burst");
+    result.set("subscriptions", m_options.burstSize);
+
+    HClientDevice* device = m_controlPoint->device(m_udns.first());
+    HClientService* service = testService(m_controlPoint, m_udns.first());
+    if (!device || !service || device->locations().isEmpty())
+    {
+        return false;
+    }
+
+    QUrl eventUrl =
+        device->locations().first().resolved(service->info().eventSubUrl());
+
+    HNotifySink sink(m_options.address, m_options.timeout);
+    sink.start();
+
+    quint16 sinkPort = sink.waitUntilListening();
+    if (!sinkPort)
+    {
+        sink.wait();
+        return false;
+    }
+
+    QByteArray path = eventUrl.encodedPath();
+    QByteArray host = QString("%1:%2").arg(
+        eventUrl.host(), QString::number(eventUrl.port())).toLatin1();
+
+    QByteArray callback = QString("http://%1:%2/burst/").arg(
+        m_options.address.toString(), QString::number(sinkPort)).toLatin1();
+
+    QList<QByteArray> subscribes;
+    for(qint32 i = 0; i < m_options.burstSize; ++i)
+    {
+        subscribes.append(
+            "SUBSCRIBE " + path + " HTTP/1.1\r\n"
+            "HOST: " + host + "\r\n"
+            "CALLBACK: <" + callback + QByteArray::number(i) + ">\r\n"
+            "NT: upnp:event\r\n"
+            "TIMEOUT: Second-300\r\n\r\n");
+    }
+
+    HRequestBurst burst(
+        QHostAddress(eventUrl.host()), eventUrl.port(), subscribes,
+        m_options.timeout);
+
+    // The round-trips of an action that has nothing to do with the
+    // subscriptions, first while the device host is otherwise idle and then
+    // for as long as the burst is being handled.
+    HClientAction* action = m_actions.first();
+    m_invocationsCompleted = m_invocationsFailed = 0;
+
+    QList<double> samples[2];
+    bool ok = true;
+    for(qint32 i = 0; i < 2 && ok; ++i)
+    {
+        if (i == 1)
+        {
+            burst.start();
+        }
+
+        for(qint32 j = 0;
+            ok && (i == 0 ? j < m_options.iterations : burst.isRunning()); ++j)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            qint32 target = m_invocationsCompleted + 1;
+            action->beginInvoke(m_echoArgs);
+            ok = waitFor(m_invocationsCompleted, target);
+
+            samples[i].append(toMs(timer.nsecsElapsed()));
+        }
+    }
+
+    burst.waitWithEvents();
+
+    result.setLatencies("idle", samples[0]);
+    result.setLatencies("during_burst", samples[1]);
+    result.set("during_burst_samples", samples[1].size());
+    result.set("burst_ms", toMs(burst.m_elapsedNs));
+    result.set("subscribe_failures", burst.m_failures);
+
+    // The initial event messages of the subscriptions.
+    QElapsedTimer timer;
+    timer.start();
+    while(sink.m_notifications < m_options.burstSize &&
+          timer.elapsed() < m_options.timeout)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    }
+
+    result.set("initial_notifications", static_cast<qint32>(sink.m_notifications));
+
+    // The subscriptions are cancelled so that the device host does not send
+    // events to the sink once it is gone.
+    QList<QByteArray> unsubscribes;
+    foreach(const QByteArray& header, burst.m_responses)
+    {
+        QByteArray sid = headerValue(header, "SID");
+        if (!sid.isEmpty())
+        {
+            unsubscribes.append(
+                "UNSUBSCRIBE " + path + " HTTP/1.1\r\n"
+                "HOST: " + host + "\r\n"
+                "SID: " + sid + "\r\n\r\n");
+        }
+    }
+
+    HRequestBurst cancel(
+        QHostAddress(eventUrl.host()), eventUrl.port(), unsubscribes,
+        m_options.timeout);
+
+    cancel.start();
+    cancel.waitWithEvents();
+
+    sink.m_stopped = 1;
+    while(!sink.wait(20))
+    {
+        QCoreApplication::processEvents();
+    }
+
+    report->add(result);
+
+    return ok && !m_invocationsFailed && !burst.m_failures;
+}
+
+bool HBenchmarkRunner::run(HBenchmarkReport* report, QString* errDescr)
+{
+    Q_ASSERT(report);
+    Q_ASSERT(errDescr);
+
+    report->setParameter("devices", m_options.deviceCount);
+    report->setParameter("subscribers", m_options.subscriberCount);
+    report->setParameter("iterations", m_options.iterations);
+    report->setParameter("concurrency", m_options.concurrency);
+    report->setParameter("address", m_options.address.toString());
+    report->setParameter("farm_size", m_options.farmSize);
+    report->setParameter("parse_iterations", m_options.parseIterations);
+    report->setParameter("validation_iterations", m_options.validationIterations);
+    report->setParameter("lazy_devices", m_options.lazyDeviceCount);
+    report->setParameter("expiry_devices", m_options.expiryDeviceCount);
+    report->setParameter("subscription_burst", m_options.burstSize);
+
+    // The device expiry benchmark needs no devices. It is run first so that
+    // the threads of the device host and the control points do not add to
+    // the wake-ups it measures.
+    QStringList failed;
+    if (m_options.expiryDeviceCount > 0 && !runDeviceExpiry(report))
+    {
+        failed.append("device_expiry");
+    }
+
+    if (!createDescriptions(errDescr))
+    {
+        return false;
+    }
+
+    HDeviceHostConfiguration hostConfig;
+    hostConfig.setDeviceModelCreator(HBenchmarkModelCreator());
+    hostConfig.setNetworkAddressesToUse(
+        QList<QHostAddress>() << m_options.address);
+
+    for(qint32 i = 0; i < m_options.deviceCount; ++i)
+    {
+        HDeviceConfiguration config;
+        config.setPathToDeviceDescription(
+            QString("%1/device_%2.xml").arg(
+                m_descriptionsDir, QString::number(i)));
+
+        hostConfig.add(config);
+    }
+
+    m_deviceHost = new HDeviceHost(this);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!m_deviceHost->init(hostConfig))
+    {
+        *errDescr = m_deviceHost->errorDescription();
+        return false;
+    }
+
+    HBenchmarkResult startup("device_host_startup");
+    startup.set("devices", m_options.deviceCount);
+    startup.set("init_ms", toMs(timer.nsecsElapsed()));
+    report->add(startup);
+
+    if (!runDiscovery(report))
+    {
+        // the rest of the benchmarks need the devices
+        *errDescr = "Discovery failed";
+        return false;
+    }
+
+    if (!runActionLatency(report))
+    {
+        failed.append("action_latency");
+    }
+    else
+    {
+        if (!runActionArguments(report))
+        {
+            failed.append("action_arguments");
+        }
+
+        if (!runGeneratedStubs(report))
+        {
+            failed.append("generated_stubs");
+        }
+
+        if (!runActionThroughput(report))
+        {
+            failed.append("action_throughput");
+        }
+    }
+
+    if (!runEventFanOut(report))
+    {
+        failed.append("event_fanout");
+    }
+
+    if (!runMulticastFanOut(report))
+    {
+        failed.append("multicast_fanout");
+    }
+
+    if (!m_actions.isEmpty() && !runActionCache(report))
+    {
+        failed.append("action_cache");
+    }
+
+    if (!m_actions.isEmpty() && !runInProcessInvoke(report))
+    {
+        failed.append("in_process_invoke");
+    }
+
+    if (!runLocalTransport(report))
+    {
+        failed.append("local_transport");
+    }
+
+    if (!runSnapshotReads(report))
+    {
+        failed.append("snapshot_reads");
+    }
+
+    if (!runStatePublication(report))
+    {
+        failed.append("state_publication");
+    }
+
+    if (!runBatchedUpdate(report))
+    {
+        failed.append("batched_update");
+    }
+
+    if (!runSearchResponse(report))
+    {
+        failed.append("msearch_response");
+    }
+
+    if (!runDescriptionServing(report))
+    {
+        failed.append("description_serving");
+    }
+
+    if (m_options.farmSize > 0 && !runDeviceFarm(report))
+    {
+        failed.append("device_farm");
+    }
+
+    if (m_options.parseIterations > 0 && !runDescriptionParsing(report))
+    {
+        failed.append("description_parsing");
+    }
+
+    if (m_options.parseIterations > 0 && !runNotifyParsing(report))
+    {
+        failed.append("notify_parsing");
+    }
+
+    if (m_options.validationIterations > 0 && !runValueValidation(report))
+    {
+        failed.append("value_validation");
+    }
+
+    if (m_options.lazyDeviceCount > 0 && !runLazyServiceModels(report))
+    {
+        failed.append("lazy_service_models");
+    }
+
+    if (!runLogging(report))
+    {
+        failed.append("logging");
+    }
+
+    // The subscriptions of the burst are cancelled afterwards, but the
+    // benchmark is run last so that it cannot affect the others.
+    if (m_options.burstSize > 0 && !m_actions.isEmpty() &&
+        !runSubscriptionBurst(report))
+    {
+        failed.append("subscription_burst");
+    }
+
+    HMetrics hostMetrics = m_deviceHost->metrics();
+    foreach(const QString& name, hostMetrics.counterNames())
+    {
+        report->setMetric(name, hostMetrics.counter(name));
+    }
+
+    if (!failed.isEmpty())
+    {
+        *errDescr = QString("Failed benchmarks: %1").arg(failed.join(", "));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <HUpnpCore/HUpnp>
+#include <HUpnpCore/HActionArguments>
+
+#include <QtCore/QList>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtNetwork/QHostAddress>
+
+class QNetworkReply;
+class QNetworkAccessManager;
+
+class HBenchmarkReport;
+
+//
+// The parameters of a benchmark run.
+//
+struct HBenchmarkOptions
+{
+    qint32 deviceCount;
+    // the number of root devices hosted by the device host
+
+    qint32 subscriberCount;
+    // the number of control points subscribing to the events of a single
+    // service in the event fan-out benchmark
+
+    qint32 iterations;
+    // the number of samples taken in each latency and throughput benchmark
+
+    qint32 concurrency;
+    // the number of requests kept in flight in the throughput benchmarks
+
+    qint32 timeout;
+    // the maximum time in milliseconds a single benchmark step may take
+
+    QHostAddress address;
+    // the address to which both the device host and the control points bind
+
+    qint32 farmSize;
+    // the number of devices created from a single template in the device
+    // farm benchmark, which is skipped if this is zero
+
+    qint32 parseIterations;
+    // the number of times the AV device and service descriptions and the
+    // LastChange events are parsed in the description parsing and the notify
+    // parsing benchmarks, which are skipped if this is zero
+
+    qint32 validationIterations;
+    // the number of times each value is validated in the value validation
+    // benchmark, which is skipped if this is zero
+
+    qint32 lazyDeviceCount;
+    // the number of devices discovered with and without lazily built service
+    // models in the lazy service models benchmark, which is skipped if this
+    // is zero
+
+    qint32 expiryDeviceCount;
+    // the number of root devices in the simulated network of the device
+    // expiry benchmark, which is skipped if this is zero
+
+    qint32 burstSize;
+    // the number of concurrent SUBSCRIBE requests sent to the device host in
+    // the subscription burst benchmark, which is skipped if this is zero
+
+    HBenchmarkOptions();
+};
+
+//
+// Runs the benchmarks against a HDeviceHost and one or more HControlPoint
+// instances, all of which live in this process and communicate over the
+// loopback interface. Each benchmark stores its results into the
+// specified HBenchmarkReport.
+//
+class HBenchmarkRunner :
+    public QObject
+{
+Q_OBJECT
+Q_DISABLE_COPY(HBenchmarkRunner)
+
+private:
+
+    HBenchmarkOptions m_options;
+    QString m_descriptionsDir;
+    QList<Herqq::Upnp::HUdn> m_udns;
+
+    Herqq::Upnp::HDeviceHost* m_deviceHost;
+    Herqq::Upnp::HControlPoint* m_controlPoint;
+    QNetworkAccessManager* m_nam;
+
+    QList<Herqq::Upnp::HClientAction*> m_actions;
+    Herqq::Upnp::HActionArguments m_echoArgs;
+    QUrl m_descriptionUrl;
+
+    QTimer m_wakeUpTimer;
+
+    // these are incremented by the slots below and polled by waitFor()
+    qint32 m_devicesOnline;
+    qint32 m_subscriptions;
+    qint32 m_invocationsCompleted;
+    qint32 m_invocationsFailed;
+    qint32 m_eventsReceived;
+    qint32 m_searchResponses;
+    qint32 m_repliesCompleted;
+    qint32 m_repliesFailed;
+    qint64 m_bytesReceived;
+
+    // the windowed request issuing of the throughput benchmarks
+    qint32 m_issued;
+    qint32 m_toIssue;
+
+    QVariant m_expectedEventValue;
+    qint64 m_lastSearchResponseNs;
+
+    // the stateChanged() signals of a server-side service, counted by
+    // serviceStateChanged()
+    qint32 m_stateChanges;
+
+    // the lazily built service models, counted by serviceModelLoaded()
+    qint32 m_modelsLoaded;
+
+    bool createDescriptions(QString* errDescr);
+    bool waitFor(const qint32& counter, qint32 target, qint32 timeout = -1);
+
+    void invokeNext();
+    void fetchNext();
+
+    bool runDiscovery(HBenchmarkReport*);
+    bool runActionLatency(HBenchmarkReport*);
+    bool runActionThroughput(HBenchmarkReport*);
+    bool runActionArguments(HBenchmarkReport*);
+    bool runGeneratedStubs(HBenchmarkReport*);
+    bool runEventFanOut(HBenchmarkReport*);
+    bool runMulticastFanOut(HBenchmarkReport*);
+    bool runActionCache(HBenchmarkReport*);
+    bool runInProcessInvoke(HBenchmarkReport*);
+    bool runLocalTransport(HBenchmarkReport*);
+    bool runSnapshotReads(HBenchmarkReport*);
+    bool runStatePublication(HBenchmarkReport*);
+    bool runBatchedUpdate(HBenchmarkReport*);
+    bool runSearchResponse(HBenchmarkReport*);
+    bool runDescriptionServing(HBenchmarkReport*);
+    bool runDeviceFarm(HBenchmarkReport*);
+    bool runDescriptionParsing(HBenchmarkReport*);
+    bool runNotifyParsing(HBenchmarkReport*);
+    bool runValueValidation(HBenchmarkReport*);
+    bool runLazyServiceModels(HBenchmarkReport*);
+    bool runLogging(HBenchmarkReport*);
+    bool runDeviceExpiry(HBenchmarkReport*);
+    bool runSubscriptionBurst(HBenchmarkReport*);
+
+private Q_SLOTS:
+
+    void rootDeviceOnline(Herqq::Upnp::HClientDevice*);
+    void subscriptionSucceeded(Herqq::Upnp::HClientService*);
+
+    void invokeComplete(
+        Herqq::Upnp::HClientAction*, const Herqq::Upnp::HClientActionOp&);
+
+    void valueChanged(
+        const Herqq::Upnp::HClientStateVariable*,
+        const Herqq::Upnp::HStateVariableEvent&);
+
+    void serviceStateChanged(const Herqq::Upnp::HServerService*);
+    void serviceModelLoaded(Herqq::Upnp::HClientService*);
+
+    void discoveryResponseReceived(
+        const Herqq::Upnp::HDiscoveryResponse&, const Herqq::Upnp::HEndpoint&);
+
+    void replyFinished(QNetworkReply*);
+
+public:
+
+    explicit HBenchmarkRunner(
+        const HBenchmarkOptions& options, QObject* parent = 0);
+
+    virtual ~HBenchmarkRunner();
+
+    //
+    // Runs every benchmark and returns false if any of them failed.
+    // The results of the benchmarks that succeeded are stored into the report
+    // in any case.
+    //
+    bool run(HBenchmarkReport* report, QString* errDescr);
+};
+
+#endif // BENCHMARK_RUNNER_H
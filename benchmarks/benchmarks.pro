@@ -0,0 +1,109 @@
+TEMPLATE = app
+TARGET   = HUpnpBenchmarks
+QT      += network xml
+QT      -= gui
+CONFIG  += console warn_on
+
+INCLUDEPATH += ../hupnp/include \
+               ../hupnp/lib/qtsoap-2.7-opensource/src
+
+LIBS += -L"../hupnp/bin" -lHUpnp \
+        -L"../hupnp/lib/qtsoap-2.7-opensource/lib"
+
+win32 {
+    debug {
+        LIBS += -lQtSolutions_SOAP-2.7d
+    }
+    else {
+        LIBS += -lQtSolutions_SOAP-2.7
+    }
+
+    LIBS += -lws2_32
+
+    DESCRIPTIONS = $$PWD\\descriptions
+    DESCRIPTIONS = $${replace(DESCRIPTIONS, /, \\)}
+    QMAKE_POST_LINK += xcopy $$DESCRIPTIONS bin\\descriptions /E /Y /C /I $$escape_expand(\\n\\t)
+
+    AV_DESCRIPTIONS = $$PWD\\..\\apps\\simple_avtest-app\\descriptions
+    AV_DESCRIPTIONS = $${replace(AV_DESCRIPTIONS, /, \\)}
+    QMAKE_POST_LINK += xcopy $$AV_DESCRIPTIONS bin\\av_descriptions /E /Y /C /I $$escape_expand(\\n\\t)
+    QMAKE_POST_LINK += copy ..\\hupnp\\bin\\* bin /Y
+}
+else {
+    LIBS += -lQtSolutions_SOAP-2.7
+    !macx:QMAKE_LFLAGS += -Wl,--rpath=\\\$\$ORIGIN
+
+    QMAKE_POST_LINK += cp -Rf $$PWD/descriptions bin &
+    QMAKE_POST_LINK += mkdir -p bin/av_descriptions && \
+                       cp -f $$PWD/../apps/simple_avtest-app/descriptions/*.xml bin/av_descriptions &
+    QMAKE_POST_LINK += cp -Rf ../hupnp/bin/* bin
+}
+
+macx {
+  CONFIG -= app_bundle
+}
+
+OBJECTS_DIR = obj
+MOC_DIR = obj
+
+DESTDIR = ./bin
+
+# The typed stubs of the test service are generated from its description
+# with hupnp_scpdgen, which is built before the benchmarks.
+SCPDGEN = ../tools/hupnp_scpdgen/bin/hupnp_scpdgen
+SCPDGEN_INPUTS = descriptions/hupnp_testservice_scpd.xml
+
+scpdgen_h.input = SCPDGEN_INPUTS
+scpdgen_h.output = $$OUT_PWD/hbenchmark_testservice.h
+scpdgen_h.commands = $$SCPDGEN -n HBenchmarkTestService --header ${QMAKE_FILE_OUT} ${QMAKE_FILE_IN}
+scpdgen_h.CONFIG += no_link target_predeps
+scpdgen_h.variable_out = HEADERS
+QMAKE_EXTRA_COMPILERS += scpdgen_h
+
+scpdgen_cpp.input = SCPDGEN_INPUTS
+scpdgen_cpp.output = $$OUT_PWD/hbenchmark_testservice.cpp
+scpdgen_cpp.commands = $$SCPDGEN -n HBenchmarkTestService --header hbenchmark_testservice.h --source ${QMAKE_FILE_OUT} ${QMAKE_FILE_IN}
+scpdgen_cpp.depends = $$OUT_PWD/hbenchmark_testservice.h
+scpdgen_cpp.variable_out = SOURCES
+QMAKE_EXTRA_COMPILERS += scpdgen_cpp
+
+INCLUDEPATH += $$OUT_PWD
+
+# The description parser, the event messages and the deadline scheduler are
+# measured directly. The library does not export these private classes,
+# which is why they are compiled in.
+HUPNP_SRC = ../hupnp/src
+
+INCLUDEPATH += \
+    $$HUPNP_SRC/devicehosting \
+    $$HUPNP_SRC/devicehosting/messages \
+    $$HUPNP_SRC/utils
+
+HEADERS += \
+    $$HUPNP_SRC/devicehosting/hddoc_parser_p.h \
+    $$HUPNP_SRC/devicehosting/messages/hevent_messages_p.h \
+    $$HUPNP_SRC/devicehosting/messages/hnt_p.h \
+    $$HUPNP_SRC/devicehosting/messages/hsid_p.h \
+    $$HUPNP_SRC/devicehosting/messages/htimeout_p.h \
+    $$HUPNP_SRC/utils/hdeadline_scheduler_p.h
+
+SOURCES += \
+    $$HUPNP_SRC/devicehosting/hddoc_parser_p.cpp \
+    $$HUPNP_SRC/devicehosting/messages/hevent_messages_p.cpp \
+    $$HUPNP_SRC/devicehosting/messages/hnt_p.cpp \
+    $$HUPNP_SRC/devicehosting/messages/hsid_p.cpp \
+    $$HUPNP_SRC/devicehosting/messages/htimeout_p.cpp \
+    $$HUPNP_SRC/utils/hdeadline_scheduler_p.cpp
+
+HEADERS += \
+    allocation_counter.h \
+    benchmark_device.h \
+    benchmark_runner.h \
+    benchmark_report.h
+
+SOURCES += \
+    main.cpp \
+    allocation_counter.cpp \
+    benchmark_device.cpp \
+    benchmark_runner.cpp \
+    benchmark_report.cpp
@@ -0,0 +1,209 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpBenchmarks
+ *  used for measuring the performance of the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpBenchmarks is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpBenchmarks is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpBenchmarks. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark_runner.h"
+#include "benchmark_report.h"
+
+#include <HUpnpCore/HUpnp>
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QCoreApplication>
+
+using namespace Herqq::Upnp;
+
+namespace
+{
+void printUsage(QTextStream& out)
+{
+    out << "Usage: HUpnpBenchmarks [options]\n"
+           "  --devices N       the number of hosted root devices (default 10)\n"
+           "  --subscribers N   the number of event subscribers (default 10)\n"
+           "  --iterations N    the number of samples per benchmark (default 1000)\n"
+           "  --concurrency N   the requests in flight in throughput runs (default 8)\n"
+           "  --timeout MS      the time limit of a single step (default 15000)\n"
+           "  --address ADDR    the address to bind to (default 127.0.0.1)\n"
+           "  --farm N          the number of template devices to host (default 0)\n"
+           "  --parse N         the times the AV descriptions and events are parsed (default 10000)\n"
+           "  --validate N      the times each value is validated (default 1000000)\n"
+           "  --lazy N          the devices discovered with lazy service models (default 200)\n"
+           "  --expiry N        the devices of the simulated expiry network (default 300)\n"
+           "  --burst N         the concurrent SUBSCRIBE requests of a burst (default 500)\n"
+           "  --log-level N     the HUPnP logging level, 0-6 (default 3)\n"
+           "  --output FILE     the file to write the JSON report to (default stdout)\n";
+    out.flush();
+}
+
+bool parseArgs(
+    const QStringList& args, HBenchmarkOptions* options, qint32* logLevel,
+    QString* outputPath)
+{
+    for(qint32 i = 1; i < args.size(); ++i)
+    {
+        QString arg = args.at(i);
+        if (i + 1 >= args.size())
+        {
+            return false;
+        }
+
+        QString value = args.at(++i);
+
+        bool ok = true;
+        if (arg == "--devices")
+        {
+            options->deviceCount = value.toInt(&ok);
+            ok = ok && options->deviceCount > 0;
+        }
+        else if (arg == "--subscribers")
+        {
+            options->subscriberCount = value.toInt(&ok);
+            ok = ok && options->subscriberCount > 0;
+        }
+        else if (arg == "--iterations")
+        {
+            options->iterations = value.toInt(&ok);
+            ok = ok && options->iterations > 0;
+        }
+        else if (arg == "--concurrency")
+        {
+            options->concurrency = value.toInt(&ok);
+            ok = ok && options->concurrency > 0;
+        }
+        else if (arg == "--timeout")
+        {
+            options->timeout = value.toInt(&ok);
+            ok = ok && options->timeout > 0;
+        }
+        else if (arg == "--address")
+        {
+            ok = options->address.setAddress(value);
+        }
+        else if (arg == "--farm")
+        {
+            options->farmSize = value.toInt(&ok);
+            ok = ok && options->farmSize >= 0;
+        }
+        else if (arg == "--parse")
+        {
+            options->parseIterations = value.toInt(&ok);
+            ok = ok && options->parseIterations >= 0;
+        }
+        else if (arg == "--validate")
+        {
+            options->validationIterations = value.toInt(&ok);
+            ok = ok && options->validationIterations >= 0;
+        }
+        else if (arg == "--lazy")
+        {
+            options->lazyDeviceCount = value.toInt(&ok);
+            ok = ok && options->lazyDeviceCount >= 0;
+        }
+        else if (arg == "--expiry")
+        {
+            options->expiryDeviceCount = value.toInt(&ok);
+            ok = ok && options->expiryDeviceCount >= 0;
+        }
+        else if (arg == "--burst")
+        {
+            options->burstSize = value.toInt(&ok);
+            ok = ok && options->burstSize >= 0;
+        }
+        else if (arg == "--log-level")
+        {
+            *logLevel = value.toInt(&ok);
+            ok = ok && *logLevel >= None && *logLevel <= All;
+        }
+        else if (arg == "--output")
+        {
+            *outputPath = value;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QTextStream err(stderr);
+
+    HBenchmarkOptions options;
+    qint32 logLevel = Warning;
+    QString outputPath;
+
+    if (!parseArgs(app.arguments(), &options, &logLevel, &outputPath))
+    {
+        printUsage(err);
+        return 1;
+    }
+
+    // Logging is part of the cost of every operation, which is why the level
+    // is recorded in the report and can be changed for comparison runs.
+    SetLoggingLevel(static_cast<HLogLevel>(logLevel));
+
+    HBenchmarkReport report;
+    report.setParameter("log_level", logLevel);
+
+    QString errDescr;
+    bool ok;
+    {
+        HBenchmarkRunner runner(options);
+        ok = runner.run(&report, &errDescr);
+    }
+
+    if (!ok)
+    {
+        err << errDescr << "\n";
+        err.flush();
+    }
+
+    QByteArray json = report.toJson();
+    if (outputPath.isEmpty())
+    {
+        QTextStream out(stdout);
+        out << json;
+    }
+    else
+    {
+        QFile file(outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(json) != json.size())
+        {
+            err << "Could not write [" << outputPath << "]\n";
+            return 1;
+        }
+    }
+
+    return ok ? 0 : 2;
+}
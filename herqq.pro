@@ -22,6 +22,10 @@ exists(hupnp_av/options.pri) {
 CONFIG(DISABLE_QTSOAP) {
     system(echo "CONFIG += DISABLE_QTSOAP" > hupnp/options.pri)
 }
+CONFIG(DISABLE_TRACING) {
+    system(echo "CONFIG += DISABLE_TRACING" >> hupnp/options.pri)
+    system(echo "CONFIG += DISABLE_TRACING" >> hupnp_av/options.pri)
+}
 CONFIG(USE_QT_INSTALL_LOC) {
     system(echo "CONFIG += USE_QT_INSTALL_LOC" >> hupnp/options.pri)
 	system(echo "CONFIG += USE_QT_INSTALL_LOC" >> hupnp_av/options.pri)
@@ -31,3 +35,6 @@ CONFIG(USE_QT_INSTALL_LOC) {
 !CONFIG(DISABLE_AV) : SUBDIRS += hupnp_av
 !CONFIG(DISABLE_TESTAPP) : SUBDIRS += apps/simple_test-app
 !CONFIG(DISABLE_AVTESTAPP) : SUBDIRS += apps/simple_avtest-app
+!CONFIG(DISABLE_TOOLS) : SUBDIRS += tools/hupnp_scpdgen
+# the typed stubs of the benchmarks are generated with hupnp_scpdgen
+!CONFIG(DISABLE_TOOLS) : !CONFIG(DISABLE_BENCHMARKS) : SUBDIRS += benchmarks
@@ -0,0 +1 @@
+#include "../../../src/devicemodel/hactioncodec.h"
@@ -0,0 +1 @@
+#include "../../../src/devicehosting/controlpoint/hdevicemodel_snapshot.h"
@@ -0,0 +1 @@
+#include "../../../src/general/hlogsink.h"
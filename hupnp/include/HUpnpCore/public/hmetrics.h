@@ -0,0 +1 @@
+#include "../../../src/general/hmetrics.h"
@@ -0,0 +1 @@
+#include "../../../src/devicemodel/server/hserverstatetransaction.h"
@@ -23,6 +23,7 @@ LIBS += -L"./bin/"
 !CONFIG(DISABLE_QTSOAP): LIBS += -L"./lib/qtsoap-2.7-opensource/lib"
 
 debug:DEFINES += DEBUG
+CONFIG(DISABLE_TRACING) : DEFINES += H_DISABLE_TRACING
 
 win32 {
     debug {
@@ -22,6 +22,8 @@
 #include "hactioninfo.h"
 #include "hactioninfo_p.h"
 
+#include "../devicemodel/hactionarguments_p.h"
+
 #include "../general/hupnp_global_p.h"
 #include "../utils/hmisc_utils_p.h"
 
@@ -87,6 +89,12 @@ HActionInfo::HActionInfo(
     h_ptr->m_inputArguments = inputArguments;
     h_ptr->m_outputArguments = outputArguments;
 
+    // the argument objects of a shared action description are created here
+    // so that iterating the const arguments from several threads never
+    // modifies them
+    HActionArgumentsPrivate::get(h_ptr->m_inputArguments)->createArguments();
+    HActionArgumentsPrivate::get(h_ptr->m_outputArguments)->createArguments();
+
     h_ptr->m_hasRetValArg = hasRetVal;
     h_ptr->m_inclusionRequirement = ireq;
 }
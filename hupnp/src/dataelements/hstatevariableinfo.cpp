@@ -33,6 +33,44 @@ namespace Herqq
 namespace Upnp
 {
 
+/*******************************************************************************
+ * HValueValidator
+ ******************************************************************************/
+HValueValidator::HValueValidator() :
+    m_type(Unconstrained),
+    m_allowedValues(),
+    m_integerMinimum(0), m_integerMaximum(0), m_integerStep(0),
+    m_rationalMinimum(0), m_rationalMaximum(0)
+{
+}
+
+void HValueValidator::compile(
+    HUpnpDataTypes::DataType dataType, const QStringList& allowedValueList,
+    const HValueRange& allowedValueRange)
+{
+    m_type = Unconstrained;
+    m_allowedValues.clear();
+
+    if (dataType == HUpnpDataTypes::string && !allowedValueList.isEmpty())
+    {
+        m_type = AllowedValueList;
+        m_allowedValues = allowedValueList.toSet();
+    }
+    else if (HUpnpDataTypes::isRational(dataType) && !allowedValueRange.isNull())
+    {
+        m_type = RationalRange;
+        m_rationalMinimum = allowedValueRange.minimum().toDouble();
+        m_rationalMaximum = allowedValueRange.maximum().toDouble();
+    }
+    else if (HUpnpDataTypes::isNumeric(dataType) && !allowedValueRange.isNull())
+    {
+        m_type = IntegerRange;
+        m_integerMinimum = allowedValueRange.minimum().toLongLong();
+        m_integerMaximum = allowedValueRange.maximum().toLongLong();
+        m_integerStep = allowedValueRange.step().toLongLong();
+    }
+}
+
 /*******************************************************************************
  * HStateVariableInfoPrivate
  ******************************************************************************/
@@ -44,57 +82,16 @@ HStateVariableInfoPrivate::HStateVariableInfoPrivate() :
     m_eventingType(HStateVariableInfo::NoEvents),
     m_allowedValueList(),
     m_allowedValueRange(),
+    m_validator(),
     m_inclusionRequirement(InclusionRequirementUnknown),
     m_maxRate(-1),
     m_version(-1)
 {
 }
 
-bool HStateVariableInfoPrivate::isWithinAllowedRange(
-    const QVariant& value, QString* errDescr)
-{
-    Q_ASSERT(!m_allowedValueRange.isNull());
-    Q_ASSERT(HUpnpDataTypes::isNumeric(m_dataType));
-
-    if (HUpnpDataTypes::isRational(m_dataType))
-    {
-        qreal tmp = value.toDouble();
-        if (tmp < m_allowedValueRange.minimum().toDouble() ||
-            tmp > m_allowedValueRange.maximum().toDouble())
-        {
-            if (errDescr)
-            {
-                *errDescr = QString(
-                    "Value [%1] is not within the specified allowed values range.").arg(
-                        value.toString());
-            }
-            return false;
-        }
-    }
-    else
-    {
-        qlonglong tmp = value.toLongLong();
-        if (tmp < m_allowedValueRange.minimum().toLongLong() ||
-            tmp > m_allowedValueRange.maximum().toLongLong())
-        {
-            if (errDescr)
-            {
-                *errDescr = QString(
-                    "Value [%1] is not within the specified allowed values range.").arg(
-                        value.toString());
-            }
-            return false;
-        }
-    }
-
-    return true;
-}
-
 bool HStateVariableInfoPrivate::checkValue(
     const QVariant& value, QVariant* acceptableValue, QString* errDescr) const
 {
-    QVariant tmp(value);
-
     if (m_dataType == HUpnpDataTypes::Undefined)
     {
         if (errDescr)
@@ -106,8 +103,14 @@ bool HStateVariableInfoPrivate::checkValue(
         return false;
     }
 
+    // usually the value is of the correct type already, in which case it is
+    // checked as is
+    QVariant tmp;
+    const QVariant* checkedValue = &value;
+
     if (value.type() != m_variantDataType)
     {
+        tmp = value;
         if (m_variantDataType == QVariant::Url)
         {
             // for some reason, QVariant does not provide automatic conversion between
@@ -135,53 +138,24 @@ bool HStateVariableInfoPrivate::checkValue(
             }
             return false;
         }
-    }
 
-    if (m_dataType == HUpnpDataTypes::string && m_allowedValueList.size())
-    {
-        if (m_allowedValueList.indexOf(value.toString()) < 0)
-        {
-            if (errDescr)
-            {
-                *errDescr = QString(
-                    "Value [%1] is not included in the allowed values list.").arg(
-                        value.toString());
-            }
-            return false;
-        }
-    }
-    else if (HUpnpDataTypes::isRational(m_dataType) && !m_allowedValueRange.isNull())
-    {
-        qreal tmp = value.toDouble();
-        if (tmp < m_allowedValueRange.minimum().toDouble() ||
-            tmp > m_allowedValueRange.maximum().toDouble())
-        {
-            if (errDescr)
-            {
-                *errDescr = QString(
-                    "Value [%1] is not within the specified allowed values range.").arg(
-                        value.toString());
-            }
-            return false;
-        }
+        checkedValue = &tmp;
     }
-    else if (HUpnpDataTypes::isNumeric(m_dataType) && !m_allowedValueRange.isNull())
+
+    if (!m_validator.isValid(*checkedValue))
     {
-        qlonglong tmp = value.toLongLong();
-        if (tmp < m_allowedValueRange.minimum().toLongLong() ||
-            tmp > m_allowedValueRange.maximum().toLongLong())
+        if (errDescr)
         {
-            if (errDescr)
-            {
-                *errDescr = QString(
+            *errDescr = QString(
+                m_validator.type() == HValueValidator::AllowedValueList ?
+                    "Value [%1] is not included in the allowed values list." :
                     "Value [%1] is not within the specified allowed values range.").arg(
                         value.toString());
-            }
-            return false;
         }
+        return false;
     }
 
-    *acceptableValue = tmp;
+    *acceptableValue = *checkedValue;
     return true;
 }
 
@@ -212,6 +186,8 @@ bool HStateVariableInfoPrivate::setDataType(
     m_variantDataType = HUpnpDataTypes::convertToVariantType(m_dataType);
     m_defaultValue = QVariant(m_variantDataType);
 
+    m_validator.compile(m_dataType, m_allowedValueList, m_allowedValueRange);
+
     return true;
 }
 
@@ -250,6 +226,8 @@ bool HStateVariableInfoPrivate::setAllowedValueList(
     }
 
     m_allowedValueList = allowedValueList;
+    m_validator.compile(m_dataType, m_allowedValueList, m_allowedValueRange);
+
     if (!allowedValueList.empty() && !allowedValueList.contains(m_defaultValue.toString()))
     {
         m_defaultValue = QVariant(QVariant::String);
@@ -283,7 +261,9 @@ bool HStateVariableInfoPrivate::setAllowedValueRange(
     }
 
     m_allowedValueRange = valueRange;
-    if (!isWithinAllowedRange(m_defaultValue))
+    m_validator.compile(m_dataType, m_allowedValueList, m_allowedValueRange);
+
+    if (!m_validator.isValid(m_defaultValue))
     {
         m_defaultValue = QVariant(m_variantDataType);
     }
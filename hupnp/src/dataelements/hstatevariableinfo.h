@@ -515,6 +515,10 @@ public:
      * succeed with the value.
      *
      * \retval false otherwise.
+     *
+     * \remarks A value of an integer data type that is restricted by a value
+     * range has to differ from the minimumValue() by a multiple of the
+     * stepValue(). The step of a rational value range is not checked.
      */
     bool isValidValue(
         const QVariant& value, QVariant* convertedValue = 0, QString* err = 0) const;
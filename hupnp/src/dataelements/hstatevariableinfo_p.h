@@ -35,6 +35,7 @@
 #include "../general/hupnp_global.h"
 #include "../general/hupnp_datatypes.h"
 
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 #include <QtCore/QSharedData>
@@ -46,6 +47,101 @@ namespace Herqq
 namespace Upnp
 {
 
+//
+// The constraints of a state variable compiled into a form that is cheap
+// to check. This is recompiled whenever the data type or the constraints of
+// the state variable change.
+//
+class HValueValidator
+{
+public:
+
+    enum Type
+    {
+        Unconstrained,
+        AllowedValueList,
+        IntegerRange,
+        RationalRange
+    };
+
+private:
+
+    Type m_type;
+
+    QSet<QString> m_allowedValues;
+
+    qlonglong m_integerMinimum;
+    qlonglong m_integerMaximum;
+    qlonglong m_integerStep;
+
+    qreal m_rationalMinimum;
+    qreal m_rationalMaximum;
+    // the step of a rational range is not checked, since the values
+    // in between the steps cannot be told apart from rounding errors
+
+    // the values are read directly from the variant when it has the type
+    // HUPnP uses for the data type, which is the usual case
+    static inline qlonglong toInteger(const QVariant& value)
+    {
+        switch(value.type())
+        {
+        case QVariant::Int:
+            return *static_cast<const int*>(value.constData());
+        case QVariant::UInt:
+            return *static_cast<const uint*>(value.constData());
+        default:
+            return value.toLongLong();
+        }
+    }
+
+    static inline double toRational(const QVariant& value)
+    {
+        return value.type() == QVariant::Double ?
+            *static_cast<const double*>(value.constData()) : value.toDouble();
+    }
+
+public:
+
+    HValueValidator();
+
+    void compile(
+        HUpnpDataTypes::DataType, const QStringList& allowedValueList,
+        const HValueRange& allowedValueRange);
+
+    inline Type type() const { return m_type; }
+
+    // the value should be of the variant type of the state variable,
+    // in which case none of the checks below converts or copies it
+    inline bool isValid(const QVariant& value) const
+    {
+        switch(m_type)
+        {
+        case AllowedValueList:
+            return value.type() == QVariant::String ?
+                m_allowedValues.contains(
+                    *static_cast<const QString*>(value.constData())) :
+                m_allowedValues.contains(value.toString());
+
+        case IntegerRange:
+        {
+            qlonglong tmp = toInteger(value);
+            return !(tmp < m_integerMinimum || tmp > m_integerMaximum) &&
+                   (m_integerStep <= 1 ||
+                    (tmp - m_integerMinimum) % m_integerStep == 0);
+        }
+
+        case RationalRange:
+        {
+            double tmp = toRational(value);
+            return !(tmp < m_rationalMinimum || tmp > m_rationalMaximum);
+        }
+
+        default:
+            return true;
+        }
+    }
+};
+
 //
 // Implementation details of HStateVariableInfo
 //
@@ -62,6 +158,7 @@ public: // attributes
     HStateVariableInfo::EventingType m_eventingType;
     QStringList              m_allowedValueList;
     HValueRange              m_allowedValueRange;
+    HValueValidator          m_validator;
 
     HInclusionRequirement m_inclusionRequirement;
     qint32 m_maxRate;
@@ -71,8 +168,6 @@ public: // methods
 
     HStateVariableInfoPrivate();
 
-    bool isWithinAllowedRange(const QVariant&, QString* errDescr=0);
-
     bool checkValue(
         const QVariant&, QVariant* acceptableValue, QString* errDescr = 0) const;
 
@@ -39,8 +39,6 @@
 
 #include "../../general/hlogger_p.h"
 
-#include <QtXml/QDomElement>
-
 namespace Herqq
 {
 
@@ -51,7 +49,8 @@ namespace Upnp
  * HClientModelCreationArgs
  ******************************************************************************/
 HClientModelCreationArgs::HClientModelCreationArgs(QNetworkAccessManager* nam) :
-    m_nam(nam)
+    m_nam(nam), m_idempotentActions(), m_actionResultTimeout(0),
+    m_lazyServiceModels(false)
 {
 }
 
@@ -62,7 +61,10 @@ HClientModelCreationArgs::~HClientModelCreationArgs()
 HClientModelCreationArgs::HClientModelCreationArgs(
     const HClientModelCreationArgs& other) :
         HModelCreationArgs(other),
-            m_nam(other.m_nam)
+            m_nam(other.m_nam),
+            m_idempotentActions(other.m_idempotentActions),
+            m_actionResultTimeout(other.m_actionResultTimeout),
+            m_lazyServiceModels(other.m_lazyServiceModels)
 {
 }
 
@@ -72,6 +74,9 @@ HClientModelCreationArgs& HClientModelCreationArgs::operator=(
     Q_ASSERT(this != &other);
     HModelCreationArgs::operator=(other);
     m_nam = other.m_nam;
+    m_idempotentActions = other.m_idempotentActions;
+    m_actionResultTimeout = other.m_actionResultTimeout;
+    m_lazyServiceModels = other.m_lazyServiceModels;
     return *this;
 }
 
@@ -89,19 +94,11 @@ HClientModelCreator::HClientModelCreator(
     Q_ASSERT(!creationParameters.m_loggingIdentifier.isEmpty());
 }
 
-bool HClientModelCreator::parseStateVariables(
-    HDefaultClientService* service, QDomElement stateVariableElement)
+void HClientModelCreator::createStateVariables(
+    HDefaultClientService* service, const QList<HStateVariableInfo>& svInfos)
 {
-    while(!stateVariableElement.isNull())
+    foreach(const HStateVariableInfo& svInfo, svInfos)
     {
-        HStateVariableInfo svInfo;
-        if (!m_docParser.parseStateVariable(stateVariableElement, &svInfo))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
-
         HDefaultClientStateVariable* sv =
             new HDefaultClientStateVariable(svInfo, service);
 
@@ -116,173 +113,134 @@ bool HClientModelCreator::parseStateVariables(
             SLOT(notifyListeners()));
 
         Q_ASSERT(ok); Q_UNUSED(ok)
-
-        Q_ASSERT(ok); Q_UNUSED(ok)
-
-        stateVariableElement =
-            stateVariableElement.nextSiblingElement("stateVariable");
     }
-
-    return true;
 }
 
-bool HClientModelCreator::parseActions(
-    HDefaultClientService* service, QDomElement actionElement,
-    const HStateVariableInfos& svInfos)
+void HClientModelCreator::createActions(
+    HDefaultClientService* service, const QList<HActionInfo>& actionInfos)
 {
-    while(!actionElement.isNull())
+    foreach(const HActionInfo& actionInfo, actionInfos)
     {
-        HActionInfo actionInfo;
-        if (!m_docParser.parseActionInfo(
-                actionElement, svInfos, &actionInfo))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
-
         HDefaultClientAction* action =
             new HDefaultClientAction(
                 actionInfo,
                 service,
                 *m_creationParameters->m_nam);
 
-        QString name = action->info().name();
+        if (m_creationParameters->m_idempotentActions.contains(actionInfo.name()))
+        {
+            action->setResultTimeout(m_creationParameters->m_actionResultTimeout);
+        }
 
         service->addAction(action);
-
-        actionElement = actionElement.nextSiblingElement("action");
     }
-
-    return true;
 }
 
-bool HClientModelCreator::parseServiceDescription(HDefaultClientService* service)
+bool HClientModelCreator::parseServiceDescription(
+    HDefaultClientService* service, const QString& description)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
     Q_ASSERT(service);
 
-    QDomDocument doc;
-    QDomElement firstSv, firstAction;
+    QList<HStateVariableInfo> svInfos;
+    QList<HActionInfo> actionInfos;
     if (!m_docParser.parseServiceDescription(
-        service->description(), &doc, &firstSv, &firstAction))
+        description, &svInfos, &actionInfos))
     {
         m_lastError = convert(m_docParser.lastError());
         m_lastErrorDescription = m_docParser.lastErrorDescription();
         return false;
     }
 
-    if (!parseStateVariables(service, firstSv))
-    {
-        return false;
-    }
+    createStateVariables(service, svInfos);
+    createActions(service, actionInfos);
+
+    return true;
+}
 
-    HStateVariableInfos svInfos;
-    HClientStateVariables svs = service->stateVariables();
-    foreach(const QString& key, svs.keys())
+bool HClientModelCreator::loadServiceModel(HDefaultClientService* service)
+{
+    HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
+    Q_ASSERT(service);
+
+    const HServiceInfo& info = service->info();
+
+    QString description;
+    if (!m_creationParameters->m_serviceDescriptionFetcher(
+            extractBaseUrl(m_creationParameters->m_deviceLocations[0]),
+            info.scpdUrl(), &description))
     {
-        svInfos.insert(key, svs.value(key)->info());
+        m_lastError = FailedToGetDataError;
+        m_lastErrorDescription = QString(
+            "Could not retrieve service description from [%1]").arg(
+                info.scpdUrl().toString());
+
+        return false;
     }
 
-    return parseActions(service, firstAction, svInfos);
+    service->setDescription(description);
+    return parseServiceDescription(service, description);
 }
 
-bool HClientModelCreator::parseServiceList(
-    const QDomElement& serviceListElement, HDefaultClientDevice* device,
+bool HClientModelCreator::createServices(
+    const QList<HServiceInfo>& serviceInfos, HDefaultClientDevice* device,
     QList<HDefaultClientService*>* retVal)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
     Q_ASSERT(device);
-    Q_ASSERT(!serviceListElement.isNull());
 
-    QDomElement serviceElement = serviceListElement.firstChildElement("service");
-    while(!serviceElement.isNull())
+    foreach(const HServiceInfo& info, serviceInfos)
     {
-        HServiceInfo info;
-        if (!m_docParser.parseServiceInfo(serviceElement, &info))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
-
         QScopedPointer<HDefaultClientService> service(
             new HDefaultClientService(info, device));
 
-        QString description;
-        if (!m_creationParameters->m_serviceDescriptionFetcher(
-                extractBaseUrl(m_creationParameters->m_deviceLocations[0]),
-                info.scpdUrl(), &description))
+        if (m_creationParameters->m_lazyServiceModels)
         {
-            m_lastError = FailedToGetDataError;
-            m_lastErrorDescription = QString(
-                "Could not retrieve service description from [%1]").arg(
-                    info.scpdUrl().toString());
-
-            return false;
+            service->setModelLoaded(false);
         }
-
-        service->setDescription(description);
-        if (!parseServiceDescription(service.data()))
+        else if (!loadServiceModel(service.data()))
         {
             return false;
         }
 
         retVal->push_back(service.take());
-
-        serviceElement = serviceElement.nextSiblingElement("service");
     }
 
     return true;
 }
 
-HDefaultClientDevice* HClientModelCreator::parseDevice(
-    const QDomElement& deviceElement, HDefaultClientDevice* parentDevice)
+HDefaultClientDevice* HClientModelCreator::createDevice(
+    const HParsedDevice& parsedDevice, HDefaultClientDevice* parentDevice)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
-    HDeviceInfo deviceInfo;
-    if (!m_docParser.parseDeviceInfo(deviceElement, &deviceInfo))
-    {
-        m_lastError = convert(m_docParser.lastError());
-        m_lastErrorDescription = m_docParser.lastErrorDescription();
-        return 0;
-    }
-
     QScopedPointer<HDefaultClientDevice> device(
         new HDefaultClientDevice(
             m_creationParameters->m_deviceDescription,
             m_creationParameters->m_deviceLocations,
-            deviceInfo,
+            parsedDevice.m_info,
             m_creationParameters->m_deviceTimeoutInSecs,
             parentDevice));
 
-    QDomElement serviceListElement =
-        deviceElement.firstChildElement("serviceList");
-
-    if (!serviceListElement.isNull())
+    if (parsedDevice.m_hasServiceList)
     {
         QList<HDefaultClientService*> services;
-        if (!parseServiceList(serviceListElement, device.data(), &services))
+        if (!createServices(parsedDevice.m_services, device.data(), &services))
         {
             return 0;
         }
         device->setServices(services);
     }
 
-    QDomElement deviceListElement = deviceElement.firstChildElement("deviceList");
-    if (!deviceListElement.isNull())
+    if (parsedDevice.m_hasDeviceList)
     {
         QList<HDefaultClientDevice*> embeddedDevices;
 
-        QDomElement embeddedDeviceElement =
-            deviceListElement.firstChildElement("device");
-
-        while(!embeddedDeviceElement.isNull())
+        foreach(const HParsedDevice& parsedEmbedded, parsedDevice.m_embeddedDevices)
         {
             HDefaultClientDevice* embeddedDevice =
-                parseDevice(embeddedDeviceElement, device.data());
+                createDevice(parsedEmbedded, device.data());
 
             if (!embeddedDevice)
             {
@@ -292,9 +250,6 @@ HDefaultClientDevice* HClientModelCreator::parseDevice(
             embeddedDevice->setParent(device.data());
 
             embeddedDevices.push_back(embeddedDevice);
-
-            embeddedDeviceElement =
-                embeddedDeviceElement.nextSiblingElement("device");
         }
 
         device->setEmbeddedDevices(embeddedDevices);
@@ -307,10 +262,10 @@ HDefaultClientDevice* HClientModelCreator::createRootDevice()
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
-    QDomDocument doc;
-    QDomElement rootElement;
-    if (!m_docParser.parseRoot(
-            m_creationParameters->m_deviceDescription, &doc, &rootElement))
+    HParsedDevice parsedDevice;
+    qint32 configId = 0;
+    if (!m_docParser.parseDeviceDescription(
+            m_creationParameters->m_deviceDescription, &parsedDevice, &configId))
     {
         m_lastError = convert(m_docParser.lastError());
         m_lastErrorDescription = m_docParser.lastErrorDescription();
@@ -318,14 +273,14 @@ HDefaultClientDevice* HClientModelCreator::createRootDevice()
     }
 
     QScopedPointer<HDefaultClientDevice> createdDevice(
-        parseDevice(rootElement, 0));
+        createDevice(parsedDevice, 0));
 
     if (!createdDevice)
     {
         return 0;
     }
 
-    createdDevice->setConfigId(m_docParser.readConfigId(rootElement));
+    createdDevice->setConfigId(configId);
 
     HDeviceValidator validator;
     if (!validator.validateRootDevice<HClientDevice, HClientService>(createdDevice.data()))
@@ -33,7 +33,7 @@
 #include "../hddoc_parser_p.h"
 #include "../hmodelcreation_p.h"
 
-#include <QtXml/QDomElement>
+#include <QtCore/QStringList>
 
 class QNetworkAccessManager;
 
@@ -55,6 +55,14 @@ public:
 
     QNetworkAccessManager* m_nam;
 
+    QStringList m_idempotentActions;
+    qint32 m_actionResultTimeout;
+    // the actions whose results are cached and for how long
+
+    bool m_lazyServiceModels;
+    // when set, the service descriptions are not retrieved while the
+    // device model is created. the control point loads them on request
+
     HClientModelCreationArgs(QNetworkAccessManager* nam);
     virtual ~HClientModelCreationArgs();
 
@@ -95,24 +103,19 @@ private:
 
 private:
 
-    QList<QPair<QUrl, QByteArray> > parseIconList(
-        const QDomElement& iconListElement);
+    void createStateVariables(
+        HDefaultClientService*, const QList<HStateVariableInfo>&);
 
-    bool parseStateVariables(
-        HDefaultClientService* service, QDomElement stateVariableElement);
+    void createActions(HDefaultClientService*, const QList<HActionInfo>&);
 
-    bool parseActions(
-        HDefaultClientService*, QDomElement actionElement,
-        const HStateVariableInfos& svInfos);
+    bool parseServiceDescription(HDefaultClientService*, const QString&);
 
-    bool parseServiceDescription(HDefaultClientService*);
-
-    bool parseServiceList(
-        const QDomElement& serviceListElement, HDefaultClientDevice*,
+    bool createServices(
+        const QList<HServiceInfo>&, HDefaultClientDevice*,
         QList<HDefaultClientService*>* retVal);
 
-    HDefaultClientDevice* parseDevice(
-        const QDomElement& deviceElement, HDefaultClientDevice* parentDevice);
+    HDefaultClientDevice* createDevice(
+        const HParsedDevice&, HDefaultClientDevice* parentDevice);
 
     inline ErrorType convert(DocumentErrorTypes type)
     {
@@ -134,6 +137,10 @@ public:
     HClientModelCreator(const HClientModelCreationArgs&);
     HDefaultClientDevice* createRootDevice();
 
+    // retrieves the service description of the specified service and
+    // creates its actions and state variables
+    bool loadServiceModel(HDefaultClientService*);
+
     inline ErrorType lastError() const { return m_lastError; }
     inline QString lastErrorDescription() const { return m_lastErrorDescription; }
 };
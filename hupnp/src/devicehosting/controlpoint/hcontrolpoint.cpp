@@ -21,29 +21,42 @@
 
 #include "hcontrolpoint.h"
 #include "hcontrolpoint_p.h"
+#include "hdevicemodel_snapshot_p.h"
 #include "hevent_subscription_p.h"
 #include "hclientmodel_creator_p.h"
+#include "hservicemodel_loader_p.h"
 #include "hcontrolpoint_configuration.h"
 #include "hcontrolpoint_configuration_p.h"
 #include "hcontrolpoint_dataretriever_p.h"
+#include "hmulticast_eventreceiver_p.h"
+#include "../hlocaldevice_registry_p.h"
 
 #include "../../general/hupnp_global_p.h"
 #include "../../general/hupnp_datatypes_p.h"
 
+#include "../../dataelements/hserviceid.h"
 #include "../../dataelements/hdeviceinfo.h"
+#include "../../dataelements/hserviceinfo.h"
 #include "../../dataelements/hdiscoverytype.h"
 #include "../../dataelements/hproduct_tokens.h"
 
+#include "../../dataelements/hstatevariableinfo.h"
+
+#include "../../devicemodel/client/hclientstatevariable.h"
 #include "../../devicemodel/client/hdefault_clientdevice_p.h"
 #include "../../devicemodel/client/hdefault_clientservice_p.h"
+#include "../../devicemodel/server/hserverdevice.h"
 
 #include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hmetrics.h"
+#include "../../general/hmetrics_p.h"
 #include "../../utils/hsysutils_p.h"
 
 #include <QtCore/QUrl>
 #include <QtCore/QString>
+#include <QtCore/QMutexLocker>
 
 #include <QtCore/QMetaType>
 
@@ -148,8 +161,38 @@ HControlPointPrivate::HControlPointPrivate() :
         m_nam(new QNetworkAccessManager(this)),
         m_state(HControlPointPrivate::Uninitialized),
         m_threadPool(new HThreadPool(this)),
-        m_deviceStorage(m_loggingIdentifier)
+        m_deviceExpirations(new HDeadlineScheduler(1000, this)),
+        m_dataRetriever(new HDataRetriever(m_loggingIdentifier, *m_nam, this)),
+        m_serviceModels(new HServiceModelLoader(this)),
+        m_subscriptionsOnLoad(),
+        m_multicastEvents(new HMulticastEventReceiver(m_loggingIdentifier, this)),
+        m_deviceStorage(m_loggingIdentifier),
+        m_snapshotMutex(),
+        m_snapshot(),
+        m_snapshotVersion(0),
+        m_snapshotPending(false)
 {
+    bool ok = connect(
+        m_deviceExpirations, SIGNAL(expired(void*)),
+        this, SLOT(deviceExpired(void*)));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        m_multicastEvents,
+        SIGNAL(notifyReceived(Herqq::Upnp::HMulticastNotifyRequest)),
+        this,
+        SLOT(multicastEventReceived(Herqq::Upnp::HMulticastNotifyRequest)));
+
+    Q_ASSERT(ok);
+
+    ok = connect(
+        m_serviceModels,
+        SIGNAL(loaded(Herqq::Upnp::HDefaultClientService*, bool)),
+        this,
+        SLOT(serviceModelLoaded(Herqq::Upnp::HDefaultClientService*, bool)));
+
+    Q_ASSERT(ok);
 }
 
 HControlPointPrivate::~HControlPointPrivate()
@@ -158,19 +201,12 @@ HControlPointPrivate::~HControlPointPrivate()
 }
 
 HDefaultClientDevice* HControlPointPrivate::buildDevice(
-    const QUrl& deviceLocation, qint32 maxAgeInSecs, QString* err)
+    const QUrl& deviceLocation, const QString& deviceDescr, qint32 maxAgeInSecs,
+    const ServiceDescriptionFetcher& serviceDescriptionFetcher,
+    const IconFetcher& iconFetcher, QString* err)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    HDataRetriever dataRetriever(m_loggingIdentifier);
-
-    QString deviceDescr;
-    if (!dataRetriever.retrieveDeviceDescription(deviceLocation, &deviceDescr))
-    {
-        *err = dataRetriever.lastError();
-        return 0;
-    }
-
     QList<QUrl> deviceLocations;
     deviceLocations.push_back(deviceLocation);
 
@@ -178,17 +214,17 @@ HDefaultClientDevice* HControlPointPrivate::buildDevice(
     creatorParams.m_deviceDescription = deviceDescr;
     creatorParams.m_deviceLocations = deviceLocations;
 
-    creatorParams.m_serviceDescriptionFetcher =
-        ServiceDescriptionFetcher(
-            &dataRetriever, &HDataRetriever::retrieveServiceDescription);
-
+    creatorParams.m_serviceDescriptionFetcher = serviceDescriptionFetcher;
     creatorParams.m_deviceTimeoutInSecs = maxAgeInSecs;
+    creatorParams.m_iconFetcher = iconFetcher;
 
-    creatorParams.m_iconFetcher =
-        IconFetcher(&dataRetriever, &HDataRetriever::retrieveIcon);
+    creatorParams.m_idempotentActions = m_configuration->idempotentActions();
+    creatorParams.m_actionResultTimeout = m_configuration->actionResultTimeout();
 
     creatorParams.m_loggingIdentifier = m_loggingIdentifier;
 
+    creatorParams.m_lazyServiceModels = m_configuration->lazyServiceModels();
+
     HClientModelCreator creator(creatorParams);
     HDefaultClientDevice* device = creator.createRootDevice();
     if (!device && err)
@@ -199,6 +235,49 @@ HDefaultClientDevice* HControlPointPrivate::buildDevice(
     return device;
 }
 
+bool HControlPointPrivate::loadServiceModel(
+    HDefaultClientService* service,
+    const ServiceDescriptionFetcher& serviceDescriptionFetcher,
+    const IconFetcher& iconFetcher, QString* err)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    Q_ASSERT(thread() == QThread::currentThread());
+
+    HDefaultClientDevice* rootDevice = service->parentDevice()->rootDevice();
+
+    HClientModelCreationArgs creatorParams(m_nam);
+    creatorParams.m_deviceDescription = rootDevice->description();
+    creatorParams.m_deviceLocations = rootDevice->locations();
+
+    creatorParams.m_serviceDescriptionFetcher = serviceDescriptionFetcher;
+    creatorParams.m_deviceTimeoutInSecs = rootDevice->deviceTimeoutInSecs();
+    creatorParams.m_iconFetcher = iconFetcher;
+
+    creatorParams.m_idempotentActions = m_configuration->idempotentActions();
+    creatorParams.m_actionResultTimeout = m_configuration->actionResultTimeout();
+
+    creatorParams.m_loggingIdentifier = m_loggingIdentifier;
+
+    HClientModelCreator creator(creatorParams);
+    if (!creator.loadServiceModel(service))
+    {
+        if (err)
+        {
+            *err = creator.lastErrorDescription();
+        }
+
+        return false;
+    }
+
+    service->setModelLoaded(true);
+
+    // the actions did not exist when the service was bound locally
+    service->setLocalService(service->localService());
+
+    return true;
+}
+
 bool HControlPointPrivate::addRootDevice(HDefaultClientDevice* newRootDevice)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
@@ -220,6 +299,7 @@ bool HControlPointPrivate::addRootDevice(HDefaultClientDevice* newRootDevice)
 
         existingDevice = static_cast<HDefaultClientDevice*>(existingDevice->rootDevice());
         existingDevice->addLocations(newRootDevice->locations());
+        // the possible change is published through locationsChanged()
         return false;
     }
 
@@ -231,13 +311,6 @@ bool HControlPointPrivate::addRootDevice(HDefaultClientDevice* newRootDevice)
     }
 
     newRootDevice->setParent(this);
-    newRootDevice->startStatusNotifier(HDefaultClientDevice::All);
-
-    bool ok = connect(
-        newRootDevice, SIGNAL(statusTimeout(HDefaultClientDevice*)),
-        this, SLOT(deviceExpired(HDefaultClientDevice*)));
-
-    Q_ASSERT(ok); Q_UNUSED(ok)
 
     if (!m_deviceStorage.addRootDevice(newRootDevice))
     {
@@ -249,28 +322,134 @@ bool HControlPointPrivate::addRootDevice(HDefaultClientDevice* newRootDevice)
         return false;
     }
 
+    m_deviceExpirations->schedule(
+        newRootDevice, newRootDevice->deviceTimeoutInSecs() * 1000);
+
+    bindLocally(newRootDevice);
+
+    trackSnapshotChanges(newRootDevice);
+    snapshotChanged();
+
     emit q_ptr->rootDeviceOnline(newRootDevice);
     return true;
 }
 
-void HControlPointPrivate::deviceExpired(HDefaultClientDevice* source)
+void HControlPointPrivate::bindLocally(HDefaultClientDevice* device)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    HServerDevice* serverDevice =
+        m_configuration->inProcessDevices() ?
+            HLocalDeviceRegistry::device(device->info().udn()) : 0;
+
+    if (serverDevice)
+    {
+        HLOG_DBG(QString("Device [%1] is hosted in this process.").arg(
+            device->info().udn().toSimpleUuid()));
+    }
+
+    foreach(HClientService* service, device->services())
+    {
+        static_cast<HDefaultClientService*>(service)->setLocalService(
+            serverDevice ?
+                serverDevice->serviceById(service->info().serviceId()) : 0);
+    }
+
+    foreach(HClientDevice* embeddedDevice, device->embeddedDevices())
+    {
+        bindLocally(static_cast<HDefaultClientDevice*>(embeddedDevice));
+    }
+}
+
+void HControlPointPrivate::trackSnapshotChanges(HDefaultClientDevice* device)
+{
+    bool ok = true;
+    if (!device->parentDevice())
+    {
+        // the locations of a device tree are stored in its root device
+        ok = connect(
+            device, SIGNAL(locationsChanged()), this, SLOT(snapshotChanged()));
+
+        Q_ASSERT(ok);
+    }
+
+    foreach(HClientService* service, device->services())
+    {
+        ok = connect(
+            service, SIGNAL(stateChanged(const Herqq::Upnp::HClientService*)),
+            this, SLOT(snapshotChanged()));
+
+        Q_ASSERT(ok);
+    }
+
+    Q_UNUSED(ok)
+
+    foreach(HClientDevice* embeddedDevice, device->embeddedDevices())
+    {
+        trackSnapshotChanges(static_cast<HDefaultClientDevice*>(embeddedDevice));
+    }
+}
+
+void HControlPointPrivate::snapshotChanged()
+{
+    if (m_snapshotPending)
+    {
+        return;
+    }
+
+    m_snapshotPending = true;
+    QMetaObject::invokeMethod(this, "publishSnapshot", Qt::QueuedConnection);
+}
+
+void HControlPointPrivate::publishSnapshot()
+{
+    Q_ASSERT(thread() == QThread::currentThread());
+
+    if (!m_snapshotPending)
+    {
+        // the snapshot has been published already
+        return;
+    }
+
+    m_snapshotPending = false;
+
+    // the version is modified only in this thread
+    qint32 version = m_snapshotVersion + 1;
+
+    HDeviceModelSnapshot snapshot =
+        HDeviceModelSnapshotBuilder::build(
+            m_deviceStorage.rootDevices(), version);
+
+    HDeviceModelSnapshot oldSnapshot;
+    {
+        QMutexLocker lock(&m_snapshotMutex);
+        oldSnapshot = m_snapshot;
+        m_snapshot = snapshot;
+    }
+    // the old snapshot is deleted outside the lock, if this was its last user
+
+    m_snapshotVersion.fetchAndStoreRelease(version);
+}
+
+void HControlPointPrivate::deviceExpired(void* source)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
     Q_ASSERT(thread() == QThread::currentThread());
 
     // according to the UDA v1.1 a "device tree" (root, embedded and services)
     // are "timed out" only when every advertisement has timed out.
+    // since an advertisement of any kind refreshes the entire device tree,
+    // the device tree times out when its root device does.
 
-    source = static_cast<HDefaultClientDevice*>(source->rootDevice());
+    HDefaultClientDevice* root = static_cast<HDefaultClientDevice*>(source);
+    Q_ASSERT(!root->parentDevice());
 
-    if (source->isTimedout(HDefaultClientDevice::All))
-    {
-        source->deviceStatus()->setOnline(false);
-        m_eventSubscriber->cancel(
-            source, VisitThisRecursively, false);
+    root->deviceStatus()->setOnline(false);
+    m_eventSubscriber->cancel(root, VisitThisRecursively, false);
 
-        emit q_ptr->rootDeviceOffline(source);
-    }
+    snapshotChanged();
+
+    emit q_ptr->rootDeviceOffline(root);
 }
 
 void HControlPointPrivate::unsubscribed(HClientService* service)
@@ -280,6 +459,71 @@ void HControlPointPrivate::unsubscribed(HClientService* service)
     emit q_ptr->subscriptionCanceled(service);
 }
 
+void HControlPointPrivate::multicastEventReceived(
+    const HMulticastNotifyRequest& req)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    if (m_state != Initialized)
+    {
+        return;
+    }
+
+    HClientDevice* device =
+        m_deviceStorage.searchDeviceByUdn(req.usn().udn(), AllDevices);
+
+    if (!device)
+    {
+        return;
+    }
+
+    HClientService* service = device->serviceById(req.serviceId());
+    if (!service ||
+        service->info().serviceType() != req.usn().resourceType())
+    {
+        return;
+    }
+    else if (!service->isModelLoaded())
+    {
+        // the state of a service is not tracked before its model is used
+        return;
+    }
+
+    // only the state variables marked as multicast evented in the SCPD are
+    // allowed to be updated through multicast events.
+    HMulticastNotifyRequest::Variables vars = req.variables();
+    HMulticastNotifyRequest::Variables::iterator it = vars.begin();
+    for(; it != vars.end(); )
+    {
+        const HClientStateVariable* stateVar =
+            service->stateVariables().value(it->first);
+
+        if (!stateVar || stateVar->info().eventingType() !=
+            HStateVariableInfo::UnicastAndMulticast)
+        {
+            HLOG_WARN(QString(
+                "Ignoring multicast event of state variable [%1] of service "
+                "[%2]: the state variable is not multicast evented").arg(
+                    it->first, req.serviceId().toString()));
+
+            it = vars.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (!vars.isEmpty() &&
+        !static_cast<HDefaultClientService*>(service)->updateVariables(vars, true))
+    {
+        HLOG_WARN(QString(
+            "Multicast event [seq: %1] to service [%2] failed. State variable(s) "
+            "were not updated.").arg(
+                QString::number(req.seq()), req.serviceId().toString()));
+    }
+}
+
 bool HControlPointPrivate::processDeviceOffline(
     const HResourceUnavailable& msg, const HEndpoint& /*source*/,
     HControlPointSsdpHandler* /*origin*/)
@@ -319,7 +563,9 @@ bool HControlPointPrivate::processDeviceOffline(
         m_eventSubscriber->remove(root, true);
 
         root->clearLocations();
-        root->stopStatusNotifier(HDefaultClientDevice::All);
+        m_deviceExpirations->remove(root);
+
+        snapshotChanged();
 
         emit q_ptr->rootDeviceOffline(root);
     }
@@ -347,7 +593,8 @@ bool HControlPointPrivate::processDeviceDiscovery(
         // ==> reset timeouts for entire device tree and all services.
 
         device = static_cast<HDefaultClientDevice*>(device->rootDevice());
-        device->startStatusNotifier(HDefaultClientDevice::All);
+        m_deviceExpirations->schedule(
+            device, device->deviceTimeoutInSecs() * 1000);
 
         // it cannot be that only some embedded device is available at certain
         // interface, since the device description is always fetched from the
@@ -359,9 +606,31 @@ bool HControlPointPrivate::processDeviceDiscovery(
                 resourceUdn.toString(), msg.location().toString()));
         }
 
+        HDeviceStatus* status = device->deviceStatus();
+        if (status->bootId() != msg.bootId() ||
+            status->configId() != msg.configId())
+        {
+            // the device has rebooted or its description has changed, which
+            // means the results of its actions may have changed as well
+            HLOG_DBG(QString("Device [%1] announced BOOTID [%2] and CONFIGID [%3]").arg(
+                resourceUdn.toString(), QString::number(msg.bootId()),
+                QString::number(msg.configId())));
+
+            status->setBootId(msg.bootId());
+            status->setConfigId(msg.configId());
+            device->invalidateActionResults();
+
+            // the device may have been restarted by a device host of this
+            // process
+            bindLocally(device);
+        }
+
         if (!device->deviceStatus()->online())
         {
+            device->invalidateActionResults();
+            bindLocally(device);
             device->deviceStatus()->setOnline(true);
+            snapshotChanged();
             emit q_ptr->rootDeviceOnline(device);
             processDeviceOnline(device, false);
         }
@@ -399,9 +668,12 @@ bool HControlPointPrivate::processDeviceDiscovery(
 
     m_deviceBuildTasks.add(newBuildTask);
 
+    // the connection is queued, since the task may be done already
+    // before it leaves start()
     bool ok = connect(
         newBuildTask, SIGNAL(done(Herqq::Upnp::HUdn)),
-        this, SLOT(deviceModelBuildDone(Herqq::Upnp::HUdn)));
+        this, SLOT(deviceModelBuildDone(Herqq::Upnp::HUdn)),
+        Qt::QueuedConnection);
 
     Q_ASSERT(ok); Q_UNUSED(ok)
 
@@ -410,7 +682,7 @@ bool HControlPointPrivate::processDeviceDiscovery(
         "Attempting to build the device model.").arg(
             msg.usn().toString(), msg.location().toString()));
 
-    m_threadPool->start(newBuildTask);
+    newBuildTask->start();
 
     return true;
 }
@@ -465,11 +737,82 @@ void HControlPointPrivate::processDeviceOnline(
         }
         if (subscribe)
         {
-            m_eventSubscriber->subscribe(
-                device, VisitThisRecursively,
-                m_configuration->desiredSubscriptionTimeout());
+            subscribeToEvents(device);
+        }
+    }
+}
+
+void HControlPointPrivate::subscribeToEvents(HDefaultClientDevice* device)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    qint32 timeout = m_configuration->desiredSubscriptionTimeout();
+    if (!m_configuration->lazyServiceModels())
+    {
+        m_eventSubscriber->subscribe(device, VisitThisRecursively, timeout);
+        return;
+    }
+
+    // Whether a service is evented is known only once its model has been
+    // loaded. The models of the services that have an event subscription URL
+    // are loaded in the background and subscribed to in serviceModelLoaded().
+    foreach(HClientService* service, device->services())
+    {
+        HDefaultClientService* defaultService =
+            static_cast<HDefaultClientService*>(service);
+
+        if (service->isModelLoaded())
+        {
+            if (service->isEvented())
+            {
+                m_eventSubscriber->subscribe(service, timeout);
+            }
+        }
+        else if (!service->info().eventSubUrl().isEmpty() &&
+                 m_serviceModels->prefetch(defaultService) &&
+                 !m_subscriptionsOnLoad.contains(defaultService))
+        {
+            m_subscriptionsOnLoad.append(defaultService);
         }
     }
+
+    foreach(HClientDevice* embeddedDevice, device->embeddedDevices())
+    {
+        subscribeToEvents(static_cast<HDefaultClientDevice*>(embeddedDevice));
+    }
+}
+
+void HControlPointPrivate::serviceModelLoaded(
+    HDefaultClientService* service, bool success)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    bool subscribe = m_subscriptionsOnLoad.removeAll(service) > 0;
+    m_subscriptionsOnLoad.removeAll(QPointer<HDefaultClientService>());
+    // the services of the removed devices
+
+    if (m_state != Initialized)
+    {
+        return;
+    }
+
+    if (!success)
+    {
+        emit q_ptr->serviceModelLoadFailed(service);
+        return;
+    }
+
+    // the values of the state variables are included in the snapshots
+    // from now on
+    snapshotChanged();
+
+    if (subscribe && service->isEvented())
+    {
+        m_eventSubscriber->subscribe(
+            service, m_configuration->desiredSubscriptionTimeout());
+    }
+
+    emit q_ptr->serviceModelLoaded(service);
 }
 
 void HControlPointPrivate::deviceModelBuildDone(const Herqq::Upnp::HUdn& udn)
@@ -496,6 +839,24 @@ void HControlPointPrivate::deviceModelBuildDone(const Herqq::Upnp::HUdn& udn)
                 device->addLocation(build->m_locations[i]);
             }
 
+            device->deviceStatus()->setBootId(build->bootId());
+            device->deviceStatus()->setConfigId(build->configId());
+
+            if (m_configuration->useLocalServers())
+            {
+                for (qint32 i = 0; i < build->m_locations.size(); ++i)
+                {
+                    QString localServer =
+                        m_dataRetriever->localServer(build->m_locations[i]);
+
+                    if (!localServer.isEmpty())
+                    {
+                        device->setLocalServer(localServer);
+                        break;
+                    }
+                }
+            }
+
             processDeviceOnline(device, true);
         }
         else
@@ -590,6 +951,32 @@ const HControlPointConfiguration* HControlPoint::configuration() const
     return h_ptr->m_configuration.data();
 }
 
+HMetrics HControlPoint::metrics() const
+{
+    HMetrics retVal = HMetricsRegistry::snapshot();
+
+    retVal.setGauge(
+        "hupnp_root_devices", h_ptr->m_deviceStorage.rootDevices().size());
+
+    retVal.setGauge(
+        "hupnp_gena_subscriptions",
+        h_ptr->m_eventSubscriber ?
+            h_ptr->m_eventSubscriber->subscriptionCount() : 0);
+
+    return retVal;
+}
+
+HDeviceModelSnapshot HControlPoint::snapshot() const
+{
+    QMutexLocker lock(&h_ptr->m_snapshotMutex);
+    return h_ptr->m_snapshot;
+}
+
+qint32 HControlPoint::snapshotVersion() const
+{
+    return h_ptr->m_snapshotVersion;
+}
+
 void HControlPoint::setError(ControlPointError error, const QString& errorStr)
 {
     HLOG2(H_AT, H_FUN, h_ptr->m_loggingIdentifier);
@@ -626,6 +1013,12 @@ bool HControlPoint::init()
 
     HLOG_INFO("ControlPoint initializing.");
 
+    h_ptr->m_dataRetriever->setTimeout(
+        h_ptr->m_configuration->dataRetrievalTimeout());
+
+    h_ptr->m_dataRetriever->setMaxRetries(
+        h_ptr->m_configuration->dataRetrievalRetries());
+
     h_ptr->m_eventSubscriber = new HEventSubscriptionManager(h_ptr);
 
     ok = connect(
@@ -667,6 +1060,15 @@ bool HControlPoint::init()
         goto end;
     }
 
+    if (h_ptr->m_configuration->useLocalServers() &&
+        !h_ptr->m_configuration->localServerName().isEmpty() &&
+        !h_ptr->m_server->listenLocal(h_ptr->m_configuration->localServerName()))
+    {
+        setError(CommunicationsError, "Failed to start the local endpoint");
+        ok = false;
+        goto end;
+    }
+
     foreach(const QHostAddress& ha, addrs)
     {
         quint32 netwAddr;
@@ -682,6 +1084,15 @@ bool HControlPoint::init()
             goto end;
         }
         h_ptr->m_ssdps.append(qMakePair(netwAddr, ssdp));
+
+        if (!h_ptr->m_multicastEvents->init(ha))
+        {
+            // multicast eventing is optional, the control point is fully
+            // functional without it.
+            HLOG_WARN(QString(
+                "Multicast events will not be received on [%1]").arg(
+                    ha.toString()));
+        }
     }
 
     if (h_ptr->m_configuration->autoDiscovery())
@@ -767,6 +1178,10 @@ void HControlPoint::quit()
 
     h_ptr->m_server->close();
 
+    h_ptr->m_serviceModels->cancelAll();
+    h_ptr->m_subscriptionsOnLoad.clear();
+
+    h_ptr->m_dataRetriever->abortAll();
     h_ptr->m_threadPool->shutdown();
 
     doQuit();
@@ -777,9 +1192,14 @@ void HControlPoint::quit()
         delete h_ptr->m_ssdps[i].second; h_ptr->m_ssdps[i].second = 0;
     }
     h_ptr->m_ssdps.clear();
+    h_ptr->m_multicastEvents->clear();
 
+    h_ptr->m_deviceExpirations->clear();
     h_ptr->m_deviceStorage.clear();
 
+    h_ptr->m_snapshotPending = true;
+    h_ptr->publishSnapshot();
+
     delete h_ptr->m_eventSubscriber; h_ptr->m_eventSubscriber = 0;
 
     h_ptr->m_state = HControlPointPrivate::Uninitialized;
@@ -1037,9 +1457,13 @@ bool HControlPoint::removeRootDevice(HClientDevice* rootDevice)
     h_ptr->m_eventSubscriber->remove(rootDevice, true);
     // TODO should send unsubscription to the UPnP device?
 
+    h_ptr->m_deviceExpirations->remove(
+        static_cast<HDefaultClientDevice*>(rootDevice));
+
     HDeviceInfo info(rootDevice->info());
     if (h_ptr->m_deviceStorage.removeRootDevice(rootDevice))
     {
+        h_ptr->snapshotChanged();
         emit rootDeviceRemoved(info);
         return true;
     }
@@ -1051,6 +1475,41 @@ bool HControlPoint::removeRootDevice(HClientDevice* rootDevice)
     return false;
 }
 
+bool HControlPoint::prefetchServiceModel(HClientService* service)
+{
+    HLOG2(H_AT, H_FUN, h_ptr->m_loggingIdentifier);
+
+    if (!isStarted())
+    {
+        setError(NotInitializedError, "The control point is not initialized");
+        return false;
+    }
+    else if (!service)
+    {
+        setError(InvalidArgumentError, "Null pointer error");
+        return false;
+    }
+    else if (!h_ptr->m_deviceStorage.searchDeviceByUdn(
+                service->parentDevice()->info().udn(), AllDevices))
+    {
+        setError(InvalidArgumentError,
+            "The specified service was not found in this control point");
+
+        return false;
+    }
+
+    if (!h_ptr->m_serviceModels->prefetch(
+            static_cast<HDefaultClientService*>(service)))
+    {
+        setError(InvalidArgumentError,
+            "The device of the specified service has no known location");
+
+        return false;
+    }
+
+    return true;
+}
+
 bool HControlPoint::scan(const HDiscoveryType& discoveryType, qint32 count)
 {
     HLOG2(H_AT, H_FUN, h_ptr->m_loggingIdentifier);
@@ -36,6 +36,8 @@ namespace Herqq
 namespace Upnp
 {
 
+class HMetrics;
+class HDeviceModelSnapshot;
 class HControlPointPrivate;
 class HControlPointConfiguration;
 
@@ -166,6 +168,8 @@ class HControlPointConfiguration;
  * \li You can use \c QObject::moveToThread() on the \c %HControlPoint, which causes
  * the control point and every object managed by it to be moved to the chosen thread.
  * However, you cannot move individual objects managed by \c %HControlPoint.
+ * \li snapshot() and snapshotVersion() are exceptions to this: they can be
+ * called from any thread to read the device model without locks.
  * \li a control point never transfers the ownership of the HClientDevice objects it manages.
  * \li <b>%HControlPoint always destroys every %HClientDevice it manages when it is
  * being destroyed</b>.
@@ -477,6 +481,49 @@ protected:
      */
     const HControlPointConfiguration* configuration() const;
 
+    /*!
+     * \brief Returns a snapshot of the runtime metrics.
+     *
+     * \return A snapshot of the runtime metrics. The counters and histograms
+     * are shared by all the device hosts and control points in the process,
+     * whereas the gauges \c hupnp_root_devices and
+     * \c hupnp_gena_subscriptions describe this control point.
+     *
+     * \sa HMetrics
+     */
+    HMetrics metrics() const;
+
+    /*!
+     * \brief Returns an immutable copy of the device model.
+     *
+     * The control point publishes a new snapshot whenever a device is added,
+     * removed, goes online or offline, changes its locations or whenever the
+     * state of a service changes. Changes that occur in quick succession
+     * are published as a single snapshot.
+     *
+     * \return An immutable copy of the device model. The returned object is
+     * empty in case the control point is not started.
+     *
+     * \remarks This method is thread-safe and it can be called from any
+     * thread. The returned object can be read without any synchronization.
+     *
+     * \sa snapshotVersion(), HDeviceModelSnapshot
+     */
+    HDeviceModelSnapshot snapshot() const;
+
+    /*!
+     * \brief Returns the version of the latest snapshot of the device model.
+     *
+     * \return The version of the latest snapshot of the device model. This
+     * can be compared with HDeviceModelSnapshot::version() to detect whether
+     * the device model has changed since a snapshot was taken.
+     *
+     * \remarks This method is thread-safe and it does not block.
+     *
+     * \sa snapshot()
+     */
+    qint32 snapshotVersion() const;
+
     /*!
      * \brief Sets the type and description of the last occurred error.
      *
@@ -669,6 +716,35 @@ public:
      */
     bool removeRootDevice(HClientDevice* rootDevice);
 
+    /*!
+     * \brief Starts building the model of the specified service in the
+     * background.
+     *
+     * This is meaningful only when the control point builds the service
+     * models lazily. The service description is retrieved asynchronously
+     * and the actions and the state variables of the service are created
+     * once it is available. Until then the service has no actions or state
+     * variables. Requesting the model of a service again while it is being
+     * built does not start another retrieval.
+     *
+     * \param service specifies the service.
+     *
+     * \retval true in case the model has been built already or it is being
+     * built. In the latter case either serviceModelLoaded() or
+     * serviceModelLoadFailed() is emitted once the model has been built.
+     *
+     * \retval false in case the specified argument:
+     * - is null,
+     * - it does not belong to a device held by the control point or
+     * - it belongs to a device that has no known location.
+     *
+     * \remarks This method returns immediately.
+     *
+     * \sa HControlPointConfiguration::setLazyServiceModels(),
+     * HClientService::isModelLoaded()
+     */
+    bool prefetchServiceModel(HClientService* service);
+
     /*!
      * Subscribes to events of the specified services contained by the
      * specified device.
@@ -945,6 +1021,29 @@ Q_SIGNALS:
      */
     void subscriptionCanceled(Herqq::Upnp::HClientService* service);
 
+    /*!
+     * \brief This signal is emitted when the model of a service that was
+     * built lazily has been built.
+     *
+     * \param service specifies the service, whose actions and state variables
+     * are now available.
+     *
+     * \sa serviceModelLoadFailed(), prefetchServiceModel()
+     */
+    void serviceModelLoaded(Herqq::Upnp::HClientService* service);
+
+    /*!
+     * \brief This signal is emitted when the model of a service that is
+     * built lazily could not be built.
+     *
+     * The model is attempted again when it is next prefetched.
+     *
+     * \param service specifies the service, whose model could not be built.
+     *
+     * \sa serviceModelLoaded(), prefetchServiceModel()
+     */
+    void serviceModelLoadFailed(Herqq::Upnp::HClientService* service);
+
     /*!
      * \brief This signal is emitted when a device has been discovered.
      *
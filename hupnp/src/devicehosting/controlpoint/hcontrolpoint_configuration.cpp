@@ -40,7 +40,15 @@ HControlPointConfigurationPrivate::HControlPointConfigurationPrivate() :
     m_subscribeToEvents(true),
     m_desiredSubscriptionTimeout(1800),
     m_autoDiscovery(true),
-    m_networkAddresses()
+    m_networkAddresses(),
+    m_dataRetrievalTimeout(3000),
+    m_dataRetrievalRetries(0),
+    m_idempotentActions(),
+    m_actionResultTimeout(30000),
+    m_inProcessDevices(false),
+    m_localServers(true),
+    m_localServerName(),
+    m_lazyServiceModels(false)
 {
     QHostAddress ha = findBindableHostAddress();
     m_networkAddresses.append(ha);
@@ -59,6 +67,14 @@ HControlPointConfigurationPrivate* HControlPointConfigurationPrivate::clone() co
     newObj->m_desiredSubscriptionTimeout = m_desiredSubscriptionTimeout;
     newObj->m_autoDiscovery = m_autoDiscovery;
     newObj->m_networkAddresses = m_networkAddresses;
+    newObj->m_dataRetrievalTimeout = m_dataRetrievalTimeout;
+    newObj->m_dataRetrievalRetries = m_dataRetrievalRetries;
+    newObj->m_idempotentActions = m_idempotentActions;
+    newObj->m_actionResultTimeout = m_actionResultTimeout;
+    newObj->m_inProcessDevices = m_inProcessDevices;
+    newObj->m_localServers = m_localServers;
+    newObj->m_localServerName = m_localServerName;
+    newObj->m_lazyServiceModels = m_lazyServiceModels;
 
     return newObj;
 }
@@ -126,6 +142,46 @@ QList<QHostAddress> HControlPointConfiguration::networkAddressesToUse() const
     return h_ptr->m_networkAddresses;
 }
 
+qint32 HControlPointConfiguration::dataRetrievalTimeout() const
+{
+    return h_ptr->m_dataRetrievalTimeout;
+}
+
+qint32 HControlPointConfiguration::dataRetrievalRetries() const
+{
+    return h_ptr->m_dataRetrievalRetries;
+}
+
+QStringList HControlPointConfiguration::idempotentActions() const
+{
+    return h_ptr->m_idempotentActions;
+}
+
+qint32 HControlPointConfiguration::actionResultTimeout() const
+{
+    return h_ptr->m_actionResultTimeout;
+}
+
+bool HControlPointConfiguration::inProcessDevices() const
+{
+    return h_ptr->m_inProcessDevices;
+}
+
+bool HControlPointConfiguration::useLocalServers() const
+{
+    return h_ptr->m_localServers;
+}
+
+QString HControlPointConfiguration::localServerName() const
+{
+    return h_ptr->m_localServerName;
+}
+
+bool HControlPointConfiguration::lazyServiceModels() const
+{
+    return h_ptr->m_lazyServiceModels;
+}
+
 void HControlPointConfiguration::setSubscribeToEvents(bool arg)
 {
     h_ptr->m_subscribeToEvents = arg;
@@ -160,5 +216,64 @@ bool HControlPointConfiguration::setNetworkAddressesToUse(
     return true;
 }
 
+void HControlPointConfiguration::setDataRetrievalTimeout(qint32 arg)
+{
+    static const qint32 def = 3000;
+
+    if (arg <= 0)
+    {
+        arg = def;
+    }
+
+    h_ptr->m_dataRetrievalTimeout = arg;
+}
+
+void HControlPointConfiguration::setDataRetrievalRetries(qint32 arg)
+{
+    if (arg < 0)
+    {
+        arg = 0;
+    }
+
+    h_ptr->m_dataRetrievalRetries = arg;
+}
+
+void HControlPointConfiguration::setIdempotentActions(const QStringList& arg)
+{
+    h_ptr->m_idempotentActions = arg;
+}
+
+void HControlPointConfiguration::setActionResultTimeout(qint32 arg)
+{
+    static const qint32 def = 30000;
+
+    if (arg <= 0)
+    {
+        arg = def;
+    }
+
+    h_ptr->m_actionResultTimeout = arg;
+}
+
+void HControlPointConfiguration::setInProcessDevices(bool arg)
+{
+    h_ptr->m_inProcessDevices = arg;
+}
+
+void HControlPointConfiguration::setUseLocalServers(bool arg)
+{
+    h_ptr->m_localServers = arg;
+}
+
+void HControlPointConfiguration::setLocalServerName(const QString& name)
+{
+    h_ptr->m_localServerName = name.trimmed();
+}
+
+void HControlPointConfiguration::setLazyServiceModels(bool arg)
+{
+    h_ptr->m_lazyServiceModels = arg;
+}
+
 }
 }
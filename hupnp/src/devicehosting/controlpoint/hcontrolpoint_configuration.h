@@ -24,6 +24,8 @@
 
 #include <HUpnpCore/HClonable>
 
+class QString;
+class QStringList;
 class QHostAddress;
 
 namespace Herqq
@@ -54,6 +56,20 @@ class HControlPointConfigurationPrivate;
  * The default is the first found interface that is up. Non-loopback interfaces
  * have preference, but if none are found the loopback is used. However, in this
  * case UDP multicast is not available.
+ * - Specify the actions whose results the HControlPoint may cache with
+ * setIdempotentActions() and for how long with setActionResultTimeout().
+ * By default no results are cached.
+ * - Specify whether an HControlPoint should talk directly to the devices
+ * hosted by an HDeviceHost in the same process and thread using
+ * setInProcessDevices(). The default is no.
+ * - Specify whether an HControlPoint should use the local endpoints of the
+ * device hosts running on the same host using setUseLocalServers(). The
+ * default is yes.
+ * - Specify a local endpoint through which the device hosts running on the
+ * same host deliver events to an HControlPoint using setLocalServerName().
+ * By default there is none.
+ * - Specify whether an HControlPoint should build the models of the services
+ * only when they are requested with setLazyServiceModels(). The default is no.
  *
  * \headerfile hcontrolpoint_configuration.h HControlPointConfiguration
  *
@@ -152,6 +168,142 @@ public:
      */
     QList<QHostAddress> networkAddressesToUse() const;
 
+    /*!
+     * \brief Returns the time a control point waits for a response when it
+     * retrieves a device or a service description.
+     *
+     * The timeout applies to every attempt to retrieve a single document.
+     * The default value is 3 seconds.
+     *
+     * \return The time in milliseconds a control point waits for a response
+     * when it retrieves a device or a service description.
+     *
+     * \sa setDataRetrievalTimeout(), dataRetrievalRetries()
+     */
+    qint32 dataRetrievalTimeout() const;
+
+    /*!
+     * \brief Returns the number of times a control point retries a failed
+     * retrieval of a device or a service description.
+     *
+     * A retrieval is retried only when it times out or fails due to a network
+     * error. The default value is 0.
+     *
+     * \return The number of times a control point retries a failed
+     * retrieval of a device or a service description.
+     *
+     * \sa setDataRetrievalRetries(), dataRetrievalTimeout()
+     */
+    qint32 dataRetrievalRetries() const;
+
+    /*!
+     * \brief Returns the names of the actions whose results a control point
+     * caches.
+     *
+     * The result of a successful invocation of such an action is reused for
+     * the subsequent invocations of the same action of the same device with
+     * the same input arguments, until the result expires or it is invalidated.
+     * A result is invalidated when an evented state variable of the service
+     * changes or when the device announces a new \c BOOTID.UPNP.ORG or
+     * \c CONFIGID.UPNP.ORG. An invocation served from the cache completes
+     * through the event loop like any other invocation, but it is never sent
+     * to the device.
+     *
+     * The list is empty by default.
+     *
+     * \return The names of the actions whose results a control point caches.
+     *
+     * \sa setIdempotentActions(), actionResultTimeout()
+     */
+    QStringList idempotentActions() const;
+
+    /*!
+     * \brief Returns the time a cached action result remains valid.
+     *
+     * The default value is 30 seconds.
+     *
+     * \return The time in milliseconds a cached action result remains valid.
+     *
+     * \sa setActionResultTimeout(), idempotentActions()
+     */
+    qint32 actionResultTimeout() const;
+
+    /*!
+     * \brief Indicates whether a control point talks directly to the devices
+     * hosted in the same process.
+     *
+     * When this is enabled and a discovered device is hosted by an
+     * HDeviceHost that lives in the same thread as the control point, the
+     * actions of the device are invoked by calling HServerAction::invoke()
+     * and the changes of the evented state variables are received straight
+     * from the HServerStateVariable instances. Nothing is serialized or sent
+     * through the network in either case. The invocations and the
+     * subscriptions still complete through the event loop. The device and
+     * service descriptions are retrieved over HTTP as usual.
+     *
+     * This is disabled by default, since an application that controls the
+     * devices it hosts itself often does so to test them through the network.
+     *
+     * \return \e true when a control point talks directly to the devices
+     * hosted in the same process.
+     *
+     * \sa setInProcessDevices()
+     */
+    bool inProcessDevices() const;
+
+    /*!
+     * \brief Indicates whether a control point uses the local endpoints of
+     * the device hosts running on the same host.
+     *
+     * When this is enabled and a device host on the same host advertises
+     * a local endpoint, see HDeviceHostConfiguration::setLocalServerName(),
+     * the action invocations and the event subscriptions are sent to
+     * the device host through a Unix domain socket instead of TCP. If
+     * connecting to the endpoint fails, TCP is used instead.
+     *
+     * This is enabled by default.
+     *
+     * \return \e true when a control point uses the local endpoints of
+     * the device hosts running on the same host.
+     *
+     * \sa setUseLocalServers(), inProcessDevices()
+     */
+    bool useLocalServers() const;
+
+    /*!
+     * \brief Returns the name of the local endpoint through which the device
+     * hosts running on the same host deliver events to a control point.
+     *
+     * The default value is an empty string, which means that events are
+     * always delivered over TCP.
+     *
+     * \return The name of the local endpoint through which the device
+     * hosts running on the same host deliver events to a control point.
+     *
+     * \sa setLocalServerName()
+     */
+    QString localServerName() const;
+
+    /*!
+     * \brief Indicates whether a control point builds the models of the
+     * services only when they are requested.
+     *
+     * When this is enabled a discovered device is reported as soon as its
+     * device description has been retrieved and parsed. The service
+     * descriptions are not retrieved at that point. Instead, the actions and
+     * the state variables of an HClientService are created once they are
+     * requested with HControlPoint::prefetchServiceModel(), which never
+     * blocks. Until then the service has no actions or state variables.
+     *
+     * This is disabled by default.
+     *
+     * \return \e true when a control point builds the models of the
+     * services only when they are requested.
+     *
+     * \sa setLazyServiceModels(), HClientService::isModelLoaded()
+     */
+    bool lazyServiceModels() const;
+
     /*!
      * Defines whether a control point should automatically subscribe to all
      * events on all services of a device when a new device is added
@@ -206,6 +358,119 @@ public:
      * \sa networkAddressesToUse()
      */
     bool setNetworkAddressesToUse(const QList<QHostAddress>& addresses);
+
+    /*!
+     * \brief Sets the time a control point waits for a response when it
+     * retrieves a device or a service description.
+     *
+     * Values less than or equal to zero are rejected and instead the default
+     * value is used. The default value is 3 seconds.
+     *
+     * \param timeout specifies the timeout in milliseconds.
+     *
+     * \sa dataRetrievalTimeout()
+     */
+    void setDataRetrievalTimeout(qint32 timeout);
+
+    /*!
+     * \brief Sets the number of times a control point retries a failed
+     * retrieval of a device or a service description.
+     *
+     * Negative values are rejected and instead the default value is used.
+     * The default value is 0.
+     *
+     * \param retries specifies the number of retries.
+     *
+     * \sa dataRetrievalRetries()
+     */
+    void setDataRetrievalRetries(qint32 retries);
+
+    /*!
+     * \brief Sets the names of the actions whose results a control point
+     * caches.
+     *
+     * Only actions that have no side effects and whose results change only
+     * when the state of the service changes should be specified. Since
+     * the changes are noticed through events, the results of a service
+     * the control point is not subscribed to are reused until they expire.
+     *
+     * \param actionNames specifies the names of the actions. The names apply
+     * to the actions of every service.
+     *
+     * \sa idempotentActions(), setActionResultTimeout()
+     */
+    void setIdempotentActions(const QStringList& actionNames);
+
+    /*!
+     * \brief Sets the time a cached action result remains valid.
+     *
+     * Values less than or equal to zero are rejected and instead the default
+     * value is used. The default value is 30 seconds.
+     *
+     * \param timeout specifies the timeout in milliseconds.
+     *
+     * \sa actionResultTimeout()
+     */
+    void setActionResultTimeout(qint32 timeout);
+
+    /*!
+     * \brief Specifies whether a control point talks directly to the devices
+     * hosted in the same process.
+     *
+     * \param arg when \e true the devices hosted by an HDeviceHost in the
+     * same process and thread are used directly instead of through the
+     * network. The default is \e false.
+     *
+     * \sa inProcessDevices()
+     */
+    void setInProcessDevices(bool arg);
+
+    /*!
+     * \brief Specifies whether a control point uses the local endpoints of
+     * the device hosts running on the same host.
+     *
+     * \param arg when \e true the local endpoints advertised by the device
+     * hosts running on the same host are used. This is the default.
+     *
+     * \sa useLocalServers()
+     */
+    void setUseLocalServers(bool arg);
+
+    /*!
+     * \brief Specifies the name of a local endpoint through which the device
+     * hosts running on the same host deliver events to a control point.
+     *
+     * The endpoint is a Unix domain socket, which is advertised in the
+     * subscription requests sent to the device hosts running on the same
+     * host. It is used only when useLocalServers() is \e true.
+     *
+     * \param name specifies either a plain name, in which case the socket is
+     * created into the directory for temporary files, or an absolute path
+     * to the socket. An empty string disables the local endpoint.
+     *
+     * \remarks This is supported only on Unix. Elsewhere HControlPoint::init()
+     * fails if a name is specified.
+     *
+     * \sa localServerName(), HDeviceHostConfiguration::setLocalServerName()
+     */
+    void setLocalServerName(const QString& name);
+
+    /*!
+     * \brief Specifies whether a control point builds the models of the
+     * services only when they are requested.
+     *
+     * \param arg when \e true the service descriptions are retrieved only
+     * when the model of a service is requested with
+     * HControlPoint::prefetchServiceModel(). The default is \e false.
+     *
+     * \remarks When automatic event subscriptions are enabled, the
+     * models of the services that declare an event subscription URL are
+     * prefetched as soon as a device is discovered and the subscriptions are
+     * made once the models are ready.
+     *
+     * \sa lazyServiceModels(), setSubscribeToEvents()
+     */
+    void setLazyServiceModels(bool arg);
 };
 
 }
@@ -33,6 +33,8 @@
 #include "../../utils/hglobal.h"
 
 #include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtNetwork/QHostAddress>
 
 namespace Herqq
@@ -54,6 +56,14 @@ public: // attributes
     qint32 m_desiredSubscriptionTimeout;
     bool m_autoDiscovery;
     QList<QHostAddress> m_networkAddresses;
+    qint32 m_dataRetrievalTimeout;
+    qint32 m_dataRetrievalRetries;
+    QStringList m_idempotentActions;
+    qint32 m_actionResultTimeout;
+    bool m_inProcessDevices;
+    bool m_localServers;
+    QString m_localServerName;
+    bool m_lazyServiceModels;
 
 public: // methods
 
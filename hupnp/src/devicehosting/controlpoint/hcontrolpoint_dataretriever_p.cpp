@@ -21,13 +21,14 @@
 
 #include "hcontrolpoint_dataretriever_p.h"
 
+#include "../../http/hhttp_utils_p.h"
 #include "../../general/hlogger_p.h"
 #include "../../general/hupnp_global_p.h"
+#include "../../utils/hdeadline_scheduler_p.h"
 
-#include <QtCore/QUrl>
-#include <QtCore/QTimerEvent>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkAccessManager>
 
 namespace Herqq
 {
@@ -35,37 +36,42 @@ namespace Herqq
 namespace Upnp
 {
 
-HDataRetriever::HDataRetriever(const QByteArray& loggingId) :
-    m_loggingIdentifier(loggingId), m_nam(), m_reply(0), m_lastError(),
-    m_success(false)
+namespace
 {
-    bool ok = connect(
-        &m_nam, SIGNAL(finished(QNetworkReply*)), this, SLOT(finished()));
-    Q_ASSERT(ok); Q_UNUSED(ok)
+QString localServerKey(const QUrl& url)
+{
+    return QString("%1:%2").arg(url.host(), QString::number(url.port(80)));
+}
 }
 
-void HDataRetriever::finished()
+/*******************************************************************************
+ * HDataRetriever
+ ******************************************************************************/
+HDataRetriever::HDataRetriever(
+    const QByteArray& loggingId, QNetworkAccessManager& nam, QObject* parent) :
+        QObject(parent),
+            m_loggingIdentifier(loggingId), m_nam(nam),
+            m_transfers(), m_replies(),
+            m_timeouts(new HDeadlineScheduler(100, this)),
+            m_timeout(3000), m_maxRetries(0), m_localServers()
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    bool ok = connect(
+        m_timeouts, SIGNAL(expired(void*)), this, SLOT(timeout(void*)));
 
-    quit();
+    Q_ASSERT(ok); Q_UNUSED(ok)
+}
 
-    if (m_reply->error() != QNetworkReply::NoError)
-    {
-        m_success = false;
-        HLOG_WARN(QString("Request failed: %1").arg(m_reply->errorString()));
-    }
-    else
+HDataRetriever::~HDataRetriever()
+{
+    foreach(Transfer* transfer, m_transfers)
     {
-        m_success = true;
+        abort(transfer);
+        delete transfer;
     }
 }
 
-bool HDataRetriever::retrieveData(
-    const QUrl& baseUrl, const QUrl& query, QByteArray* data)
+QUrl HDataRetriever::resolveUrl(const QUrl& baseUrl, const QUrl& query)
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-
     QString queryPart = extractRequestPart(query);
 
     QString request = queryPart.startsWith('/') ?
@@ -83,82 +89,218 @@ bool HDataRetriever::retrieveData(
         request.append('/');
     }
 
-    QNetworkRequest req(request);
-    m_reply = m_nam.get(req);
+    return QUrl(request);
+}
+
+void HDataRetriever::send(Transfer* transfer)
+{
+    Q_ASSERT(!transfer->m_reply);
 
-    int id = startTimer(3000);
-    exec();
-    killTimer(id);
+    ++transfer->m_attempts;
 
-    if (m_success)
+    QNetworkRequest req(transfer->m_url);
+    transfer->m_reply = m_nam.get(req);
+
+    bool ok = connect(
+        transfer->m_reply, SIGNAL(finished()), this, SLOT(finished()));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_replies.insert(transfer->m_reply, transfer);
+    m_timeouts->schedule(transfer, m_timeout);
+}
+
+void HDataRetriever::abort(Transfer* transfer)
+{
+    m_timeouts->remove(transfer);
+
+    if (transfer->m_reply)
     {
-        *data = m_reply->readAll();
-    }
+        QNetworkReply* reply = transfer->m_reply;
+        transfer->m_reply = 0;
 
-    m_reply->deleteLater(); m_reply = 0;
-    return m_success;
+        m_replies.remove(reply);
+
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
 }
 
-void HDataRetriever::timerEvent(QTimerEvent* event)
+bool HDataRetriever::retry(Transfer* transfer)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    HLOG_WARN(QString("Request timed out."));
+    if (transfer->m_attempts > m_maxRetries)
+    {
+        return false;
+    }
+
+    HLOG_DBG(QString("Retrying the retrieval of [%1]").arg(
+        transfer->m_url.toString()));
+
+    send(transfer);
+    return true;
+}
+
+void HDataRetriever::complete(
+    Transfer* transfer, bool success, const QByteArray& data,
+    const QString& err)
+{
+    m_transfers.remove(transfer->m_url.toString());
 
-    quit();
-    killTimer(event->timerId());
+    QList<QPair<void*, DataRetrievedCallback> > waiters = transfer->m_waiters;
+    QUrl url = transfer->m_url;
+    delete transfer;
 
-    m_success = false;
+    // The transfer is not referenced anymore, which means that the callbacks
+    // are free to start new retrievals.
+    for(qint32 i = 0; i < waiters.size(); ++i)
+    {
+        waiters[i].second(url, success, data, err);
+    }
 }
 
-bool HDataRetriever::retrieveServiceDescription(
-    const QUrl& deviceLocation, const QUrl& scpdUrl, QString* data)
+void HDataRetriever::finished()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    HLOG_DBG(QString(
-        "Attempting to fetch a service description for [%1] from: [%2]").arg(
-            scpdUrl.toString(), deviceLocation.toString()));
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    Q_ASSERT(reply);
 
-    QByteArray tmp;
-    if (!retrieveData(deviceLocation, scpdUrl, &tmp))
+    Transfer* transfer = m_replies.take(reply);
+    reply->deleteLater();
+
+    if (!transfer)
     {
-        return false;
+        return;
     }
 
-    *data = QString::fromUtf8(tmp);
-    return true;
+    m_timeouts->remove(transfer);
+    transfer->m_reply = 0;
+
+    if (reply->error() != QNetworkReply::NoError)
+    {
+        HLOG_WARN(QString("Request to [%1] failed: %2").arg(
+            transfer->m_url.toString(), reply->errorString()));
+
+        // only errors that occur below the HTTP level are worth retrying
+        if (reply->error() >= QNetworkReply::ContentAccessDenied ||
+            !retry(transfer))
+        {
+            complete(transfer, false, QByteArray(), reply->errorString());
+        }
+    }
+    else
+    {
+        QString localServer = QString::fromUtf8(reply->rawHeader(
+            HHttpUtils::localServerHeader().toLatin1())).trimmed();
+
+        if (!localServer.isEmpty() && HHttpUtils::isSameHost(transfer->m_url))
+        {
+            m_localServers.insert(localServerKey(transfer->m_url), localServer);
+        }
+
+        complete(transfer, true, reply->readAll(), QString());
+    }
+}
+
+QString HDataRetriever::localServer(const QUrl& url) const
+{
+    return m_localServers.value(localServerKey(url));
 }
 
-bool HDataRetriever::retrieveIcon(
-    const QUrl& deviceLocation, const QUrl& iconUrl, QByteArray* data)
+void HDataRetriever::timeout(void* key)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    HLOG_DBG(QString(
-        "Attempting to retrieve icon [%1] from: [%2]").arg(
-            iconUrl.toString(), deviceLocation.toString()));
+    Transfer* transfer = static_cast<Transfer*>(key);
+
+    HLOG_WARN(QString("Request to [%1] timed out.").arg(
+        transfer->m_url.toString()));
 
-    return retrieveData(deviceLocation, iconUrl, data);
+    abort(transfer);
+
+    if (!retry(transfer))
+    {
+        complete(transfer, false, QByteArray(), "Request timed out");
+    }
 }
 
-bool HDataRetriever::retrieveDeviceDescription(
-    const QUrl& deviceLocation, QString* data)
+void HDataRetriever::retrieve(
+    const QUrl& url, void* owner, const DataRetrievedCallback& callback)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    HLOG_DBG(QString(
-        "Attempting to fetch a device description from: [%1]").arg(
-            deviceLocation.toString()));
+    Q_ASSERT(owner);
+    Q_ASSERT(callback);
 
-    QByteArray tmp;
-    if (!retrieveData(deviceLocation, QUrl(), &tmp))
+    Transfer* transfer = m_transfers.value(url.toString());
+    if (transfer)
     {
-        return false;
+        HLOG_DBG(QString("Joining an ongoing retrieval of [%1]").arg(
+            url.toString()));
     }
+    else
+    {
+        transfer = new Transfer();
+        transfer->m_url = url;
+        transfer->m_reply = 0;
+        transfer->m_attempts = 0;
 
-    *data = QString::fromUtf8(tmp);
-    return true;
+        m_transfers.insert(url.toString(), transfer);
+        send(transfer);
+    }
+
+    transfer->m_waiters.append(qMakePair(owner, callback));
+}
+
+void HDataRetriever::cancel(void* owner)
+{
+    QHash<QString, Transfer*>::iterator it = m_transfers.begin();
+    while(it != m_transfers.end())
+    {
+        Transfer* transfer = it.value();
+
+        QList<QPair<void*, DataRetrievedCallback> >::iterator wit =
+            transfer->m_waiters.begin();
+
+        while(wit != transfer->m_waiters.end())
+        {
+            if (wit->first == owner)
+            {
+                wit = transfer->m_waiters.erase(wit);
+            }
+            else
+            {
+                ++wit;
+            }
+        }
+
+        if (transfer->m_waiters.isEmpty())
+        {
+            abort(transfer);
+            delete transfer;
+            it = m_transfers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void HDataRetriever::abortAll()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    // the callbacks may cancel other retrievals
+    while(!m_transfers.isEmpty())
+    {
+        Transfer* transfer = *m_transfers.begin();
+        abort(transfer);
+        complete(transfer, false, QByteArray(), "Request aborted");
+    }
 }
 
 }
@@ -31,13 +31,17 @@
 //
 
 #include "../../general/hupnp_defs.h"
+#include "../../utils/hfunctor.h"
 
+#include <QtCore/QUrl>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QObject>
 #include <QtCore/QByteArray>
-#include <QtCore/QEventLoop>
-#include <QtNetwork/QNetworkAccessManager>
 
-class QUrl;
 class QNetworkReply;
+class QNetworkAccessManager;
 
 namespace Herqq
 {
@@ -45,52 +49,100 @@ namespace Herqq
 namespace Upnp
 {
 
+class HDeadlineScheduler;
+
+//
+// The callback invoked when a retrieval completes. The arguments are the
+// retrieved URL, a flag indicating whether the retrieval succeeded, the
+// retrieved data and a description of the error that occurred, if any.
 //
+typedef Functor<void, H_TYPELIST_4(
+    const QUrl&, bool, const QByteArray&, const QString&)> DataRetrievedCallback;
+
 //
+// Retrieves device and service descriptions asynchronously using the
+// network access manager of the control point. Concurrent retrievals of the same
+// URL share a single transfer. Every transfer is guarded by a timeout and
+// a transfer that times out or fails due to a network error is retried up to
+// the specified number of times.
+//
+// The instance has to be used from the thread in which it lives.
 //
 class HDataRetriever :
-    public QEventLoop
+    public QObject
 {
 Q_OBJECT
 H_DISABLE_COPY(HDataRetriever)
 
-private slots:
-
-    void finished();
-
 private:
 
+    struct Transfer
+    {
+        QUrl m_url;
+        QNetworkReply* m_reply;
+        qint32 m_attempts;
+        QList<QPair<void*, DataRetrievedCallback> > m_waiters;
+    };
+
     const QByteArray m_loggingIdentifier;
-    QNetworkAccessManager m_nam;
-    QNetworkReply* m_reply;
-    QString m_lastError;
+    QNetworkAccessManager& m_nam;
 
-    bool m_success;
+    QHash<QString, Transfer*> m_transfers;
+    // keyed by the retrieved URL
 
-private:
+    QHash<QNetworkReply*, Transfer*> m_replies;
+
+    HDeadlineScheduler* m_timeouts;
+    // the keys are Transfer instances
+
+    qint32 m_timeout;
+    qint32 m_maxRetries;
 
-    bool retrieveData(const QUrl& baseUrl, const QUrl& query, QByteArray*);
+    QHash<QString, QString> m_localServers;
+    // the local endpoints advertised by the servers running on this host,
+    // keyed by the host and port of the server
 
-protected:
+    void send(Transfer*);
+    void abort(Transfer*);
+    bool retry(Transfer*);
+    void complete(
+        Transfer*, bool success, const QByteArray& data, const QString& err);
 
-    virtual void timerEvent(QTimerEvent*);
+private Q_SLOTS:
+
+    void finished();
+    void timeout(void*);
 
 public:
 
-    HDataRetriever(const QByteArray& loggingId);
+    HDataRetriever(
+        const QByteArray& loggingId, QNetworkAccessManager& nam,
+        QObject* parent = 0);
 
-    inline QString lastError() const
-    {
-        return m_lastError;
-    }
+    virtual ~HDataRetriever();
+
+    static QUrl resolveUrl(const QUrl& baseUrl, const QUrl& query);
+
+    inline void setTimeout(qint32 timeoutInMsecs) { m_timeout = timeoutInMsecs; }
+    inline void setMaxRetries(qint32 retries) { m_maxRetries = retries; }
+
+    // Starts retrieving the specified URL, or joins a retrieval of the URL that
+    // is already in progress. The callback is always invoked asynchronously
+    // unless the retrieval is canceled before it completes.
+    // The owner is used only to cancel the retrieval.
+    void retrieve(
+        const QUrl& url, void* owner, const DataRetrievedCallback& callback);
 
-    bool retrieveServiceDescription(
-        const QUrl& deviceLocation, const QUrl& scpdUrl, QString*);
+    // Cancels every retrieval of the specified owner without invoking the
+    // callbacks. A transfer that has no more waiters is aborted.
+    void cancel(void* owner);
 
-    bool retrieveIcon(
-        const QUrl& deviceLocation, const QUrl& iconUrl, QByteArray*);
+    // Aborts every transfer and invokes the callbacks with an error.
+    void abortAll();
 
-    bool retrieveDeviceDescription(const QUrl& deviceLocation, QString*);
+    // Returns the local endpoint advertised by the server of the specified URL
+    // in its latest response, if the server runs on the same host.
+    QString localServer(const QUrl&) const;
 };
 
 }
@@ -32,9 +32,11 @@
 
 #include "hcontrolpoint.h"
 #include "hdevicebuild_p.h"
+#include "hdevicemodel_snapshot.h"
 #include "hevent_subscriptionmanager_p.h"
 
 #include "../hdevicestorage_p.h"
+#include "../hmodelcreation_p.h"
 
 #include "../../devicemodel/client/hclientdevice.h"
 #include "../../devicemodel/client/hclientservice.h"
@@ -45,8 +47,12 @@
 #include "../../ssdp/hdiscovery_messages.h"
 
 #include "../../utils/hthreadpool_p.h"
+#include "../../utils/hdeadline_scheduler_p.h"
 
 #include <QtCore/QUuid>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QScopedPointer>
 #include <QtNetwork/QNetworkAccessManager>
 
@@ -56,6 +62,11 @@ namespace Herqq
 namespace Upnp
 {
 
+class HDataRetriever;
+class HServiceModelLoader;
+class HDefaultClientService;
+class HMulticastEventReceiver;
+class HMulticastNotifyRequest;
 class HControlPointPrivate;
 
 //
@@ -134,8 +145,19 @@ private Q_SLOTS:
 private:
 
     bool addRootDevice(HDefaultClientDevice*);
+
+    // subscribes to the evented services of the device tree. the models
+    // of the services that have not been loaded are loaded first.
     void subscribeToEvents(HDefaultClientDevice*);
 
+    // binds the services of the device tree to the devices hosted in this
+    // process, if any, or unbinds them
+    void bindLocally(HDefaultClientDevice*);
+
+    // connects the signals of the device tree that indicate a change
+    // to the device model to snapshotChanged()
+    void trackSnapshotChanges(HDefaultClientDevice*);
+
     void processDeviceOnline(HDefaultClientDevice*, bool newDevice);
 
     bool processDeviceOffline(
@@ -151,8 +173,16 @@ private:
 
 private Q_SLOTS:
 
-    void deviceExpired(HDefaultClientDevice* source);
+    void deviceExpired(void* source);
     void unsubscribed(Herqq::Upnp::HClientService*);
+    void multicastEventReceived(const Herqq::Upnp::HMulticastNotifyRequest&);
+    void serviceModelLoaded(Herqq::Upnp::HDefaultClientService*, bool success);
+
+    // schedules the publication of a new snapshot of the device model.
+    // the changes made before the control returns to the event loop are
+    // published together.
+    void snapshotChanged();
+    void publishSnapshot();
 
 public:
 
@@ -187,13 +217,47 @@ public:
 
     HThreadPool* m_threadPool;
 
+    HDeadlineScheduler* m_deviceExpirations;
+    // tracks the expiration of every root device with a single timer.
+    // the keys are HDefaultClientDevice instances.
+
+    HDataRetriever* m_dataRetriever;
+    // retrieves the device and service descriptions for the device builds
+
+    HServiceModelLoader* m_serviceModels;
+    // loads the models of the services when the models are built lazily
+
+    QList<QPointer<HDefaultClientService> > m_subscriptionsOnLoad;
+    // the services to subscribe to once their models have been loaded
+
+    HMulticastEventReceiver* m_multicastEvents;
+    // receives the UDA 2.0 multicast events sent by the discovered devices
+
     HDeviceStorage<HClientDevice, HClientService> m_deviceStorage;
 
+    mutable QMutex m_snapshotMutex;
+    HDeviceModelSnapshot m_snapshot;
+    // the latest snapshot of m_deviceStorage. the mutex guards only the copying
+    // of the handle; the snapshots themselves are never modified.
+
+    QAtomicInt m_snapshotVersion;
+    // the version of m_snapshot, readable without the mutex
+
+    bool m_snapshotPending;
+
     HControlPointPrivate();
     virtual ~HControlPointPrivate();
 
     HDefaultClientDevice* buildDevice(
-        const QUrl& deviceLocation, qint32 maxAge, QString* err);
+        const QUrl& deviceLocation, const QString& deviceDescription,
+        qint32 maxAge, const ServiceDescriptionFetcher&, const IconFetcher&,
+        QString* err);
+
+    // creates the actions and the state variables of a service whose model
+    // was not built with the device model
+    bool loadServiceModel(
+        HDefaultClientService*, const ServiceDescriptionFetcher&,
+        const IconFetcher&, QString* err);
 };
 
 }
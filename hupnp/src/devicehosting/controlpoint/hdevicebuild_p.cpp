@@ -21,10 +21,15 @@
 
 #include "hdevicebuild_p.h"
 #include "hcontrolpoint_p.h"
+#include "hcontrolpoint_configuration.h"
+#include "hcontrolpoint_dataretriever_p.h"
 
 #include "../../devicemodel/client/hdefault_clientdevice_p.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hupnp_global_p.h"
+
+#include <QtCore/QXmlStreamReader>
 
 namespace Herqq
 {
@@ -39,6 +44,8 @@ DeviceBuildTask::~DeviceBuildTask()
 {
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
 
+    m_owner->m_dataRetriever->cancel(this);
+
     if (m_createdDevice.data())
     {
         m_createdDevice->deleteLater();
@@ -52,6 +59,143 @@ HDefaultClientDevice* DeviceBuildTask::createdDevice()
     return m_createdDevice.take();
 }
 
+void DeviceBuildTask::fail(const QString& err)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    HLOG_WARN(QString("Couldn't create a device: %1").arg(err));
+
+    m_owner->m_dataRetriever->cancel(this);
+    m_pendingRetrievals = 0;
+
+    m_completionValue = -1;
+    m_errorString = err;
+
+    emit done(m_udn);
+}
+
+void DeviceBuildTask::start()
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    HLOG_DBG(QString(
+        "Attempting to fetch a device description from: [%1]").arg(
+            m_locations[0].toString()));
+
+    m_pendingRetrievals = 1;
+
+    m_owner->m_dataRetriever->retrieve(
+        HDataRetriever::resolveUrl(m_locations[0], QUrl()), this,
+        DataRetrievedCallback(this, &DeviceBuildTask::deviceDescriptionRetrieved));
+}
+
+void DeviceBuildTask::deviceDescriptionRetrieved(
+    const QUrl&, bool success, const QByteArray& data, const QString& err)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    --m_pendingRetrievals;
+
+    if (!success)
+    {
+        fail(err);
+        return;
+    }
+
+    m_deviceDescription = QString::fromUtf8(data);
+
+    if (m_owner->m_configuration->lazyServiceModels())
+    {
+        // the service descriptions are retrieved when the services are used
+        m_owner->m_threadPool->start(this);
+        return;
+    }
+
+    // The service descriptions are retrieved concurrently before the
+    // device model is built. Any errors in the device description are left
+    // for the model creator to report.
+    QUrl baseUrl = extractBaseUrl(m_locations[0]);
+
+    QXmlStreamReader reader(m_deviceDescription);
+    while(!reader.atEnd())
+    {
+        if (reader.readNext() != QXmlStreamReader::StartElement ||
+            reader.name() != QLatin1String("SCPDURL"))
+        {
+            continue;
+        }
+
+        QUrl scpdUrl = QUrl(reader.readElementText());
+        QUrl url = HDataRetriever::resolveUrl(baseUrl, scpdUrl);
+        if (m_serviceDescriptions.contains(url.toString()))
+        {
+            continue;
+        }
+
+        HLOG_DBG(QString(
+            "Attempting to fetch a service description for [%1] from: [%2]").arg(
+                scpdUrl.toString(), baseUrl.toString()));
+
+        m_serviceDescriptions.insert(url.toString(), QString());
+        ++m_pendingRetrievals;
+
+        m_owner->m_dataRetriever->retrieve(
+            url, this,
+            DataRetrievedCallback(
+                this, &DeviceBuildTask::serviceDescriptionRetrieved));
+    }
+
+    if (!m_pendingRetrievals)
+    {
+        m_owner->m_threadPool->start(this);
+    }
+}
+
+void DeviceBuildTask::serviceDescriptionRetrieved(
+    const QUrl& url, bool success, const QByteArray& data, const QString& err)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    --m_pendingRetrievals;
+
+    if (!success)
+    {
+        fail(QString(
+            "Could not retrieve service description from [%1]: %2").arg(
+                url.toString(), err));
+        return;
+    }
+
+    m_serviceDescriptions[url.toString()] = QString::fromUtf8(data);
+
+    if (!m_pendingRetrievals)
+    {
+        m_owner->m_threadPool->start(this);
+    }
+}
+
+bool DeviceBuildTask::serviceDescription(
+    const QUrl& deviceLocation, const QUrl& scpdUrl, QString* data)
+{
+    QHash<QString, QString>::const_iterator ci =
+        m_serviceDescriptions.constFind(
+            HDataRetriever::resolveUrl(deviceLocation, scpdUrl).toString());
+
+    if (ci == m_serviceDescriptions.constEnd())
+    {
+        return false;
+    }
+
+    *data = ci.value();
+    return true;
+}
+
+bool DeviceBuildTask::icon(const QUrl&, const QUrl&, QByteArray*)
+{
+    // the client side device model does not use icons
+    return false;
+}
+
 void DeviceBuildTask::run()
 {
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
@@ -59,7 +203,11 @@ void DeviceBuildTask::run()
     QString err;
     QScopedPointer<HDefaultClientDevice> device;
     device.reset(
-        m_owner->buildDevice(m_locations[0], m_cacheControlMaxAge, &err));
+        m_owner->buildDevice(
+            m_locations[0], m_deviceDescription, m_cacheControlMaxAge,
+            ServiceDescriptionFetcher(this, &DeviceBuildTask::serviceDescription),
+            IconFetcher(this, &DeviceBuildTask::icon),
+            &err));
     // the returned device is a fully built root device containing every
     // embedded device and service advertised in the device and service descriptions
     // otherwise, the creation failed
@@ -34,6 +34,7 @@
 #include "../../dataelements/hudn.h"
 #include "../../utils/hthreadpool_p.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
 
 namespace Herqq
@@ -47,8 +48,12 @@ class HControlPointPrivate;
 class HDefaultClientDevice;
 
 //
-// This class is used as a thread pool task to fetch a device description, its
-// accompanying service descriptions (if any) and to build the device model.
+// This class is used to fetch a device description and its accompanying
+// service descriptions (if any) and to build the device model.
+//
+// The descriptions are retrieved asynchronously in the thread of the control
+// point. Once every description is available, the class is run as a thread pool
+// task that builds the device model.
 //
 class DeviceBuildTask :
     public HRunnable
@@ -71,6 +76,29 @@ private:
     const HUdn m_udn;
     const qint32 m_cacheControlMaxAge;
 
+    const qint32 m_bootId;
+    const qint32 m_configId;
+    // the values announced by the device, -1 when not specified
+
+    QString m_deviceDescription;
+    QHash<QString, QString> m_serviceDescriptions;
+    // keyed by the URL of the service description
+
+    qint32 m_pendingRetrievals;
+
+    void fail(const QString& err);
+
+    void deviceDescriptionRetrieved(
+        const QUrl&, bool, const QByteArray&, const QString&);
+
+    void serviceDescriptionRetrieved(
+        const QUrl&, bool, const QByteArray&, const QString&);
+
+    bool serviceDescription(
+        const QUrl& deviceLocation, const QUrl& scpdUrl, QString*);
+
+    bool icon(const QUrl& deviceLocation, const QUrl& iconUrl, QByteArray*);
+
 public:
 
     QList<QUrl> m_locations;
@@ -83,6 +111,11 @@ public:
             m_createdDevice(0),
             m_udn(msg.usn().udn()),
             m_cacheControlMaxAge(msg.cacheControlMaxAge()),
+            m_bootId(msg.bootId()),
+            m_configId(msg.configId()),
+            m_deviceDescription(),
+            m_serviceDescriptions(),
+            m_pendingRetrievals(0),
             m_locations()
     {
         m_locations.append(msg.location());
@@ -91,10 +124,17 @@ public:
     virtual ~DeviceBuildTask();
     // deletes the created device if it has not been retrieved
 
+    void start();
+    // starts retrieving the descriptions
+
     virtual void run();
+    // builds the device model of the retrieved descriptions
 
     inline HUdn udn() const { return m_udn; }
 
+    inline qint32 bootId() const { return m_bootId; }
+    inline qint32 configId() const { return m_configId; }
+
     inline qint32 completionValue() const { return m_completionValue; }
 
     inline QString errorString() const { return m_errorString; }
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hdevicemodel_snapshot.h"
+#include "hdevicemodel_snapshot_p.h"
+
+#include "../../devicemodel/client/hclientservice.h"
+#include "../../devicemodel/client/hclientstatevariable.h"
+#include "../../devicemodel/client/hdefault_clientdevice_p.h"
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+/*******************************************************************************
+ * HServiceSnapshot
+ ******************************************************************************/
+HServiceSnapshot::HServiceSnapshot() :
+    m_info(), m_values()
+{
+}
+
+/*******************************************************************************
+ * HDeviceSnapshot
+ ******************************************************************************/
+HDeviceSnapshot::HDeviceSnapshot() :
+    m_info(), m_locations(), m_parentUdn(), m_embeddedDevices(), m_services(),
+    m_online(false)
+{
+}
+
+HServiceSnapshot HDeviceSnapshot::service(const HServiceId& serviceId) const
+{
+    for(qint32 i = 0; i < m_services.size(); ++i)
+    {
+        if (m_services[i].info().serviceId() == serviceId)
+        {
+            return m_services[i];
+        }
+    }
+
+    return HServiceSnapshot();
+}
+
+/*******************************************************************************
+ * HDeviceModelSnapshotPrivate
+ ******************************************************************************/
+HDeviceModelSnapshotPrivate::HDeviceModelSnapshotPrivate() :
+    m_version(0), m_devices(), m_rootDevices(), m_devicesByUdn()
+{
+}
+
+/*******************************************************************************
+ * HDeviceModelSnapshotBuilder
+ ******************************************************************************/
+void HDeviceModelSnapshotBuilder::addDevice(
+    HDeviceModelSnapshotPrivate* snapshot, const HClientDevice* device)
+{
+    const HDefaultClientDevice* defaultDevice =
+        static_cast<const HDefaultClientDevice*>(device);
+
+    HDeviceSnapshot deviceSnapshot;
+    deviceSnapshot.m_info = device->info();
+    deviceSnapshot.m_locations = device->locations();
+    deviceSnapshot.m_online = defaultDevice->deviceStatus()->online();
+
+    if (device->parentDevice())
+    {
+        deviceSnapshot.m_parentUdn = device->parentDevice()->info().udn();
+    }
+
+    foreach(const HClientService* service, device->services())
+    {
+        HServiceSnapshot serviceSnapshot;
+        serviceSnapshot.m_info = service->info();
+
+        if (!service->isModelLoaded())
+        {
+            // the model is not loaded only to take a snapshot
+            deviceSnapshot.m_services.append(serviceSnapshot);
+            continue;
+        }
+
+        const HClientStateVariables& stateVars = service->stateVariables();
+        HClientStateVariables::const_iterator ci = stateVars.constBegin();
+        for(; ci != stateVars.constEnd(); ++ci)
+        {
+            serviceSnapshot.m_values.insert(ci.key(), ci.value()->value());
+        }
+
+        deviceSnapshot.m_services.append(serviceSnapshot);
+    }
+
+    HClientDevices embeddedDevices = device->embeddedDevices();
+    foreach(const HClientDevice* embeddedDevice, embeddedDevices)
+    {
+        deviceSnapshot.m_embeddedDevices.append(embeddedDevice->info().udn());
+    }
+
+    snapshot->m_devicesByUdn.insert(
+        deviceSnapshot.m_info.udn(), snapshot->m_devices.size());
+
+    snapshot->m_devices.append(deviceSnapshot);
+
+    foreach(const HClientDevice* embeddedDevice, embeddedDevices)
+    {
+        addDevice(snapshot, embeddedDevice);
+    }
+}
+
+HDeviceModelSnapshot HDeviceModelSnapshotBuilder::build(
+    const HClientDevices& rootDevices, qint32 version)
+{
+    HDeviceModelSnapshot retVal;
+
+    HDeviceModelSnapshotPrivate* snapshot = retVal.h_ptr.data();
+    snapshot->m_version = version;
+
+    foreach(const HClientDevice* rootDevice, rootDevices)
+    {
+        snapshot->m_rootDevices.append(snapshot->m_devices.size());
+        addDevice(snapshot, rootDevice);
+    }
+
+    return retVal;
+}
+
+/*******************************************************************************
+ * HDeviceModelSnapshot
+ ******************************************************************************/
+HDeviceModelSnapshot::HDeviceModelSnapshot() :
+    h_ptr(new HDeviceModelSnapshotPrivate())
+{
+}
+
+HDeviceModelSnapshot::HDeviceModelSnapshot(const HDeviceModelSnapshot& other) :
+    h_ptr(other.h_ptr)
+{
+}
+
+HDeviceModelSnapshot& HDeviceModelSnapshot::operator=(
+    const HDeviceModelSnapshot& other)
+{
+    h_ptr = other.h_ptr;
+    return *this;
+}
+
+HDeviceModelSnapshot::~HDeviceModelSnapshot()
+{
+}
+
+qint32 HDeviceModelSnapshot::version() const
+{
+    return h_ptr->m_version;
+}
+
+bool HDeviceModelSnapshot::isEmpty() const
+{
+    return h_ptr->m_devices.isEmpty();
+}
+
+QList<HDeviceSnapshot> HDeviceModelSnapshot::rootDevices() const
+{
+    QList<HDeviceSnapshot> retVal;
+    foreach(qint32 index, h_ptr->m_rootDevices)
+    {
+        retVal.append(h_ptr->m_devices[index]);
+    }
+
+    return retVal;
+}
+
+const QList<HDeviceSnapshot>& HDeviceModelSnapshot::devices() const
+{
+    return h_ptr->m_devices;
+}
+
+HDeviceSnapshot HDeviceModelSnapshot::device(const HUdn& udn) const
+{
+    qint32 index = h_ptr->m_devicesByUdn.value(udn, -1);
+    return index < 0 ? HDeviceSnapshot() : h_ptr->m_devices[index];
+}
+
+}
+}
@@ -0,0 +1,317 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HDEVICEMODEL_SNAPSHOT_H_
+#define HDEVICEMODEL_SNAPSHOT_H_
+
+#include <HUpnpCore/HUdn>
+#include <HUpnpCore/HServiceId>
+#include <HUpnpCore/HDeviceInfo>
+#include <HUpnpCore/HServiceInfo>
+
+#include <QtCore/QUrl>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QSharedDataPointer>
+
+/*!
+ * \file
+ * This file contains the types used to read the device model of a control
+ * point from any thread.
+ */
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+class HDeviceModelSnapshotBuilder;
+class HDeviceModelSnapshotPrivate;
+
+/*!
+ * \brief This class contains the state of a service at the time a
+ * HDeviceModelSnapshot was taken.
+ *
+ * \headerfile hdevicemodel_snapshot.h HServiceSnapshot
+ *
+ * \ingroup hupnp_devicehosting
+ *
+ * \sa HDeviceSnapshot, HClientService
+ */
+class H_UPNP_CORE_EXPORT HServiceSnapshot
+{
+friend class HDeviceModelSnapshotBuilder;
+
+private:
+
+    HServiceInfo m_info;
+    QHash<QString, QVariant> m_values;
+
+public:
+
+    /*!
+     * \brief Creates a new, invalid instance.
+     */
+    HServiceSnapshot();
+
+    /*!
+     * \brief Returns information about the service.
+     *
+     * \return information about the service read from the device description.
+     */
+    inline const HServiceInfo& info() const { return m_info; }
+
+    /*!
+     * \brief Returns the values of the state variables of the service.
+     *
+     * \return The values of the state variables of the service. The keys are
+     * the names of the state variables. The values are empty when the model
+     * of the service had not been loaded, see HClientService::isModelLoaded().
+     */
+    inline const QHash<QString, QVariant>& values() const { return m_values; }
+
+    /*!
+     * \brief Returns the value of the specified state variable.
+     *
+     * \param stateVarName specifies the name of the state variable.
+     *
+     * \return The value of the specified state variable, or an invalid
+     * \c QVariant in case the service has no such state variable.
+     */
+    inline QVariant value(const QString& stateVarName) const
+    {
+        return m_values.value(stateVarName);
+    }
+
+    /*!
+     * \brief Indicates whether the object is valid.
+     *
+     * \return \e true in case the object is valid.
+     */
+    inline bool isValid() const { return m_info.isValid(LooseChecks); }
+};
+
+/*!
+ * \brief This class contains the state of a device at the time a
+ * HDeviceModelSnapshot was taken.
+ *
+ * \headerfile hdevicemodel_snapshot.h HDeviceSnapshot
+ *
+ * \ingroup hupnp_devicehosting
+ *
+ * \sa HDeviceModelSnapshot, HClientDevice
+ */
+class H_UPNP_CORE_EXPORT HDeviceSnapshot
+{
+friend class HDeviceModelSnapshotBuilder;
+
+private:
+
+    HDeviceInfo m_info;
+    QList<QUrl> m_locations;
+    HUdn m_parentUdn;
+    QList<HUdn> m_embeddedDevices;
+    QList<HServiceSnapshot> m_services;
+    bool m_online;
+
+public:
+
+    /*!
+     * \brief Creates a new, invalid instance.
+     *
+     * \sa isValid()
+     */
+    HDeviceSnapshot();
+
+    /*!
+     * \brief Returns information about the device.
+     *
+     * \return information about the device read from the device description.
+     */
+    inline const HDeviceInfo& info() const { return m_info; }
+
+    /*!
+     * \brief Returns the locations where the device description of the
+     * device tree is available.
+     *
+     * \return The locations where the device description of the device tree
+     * is available.
+     */
+    inline const QList<QUrl>& locations() const { return m_locations; }
+
+    /*!
+     * \brief Returns the UDN of the parent device.
+     *
+     * \return The UDN of the parent device, or an invalid UDN in case the
+     * device is a root device.
+     */
+    inline const HUdn& parentUdn() const { return m_parentUdn; }
+
+    /*!
+     * \brief Returns the UDNs of the embedded devices of the device.
+     *
+     * \return The UDNs of the embedded devices of the device. Use
+     * HDeviceModelSnapshot::device() to retrieve the embedded devices.
+     */
+    inline const QList<HUdn>& embeddedDevices() const { return m_embeddedDevices; }
+
+    /*!
+     * \brief Returns the services of the device.
+     *
+     * \return The services of the device.
+     */
+    inline const QList<HServiceSnapshot>& services() const { return m_services; }
+
+    /*!
+     * \brief Returns the service that has the specified service ID.
+     *
+     * \param serviceId specifies the service ID of the service.
+     *
+     * \return The service that has the specified service ID, or an invalid
+     * object in case the device has no such service.
+     */
+    HServiceSnapshot service(const HServiceId& serviceId) const;
+
+    /*!
+     * \brief Indicates whether the device tree was online.
+     *
+     * \return \e true in case the device tree was online.
+     */
+    inline bool online() const { return m_online; }
+
+    /*!
+     * \brief Indicates whether the object is valid.
+     *
+     * \return \e true in case the object is valid.
+     */
+    inline bool isValid() const { return m_info.isValid(LooseChecks); }
+};
+
+/*!
+ * \brief This class is an immutable copy of the device model of a
+ * control point.
+ *
+ * HControlPoint and the HClientDevice instances it owns have to be used from
+ * the thread in which they live. A snapshot can be read from any thread
+ * without locks: the control point builds a new snapshot whenever its device
+ * model changes and publishes it atomically, while the readers of the previous
+ * snapshot continue to use it undisturbed. A snapshot is freed once the
+ * last copy of it is destroyed.
+ *
+ * \headerfile hdevicemodel_snapshot.h HDeviceModelSnapshot
+ *
+ * \ingroup hupnp_devicehosting
+ *
+ * \remarks This class is implicitly shared and copying an instance is
+ * cheap. The copies of an instance can be read from several threads
+ * simultaneously.
+ *
+ * \sa HControlPoint::snapshot(), HControlPoint::snapshotVersion()
+ */
+class H_UPNP_CORE_EXPORT HDeviceModelSnapshot
+{
+friend class HDeviceModelSnapshotBuilder;
+
+private:
+
+    QSharedDataPointer<HDeviceModelSnapshotPrivate> h_ptr;
+
+public:
+
+    /*!
+     * \brief Creates a new, empty instance.
+     *
+     * \sa isEmpty()
+     */
+    HDeviceModelSnapshot();
+
+    /*!
+     * \brief Copy constructor.
+     *
+     * Creates a shallow copy of \c other.
+     */
+    HDeviceModelSnapshot(const HDeviceModelSnapshot& other);
+
+    /*!
+     * \brief Assignment operator.
+     *
+     * Makes this object a shallow copy of \c other.
+     */
+    HDeviceModelSnapshot& operator=(const HDeviceModelSnapshot& other);
+
+    /*!
+     * \brief Destroys the instance.
+     */
+    ~HDeviceModelSnapshot();
+
+    /*!
+     * \brief Returns the version of the snapshot.
+     *
+     * \return The version of the snapshot. The version is incremented every
+     * time the control point publishes a new snapshot, which means that
+     * two snapshots of a control point that have the same version
+     * are identical.
+     *
+     * \sa HControlPoint::snapshotVersion()
+     */
+    qint32 version() const;
+
+    /*!
+     * \brief Indicates whether the snapshot contains any devices.
+     *
+     * \return \e true in case the snapshot contains no devices.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Returns the root devices.
+     *
+     * \return The root devices in the order the control point
+     * discovered them.
+     */
+    QList<HDeviceSnapshot> rootDevices() const;
+
+    /*!
+     * \brief Returns the root and embedded devices.
+     *
+     * \return The root and embedded devices. Each root device is followed
+     * by its embedded devices.
+     */
+    const QList<HDeviceSnapshot>& devices() const;
+
+    /*!
+     * \brief Returns the device that has the specified UDN.
+     *
+     * \param udn specifies the UDN of the device.
+     *
+     * \return The device that has the specified UDN, or an invalid object in
+     * case the snapshot contains no such device.
+     */
+    HDeviceSnapshot device(const HUdn& udn) const;
+};
+
+}
+}
+
+#endif /* HDEVICEMODEL_SNAPSHOT_H_ */
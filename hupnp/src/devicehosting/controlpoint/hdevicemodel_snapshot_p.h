@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HDEVICEMODEL_SNAPSHOT_P_H_
+#define HDEVICEMODEL_SNAPSHOT_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "hdevicemodel_snapshot.h"
+
+#include "../../general/hupnp_fwd.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QSharedData>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+//
+// Implementation details of HDeviceModelSnapshot
+//
+class HDeviceModelSnapshotPrivate :
+    public QSharedData
+{
+HDeviceModelSnapshotPrivate& operator=(const HDeviceModelSnapshotPrivate&);
+
+public:
+
+    qint32 m_version;
+
+    QList<HDeviceSnapshot> m_devices;
+    // the root devices, each followed by its embedded devices
+
+    QList<qint32> m_rootDevices;
+    // the indices of the root devices in m_devices
+
+    QHash<HUdn, qint32> m_devicesByUdn;
+    // the indices of the devices in m_devices
+
+    HDeviceModelSnapshotPrivate();
+};
+
+//
+// Copies the state of a client-side device model into a snapshot.
+// This has to be used in the thread in which the devices live.
+//
+class HDeviceModelSnapshotBuilder
+{
+private:
+
+    static void addDevice(
+        HDeviceModelSnapshotPrivate*, const HClientDevice*);
+
+public:
+
+    static HDeviceModelSnapshot build(
+        const HClientDevices& rootDevices, qint32 version);
+};
+
+}
+}
+
+#endif /* HDEVICEMODEL_SNAPSHOT_P_H_ */
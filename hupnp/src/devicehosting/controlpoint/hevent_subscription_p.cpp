@@ -23,9 +23,15 @@
 
 #include "../../devicemodel/client/hclientdevice.h"
 #include "../../devicemodel/client/hdefault_clientservice_p.h"
+#include "../../devicemodel/server/hserverservice.h"
+#include "../../devicemodel/server/hserverstatevariable.h"
+#include "../../devicemodel/hstatevariable_event.h"
+#include "../../dataelements/hserviceid.h"
+#include "../../dataelements/hstatevariableinfo.h"
 
 #include "../../dataelements/hserviceinfo.h"
 
+#include "../../http/hhttp_utils_p.h"
 #include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hlogger_p.h"
@@ -37,100 +43,490 @@ namespace Herqq
 namespace Upnp
 {
 
+/*******************************************************************************
+ * HEventSubscriptionChannel
+ ******************************************************************************/
+HEventSubscriptionChannel::HEventSubscriptionChannel(
+    const QByteArray& loggingIdentifier, const QList<QUrl>& deviceLocations,
+    QObject* parent) :
+        QObject(parent),
+            m_loggingIdentifier(loggingIdentifier),
+            m_deviceLocations(deviceLocations),
+            m_nextLocationToTry(0),
+            m_connectErrorCount(0),
+            m_socket(this),
+            m_http(loggingIdentifier, this),
+            m_subscriptions(),
+            m_queue(),
+            m_current(0),
+            m_requestInProgress(false),
+            m_localServer(),
+            m_local(false)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    Q_ASSERT(m_deviceLocations.size() > 0);
+    for(qint32 i = 0; i < m_deviceLocations.size(); ++i)
+    {
+        Q_ASSERT(!m_deviceLocations[i].isEmpty());
+        Q_ASSERT_X(m_deviceLocations[i].isValid(), H_AT,
+                   m_deviceLocations[i].toString().toLocal8Bit());
+    }
+
+    bool ok = connect(&m_socket, SIGNAL(connected()), this, SLOT(connected()));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        &m_http, SIGNAL(msgIoComplete(HHttpAsyncOperation*)),
+        this, SLOT(msgIoComplete(HHttpAsyncOperation*)),
+        Qt::DirectConnection);
+
+    Q_ASSERT(ok);
+}
+
+HEventSubscriptionChannel::~HEventSubscriptionChannel()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    Q_ASSERT(m_subscriptions.isEmpty());
+}
+
+void HEventSubscriptionChannel::attach(HEventSubscription* sub)
+{
+    Q_ASSERT(sub);
+    if (!m_subscriptions.contains(sub))
+    {
+        m_subscriptions.append(sub);
+    }
+}
+
+void HEventSubscriptionChannel::detach(HEventSubscription* sub)
+{
+    cancel(sub);
+    m_subscriptions.removeAll(sub);
+}
+
+void HEventSubscriptionChannel::cancel(HEventSubscription* sub)
+{
+    m_queue.removeAll(sub);
+    if (m_current == sub)
+    {
+        // the response to the request in progress is ignored, but the
+        // channel stays busy until it has been received
+        m_current = 0;
+    }
+}
+
+void HEventSubscriptionChannel::enqueue(
+    HEventSubscription* sub, qint32 msecsToWait)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    Q_ASSERT(m_subscriptions.contains(sub));
+
+    if (m_current != sub && !m_queue.contains(sub))
+    {
+        m_queue.append(sub);
+    }
+
+    if (msecsToWait > 0 && m_socket.state() != QTcpSocket::ConnectedState)
+    {
+        connectToDevice(msecsToWait);
+    }
+
+    sendNext();
+}
+
+bool HEventSubscriptionChannel::connectToDevice(qint32 msecsToWait)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    switch(m_socket.state())
+    {
+    case QTcpSocket::ConnectedState:
+        return true;
+
+    case QTcpSocket::HostLookupState:
+    case QTcpSocket::ConnectingState:
+        if (msecsToWait > 0)
+        {
+            m_socket.waitForConnected(msecsToWait);
+        }
+        return m_socket.state() == QTcpSocket::ConnectedState;
+
+    case QTcpSocket::UnconnectedState:
+        break;
+
+    default:
+        // the connection is being closed, most likely after the device
+        // indicated that it does not keep the connection alive.
+        m_socket.abort();
+        break;
+    }
+
+    if (!m_localServer.isEmpty())
+    {
+        // connecting to a local endpoint completes immediately
+        if (HHttpUtils::connectToLocalServer(m_socket, m_localServer))
+        {
+            m_local = true;
+            m_connectErrorCount = 0;
+            return true;
+        }
+
+        HLOG_WARN(QString(
+            "Cannot connect to the local endpoint [%1]. Using [%2] instead.").arg(
+                m_localServer, urlsAsStr(m_deviceLocations)));
+
+        m_localServer.clear();
+    }
+
+    m_local = false;
+
+    QUrl lastLoc = m_deviceLocations[m_nextLocationToTry];
+
+    bool ok = connect(
+        &m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(error(QAbstractSocket::SocketError)));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_socket.connectToHost(lastLoc.host(), lastLoc.port());
+    if (msecsToWait > 0)
+    {
+        m_socket.waitForConnected(msecsToWait);
+    }
+
+    return m_socket.state() == QTcpSocket::ConnectedState;
+}
+
+void HEventSubscriptionChannel::connected()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    bool ok = disconnect(
+        &m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(error(QAbstractSocket::SocketError)));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_connectErrorCount = 0;
+    sendNext();
+}
+
+void HEventSubscriptionChannel::error(QAbstractSocket::SocketError /*err*/)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    // this can be called only when connecting to host
+
+    bool ok = disconnect(
+        &m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(error(QAbstractSocket::SocketError)));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    if (++m_connectErrorCount >= m_deviceLocations.size() * 2)
+    {
+        HLOG_WARN(QString("Could not connect to the device @ [%1]: %2").arg(
+            urlsAsStr(m_deviceLocations), m_socket.errorString()));
+
+        m_connectErrorCount = 0;
+        failAll();
+        return;
+    }
+
+    if (m_nextLocationToTry >= m_deviceLocations.size() - 1)
+    {
+        m_nextLocationToTry = 0;
+    }
+    else
+    {
+        ++m_nextLocationToTry;
+    }
+
+    connectToDevice(0);
+}
+
+void HEventSubscriptionChannel::failAll()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    while(!m_queue.isEmpty())
+    {
+        m_queue.takeFirst()->requestFailed();
+    }
+}
+
+void HEventSubscriptionChannel::sendNext()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    while(!m_requestInProgress && !m_queue.isEmpty())
+    {
+        if (!connectToDevice(0))
+        {
+            // the queue is processed once the connection is established
+            return;
+        }
+
+        HEventSubscription* sub = m_queue.takeFirst();
+
+        HMessagingInfo* mi = new HMessagingInfo(m_socket, true);
+        QByteArray data =
+            sub->createRequest(m_deviceLocations[m_nextLocationToTry], mi);
+
+        if (data.isEmpty())
+        {
+            delete mi;
+            continue;
+        }
+
+        m_current = sub;
+        m_requestInProgress = true;
+        if (!m_http.msgIo(mi, data))
+        {
+            m_current = 0;
+            m_requestInProgress = false;
+            m_socket.abort();
+            sub->requestFailed();
+        }
+    }
+
+    if (!m_requestInProgress && m_queue.isEmpty() &&
+        m_socket.state() == QTcpSocket::ConnectedState)
+    {
+        m_socket.disconnectFromHost();
+    }
+}
+
+void HEventSubscriptionChannel::msgIoComplete(HHttpAsyncOperation* op)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    Q_ASSERT(op);
+
+    HEventSubscription* sub = m_current;
+    m_current = 0;
+    m_requestInProgress = false;
+
+    if (op->state() == HHttpAsyncOperation::Failed)
+    {
+        m_socket.abort();
+    }
+    else if (!op->messagingInfo()->keepAlive())
+    {
+        m_socket.disconnectFromHost();
+    }
+
+    if (sub)
+    {
+        sub->requestDone(op);
+    }
+
+    delete op;
+
+    sendNext();
+}
+
 /*******************************************************************************
  * HEventSubscription definition
  ******************************************************************************/
 HEventSubscription::HEventSubscription(
     const QByteArray& loggingIdentifier, HClientService* service,
-    const QUrl& serverRootUrl, const HTimeout& desiredTimeout, QObject* parent) :
+    const QUrl& serverRootUrl, const QString& localServerName,
+    const HTimeout& desiredTimeout, HEventSubscriptionChannel* channel,
+    QObject* parent) :
         QObject(parent),
             m_loggingIdentifier(loggingIdentifier),
             m_randomIdentifier (QUuid::createUuid()),
-            m_deviceLocations(),
-            m_nextLocationToTry(0),
             m_eventUrl(),
-            m_connectErrorCount(0),
             m_sid(),
             m_seq(0),
             m_desiredTimeout(desiredTimeout),
             m_timeout(),
-            m_subscriptionTimer(this),
             m_announcementTimer(this),
             m_announcementTimedOut(false),
             m_service(service),
             m_serverRootUrl(serverRootUrl),
-            m_http(loggingIdentifier, this),
-            m_socket(this),
+            m_localServerName(localServerName),
+            m_channel(channel),
             m_currentOpType(Op_None),
             m_nextOpType(Op_None),
-            m_subscribed(false)
+            m_subscribed(false),
+            m_localService()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
     Q_ASSERT(m_service);
+    Q_ASSERT(m_channel);
     Q_ASSERT(!m_serverRootUrl.isEmpty());
     Q_ASSERT_X(m_serverRootUrl.isValid(), H_AT,
              m_serverRootUrl.toString().toLocal8Bit());
 
-    m_deviceLocations = service->parentDevice()->locations();
+    bool ok = connect(
+        &m_announcementTimer, SIGNAL(timeout()),
+        this, SLOT(announcementTimeout()));
 
-    Q_ASSERT(m_deviceLocations.size() > 0);
-    for(qint32 i = 0; i < m_deviceLocations.size(); ++i)
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    m_channel->attach(this);
+}
+
+HEventSubscription::~HEventSubscription()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    m_channel->detach(this);
+}
+
+void HEventSubscription::announcementTimeout()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    m_announcementTimedOut = true;
+}
+
+void HEventSubscription::localSubscribe()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    if (m_currentOpType != Op_Subscribe || m_subscribed)
     {
-        Q_ASSERT(!m_deviceLocations[i].isEmpty());
-        Q_ASSERT_X(m_deviceLocations[i].isValid(), H_AT,
-                   m_deviceLocations[i].toString().toLocal8Bit());
+        // the subscription was reset before this was run
+        return;
+    }
+
+    if (!m_localService || m_localService->thread() != thread())
+    {
+        // the device host was shut down or moved to another thread
+        m_localService = 0;
+        m_channel->enqueue(this);
+        return;
+    }
+
+    // the current values of the evented state variables make up the
+    // initial event, just like with GENA
+    QList<QPair<QString, QVariant> > values;
+    foreach(HServerStateVariable* sv, m_localService->stateVariables())
+    {
+        if (sv->info().eventingType() == HStateVariableInfo::NoEvents)
+        {
+            continue;
+        }
+
+        bool ok = connect(
+            sv,
+            SIGNAL(valueChanged(
+                Herqq::Upnp::HServerStateVariable*,
+                const Herqq::Upnp::HStateVariableEvent&)),
+            this,
+            SLOT(localValueChanged(
+                Herqq::Upnp::HServerStateVariable*,
+                const Herqq::Upnp::HStateVariableEvent&)));
+
+        Q_ASSERT(ok); Q_UNUSED(ok)
+
+        values.append(qMakePair(sv->info().name(), sv->value()));
     }
 
     bool ok = connect(
-        &m_subscriptionTimer, SIGNAL(timeout()),
-        this, SLOT(subscriptionTimeout()));
+        m_localService, SIGNAL(destroyed()), this, SLOT(localServiceDestroyed()));
 
     Q_ASSERT(ok); Q_UNUSED(ok)
 
-    ok = connect(
-        &m_announcementTimer, SIGNAL(timeout()),
-        this, SLOT(announcementTimeout()));
+    m_seq = 0;
+    m_subscribed = true;
+    m_timeout = HTimeout();
+    // the subscription lasts as long as the service exists and thus
+    // it is never renewed
 
-    Q_ASSERT(ok);
+    HLOG_DBG(QString("Subscribed to [%1] in process.").arg(
+        m_service->info().serviceId().toString()));
 
-    ok = connect(&m_socket, SIGNAL(connected()), this, SLOT(connected()));
+    static_cast<HDefaultClientService*>(m_service)->updateVariables(values, false);
 
-    Q_ASSERT(ok);
+    emit subscribed(this);
 
-    ok = connect(
-        &m_http, SIGNAL(msgIoComplete(HHttpAsyncOperation*)),
-        this, SLOT(msgIoComplete(HHttpAsyncOperation*)),
-        Qt::DirectConnection);
+    if (m_nextOpType != Op_None)
+    {
+        m_currentOpType = m_nextOpType;
+        m_nextOpType = Op_None;
 
-    Q_ASSERT(ok);
+        runNextOp();
+    }
+    else
+    {
+        m_currentOpType = Op_None;
+    }
 }
 
-HEventSubscription::~HEventSubscription()
+void HEventSubscription::localUnsubscribed()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    if (m_currentOpType != Op_Unsubscribe)
+    {
+        return;
+    }
+
+    resetSubscription();
+    emit unsubscribed(this);
 }
 
-void HEventSubscription::subscriptionTimeout()
+void HEventSubscription::localServiceDestroyed()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    m_subscriptionTimer.stop();
+    // the state variables of the service have been disconnected already
+    m_localService = 0;
 
-    if (m_sid.isEmpty())
+    if (!m_subscribed || !m_sid.isEmpty() || m_currentOpType != Op_None)
     {
-        subscribe();
+        return;
     }
-    else
+
+    HLOG_DBG(QString(
+        "In-process service [%1] was deleted. Subscribing over the network.").arg(
+            m_service->info().serviceId().toString()));
+
+    // the device may still be reachable over the network, such as when the
+    // device host was restarted. if it is not, the subscription request
+    // fails and subscriptionFailed() is emitted.
+    m_seq = 0;
+    m_subscribed = false;
+    m_timeout = HTimeout();
+
+    m_currentOpType = Op_Subscribe;
+    m_channel->enqueue(this);
+}
+
+void HEventSubscription::localValueChanged(
+    Herqq::Upnp::HServerStateVariable* source,
+    const Herqq::Upnp::HStateVariableEvent& event)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    QList<QPair<QString, QVariant> > values;
+    values.append(qMakePair(source->info().name(), event.newValue()));
+
+    if (!static_cast<HDefaultClientService*>(m_service)->updateVariables(values, true))
     {
-        renewSubscription();
+        HLOG_WARN(QString("State variable [%1] was not updated.").arg(
+            source->info().name()));
     }
 }
 
-void HEventSubscription::announcementTimeout()
+void HEventSubscription::disconnectLocalService()
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-    m_announcementTimedOut = true;
+    if (m_localService)
+    {
+        foreach(HServerStateVariable* sv, m_localService->stateVariables())
+        {
+            sv->disconnect(this);
+        }
+
+        m_localService->disconnect(this);
+        m_localService = 0;
+    }
 }
 
 void HEventSubscription::resetSubscription()
@@ -141,16 +537,12 @@ void HEventSubscription::resetSubscription()
     m_sid = HSid();
     m_eventUrl = QUrl();
     m_timeout = HTimeout();
-    m_nextLocationToTry = 0;
     m_currentOpType = Op_None;
+    m_nextOpType = Op_None;
     m_subscribed = false;
-    m_connectErrorCount = 0;
-    m_subscriptionTimer.stop();
 
-    if (m_socket.state() == QAbstractSocket::ConnectedState)
-    {
-        m_socket.disconnectFromHost();
-    }
+    disconnectLocalService();
+    m_channel->cancel(this);
 }
 
 void HEventSubscription::runNextOp()
@@ -179,21 +571,103 @@ void HEventSubscription::runNextOp()
     };
 }
 
-void HEventSubscription::connected()
+QByteArray HEventSubscription::createRequest(
+    const QUrl& deviceLocation, HMessagingInfo* mi)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    bool ok = disconnect(
-        &m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
-        this, SLOT(error(QAbstractSocket::SocketError)));
+    QUrl eventUrl = resolveUri(
+        extractBaseUrl(deviceLocation), m_service->info().eventSubUrl());
 
-    Q_ASSERT(ok); Q_UNUSED(ok)
+    mi->setHostInfo(eventUrl);
 
-    m_connectErrorCount = 0;
-    runNextOp();
+    switch(m_currentOpType)
+    {
+    case Op_Subscribe:
+    {
+        m_eventUrl = eventUrl;
+
+        HLOG_DBG(QString("Attempting to subscribe to [%1]").arg(
+            m_eventUrl.toString()));
+
+        HSubscribeRequest req(
+            m_eventUrl,
+            HSysInfo::instance().herqqProductTokens(),
+            m_serverRootUrl.toString().append("/").append(
+                m_randomIdentifier.toString().remove('{').remove('}')),
+            m_desiredTimeout);
+
+        if (m_channel->isLocal())
+        {
+            // the device host runs on the same host and it may deliver the
+            // events through the local endpoint of this control point as well
+            req.setLocalServer(m_localServerName);
+        }
+
+        return HHttpMessageCreator::create(req, *mi);
+    }
+
+    case Op_Renew:
+    {
+        HLOG_DBG(QString("Renewing subscription [sid: %1].").arg(
+            m_sid.toString()));
+
+        HSubscribeRequest req(eventUrl, m_sid, m_desiredTimeout);
+        return HHttpMessageCreator::create(req, *mi);
+    }
+
+    case Op_Unsubscribe:
+    {
+        m_eventUrl = eventUrl;
+
+        HLOG_DBG(QString(
+            "Attempting to cancel event subscription from [%1]").arg(
+                m_eventUrl.toString()));
+
+        HUnsubscribeRequest req(m_eventUrl, m_sid);
+        return HHttpMessageCreator::create(req, mi);
+    }
+
+    default:
+        return QByteArray();
+    }
 }
 
-void HEventSubscription::msgIoComplete(HHttpAsyncOperation* op)
+void HEventSubscription::requestFailed()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    switch(m_currentOpType)
+    {
+    case Op_Subscribe:
+    case Op_Renew:
+        HLOG_WARN(QString(
+            "Failed to send an event subscription request to [%1]").arg(
+                urlsAsStr(m_channel->deviceLocations())));
+
+        m_currentOpType = Op_None;
+        emit subscriptionFailed(this);
+        break;
+
+    case Op_Unsubscribe:
+        // if the unsubscription "failed", there's nothing much to do, but to log
+        // the error. UPnP has expiration mechanism for events and thus even if
+        // the device did not receive the request, eventually the subscription
+        // will expire.
+        HLOG_WARN(QString(
+            "Failed to send a subscription cancellation to [%1]").arg(
+                urlsAsStr(m_channel->deviceLocations())));
+
+        resetSubscription();
+        emit unsubscribed(this);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void HEventSubscription::requestDone(HHttpAsyncOperation* op)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
@@ -218,13 +692,6 @@ void HEventSubscription::msgIoComplete(HHttpAsyncOperation* op)
         break;
     };
 
-    if (m_socket.state() == QTcpSocket::ConnectedState)
-    {
-        m_socket.disconnectFromHost();
-    }
-
-    delete op;
-
     if (m_currentOpType == Op_Subscribe || m_currentOpType == Op_Renew)
     {
         foreach(const HNotifyRequest& req, m_queuedNotifications)
@@ -297,10 +764,8 @@ void HEventSubscription::renewSubscription_done(HHttpAsyncOperation* op)
         m_eventUrl.toString(), m_sid.toString()));
 
     m_timeout = response.timeout();
-    if (!m_timeout.isInfinite())
-    {
-        m_subscriptionTimer.start(m_timeout.value() * 1000 / 2);
-    }
+
+    emit renewed(this);
 }
 
 void HEventSubscription::renewSubscription()
@@ -315,31 +780,7 @@ void HEventSubscription::renewSubscription()
     m_announcementTimer.stop();
 
     m_currentOpType = Op_Renew;
-
-    if (!connectToDevice())
-    {
-        return;
-    }
-
-    HLOG_DBG(QString("Renewing subscription [sid: %1].").arg(
-        m_sid.toString()));
-
-    QUrl eventUrl = resolveUri(
-        extractBaseUrl(m_deviceLocations[m_nextLocationToTry]),
-        m_service->info().eventSubUrl());
-
-    HMessagingInfo* mi = new HMessagingInfo(m_socket, false);
-    mi->setHostInfo(eventUrl);
-
-    HSubscribeRequest req(eventUrl, m_sid, m_desiredTimeout);
-    QByteArray data = HHttpMessageCreator::create(req, *mi);
-
-    if (!m_http.msgIo(mi, data))
-    {
-        HLOG_WARN(QString("Failed to renew subscription [sid %1].").arg(
-            m_sid.toString()));
-        emit subscriptionFailed(this);
-    }
+    m_channel->enqueue(this);
 }
 
 void HEventSubscription::resubscribe()
@@ -356,62 +797,6 @@ void HEventSubscription::resubscribe()
     }
 }
 
-void HEventSubscription::error(QAbstractSocket::SocketError /*err*/)
-{
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-
-    // this can be called only when connecting to host
-
-    if (++m_connectErrorCount >= m_deviceLocations.size() * 2)
-    {
-        return;
-    }
-
-    if (m_nextLocationToTry >= m_deviceLocations.size() - 1)
-    {
-        m_nextLocationToTry = 0;
-    }
-    else
-    {
-        ++m_nextLocationToTry;
-    }
-
-    connectToDevice();
-}
-
-bool HEventSubscription::connectToDevice(qint32 msecsToWait)
-{
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-
-    Q_ASSERT(m_currentOpType != Op_None);
-
-    if (m_socket.state() == QTcpSocket::ConnectedState)
-    {
-        return true;
-    }
-    else if (m_socket.state() == QTcpSocket::ConnectingState ||
-             m_socket.state() == QTcpSocket::HostLookupState)
-    {
-        return false;
-    }
-
-    QUrl lastLoc = m_deviceLocations[m_nextLocationToTry];
-
-    bool ok = connect(
-        &m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
-        this, SLOT(error(QAbstractSocket::SocketError)));
-
-    Q_ASSERT(ok); Q_UNUSED(ok)
-
-    m_socket.connectToHost(lastLoc.host(), lastLoc.port());
-    if (msecsToWait > 0)
-    {
-        m_socket.waitForConnected(msecsToWait);
-    }
-
-    return m_socket.state() == QAbstractSocket::ConnectedState;
-}
-
 void HEventSubscription::subscribe_done(HHttpAsyncOperation* op)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
@@ -449,11 +834,6 @@ void HEventSubscription::subscribe_done(HHttpAsyncOperation* op)
     HLOG_DBG(QString("Subscription to [%1] succeeded. Received SID: [%2]").arg(
         m_eventUrl.toString(), m_sid.toString()));
 
-    if (!m_timeout.isInfinite())
-    {
-        m_subscriptionTimer.start(m_timeout.value() * 1000 / 2);
-    }
-
     emit subscribed(this);
 }
 
@@ -487,41 +867,21 @@ void HEventSubscription::subscribe()
     if (!m_sid.isEmpty())
     {
         HLOG_DBG("Ignoring subscription request, since subscription is already active");
+        m_currentOpType = Op_None;
         return;
     }
 
-    if (!connectToDevice())
+    m_localService =
+        static_cast<HDefaultClientService*>(m_service)->localService();
+
+    if (m_localService)
     {
+        // the result is delivered asynchronously as with the network
+        QMetaObject::invokeMethod(this, "localSubscribe", Qt::QueuedConnection);
         return;
     }
 
-    m_eventUrl = resolveUri(
-        extractBaseUrl(m_deviceLocations[m_nextLocationToTry]),
-        m_service->info().eventSubUrl());
-
-    HMessagingInfo* mi = new HMessagingInfo(m_socket, false);
-    mi->setHostInfo(m_eventUrl);
-
-    HSubscribeRequest req(
-        m_eventUrl,
-        HSysInfo::instance().herqqProductTokens(),
-        m_serverRootUrl.toString().append("/").append(
-            m_randomIdentifier.toString().remove('{').remove('}')),
-        m_desiredTimeout);
-
-    QByteArray data = HHttpMessageCreator::create(req, *mi);
-
-    HLOG_DBG(QString("Attempting to subscribe to [%1]").arg(
-        m_eventUrl.toString()));
-
-    if (!m_http.msgIo(mi, data))
-    {
-        HLOG_WARN(QString(
-            "Failed to subscribe to events @ [%1]: %2").arg(
-                urlsAsStr(m_deviceLocations), m_socket.errorString()));
-
-        emit subscriptionFailed(this);
-    }
+    m_channel->enqueue(this);
 }
 
 StatusCode HEventSubscription::processNotify(const HNotifyRequest& req)
@@ -631,44 +991,20 @@ void HEventSubscription::unsubscribe(qint32 msecsToWait)
         Q_ASSERT(false);
     }
 
-    Q_ASSERT(m_sid.isValid());
-    Q_ASSERT(!m_eventUrl.isEmpty());
-
-    m_subscriptionTimer.stop();
-
-    if (!connectToDevice(msecsToWait))
+    if (m_sid.isEmpty())
     {
+        // a subscription to a service hosted in this process
+        disconnectLocalService();
+        QMetaObject::invokeMethod(
+            this, "localUnsubscribed", Qt::QueuedConnection);
+
         return;
     }
 
-    m_eventUrl = resolveUri(
-        extractBaseUrl(m_deviceLocations[m_nextLocationToTry]),
-        m_service->info().eventSubUrl());
-
-    HLOG_DBG(QString(
-        "Attempting to cancel event subscription from [%1]").arg(
-            m_eventUrl.toString()));
-
-    HMessagingInfo* mi = new HMessagingInfo(m_socket, false);
-    mi->setHostInfo(m_eventUrl);
-
-    HUnsubscribeRequest req(m_eventUrl, m_sid);
-    QByteArray data = HHttpMessageCreator::create(req, mi);
-
-    if (!m_http.msgIo(mi, data))
-    {
-        HLOG_WARN(QString(
-            "Encountered an error during subscription cancellation: %1").arg(
-                mi->lastErrorDescription()));
-
-        // if the unsubscription "failed", there's nothing much to do, but to log
-        // the error and perhaps to retry. Then again, UPnP has expiration mechanism
-        // for events and thus even if the device failed to process the request, eventually
-        // the subscription will expire.
+    Q_ASSERT(m_sid.isValid());
+    Q_ASSERT(!m_eventUrl.isEmpty());
 
-        resetSubscription();
-        emit unsubscribed(this);
-    }
+    m_channel->enqueue(this, msecsToWait);
 }
 
 HEventSubscription::SubscriptionStatus HEventSubscription::subscriptionStatus() const
@@ -40,6 +40,8 @@
 #include <QtCore/QUrl>
 #include <QtCore/QList>
 #include <QtCore/QTimer>
+#include <QtCore/QString>
+#include <QtCore/QPointer>
 #include <QtCore/QByteArray>
 
 #include <QtNetwork/QTcpSocket>
@@ -50,27 +52,27 @@ namespace Herqq
 namespace Upnp
 {
 
+class HEventSubscription;
 class HHttpAsyncOperation;
 
 //
-// This class represents and maintains a subscription to a service instantiated on the
-// device host (server) side.
+// A keep-alive connection to a UPnP device that is shared by all the event
+// subscriptions to the services of the device. The (un)subscription requests
+// are queued and sent one after another over the same connection, which is
+// closed once the queue has been drained.
 //
-class HEventSubscription :
+class HEventSubscriptionChannel :
     public QObject
 {
 Q_OBJECT
-H_DISABLE_COPY(HEventSubscription)
+H_DISABLE_COPY(HEventSubscriptionChannel)
 
 private:
 
     const QByteArray m_loggingIdentifier;
 
-    const QUuid m_randomIdentifier;
-    // identifies the service subscription. used in the callback url
-
     QList<QUrl> m_deviceLocations;
-    // the URLs of the device where the desired service is located
+    // the URLs of the device
 
     qint32 m_nextLocationToTry;
     // index of the device location URL that has been tried / used previously
@@ -78,11 +80,101 @@ private:
     // URL fails. At that time the index is incremented if there are more
     // device locations to try.
 
+    qint32 m_connectErrorCount;
+
+    QTcpSocket m_socket;
+    // the connection shared by the subscriptions
+
+    HHttpAsyncHandler m_http;
+
+    QList<HEventSubscription*> m_subscriptions;
+    // the subscriptions using this channel
+
+    QList<HEventSubscription*> m_queue;
+    // the subscriptions waiting for their request to be sent
+
+    HEventSubscription* m_current;
+    // the subscription whose request is currently in progress, or null if
+    // there is none or if the subscription cancelled it
+
+    bool m_requestInProgress;
+    // true until the response to the request in progress has been received.
+    // the socket cannot be used for another request before that, even if
+    // the subscription cancelled the request.
+
+    QString m_localServer;
+    // the local endpoint advertised by the device host, if the device host
+    // runs on the same host. it is tried before the device locations.
+
+    bool m_local;
+    // true when the socket is connected to the local endpoint
+
+private Q_SLOTS:
+
+    void connected();
+    void error(QAbstractSocket::SocketError);
+    void msgIoComplete(HHttpAsyncOperation*);
+
+private:
+
+    bool connectToDevice(qint32 msecsToWait);
+    void sendNext();
+    void failAll();
+
+public:
+
+    HEventSubscriptionChannel(
+        const QByteArray& loggingIdentifier,
+        const QList<QUrl>& deviceLocations,
+        QObject* parent = 0);
+
+    virtual ~HEventSubscriptionChannel();
+
+    void attach(HEventSubscription*);
+    void detach(HEventSubscription*);
+
+    inline const QList<HEventSubscription*>& subscriptions() const
+    {
+        return m_subscriptions;
+    }
+
+    // queues the request of the specified subscription. if msecsToWait is
+    // larger than zero and a connection has to be established, the call
+    // blocks at most the specified time waiting for the connection.
+    void enqueue(HEventSubscription*, qint32 msecsToWait = 0);
+    void cancel(HEventSubscription*);
+
+    inline QList<QUrl> deviceLocations() const { return m_deviceLocations; }
+
+    inline void setLocalServer(const QString& localServer)
+    {
+        m_localServer = localServer;
+    }
+
+    inline bool isLocal() const { return m_local; }
+};
+
+//
+// This class represents and maintains a subscription to a service instantiated on the
+// device host (server) side.
+//
+class HEventSubscription :
+    public QObject
+{
+Q_OBJECT
+H_DISABLE_COPY(HEventSubscription)
+friend class HEventSubscriptionChannel;
+
+private:
+
+    const QByteArray m_loggingIdentifier;
+
+    const QUuid m_randomIdentifier;
+    // identifies the service subscription. used in the callback url
+
     QUrl m_eventUrl;
     // the URL that is currently used in HTTP messaging
 
-    qint32 m_connectErrorCount;
-
     HSid m_sid;
     // the unique identifier of the subscription created by the upnp device
 
@@ -97,9 +189,6 @@ private:
     // upon successful subscription. if no error occurs, the subscription will
     // be renewed before the specified timeout elapses.
 
-    QTimer m_subscriptionTimer;
-    // used to signal the time when the subscription should be renewed
-
     QTimer m_announcementTimer;
     bool m_announcementTimedOut;
 
@@ -111,8 +200,13 @@ private:
     // this is used in subscription requests to tell the upnp device where the
     // notifications are to be sent
 
-    HHttpAsyncHandler m_http;
-    // the class used to perform HTTP messaging
+    QString m_localServerName;
+    // the local endpoint of the same server, if any. this is advertised to
+    // the device hosts that are reached through their local endpoints.
+
+    HEventSubscriptionChannel* m_channel;
+    // the connection to the device shared with the other subscriptions to
+    // the services of the same device
 
     enum OperationType
     {
@@ -122,9 +216,6 @@ private:
         Op_Unsubscribe
     };
 
-    QTcpSocket m_socket;
-    // socket for the messaging
-
     OperationType m_currentOpType;
     OperationType m_nextOpType;
 
@@ -132,31 +223,43 @@ private:
 
     QList<HNotifyRequest> m_queuedNotifications;
 
+    QPointer<HServerService> m_localService;
+    // the server-side service when the subscription is to a service hosted
+    // in this process. the changes of the evented state variables are then
+    // received directly from the state variables. if the service is deleted
+    // while subscribed, the subscription is made again over the network.
+
 private Q_SLOTS:
 
-    void subscriptionTimeout();
     void announcementTimeout();
 
-    void connected();
-    void msgIoComplete(HHttpAsyncOperation*);
-
-    void error(QAbstractSocket::SocketError);
+    void localSubscribe();
+    void localUnsubscribed();
+    void localServiceDestroyed();
+    void localValueChanged(
+        Herqq::Upnp::HServerStateVariable* source,
+        const Herqq::Upnp::HStateVariableEvent&);
 
 private:
 
-    bool connectToDevice(qint32 msecsToWait=0);
+    // these are called by the channel
+    QByteArray createRequest(const QUrl& deviceLocation, HMessagingInfo*);
+    void requestDone(HHttpAsyncOperation*);
+    void requestFailed();
+
     void subscribe_done(HHttpAsyncOperation*);
     void renewSubscription_done(HHttpAsyncOperation*);
     void unsubscribe_done(HHttpAsyncOperation*);
 
     void runNextOp();
     void resubscribe();
-    void renewSubscription();
+    void disconnectLocalService();
     StatusCode processNotify(const HNotifyRequest&);
 
 Q_SIGNALS:
 
     void subscribed(HEventSubscription*);
+    void renewed(HEventSubscription*);
     void subscriptionFailed(HEventSubscription*);
     void unsubscribed(HEventSubscription*);
 
@@ -173,15 +276,20 @@ public:
         const QByteArray& loggingIdentifier,
         HClientService* service,
         const QUrl& serverRootUrl,
+        const QString& localServerName,
         const HTimeout& desiredTimeout,
+        HEventSubscriptionChannel* channel,
         QObject* parent = 0);
 
     virtual ~HEventSubscription();
 
     inline QUuid id() const { return m_randomIdentifier ; }
     inline HClientService* service() const { return m_service; }
+    inline HEventSubscriptionChannel* channel() const { return m_channel; }
+    inline HTimeout timeout() const { return m_timeout; }
 
     void subscribe();
+    void renewSubscription();
     void unsubscribe(qint32 msecsToWait=0);
     void resetSubscription();
     StatusCode onNotify(const HNotifyRequest&);
@@ -26,6 +26,7 @@
 #include "../../general/hupnp_global_p.h"
 
 #include "../../devicemodel/client/hclientdevice.h"
+#include "../../devicemodel/client/hdefault_clientdevice_p.h"
 #include "../../devicemodel/client/hdefault_clientservice_p.h"
 
 #include "../../dataelements/hserviceid.h"
@@ -33,6 +34,7 @@
 #include "../../dataelements/hserviceinfo.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../utils/hdeadline_scheduler_p.h"
 
 namespace Herqq
 {
@@ -42,9 +44,15 @@ namespace Upnp
 
 HEventSubscriptionManager::HEventSubscriptionManager(HControlPointPrivate* owner) :
     QObject(owner),
-        m_owner(owner), m_subscribtionsByUuid(), m_subscriptionsByUdn()
+        m_owner(owner), m_subscribtionsByUuid(), m_subscriptionsByUdn(),
+        m_channels(), m_renewals(new HDeadlineScheduler(1000, this))
 {
     Q_ASSERT(m_owner);
+
+    bool ok = connect(
+        m_renewals, SIGNAL(expired(void*)), this, SLOT(renewalDue(void*)));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
 }
 
 HEventSubscriptionManager::~HEventSubscriptionManager()
@@ -58,15 +66,104 @@ void HEventSubscriptionManager::subscribed_slot(HEventSubscription* sub)
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
     Q_ASSERT(sub);
 
+    scheduleRenewal(sub);
     emit subscribed(sub->service());
 }
 
+void HEventSubscriptionManager::renewed_slot(HEventSubscription* sub)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+    Q_ASSERT(sub);
+
+    scheduleRenewal(sub);
+}
+
+void HEventSubscriptionManager::scheduleRenewal(HEventSubscription* sub)
+{
+    HTimeout timeout = sub->timeout();
+    if (timeout.isInfinite())
+    {
+        m_renewals->remove(sub);
+    }
+    else
+    {
+        m_renewals->schedule(sub, timeout.value() * 1000 / 2);
+    }
+}
+
+void HEventSubscriptionManager::renewalDue(void* key)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    HEventSubscription* sub = static_cast<HEventSubscription*>(key);
+
+    // the other subscriptions to the same device that would be due within
+    // the next quarter of their renewal interval are renewed at the same time.
+    // this way the requests go over a single connection and over time the
+    // renewals of a device settle into the same window.
+    QList<HEventSubscription*> subs = sub->channel()->subscriptions();
+    foreach(HEventSubscription* other, subs)
+    {
+        if (other != sub)
+        {
+            qint64 remaining = m_renewals->remainingTime(other);
+            if (remaining < 0 ||
+                remaining > other->timeout().value() * 1000 / 4)
+            {
+                continue;
+            }
+            m_renewals->remove(other);
+        }
+
+        other->renewSubscription();
+    }
+}
+
+HEventSubscriptionChannel* HEventSubscriptionManager::channel(
+    HClientService* service)
+{
+    HClientDevice* root = service->parentDevice()->rootDevice();
+    HUdn udn = root->info().udn();
+
+    HEventSubscriptionChannel* retVal = m_channels.value(udn);
+    if (!retVal)
+    {
+        retVal = new HEventSubscriptionChannel(
+            m_owner->m_loggingIdentifier, root->locations(), this);
+
+        m_channels.insert(udn, retVal);
+    }
+
+    // the endpoint is refreshed, since a failure to connect to it clears it
+    retVal->setLocalServer(
+        static_cast<HDefaultClientDevice*>(root)->localServer());
+
+    return retVal;
+}
+
+void HEventSubscriptionManager::destroy(HEventSubscription* sub)
+{
+    m_renewals->remove(sub);
+
+    HEventSubscriptionChannel* ch = sub->channel();
+    delete sub;
+
+    if (ch->subscriptions().isEmpty())
+    {
+        m_channels.remove(m_channels.key(ch));
+
+        // the channel may be in the middle of delivering a response
+        ch->deleteLater();
+    }
+}
+
 void HEventSubscriptionManager::subscriptionFailed_slot(HEventSubscription* sub)
 {
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
     Q_ASSERT(sub);
 
     HClientService* service = sub->service();
+    m_renewals->remove(sub);
     sub->resetSubscription();
     emit subscriptionFailed(service);
 }
@@ -76,6 +173,7 @@ void HEventSubscriptionManager::unsubscribed(HEventSubscription* sub)
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
     Q_ASSERT(sub);
 
+    m_renewals->remove(sub);
     emit unsubscribed(sub->service());
 }
 
@@ -97,7 +195,9 @@ HEventSubscription* HEventSubscriptionManager::createSubscription(
             m_owner->m_loggingIdentifier,
             service,
             httpSrvRootUrl,
+            m_owner->m_server->localServerName(),
             HTimeout(timeout),
+            channel(service),
             this);
 
     bool ok = connect(
@@ -108,6 +208,14 @@ HEventSubscription* HEventSubscriptionManager::createSubscription(
 
     Q_ASSERT(ok); Q_UNUSED(ok)
 
+    ok = connect(
+        subscription,
+        SIGNAL(renewed(HEventSubscription*)),
+        this,
+        SLOT(renewed_slot(HEventSubscription*)));
+
+    Q_ASSERT(ok);
+
     ok = connect(
         subscription,
         SIGNAL(subscriptionFailed(HEventSubscription*)),
@@ -303,6 +411,8 @@ bool HEventSubscriptionManager::cancel(
     QList<HEventSubscription*>::iterator it = subs->begin();
     for(; it != subs->end(); ++it)
     {
+        m_renewals->remove(*it);
+
         if (unsubscribe)
         {
             (*it)->unsubscribe();
@@ -350,7 +460,7 @@ bool HEventSubscriptionManager::remove(HClientDevice* device, bool recursive)
     {
         HEventSubscription* sub = (*it);
         m_subscribtionsByUuid.remove(sub->id());
-        delete sub;
+        destroy(sub);
     }
 
     m_subscriptionsByUdn.remove(udn);
@@ -395,6 +505,8 @@ bool HEventSubscriptionManager::cancel(HClientService* service, bool unsubscribe
             continue;
         }
 
+        m_renewals->remove(sub);
+
         if (unsubscribe)
         {
             (*it)->unsubscribe();
@@ -445,7 +557,7 @@ bool HEventSubscriptionManager::remove(HClientService* service)
         }
 
         m_subscribtionsByUuid.remove(sub->id());
-        delete sub;
+        destroy(sub);
 
         return true;
     }
@@ -472,11 +584,19 @@ void HEventSubscriptionManager::removeAll()
     HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
     Q_ASSERT(thread() == QThread::currentThread());
 
+    m_renewals->clear();
+
     qDeleteAll(m_subscribtionsByUuid);
     m_subscribtionsByUuid.clear();
 
     qDeleteAll(m_subscriptionsByUdn);
     m_subscriptionsByUdn.clear();
+
+    foreach(HEventSubscriptionChannel* ch, m_channels)
+    {
+        ch->deleteLater();
+    }
+    m_channels.clear();
 }
 
 StatusCode HEventSubscriptionManager::onNotify(
@@ -37,6 +37,7 @@ namespace Herqq
 namespace Upnp
 {
 
+class HDeadlineScheduler;
 class HControlPointPrivate;
 
 //
@@ -55,9 +56,19 @@ private:
     QHash<QUuid, HEventSubscription*> m_subscribtionsByUuid;
     QHash<HUdn, QList<HEventSubscription*>* > m_subscriptionsByUdn;
 
+    QHash<HUdn, HEventSubscriptionChannel*> m_channels;
+    // the connections shared by the subscriptions to the services of a
+    // root device and its embedded devices. keyed by the UDN of the root device
+
+    HDeadlineScheduler* m_renewals;
+    // the renewal deadlines of all the active subscriptions
+
 private:
 
     HEventSubscription* createSubscription(HClientService*, qint32 timeout);
+    HEventSubscriptionChannel* channel(HClientService*);
+    void scheduleRenewal(HEventSubscription*);
+    void destroy(HEventSubscription*);
     QUrl getSuitableHttpServerRootUrl(const QList<QUrl>& deviceLocations);
     // attempts to figure out the most suitable HTTP server URL for one of the
     // device locations specified
@@ -65,6 +76,8 @@ private:
 public Q_SLOTS:
 
     void subscribed_slot(HEventSubscription*);
+    void renewed_slot(HEventSubscription*);
+    void renewalDue(void*);
     void subscriptionFailed_slot(HEventSubscription*);
     void unsubscribed(HEventSubscription*);
 
@@ -79,6 +92,11 @@ public:
     HEventSubscriptionManager(HControlPointPrivate*);
     virtual ~HEventSubscriptionManager();
 
+    inline qint32 subscriptionCount() const
+    {
+        return m_subscribtionsByUuid.size();
+    }
+
     enum SubscriptionResult
     {
         Sub_Success = 0,
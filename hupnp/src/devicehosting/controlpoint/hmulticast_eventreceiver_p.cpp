@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hmulticast_eventreceiver_p.h"
+
+#include "../messages/hevent_messages_p.h"
+
+#include "../../http/hhttp_header_p.h"
+#include "../../http/hhttp_messagecreator_p.h"
+
+#include "../../socket/hmulticast_socket.h"
+#include "../../general/hlogger_p.h"
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace
+{
+inline QHostAddress multicastEventAddress()
+{
+    static QHostAddress retVal("239.255.255.246");
+    return retVal;
+}
+}
+
+/*******************************************************************************
+ * HMulticastEventReceiver
+ ******************************************************************************/
+HMulticastEventReceiver::HMulticastEventReceiver(
+    const QByteArray& loggingIdentifier, QObject* parent) :
+        QObject(parent),
+            m_loggingIdentifier(loggingIdentifier), m_sockets(), m_lastSeqs()
+{
+}
+
+HMulticastEventReceiver::~HMulticastEventReceiver()
+{
+    clear();
+}
+
+bool HMulticastEventReceiver::init(const QHostAddress& addressToListen)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    HMulticastSocket* sock = new HMulticastSocket(this);
+
+    bool ok = connect(sock, SIGNAL(readyRead()), this, SLOT(datagramReceived()));
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    if (!sock->bind(7900))
+    {
+        HLOG_WARN("Failed to bind a socket for receiving multicast events");
+        delete sock;
+        return false;
+    }
+
+    if (!sock->joinMulticastGroup(multicastEventAddress(), addressToListen))
+    {
+        HLOG_WARN(QString("Could not join %1 on [%2]").arg(
+            multicastEventAddress().toString(), addressToListen.toString()));
+
+        delete sock;
+        return false;
+    }
+
+    m_sockets.append(qMakePair(addressToListen, sock));
+    return true;
+}
+
+void HMulticastEventReceiver::clear()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    for(qint32 i = 0; i < m_sockets.size(); ++i)
+    {
+        HMulticastSocket* sock = m_sockets[i].second;
+        if (sock->state() == QUdpSocket::BoundState)
+        {
+            sock->leaveMulticastGroup(
+                multicastEventAddress(), m_sockets[i].first);
+        }
+        delete sock;
+    }
+
+    m_sockets.clear();
+    m_lastSeqs.clear();
+}
+
+bool HMulticastEventReceiver::isDuplicate(const HMulticastNotifyRequest& req)
+{
+    QString key = QString("%1::%2").arg(
+        req.usn().toString(), req.serviceId().toString());
+
+    QHash<QString, QPair<qint32, quint32> >::iterator it = m_lastSeqs.find(key);
+    if (it == m_lastSeqs.end())
+    {
+        m_lastSeqs.insert(key, qMakePair(req.bootId(), req.seq()));
+        return false;
+    }
+
+    if (it.value().first == req.bootId() && it.value().second == req.seq())
+    {
+        return true;
+    }
+
+    it.value() = qMakePair(req.bootId(), req.seq());
+    return false;
+}
+
+void HMulticastEventReceiver::datagramReceived()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    HMulticastSocket* sock = static_cast<HMulticastSocket*>(sender());
+    Q_ASSERT(sock);
+
+    while(sock->hasPendingDatagrams())
+    {
+        QByteArray buf;
+        buf.resize(sock->pendingDatagramSize());
+
+        qint64 read = sock->readDatagram(buf.data(), buf.size());
+        if (read < 0)
+        {
+            HLOG_WARN(QString("Read failed: %1").arg(sock->errorString()));
+            return;
+        }
+        buf.resize(read);
+
+        qint32 headerEnd = buf.indexOf("\r\n\r\n");
+        if (headerEnd < 0 || !buf.startsWith("NOTIFY * HTTP/1."))
+        {
+            continue;
+        }
+
+        HHttpRequestHeader hdr(QString::fromUtf8(buf.left(headerEnd + 4)));
+        if (!hdr.isValid())
+        {
+            HLOG_WARN("Ignoring an invalid multicast event message.");
+            continue;
+        }
+
+        HMulticastNotifyRequest req;
+        qint32 rv = HHttpMessageCreator::create(hdr, buf.mid(headerEnd + 4), req);
+        if (rv != HMulticastNotifyRequest::Success)
+        {
+            HLOG_FIELD(Usn, hdr.value("USN"));
+            HLOG_WARN(QString(
+                "Ignoring an invalid multicast event message: [%1]").arg(
+                    QString::number(rv)));
+            continue;
+        }
+
+        if (!isDuplicate(req))
+        {
+            emit notifyReceived(req);
+        }
+    }
+}
+
+}
+}
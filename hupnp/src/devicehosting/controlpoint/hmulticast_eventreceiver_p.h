@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HMULTICAST_EVENTRECEIVER_P_H_
+#define HMULTICAST_EVENTRECEIVER_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "../../general/hupnp_defs.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QObject>
+
+#include <QtNetwork/QHostAddress>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+class HMulticastSocket;
+class HMulticastNotifyRequest;
+
+//
+// Listens for UDA 2.0 multicast event messages sent to 239.255.255.246:7900.
+// A single message is likely to arrive through every socket joined to the
+// group, which is why the duplicates are filtered using the SEQ header.
+//
+class HMulticastEventReceiver :
+    public QObject
+{
+Q_OBJECT
+H_DISABLE_COPY(HMulticastEventReceiver)
+
+private:
+
+    const QByteArray m_loggingIdentifier;
+
+    QList<QPair<QHostAddress, HMulticastSocket*> > m_sockets;
+
+    QHash<QString, QPair<qint32, quint32> > m_lastSeqs;
+    // the last boot ID and SEQ received for each USN::SVCID pair
+
+    bool isDuplicate(const HMulticastNotifyRequest&);
+
+private Q_SLOTS:
+
+    void datagramReceived();
+
+public:
+
+    HMulticastEventReceiver(
+        const QByteArray& loggingIdentifier, QObject* parent);
+
+    virtual ~HMulticastEventReceiver();
+
+    bool init(const QHostAddress& addressToListen);
+    void clear();
+
+Q_SIGNALS:
+
+    void notifyReceived(const Herqq::Upnp::HMulticastNotifyRequest&);
+};
+
+}
+}
+
+#endif /* HMULTICAST_EVENTRECEIVER_P_H_ */
@@ -0,0 +1,188 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hservicemodel_loader_p.h"
+#include "hcontrolpoint_p.h"
+#include "hcontrolpoint_dataretriever_p.h"
+
+#include "../../dataelements/hserviceinfo.h"
+
+#include "../../devicemodel/client/hdefault_clientdevice_p.h"
+#include "../../devicemodel/client/hdefault_clientservice_p.h"
+
+#include "../../general/hlogger_p.h"
+#include "../../general/hupnp_global_p.h"
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+/*******************************************************************************
+ * HServiceModelLoader
+ ******************************************************************************/
+HServiceModelLoader::HServiceModelLoader(HControlPointPrivate* owner) :
+    QObject(owner),
+        m_owner(owner), m_loads(), m_description()
+{
+    Q_ASSERT(m_owner);
+}
+
+HServiceModelLoader::~HServiceModelLoader()
+{
+}
+
+bool HServiceModelLoader::isLoading(HDefaultClientService* service) const
+{
+    QHash<QString, QList<QPointer<HDefaultClientService> > >::const_iterator ci =
+        m_loads.constBegin();
+
+    for(; ci != m_loads.constEnd(); ++ci)
+    {
+        if (ci.value().contains(service))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HServiceModelLoader::descriptionRetrieved(
+    const QUrl& url, bool success, const QByteArray& data, const QString& err)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    QList<QPointer<HDefaultClientService> > services =
+        m_loads.take(url.toString());
+
+    QString description;
+    if (success)
+    {
+        description = QString::fromUtf8(data);
+    }
+    else
+    {
+        HLOG_WARN(QString(
+            "Could not retrieve service description from [%1]: %2").arg(
+                url.toString(), err));
+    }
+
+    for(qint32 i = 0; i < services.size(); ++i)
+    {
+        HDefaultClientService* service = services.at(i);
+        if (!service)
+        {
+            // the device was removed while its description was retrieved
+            continue;
+        }
+
+        bool ok = service->isModelLoaded();
+        if (success && !ok)
+        {
+            // the slots connected to loaded() may run a nested event loop,
+            // in which another description may be used
+            m_description = description;
+
+            QString errStr;
+            ok = m_owner->loadServiceModel(
+                service,
+                ServiceDescriptionFetcher(
+                    this, &HServiceModelLoader::serviceDescription),
+                IconFetcher(this, &HServiceModelLoader::icon),
+                &errStr);
+
+            if (!ok)
+            {
+                HLOG_WARN(QString(
+                    "Couldn't create the model of service [%1]: %2").arg(
+                        service->info().serviceId().toString(), errStr));
+            }
+
+            m_description.clear();
+        }
+
+        emit loaded(service, ok);
+    }
+}
+
+bool HServiceModelLoader::serviceDescription(
+    const QUrl&, const QUrl&, QString* data)
+{
+    // only the description that was just retrieved is ever requested
+    *data = m_description;
+    return true;
+}
+
+bool HServiceModelLoader::icon(const QUrl&, const QUrl&, QByteArray*)
+{
+    // the client side device model does not use icons
+    return false;
+}
+
+bool HServiceModelLoader::prefetch(HDefaultClientService* service)
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+    Q_ASSERT(service);
+
+    if (service->isModelLoaded() || isLoading(service))
+    {
+        return true;
+    }
+
+    QList<QUrl> locations = service->parentDevice()->rootDevice()->locations();
+    if (locations.isEmpty())
+    {
+        return false;
+    }
+
+    QUrl url = HDataRetriever::resolveUrl(
+        extractBaseUrl(locations[0]), service->info().scpdUrl());
+
+    HLOG_DBG(QString(
+        "Attempting to fetch the service description of [%1] from: [%2]").arg(
+            service->info().serviceId().toString(), url.toString()));
+
+    QList<QPointer<HDefaultClientService> >& waiting = m_loads[url.toString()];
+    waiting.append(service);
+
+    if (waiting.size() == 1)
+    {
+        m_owner->m_dataRetriever->retrieve(
+            url, this,
+            DataRetrievedCallback(
+                this, &HServiceModelLoader::descriptionRetrieved));
+    }
+
+    return true;
+}
+
+void HServiceModelLoader::cancelAll()
+{
+    HLOG2(H_AT, H_FUN, m_owner->m_loggingIdentifier);
+
+    m_owner->m_dataRetriever->cancel(this);
+    m_loads.clear();
+}
+
+}
+}
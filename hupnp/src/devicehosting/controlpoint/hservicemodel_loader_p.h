@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSERVICEMODEL_LOADER_P_H_
+#define HSERVICEMODEL_LOADER_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "../../general/hupnp_defs.h"
+
+#include <QtCore/QUrl>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QByteArray>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+class HControlPointPrivate;
+class HDefaultClientService;
+
+//
+// Builds the models of the services whose descriptions were not retrieved
+// when the device model was built.
+//
+// The service descriptions are retrieved through the data retriever of the
+// control point, which is why the concurrent loads of the same service, or
+// of services that share a description, share a single transfer. The
+// models are created in the thread of the control point once the
+// descriptions are available.
+//
+// The instance has to be used from the thread in which it lives.
+//
+class HServiceModelLoader :
+    public QObject
+{
+Q_OBJECT
+H_DISABLE_COPY(HServiceModelLoader)
+
+private:
+
+    HControlPointPrivate* m_owner;
+
+    QHash<QString, QList<QPointer<HDefaultClientService> > > m_loads;
+    // the services waiting for a service description, keyed by the URL
+    // of the description
+
+    QString m_description;
+    // the service description that is currently used to create a model
+
+    bool isLoading(HDefaultClientService*) const;
+
+    void descriptionRetrieved(
+        const QUrl&, bool, const QByteArray&, const QString&);
+
+    bool serviceDescription(
+        const QUrl& deviceLocation, const QUrl& scpdUrl, QString*);
+
+    bool icon(const QUrl& deviceLocation, const QUrl& iconUrl, QByteArray*);
+
+Q_SIGNALS:
+
+    void loaded(Herqq::Upnp::HDefaultClientService*, bool success);
+
+public:
+
+    explicit HServiceModelLoader(HControlPointPrivate* owner);
+    virtual ~HServiceModelLoader();
+
+    // starts loading the model of the specified service unless it has been
+    // loaded or it is being loaded already. returns false if the model
+    // cannot be loaded.
+    bool prefetch(HDefaultClientService*);
+
+    // cancels the pending retrievals. the loaded() signal is not emitted
+    // for the services whose models were being loaded
+    void cancelAll();
+};
+
+}
+}
+
+#endif /* HSERVICEMODEL_LOADER_P_H_ */
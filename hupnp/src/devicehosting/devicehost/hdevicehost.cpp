@@ -22,6 +22,7 @@
 #include "hdevicehost.h"
 #include "hdevicehost_p.h"
 #include "hevent_notifier_p.h"
+#include "hevent_subscriber_p.h"
 #include "hpresence_announcer_p.h"
 #include "hdevicehost_configuration.h"
 #include "hserverdevicecontroller_p.h"
@@ -31,8 +32,11 @@
 #include "hdevicehost_dataretriever_p.h"
 
 #include "hservermodel_creator_p.h"
+#include "../hlocaldevice_registry_p.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hmetrics.h"
+#include "../../general/hmetrics_p.h"
 #include "../../utils/hsysutils_p.h"
 
 #include <ctime>
@@ -120,7 +124,8 @@ HDeviceHostPrivate::HDeviceHostPrivate() :
         m_lastError(HDeviceHost::UndefinedError),
         m_initialized(false),
         m_deviceStorage(m_loggingIdentifier),
-        m_nam(0)
+        m_nam(0),
+        m_templates()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
     qsrand(time(0));
@@ -129,6 +134,13 @@ HDeviceHostPrivate::HDeviceHostPrivate() :
 HDeviceHostPrivate::~HDeviceHostPrivate()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    clearTemplates();
+}
+
+void HDeviceHostPrivate::clearTemplates()
+{
+    qDeleteAll(m_templates);
+    m_templates.clear();
 }
 
 void HDeviceHostPrivate::announcementTimedout(
@@ -149,18 +161,34 @@ bool HDeviceHostPrivate::createRootDevice(const HDeviceConfiguration* deviceconf
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    QString baseDir = extractBaseUrl(deviceconfig->pathToDeviceDescription());
+    QString path = deviceconfig->pathToDeviceDescription();
+    QString baseDir = extractBaseUrl(path);
 
     DeviceHostDataRetriever dataRetriever(m_loggingIdentifier, baseDir);
 
+    HServerModelTemplate* deviceTemplate = 0;
+    if (deviceconfig->isTemplateInstance())
+    {
+        deviceTemplate = m_templates.value(path);
+    }
+
     QString deviceDescr;
-    if (!dataRetriever.retrieveDeviceDescription(
-        deviceconfig->pathToDeviceDescription(), &deviceDescr))
+    if (deviceTemplate)
+    {
+        deviceDescr = deviceTemplate->m_deviceDescription;
+    }
+    else if (!dataRetriever.retrieveDeviceDescription(path, &deviceDescr))
     {
         m_lastError = HDeviceHost::InvalidConfigurationError;
         m_lastErrorDescription = dataRetriever.lastError();
         return false;
     }
+    else if (deviceconfig->isTemplateInstance())
+    {
+        deviceTemplate = new HServerModelTemplate();
+        deviceTemplate->m_deviceDescription = deviceDescr;
+        m_templates.insert(path, deviceTemplate);
+    }
 
     HServerModelCreationArgs creatorParams(m_config->deviceModelCreator());
     creatorParams.m_deviceDescription = deviceDescr;
@@ -181,6 +209,12 @@ bool HDeviceHostPrivate::createRootDevice(const HDeviceConfiguration* deviceconf
 
     creatorParams.m_loggingIdentifier = m_loggingIdentifier;
 
+    if (deviceTemplate)
+    {
+        creatorParams.setTemplate(
+            deviceTemplate, deviceconfig->udn(), deviceconfig->friendlyName());
+    }
+
     HServerModelCreator creator(creatorParams);
     QScopedPointer<HServerDevice> rootDevice(creator.createRootDevice());
 
@@ -259,6 +293,8 @@ void HDeviceHostPrivate::connectSelfToServiceSignals(HServerDevice* device)
             SLOT(stateChanged(const Herqq::Upnp::HServerService*)));
 
         Q_ASSERT(ok); Q_UNUSED(ok)
+
+        m_eventNotifier->addService(service);
     }
 
     HServerDevices devices(device->embeddedDevices());
@@ -350,6 +386,16 @@ const HDeviceHostRuntimeStatus* HDeviceHost::runtimeStatus() const
     return h_ptr->m_runtimeStatus.data();
 }
 
+HMetrics HDeviceHost::metrics() const
+{
+    if (!h_ptr->m_httpServer)
+    {
+        return HMetricsRegistry::snapshot();
+    }
+
+    return h_ptr->m_httpServer->metrics();
+}
+
 void HDeviceHost::setError(DeviceHostError error, const QString& errorStr)
 {
     HLOG2(H_AT, H_FUN, h_ptr->m_loggingIdentifier);
@@ -397,12 +443,21 @@ bool HDeviceHost::init(const HDeviceHostConfiguration& config)
             h_ptr->m_deviceStorage,
             *h_ptr->m_eventNotifier, this));
 
+    h_ptr->m_httpServer->setMetricsEndpointEnabled(
+        config.isMetricsEndpointEnabled());
+
     QList<QHostAddress> addrs = config.networkAddressesToUse();
     if (!h_ptr->m_httpServer->init(convertHostAddressesToEndpoints(addrs)))
     {
         setError(CommunicationsError, "Failed to initialize HTTP server");
         goto err;
     }
+    else if (!config.localServerName().isEmpty() &&
+             !h_ptr->m_httpServer->listenLocal(config.localServerName()))
+    {
+        setError(CommunicationsError, "Failed to initialize the local endpoint");
+        goto err;
+    }
     else
     {
          if (!h_ptr->createRootDevices())
@@ -446,6 +501,12 @@ bool HDeviceHost::init(const HDeviceHostConfiguration& config)
 
         h_ptr->startNotifiers();
 
+        foreach(HServerDevice* rootDevice,
+                h_ptr->m_deviceStorage.rootDevices<HServerDevice>())
+        {
+            HLocalDeviceRegistry::add(rootDevice);
+        }
+
         h_ptr->m_initialized = true;
 
         HLOG_INFO("DeviceHost initialized.");
@@ -493,6 +554,12 @@ void HDeviceHost::quit()
 
     h_ptr->m_initialized = false;
 
+    foreach(HServerDevice* rootDevice,
+            h_ptr->m_deviceStorage.rootDevices<HServerDevice>())
+    {
+        HLocalDeviceRegistry::remove(rootDevice);
+    }
+
     doQuit();
 
     h_ptr->m_presenceAnnouncer.reset(0);
@@ -505,6 +572,7 @@ void HDeviceHost::quit()
     h_ptr->m_config.reset(0);
 
     h_ptr->m_deviceStorage.clear();
+    h_ptr->clearTemplates();
 
     HLOG_INFO("Shut down.");
 }
@@ -538,6 +606,8 @@ bool HDeviceHost::add(const HDeviceConfiguration& configuration)
         h_ptr->m_config->add(configuration);
         h_ptr->m_presenceAnnouncer->announce<ResourceAvailableAnnouncement>(newController);
         h_ptr->startNotifiers(newController);
+
+        HLocalDeviceRegistry::add(newController->m_device);
     }
     return b;
 }
@@ -607,5 +677,65 @@ QList<HEndpoint> HDeviceHostRuntimeStatus::httpEndpoints() const
     return h_ptr->m_deviceHost->h_ptr->m_httpServer->endpoints();
 }
 
+QList<QPair<QUrl, qint32> > HDeviceHostRuntimeStatus::eventQueueLengths() const
+{
+    Q_ASSERT(h_ptr->m_deviceHost);
+
+    QList<QPair<QUrl, qint32> > retVal;
+
+    HEventNotifier* notifier =
+        h_ptr->m_deviceHost->h_ptr->m_eventNotifier.data();
+    if (notifier)
+    {
+        foreach(const HServiceEventSubscriber* sub, notifier->subscribers())
+        {
+            retVal.append(qMakePair(sub->location(), sub->queueLength()));
+        }
+    }
+
+    return retVal;
+}
+
+qint32 HDeviceHostRuntimeStatus::coalescedEventCount() const
+{
+    Q_ASSERT(h_ptr->m_deviceHost);
+
+    qint32 retVal = 0;
+
+    HEventNotifier* notifier =
+        h_ptr->m_deviceHost->h_ptr->m_eventNotifier.data();
+    if (notifier)
+    {
+        foreach(const HServiceEventSubscriber* sub, notifier->subscribers())
+        {
+            retVal += sub->coalescedCount();
+        }
+    }
+
+    return retVal;
+}
+
+qint32 HDeviceHostRuntimeStatus::suspendedSubscriberCount() const
+{
+    Q_ASSERT(h_ptr->m_deviceHost);
+
+    qint32 retVal = 0;
+
+    HEventNotifier* notifier =
+        h_ptr->m_deviceHost->h_ptr->m_eventNotifier.data();
+    if (notifier)
+    {
+        foreach(const HServiceEventSubscriber* sub, notifier->subscribers())
+        {
+            if (sub->isSuspended())
+            {
+                ++retVal;
+            }
+        }
+    }
+
+    return retVal;
+}
+
 }
 }
@@ -24,6 +24,8 @@
 
 #include <HUpnpCore/HUpnp>
 
+#include <QtCore/QUrl>
+#include <QtCore/QPair>
 #include <QtCore/QObject>
 
 namespace Herqq
@@ -32,6 +34,7 @@ namespace Herqq
 namespace Upnp
 {
 
+class HMetrics;
 class HDeviceHostPrivate;
 
 /*!
@@ -372,6 +375,18 @@ protected:
      */
     const HDeviceHostRuntimeStatus* runtimeStatus() const;
 
+    /*!
+     * \brief Returns a snapshot of the runtime metrics.
+     *
+     * \return A snapshot of the runtime metrics. The counters and histograms
+     * are shared by all the device hosts and control points in the process,
+     * whereas the gauges describe the event subscribers of this device host.
+     * The gauges are not available when the device host is not started.
+     *
+     * \sa HMetrics, HDeviceHostConfiguration::setMetricsEndpointEnabled()
+     */
+    HMetrics metrics() const;
+
     /*!
      * \brief Sets the type and description of the last error occurred.
      *
@@ -484,8 +499,12 @@ public:
      * returns \e false, you can call error() and errorDescription() to get
      * more information of the error that occurred.
      *
-     * \remarks The specified device configuration has to be compatible with
+     * \remarks
+     * \li The specified device configuration has to be compatible with
      * the specified HDeviceHostConfiguration specified in init().
+     * \li Adding a large number of devices that differ only in their UDNs and
+     * friendly names is considerably cheaper when the configurations use
+     * the same description as a template. See HDeviceConfiguration::setUdn().
      *
      * \sa error(), errorDescription()
      */
@@ -558,6 +577,40 @@ public:
      * \return The IP endpoints that the device host uses for HTTP communications.
      */
     QList<HEndpoint> httpEndpoints() const;
+
+    /*!
+     * \brief Returns the number of undelivered event messages of each
+     * event subscriber.
+     *
+     * \return The callback URL of each event subscriber paired with the
+     * number of event messages queued for it, including the message being
+     * delivered.
+     *
+     * \sa HDeviceHostConfiguration::setMaxEventQueueLength()
+     */
+    QList<QPair<QUrl, qint32> > eventQueueLengths() const;
+
+    /*!
+     * \brief Returns the number of event messages that were not delivered
+     * to the current event subscribers, because they were collapsed into
+     * a later message.
+     *
+     * \return The number of event messages that were not delivered
+     * to the current event subscribers, because they were collapsed into
+     * a later message.
+     */
+    qint32 coalescedEventCount() const;
+
+    /*!
+     * \brief Returns the number of event subscribers to which the deliveries
+     * are currently suspended.
+     *
+     * \return The number of event subscribers to which the deliveries
+     * are currently suspended.
+     *
+     * \sa HDeviceHostConfiguration::setEventDeliveryFailureThreshold()
+     */
+    qint32 suspendedSubscriberCount() const;
 };
 
 }
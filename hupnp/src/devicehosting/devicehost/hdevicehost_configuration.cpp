@@ -38,7 +38,8 @@ namespace Upnp
  * HDeviceConfigurationPrivate
  ******************************************************************************/
 HDeviceConfigurationPrivate::HDeviceConfigurationPrivate() :
-    m_pathToDeviceDescriptor(), m_cacheControlMaxAgeInSecs(1800)
+    m_pathToDeviceDescriptor(), m_cacheControlMaxAgeInSecs(1800),
+    m_udn(), m_friendlyName()
 {
 }
 
@@ -75,6 +76,8 @@ void HDeviceConfiguration::doClone(HClonable* target) const
 
     conf->h_ptr->m_cacheControlMaxAgeInSecs = h_ptr->m_cacheControlMaxAgeInSecs;
     conf->h_ptr->m_pathToDeviceDescriptor = h_ptr->m_pathToDeviceDescriptor;
+    conf->h_ptr->m_udn = h_ptr->m_udn;
+    conf->h_ptr->m_friendlyName = h_ptr->m_friendlyName;
 }
 
 HDeviceConfiguration* HDeviceConfiguration::clone() const
@@ -114,6 +117,31 @@ qint32 HDeviceConfiguration::cacheControlMaxAge() const
     return h_ptr->m_cacheControlMaxAgeInSecs;
 }
 
+void HDeviceConfiguration::setUdn(const HUdn& udn)
+{
+    h_ptr->m_udn = udn;
+}
+
+HUdn HDeviceConfiguration::udn() const
+{
+    return h_ptr->m_udn;
+}
+
+void HDeviceConfiguration::setFriendlyName(const QString& friendlyName)
+{
+    h_ptr->m_friendlyName = friendlyName;
+}
+
+QString HDeviceConfiguration::friendlyName() const
+{
+    return h_ptr->m_friendlyName;
+}
+
+bool HDeviceConfiguration::isTemplateInstance() const
+{
+    return h_ptr->m_udn.isValid(LooseChecks);
+}
+
 bool HDeviceConfiguration::isValid() const
 {
     return !h_ptr->m_pathToDeviceDescriptor.isEmpty();
@@ -126,6 +154,11 @@ HDeviceHostConfigurationPrivate::HDeviceHostConfigurationPrivate() :
     m_collection(),
     m_individualAdvertisementCount(2),
     m_subscriptionExpirationTimeout(0),
+    m_maxEventQueueLength(8),
+    m_maxEventQueueSize(512 * 1024),
+    m_eventDeliveryFailureThreshold(3),
+    m_metricsEndpointEnabled(false),
+    m_localServerName(),
     m_networkAddresses(),
     m_deviceCreator(0),
     m_infoProvider(0)
@@ -178,6 +211,15 @@ void HDeviceHostConfiguration::doClone(HClonable* target) const
     conf->h_ptr->m_subscriptionExpirationTimeout =
         h_ptr->m_subscriptionExpirationTimeout;
 
+    conf->h_ptr->m_maxEventQueueLength = h_ptr->m_maxEventQueueLength;
+    conf->h_ptr->m_maxEventQueueSize = h_ptr->m_maxEventQueueSize;
+
+    conf->h_ptr->m_eventDeliveryFailureThreshold =
+        h_ptr->m_eventDeliveryFailureThreshold;
+
+    conf->h_ptr->m_metricsEndpointEnabled = h_ptr->m_metricsEndpointEnabled;
+    conf->h_ptr->m_localServerName = h_ptr->m_localServerName;
+
     QList<const HDeviceConfiguration*> confCollection;
     foreach(const HDeviceConfiguration* conf, h_ptr->m_collection)
     {
@@ -268,6 +310,56 @@ qint32 HDeviceHostConfiguration::subscriptionExpirationTimeout() const
     return h_ptr->m_subscriptionExpirationTimeout;
 }
 
+qint32 HDeviceHostConfiguration::maxEventQueueLength() const
+{
+    return h_ptr->m_maxEventQueueLength;
+}
+
+qint32 HDeviceHostConfiguration::maxEventQueueSize() const
+{
+    return h_ptr->m_maxEventQueueSize;
+}
+
+qint32 HDeviceHostConfiguration::eventDeliveryFailureThreshold() const
+{
+    return h_ptr->m_eventDeliveryFailureThreshold;
+}
+
+void HDeviceHostConfiguration::setMaxEventQueueLength(qint32 arg)
+{
+    h_ptr->m_maxEventQueueLength = qMax(arg, 2);
+}
+
+void HDeviceHostConfiguration::setMaxEventQueueSize(qint32 arg)
+{
+    h_ptr->m_maxEventQueueSize = qMax(arg, 0);
+}
+
+void HDeviceHostConfiguration::setEventDeliveryFailureThreshold(qint32 arg)
+{
+    h_ptr->m_eventDeliveryFailureThreshold = qMax(arg, 0);
+}
+
+bool HDeviceHostConfiguration::isMetricsEndpointEnabled() const
+{
+    return h_ptr->m_metricsEndpointEnabled;
+}
+
+void HDeviceHostConfiguration::setMetricsEndpointEnabled(bool enable)
+{
+    h_ptr->m_metricsEndpointEnabled = enable;
+}
+
+QString HDeviceHostConfiguration::localServerName() const
+{
+    return h_ptr->m_localServerName;
+}
+
+void HDeviceHostConfiguration::setLocalServerName(const QString& name)
+{
+    h_ptr->m_localServerName = name.trimmed();
+}
+
 void HDeviceHostConfiguration::setSubscriptionExpirationTimeout(qint32 arg)
 {
     static const qint32 max = 60*60*24;
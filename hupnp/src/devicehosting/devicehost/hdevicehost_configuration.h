@@ -133,6 +133,71 @@ public:
      */
     qint32 cacheControlMaxAge() const;
 
+    /*!
+     * \brief Sets the UDN of the device, which makes the device description
+     * a template shared by every device that uses the same description.
+     *
+     * When the UDN is set, the device description pointed by
+     * pathToDeviceDescription() and the service descriptions it refers to
+     * are read and parsed only once per HDeviceHost. Every device created from
+     * the same description shares the parsed action and state variable
+     * metadata, which makes adding a device with HDeviceHost::add() cheap.
+     * The UDN and the friendly name in the description are substituted
+     * with the values of this configuration when the description is served,
+     * and the UDNs of embedded devices are derived from the specified UDN.
+     * The derived UDNs are name-based UUIDs, which stay the same across
+     * restarts for as long as the specified UDN stays the same.
+     *
+     * \param udn specifies the UDN of the device. An invalid UDN turns
+     * the template mode off.
+     *
+     * \remarks The description files of a template are not re-read while the
+     * HDeviceHost is running, which means modifications to them are not noticed
+     * until the device host is restarted.
+     *
+     * \sa udn(), setFriendlyName(), isTemplateInstance()
+     */
+    void setUdn(const HUdn& udn);
+
+    /*!
+     * \brief Returns the UDN of a device created from a template.
+     *
+     * \return The UDN of a device created from a template. The returned
+     * object is invalid if the UDN has not been set.
+     *
+     * \sa setUdn()
+     */
+    HUdn udn() const;
+
+    /*!
+     * \brief Sets the friendly name of a device created from a template.
+     *
+     * \param friendlyName specifies the friendly name of the root device.
+     * If the friendly name is not set, the one in the template is used.
+     * This is used only if the UDN has been set.
+     *
+     * \sa friendlyName(), setUdn()
+     */
+    void setFriendlyName(const QString& friendlyName);
+
+    /*!
+     * \brief Returns the friendly name of a device created from a template.
+     *
+     * \return The friendly name of a device created from a template.
+     *
+     * \sa setFriendlyName()
+     */
+    QString friendlyName() const;
+
+    /*!
+     * \brief Indicates whether the device description is used as a template.
+     *
+     * \return \e true in case the UDN of the device has been set.
+     *
+     * \sa setUdn()
+     */
+    bool isTemplateInstance() const;
+
     /*!
      * \brief Indicates whether or not the object contains the necessary details
      * for hosting an HServerDevice class in a HDeviceHost.
@@ -180,6 +245,17 @@ class HDeviceHostConfigurationPrivate;
  * setSubscriptionExpirationTimeout(). The default is 0, which means that
  * an HDeviceHost respects the subscription timeouts requested by control points
  * as long as the requested values are less than a day.
+ * - Specify how many undelivered event messages are queued for a single
+ * event subscriber with setMaxEventQueueLength() and setMaxEventQueueSize().
+ * The defaults are 8 messages and 512 KiB.
+ * - Specify after how many consecutive failed deliveries the event messages to
+ * a subscriber are suspended for a while with
+ * setEventDeliveryFailureThreshold(). The default is 3.
+ * - Specify whether the runtime metrics are served over HTTP with
+ * setMetricsEndpointEnabled().
+ * - Specify a local endpoint through which the control points running on the
+ * same host can reach the device host with setLocalServerName(). By default
+ * there is none.
  * - Specify the network addresses an HDeviceHost should use in its operations
  * with setNetworkAddressesToUse().
  * The default is the first found interface that is up. Non-loopback interfaces
@@ -306,6 +382,72 @@ public:
      */
     qint32 subscriptionExpirationTimeout() const;
 
+    /*!
+     * \brief Returns the maximum number of event messages queued for
+     * a single event subscriber.
+     *
+     * The default value is 8.
+     *
+     * \return The maximum number of event messages queued for a single
+     * event subscriber.
+     *
+     * \sa setMaxEventQueueLength()
+     */
+    qint32 maxEventQueueLength() const;
+
+    /*!
+     * \brief Returns the maximum combined size in bytes of the event messages
+     * queued for a single event subscriber.
+     *
+     * The default value is 512 KiB.
+     *
+     * \return The maximum combined size in bytes of the event messages
+     * queued for a single event subscriber. Zero means there is no limit.
+     *
+     * \sa setMaxEventQueueSize()
+     */
+    qint32 maxEventQueueSize() const;
+
+    /*!
+     * \brief Returns the number of consecutive failed event deliveries after
+     * which the device host stops sending events to the subscriber for a while.
+     *
+     * The default value is 3.
+     *
+     * \return The number of consecutive failed event deliveries after
+     * which the device host stops sending events to the subscriber for a while.
+     * Zero means the deliveries are never suspended.
+     *
+     * \sa setEventDeliveryFailureThreshold()
+     */
+    qint32 eventDeliveryFailureThreshold() const;
+
+    /*!
+     * \brief Indicates whether the device host serves its runtime metrics
+     * over HTTP.
+     *
+     * The default value is \e false.
+     *
+     * \return \e true in case the device host serves its runtime metrics
+     * over HTTP.
+     *
+     * \sa setMetricsEndpointEnabled()
+     */
+    bool isMetricsEndpointEnabled() const;
+
+    /*!
+     * \brief Returns the name of the local endpoint the device host listens
+     * to in addition to its TCP endpoints.
+     *
+     * The default value is an empty string, which means the device host does
+     * not listen for local connections.
+     *
+     * \return The name of the local endpoint the device host listens to.
+     *
+     * \sa setLocalServerName()
+     */
+    QString localServerName() const;
+
     /*!
      * \brief Returns the device model creator the HDeviceHost should use
      * to create HServerDevice instances.
@@ -381,6 +523,93 @@ public:
      */
     void setSubscriptionExpirationTimeout(qint32 timeout);
 
+    /*!
+     * \brief Specifies the maximum number of event messages queued for a
+     * single event subscriber.
+     *
+     * Once the limit is exceeded, the undelivered messages are collapsed into
+     * the latest one. Since every event message contains the current values of
+     * all the evented state variables of the service, the subscriber still
+     * receives the current state and the sequence numbers stay contiguous.
+     *
+     * \param count specifies the maximum number of queued event messages,
+     * including the message being delivered. Values smaller than 2 are set to 2.
+     *
+     * \sa maxEventQueueLength(), setMaxEventQueueSize()
+     */
+    void setMaxEventQueueLength(qint32 count);
+
+    /*!
+     * \brief Specifies the maximum combined size in bytes of the event messages
+     * queued for a single event subscriber.
+     *
+     * Once the limit is exceeded, the undelivered messages are collapsed into
+     * the latest one, as described in setMaxEventQueueLength().
+     *
+     * \param size specifies the maximum size in bytes. Zero means there is
+     * no limit.
+     *
+     * \sa maxEventQueueSize()
+     */
+    void setMaxEventQueueSize(qint32 size);
+
+    /*!
+     * \brief Specifies the number of consecutive failed event deliveries after
+     * which the device host stops sending events to the subscriber for a while.
+     *
+     * While the deliveries are suspended, only the latest event message is
+     * kept. The suspension starts from 30 seconds and doubles each time the
+     * first delivery attempt after a suspension fails, up to four minutes.
+     *
+     * \param count specifies the number of consecutive failures. Zero means
+     * the deliveries are never suspended.
+     *
+     * \sa eventDeliveryFailureThreshold()
+     */
+    void setEventDeliveryFailureThreshold(qint32 count);
+
+    /*!
+     * \brief Specifies whether the device host serves its runtime metrics
+     * over HTTP.
+     *
+     * When enabled, the device host responds to HTTP GET requests to the path
+     * \c /metrics with HDeviceHost::metrics() in the Prometheus text format.
+     *
+     * \param enable specifies whether the device host serves its runtime
+     * metrics over HTTP.
+     *
+     * \remarks The metrics are available to anyone who can reach the device
+     * host, so enable this only in networks you trust.
+     *
+     * \sa isMetricsEndpointEnabled(), HMetrics::toPrometheusText()
+     */
+    void setMetricsEndpointEnabled(bool enable);
+
+    /*!
+     * \brief Specifies the name of a local endpoint the device host listens
+     * to in addition to its TCP endpoints.
+     *
+     * The endpoint is a Unix domain socket, which is advertised to the
+     * control points in the responses to device description requests.
+     * A control point running on the same host then sends its action
+     * invocations and event subscriptions through the socket instead of TCP,
+     * and the device host delivers the events to it the same way if the
+     * control point has a local endpoint of its own. Everything else, such as
+     * the discovery and the description documents, works as before.
+     *
+     * \param name specifies either a plain name, in which case the socket is
+     * created into the directory for temporary files, or an absolute path
+     * to the socket. An empty string disables the local endpoint.
+     *
+     * \remarks
+     * \li This is supported only on Unix. Elsewhere HDeviceHost::init()
+     * fails if a name is specified.
+     * \li Anyone who can access the socket file can access the device host.
+     *
+     * \sa localServerName(), HControlPointConfiguration::setLocalServerName()
+     */
+    void setLocalServerName(const QString& name);
+
     /*!
      * Defines the network addresses the device host should use in its
      * operations.
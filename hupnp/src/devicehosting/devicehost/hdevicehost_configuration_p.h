@@ -32,6 +32,8 @@
 
 #include "hdevicehost_configuration.h"
 
+#include "../../dataelements/hudn.h"
+
 #include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QScopedPointer>
@@ -55,6 +57,10 @@ public: // attributes
     QString m_pathToDeviceDescriptor;
     qint32  m_cacheControlMaxAgeInSecs;
 
+    HUdn m_udn;
+    QString m_friendlyName;
+    // the per-instance values of a device created from a template
+
 public: // methods
 
     HDeviceConfigurationPrivate();
@@ -78,6 +84,16 @@ public:
 
     qint32 m_subscriptionExpirationTimeout;
 
+    qint32 m_maxEventQueueLength;
+    qint32 m_maxEventQueueSize;
+    // the limits of the undelivered event messages of a single subscriber
+
+    qint32 m_eventDeliveryFailureThreshold;
+
+    bool m_metricsEndpointEnabled;
+
+    QString m_localServerName;
+
     QList<QHostAddress> m_networkAddresses;
 
     QScopedPointer<HDeviceModelCreator> m_deviceCreator;
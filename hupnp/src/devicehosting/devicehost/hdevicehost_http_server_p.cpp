@@ -24,12 +24,14 @@
 
 #include "../messages/hcontrol_messages_p.h"
 
+#include "../../http/hhttp_utils_p.h"
 #include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hupnp_global_p.h"
 #include "../../general/hupnp_datatypes_p.h"
 
 #include "../../devicemodel/hactionarguments.h"
+#include "../../devicemodel/hactionarguments_p.h"
 #include "../../devicemodel/server/hserveraction.h"
 #include "../../devicemodel/server/hserverdevice.h"
 #include "../../devicemodel/server/hserverservice.h"
@@ -39,9 +41,12 @@
 #include "../../dataelements/hserviceinfo.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hmetrics.h"
+#include "../../general/hmetrics_p.h"
 
 #include <QtCore/QUrl>
 #include <QtCore/QPair>
+#include <QtCore/QElapsedTimer>
 
 namespace Herqq
 {
@@ -83,7 +88,7 @@ HDeviceHostHttpServer::HDeviceHostHttpServer(
     QObject* parent) :
         HHttpServer(loggingId, parent),
             m_deviceStorage(ds), m_eventNotifier(en), m_ddPostFix(ddPostFix),
-            m_ops()
+            m_ops(), m_actionDurations(), m_metricsEndpointEnabled(false)
 {
 }
 
@@ -179,6 +184,15 @@ void HDeviceHostHttpServer::incomingSubscriptionRequest(
 
     HServiceEventSubscriber* subscriber = m_eventNotifier.remoteClient(sid);
 
+    if (!sreq.isRenewal() && !sreq.localServer().isEmpty() &&
+        HHttpUtils::isLocalPeer(mi->socket()))
+    {
+        // the subscriber runs on the same host and the events are delivered
+        // to its local endpoint. the endpoint is not accepted from others,
+        // since it would let them direct the device host to any local socket.
+        subscriber->setLocalServer(sreq.localServer());
+    }
+
     HSubscribeResponse response(
         subscriber->sid(),
         HSysInfo::instance().herqqProductTokens(),
@@ -293,13 +307,13 @@ void HDeviceHostHttpServer::incomingControlRequest(
         return;
     }
 
+    // the copy shares the argument names with the action information and
+    // only the values are set here
     HActionArguments iargs = action->info().inputArguments();
-    HActionArguments::iterator it = iargs.begin();
-    for(; it != iargs.end(); ++it)
+    HActionArgumentsPrivate* iargsData = HActionArgumentsPrivate::get(iargs);
+    for(qint32 i = 0; i < iargsData->size(); ++i)
     {
-        HActionArgument iarg = *it;
-
-        const QtSoapType& arg = method[iarg.name()];
+        const QtSoapType& arg = method[iargsData->nameAt(i)];
         if (!arg.isValid())
         {
             mi->setKeepAlive(false);
@@ -309,9 +323,10 @@ void HDeviceHostHttpServer::incomingControlRequest(
             return;
         }
 
-        if (!iarg.setValue(
+        if (!iargsData->setValueAt(i,
                 HUpnpDataTypes::convertToRightVariantType(
-                    arg.value().toString(), iarg.dataType())))
+                    arg.value().toString(),
+                    iargsData->stateVariableAt(i).dataType())))
         {
             mi->setKeepAlive(false);
             m_httpHandler->send(mi, HHttpMessageCreator::createResponse(
@@ -321,8 +336,22 @@ void HDeviceHostHttpServer::incomingControlRequest(
         }
     }
 
-    HActionArguments outArgs = action->info().outputArguments();
+    HMetricHistogram*& durations = m_actionDurations[action->info().name()];
+    if (!durations)
+    {
+        durations = HMetricsRegistry::histogram(QString(
+            "hupnp_action_duration_milliseconds{side=\"server\",action=\"%1\"}").arg(
+                HMetricsRegistry::label(action->info().name())));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // HServerAction::invoke() initializes the output arguments
+    HActionArguments outArgs;
     qint32 retVal = action->invoke(iargs, &outArgs);
+
+    durations->add(static_cast<qint32>(timer.elapsed()));
     if (retVal != UpnpSuccess)
     {
         mi->setKeepAlive(false);
@@ -340,10 +369,16 @@ void HDeviceHostHttpServer::incomingControlRequest(
         QString("%1%2").arg(action->info().name(), "Response"),
         service->info().serviceType().toString()));
 
-    foreach(const HActionArgument& oarg, outArgs)
+    const HActionArgumentsPrivate* outArgsData =
+        HActionArgumentsPrivate::get(outArgs);
+
+    for(qint32 i = 0; i < outArgsData->size(); ++i)
     {
         QtSoapType* soapArg =
-            new SoapType(oarg.name(), oarg.dataType(), oarg.value());
+            new SoapType(
+                outArgsData->nameAt(i),
+                outArgsData->stateVariableAt(i).dataType(),
+                outArgsData->valueAt(i));
 
         soapResponse.addMethodArgument(soapArg);
     }
@@ -367,6 +402,15 @@ void HDeviceHostHttpServer::incomingUnknownGetRequest(
     HLOG_DBG(QString(
         "HTTP GET request received from [%1] to [%2].").arg(peer, requestPath));
 
+    if (m_metricsEndpointEnabled && requestPath == "/metrics")
+    {
+        m_httpHandler->send(mi, HHttpMessageCreator::createResponse(
+            Ok, *mi, metrics().toPrometheusText().toUtf8(),
+            ContentType_TextPlain));
+
+        return;
+    }
+
     QUuid searchedUdn(requestPath.section('/', 1, 1));
     if (searchedUdn.isNull())
     {
@@ -413,6 +457,20 @@ void HDeviceHostHttpServer::incomingUnknownGetRequest(
         HLOG_DBG(QString(
             "Sending device description to [%1] as requested.").arg(peer));
 
+        QString localServer = localServerName();
+        if (!localServer.isEmpty() && HHttpUtils::isLocalPeer(mi->socket()))
+        {
+            // the control points on the same host may use the local endpoint
+            // in the messaging that follows
+            HHttpResponseHeader hdr(200, "OK");
+            hdr.setValue(HHttpUtils::localServerHeader(), localServer);
+
+            m_httpHandler->send(mi, HHttpMessageCreator::setupData(
+                hdr, device->description().toUtf8(), *mi, ContentType_TextXml));
+
+            return;
+        }
+
         m_httpHandler->send(mi, HHttpMessageCreator::createResponse(
             Ok, *mi, device->description().toUtf8(), ContentType_TextXml));
 
@@ -492,5 +550,29 @@ bool HDeviceHostHttpServer::sendComplete(HHttpAsyncOperation* op)
     return true;
 }
 
+HMetrics HDeviceHostHttpServer::metrics() const
+{
+    HMetrics retVal = HMetricsRegistry::snapshot();
+
+    qint32 suspended = 0;
+    foreach(const HServiceEventSubscriber* sub, m_eventNotifier.subscribers())
+    {
+        retVal.setGauge(QString(
+            "hupnp_gena_subscriber_queue_length{sid=\"%1\",callback=\"%2\"}").arg(
+                sub->sid().toString(),
+                HMetricsRegistry::label(sub->location().toString())),
+            sub->queueLength());
+
+        if (sub->isSuspended())
+        {
+            ++suspended;
+        }
+    }
+
+    retVal.setGauge("hupnp_gena_subscribers_suspended", suspended);
+
+    return retVal;
+}
+
 }
 }
@@ -38,6 +38,7 @@
 
 #include "../../http/hhttp_server_p.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QPointer>
 
 namespace Herqq
@@ -46,6 +47,9 @@ namespace Herqq
 namespace Upnp
 {
 
+class HMetrics;
+struct HMetricHistogram;
+
 //
 //
 //
@@ -89,6 +93,11 @@ private:
 
     QList<QPair<QPointer<HHttpAsyncOperation>, HOpInfo> > m_ops;
 
+    QHash<QString, HMetricHistogram*> m_actionDurations;
+    // the invocation durations of each action, keyed by the action name
+
+    bool m_metricsEndpointEnabled;
+
 protected:
 
     virtual void incomingSubscriptionRequest(
@@ -113,6 +122,17 @@ public:
         QObject* parent = 0);
 
     virtual ~HDeviceHostHttpServer();
+
+    // the process-wide metrics and the event queue depths of the subscribers
+    // of this device host
+    HMetrics metrics() const;
+
+    // when enabled, the metrics are served in the Prometheus text format
+    // to HTTP GET requests to /metrics
+    inline void setMetricsEndpointEnabled(bool enable)
+    {
+        m_metricsEndpointEnabled = enable;
+    }
 };
 
 }
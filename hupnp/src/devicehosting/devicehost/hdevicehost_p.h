@@ -34,6 +34,7 @@
 
 #include "../hdevicestorage_p.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
 
@@ -54,6 +55,7 @@ class PresenceAnnouncer;
 class HDeviceHostHttpServer;
 class HDeviceHostSsdpHandler;
 class HServerDeviceController;
+class HServerModelTemplate;
 class HDeviceHostConfiguration;
 
 
@@ -109,6 +111,10 @@ public: // attributes
 
     QNetworkAccessManager* m_nam;
 
+    QHash<QString, HServerModelTemplate*> m_templates;
+    // The parsed descriptions shared by the devices created from templates,
+    // keyed by the paths to the device descriptions.
+
 public Q_SLOTS:
 
     void announcementTimedout(HServerDeviceController*);
@@ -124,6 +130,7 @@ public: // methods
     void startNotifiers();
     bool createRootDevice(const HDeviceConfiguration*);
     bool createRootDevices();
+    void clearTemplates();
 
     inline static const QString& deviceDescriptionPostFix()
     {
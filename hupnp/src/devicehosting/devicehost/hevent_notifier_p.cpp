@@ -25,6 +25,7 @@
 
 #include "../messages/hevent_messages_p.h"
 
+#include "../../devicemodel/hdevicestatus.h"
 #include "../../devicemodel/server/hserverdevice.h"
 #include "../../devicemodel/server/hserverservice.h"
 #include "../../devicemodel/server/hserverstatevariable.h"
@@ -35,8 +36,12 @@
 #include "../../dataelements/hstatevariableinfo.h"
 
 #include "../../http/hhttp_messaginginfo_p.h"
+#include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hmetrics_p.h"
+
+#include "../../socket/hmulticast_socket.h"
 
 #include <QtXml/QDomDocument>
 #include <QtNetwork/QTcpSocket>
@@ -49,7 +54,8 @@ namespace Upnp
 
 namespace
 {
-void getCurrentValues(QByteArray& msgBody, const HServerService* service)
+bool getCurrentValues(
+    QByteArray& msgBody, const HServerService* service, bool multicastOnly = false)
 {
     HLOG(H_AT, H_FUN);
 
@@ -73,7 +79,9 @@ void getCurrentValues(QByteArray& msgBody, const HServerService* service)
         Q_ASSERT(stateVar);
 
         const HStateVariableInfo& info = stateVar->info();
-        if (info.eventingType() == HStateVariableInfo::NoEvents)
+        if (info.eventingType() == HStateVariableInfo::NoEvents ||
+           (multicastOnly &&
+            info.eventingType() != HStateVariableInfo::UnicastAndMulticast))
         {
             continue;
         }
@@ -88,7 +96,30 @@ void getCurrentValues(QByteArray& msgBody, const HServerService* service)
         propertySetElem.appendChild(propertyElem);
     }
 
+    if (!propertySetElem.hasChildNodes())
+    {
+        return false;
+    }
+
     msgBody = dd.toByteArray();
+    return true;
+}
+
+inline QHostAddress multicastEventAddress()
+{
+    static QHostAddress retVal("239.255.255.246");
+    return retVal;
+}
+
+inline quint16 multicastEventPort()
+{
+    return 7900;
+}
+
+// the UDA specifies 2 as the default TTL of multicast messages
+inline quint8 multicastEventTtl()
+{
+    return 2;
 }
 }
 
@@ -102,7 +133,10 @@ HEventNotifier::HEventNotifier(
         QObject(parent),
             m_loggingIdentifier(loggingIdentifier),
             m_subscribers(),
-            m_configuration(configuration)
+            m_configuration(configuration),
+            m_multicastSockets(),
+            m_multicastSeqs(),
+            m_propertySets()
 {
 }
 
@@ -217,6 +251,7 @@ StatusCode HEventNotifier::addSubscriber(
             service,
             sreq.callbacks().at(0),
             timeout,
+            m_configuration,
             this);
 
     m_subscribers.push_back(rc);
@@ -317,6 +352,9 @@ void HEventNotifier::stateChanged(const HServerService* source)
 
     QByteArray msgBody;
     getCurrentValues(msgBody, source);
+    setPropertySet(source, msgBody);
+
+    qint32 fanOut = 0;
 
     QList<HServiceEventSubscriber*>::iterator it = m_subscribers.begin();
     for(; it != m_subscribers.end(); )
@@ -325,6 +363,7 @@ void HEventNotifier::stateChanged(const HServerService* source)
         if (sub->isInterested(source))
         {
             sub->notify(msgBody);
+            ++fanOut;
             ++it;
         }
         else if ((*it)->expired())
@@ -341,7 +380,105 @@ void HEventNotifier::stateChanged(const HServerService* source)
         }
     }
 
-    // TODO add multicast event support
+    if (fanOut)
+    {
+        HMetricsRegistry::add(HMetricsRegistry::GenaNotifications, fanOut);
+    }
+
+    multicastNotify(source);
+}
+
+void HEventNotifier::multicastNotify(const HServerService* source)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    // UDA 2.0 multicast eventing is used only for the state variables that
+    // are marked as multicast evented in the SCPD. The message contains the
+    // current values of all those variables and it is sent only when one of
+    // them has changed, not when the state change concerned only unicast
+    // evented variables.
+    QByteArray msgBody;
+    if (!getCurrentValues(msgBody, source, true) ||
+        m_multicastPropertySets.value(source) == msgBody)
+    {
+        return;
+    }
+
+    m_multicastPropertySets.insert(source, msgBody);
+
+    if (m_multicastSockets.isEmpty())
+    {
+        foreach(const QHostAddress& ha, m_configuration.networkAddressesToUse())
+        {
+            HMulticastSocket* sock = new HMulticastSocket(this);
+            if (!sock->bind(ha, 0))
+            {
+                HLOG_WARN(QString(
+                    "Failed to bind a socket for multicast eventing on "
+                    "address [%1]").arg(ha.toString()));
+
+                delete sock;
+                continue;
+            }
+
+            if (!sock->setMulticastTtl(multicastEventTtl()))
+            {
+                HLOG_WARN(QString(
+                    "Failed to set the multicast TTL of the socket bound to "
+                    "address [%1]").arg(ha.toString()));
+            }
+
+            // the socket is bound to the address, but the interface from
+            // which the datagrams leave is chosen separately
+            if (!sock->setMulticastInterface(ha))
+            {
+                HLOG_WARN(QString(
+                    "Failed to set the multicast interface of the socket bound to "
+                    "address [%1]").arg(ha.toString()));
+            }
+
+            m_multicastSockets.append(sock);
+        }
+    }
+
+    const HServerDevice* device = source->parentDevice();
+
+    // the SEQ of multicast events is maintained per service. Zero is used only
+    // for the first message and the counter wraps to one.
+    quint32& seq = m_multicastSeqs[source];
+
+    HMulticastNotifyRequest req(
+        HDiscoveryType(device->info().udn(), source->info().serviceType()),
+        source->info().serviceId(),
+        seq,
+        "upnp:/info",
+        device->rootDevice()->deviceStatus().bootId(),
+        msgBody);
+
+    seq = seq == 0xffffffff ? 1 : seq + 1;
+
+    if (!req.isValid(false))
+    {
+        HLOG_WARN(QString(
+            "Could not create a multicast event message for service [%1]").arg(
+                source->info().serviceId().toString()));
+        return;
+    }
+
+    QByteArray data = HHttpMessageCreator::create(req);
+    foreach(HMulticastSocket* sock, m_multicastSockets)
+    {
+        if (sock->writeDatagram(
+                data, multicastEventAddress(), multicastEventPort()) < 0)
+        {
+            HLOG_WARN(QString("Failed to send a multicast event: %1").arg(
+                sock->errorString()));
+        }
+        else
+        {
+            HMetricsRegistry::add(HMetricsRegistry::GenaMulticastNotifications);
+        }
+    }
 }
 
 void HEventNotifier::initialNotify(
@@ -349,8 +486,14 @@ void HEventNotifier::initialNotify(
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    QByteArray msgBody;
-    getCurrentValues(msgBody, rc->service());
+    // a burst of subscriptions to the same service, such as when a control
+    // point restarts, is served from the same snapshot
+    QByteArray msgBody = m_propertySets.value(rc->service());
+    if (msgBody.isEmpty())
+    {
+        getCurrentValues(msgBody, rc->service());
+        setPropertySet(rc->service(), msgBody);
+    }
 
     if (mi->keepAlive() && mi->socket().state() == QTcpSocket::ConnectedState)
     {
@@ -385,13 +528,15 @@ void HEventNotifier::initialNotify(
 
     // before sending the initial event message (specified in UDA),
     // the UDA mandates that FIN has been sent to the subscriber unless
-    // the connection is to be kept alive.
+    // the connection is to be kept alive. if the connection cannot be closed
+    // right away, the subscriber sends the initial event once it has been.
     if (mi->socket().state() == QTcpSocket::ConnectedState)
     {
         mi->socket().disconnectFromHost();
-        if (mi->socket().state() != QAbstractSocket::UnconnectedState)
+        if (mi->socket().state() == QAbstractSocket::ClosingState)
         {
-            mi->socket().waitForDisconnected(50);
+            rc->initialNotifyOnClose(msgBody, mi);
+            return;
         }
     }
 
@@ -399,5 +544,49 @@ void HEventNotifier::initialNotify(
     rc->initialNotify(msgBody);
 }
 
+void HEventNotifier::addService(const HServerService* service)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    // the values the multicast evented variables have at start-up are the
+    // ones against which the first change is detected
+    QByteArray msgBody;
+    if (service->isEvented() && getCurrentValues(msgBody, service, true))
+    {
+        watchService(service);
+        m_multicastPropertySets.insert(service, msgBody);
+    }
+}
+
+void HEventNotifier::watchService(const HServerService* service)
+{
+    if (!m_propertySets.contains(service) &&
+        !m_multicastSeqs.contains(service) &&
+        !m_multicastPropertySets.contains(service))
+    {
+        bool ok = connect(
+            service, SIGNAL(destroyed(QObject*)),
+            this, SLOT(serviceDestroyed(QObject*)));
+
+        Q_ASSERT(ok); Q_UNUSED(ok)
+    }
+}
+
+void HEventNotifier::setPropertySet(
+    const HServerService* service, const QByteArray& propertySet)
+{
+    watchService(service);
+    m_propertySets.insert(service, propertySet);
+}
+
+void HEventNotifier::serviceDestroyed(QObject* obj)
+{
+    const HServerService* service = static_cast<const HServerService*>(obj);
+
+    m_propertySets.remove(service);
+    m_multicastSeqs.remove(service);
+    m_multicastPropertySets.remove(service);
+}
+
 }
 }
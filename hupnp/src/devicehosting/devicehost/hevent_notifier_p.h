@@ -34,6 +34,7 @@
 #include "../../general/hupnp_fwd.h"
 #include "../../general/hupnp_defs.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QByteArray>
@@ -46,6 +47,7 @@ namespace Upnp
 
 class HSid;
 class HTimeout;
+class HMulticastSocket;
 class HMessagingInfo;
 class HSubscribeRequest;
 class HUnsubscribeRequest;
@@ -69,13 +71,34 @@ private: // attributes
 
     HDeviceHostConfiguration& m_configuration;
 
+    QList<HMulticastSocket*> m_multicastSockets;
+    // one socket per network address; created on the first multicast event
+
+    QHash<const HServerService*, quint32> m_multicastSeqs;
+    // the sequence number of the next multicast event of each service
+
+    QHash<const HServerService*, QByteArray> m_multicastPropertySets;
+    // the propertyset containing the values of the multicast evented state
+    // variables of a service that were last sent, or the initial values
+    // if none have been sent yet
+
+    QHash<const HServerService*, QByteArray> m_propertySets;
+    // the propertyset containing the current values of all the evented
+    // state variables of a service. this is replaced whenever the service
+    // signals a state change.
+
 private: // methods
 
     HTimeout getSubscriptionTimeout(const HSubscribeRequest&);
 
+    void multicastNotify(const HServerService*);
+    void watchService(const HServerService*);
+    void setPropertySet(const HServerService*, const QByteArray&);
+
 private Q_SLOTS:
 
     void stateChanged(const Herqq::Upnp::HServerService* source);
+    void serviceDestroyed(QObject*);
 
 public:
 
@@ -86,12 +109,21 @@ public:
 
     virtual ~HEventNotifier();
 
+    // records the initial values of the multicast evented state variables
+    // of a service whose state changes are signaled to this instance
+    void addService(const HServerService*);
+
     StatusCode addSubscriber(HServerService*, const HSubscribeRequest&, HSid*);
 
     bool removeSubscriber(const HUnsubscribeRequest&);
     StatusCode renewSubscription(const HSubscribeRequest&, HSid*);
     HServiceEventSubscriber* remoteClient(const HSid&) const;
 
+    inline const QList<HServiceEventSubscriber*>& subscribers() const
+    {
+        return m_subscribers;
+    }
+
     void initialNotify(HServiceEventSubscriber*, HMessagingInfo*);
 };
 
@@ -20,11 +20,13 @@
  */
 
 #include "hevent_subscriber_p.h"
+#include "hdevicehost_configuration.h"
 
 #include "../../devicemodel/server/hserverservice.h"
 #include "../../dataelements/hserviceid.h"
 #include "../../dataelements/hserviceinfo.h"
 
+#include "../../http/hhttp_utils_p.h"
 #include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hlogger_p.h"
@@ -38,6 +40,14 @@ namespace Herqq
 namespace Upnp
 {
 
+namespace
+{
+// the first suspension of deliveries to a failing subscriber. each failed
+// attempt after a suspension doubles this up to eight times.
+const qint32 SuspensionMsecs = 30000;
+const qint32 MaxSuspensionShift = 3;
+}
+
 bool HServiceEventSubscriber::send(HMessagingInfo* mi)
 {
     HLOG2(H_AT, H_FUN, "__DEVICE HOST__: ");
@@ -49,6 +59,7 @@ bool HServiceEventSubscriber::send(HMessagingInfo* mi)
                 m_sid.toString()));
 
         delete mi;
+        send();
         return false;
     }
 
@@ -77,14 +88,19 @@ bool HServiceEventSubscriber::send(HMessagingInfo* mi)
             "Could not send notify [seq: %1, sid: %2] to host @ [%3].").arg(
                 QString::number(seq), m_sid.toString(),
                 m_location.toString()));
+
+        dequeue();
+        return false;
     }
 
-    return oper;
+    m_sending = true;
+    return true;
 }
 
 HServiceEventSubscriber::HServiceEventSubscriber(
     const QByteArray& loggingIdentifier, HServerService* service,
-    const QUrl location, const HTimeout& timeout, QObject* parent) :
+    const QUrl location, const HTimeout& timeout,
+    const HDeviceHostConfiguration& conf, QObject* parent) :
         QObject(parent),
             m_service(service),
             m_location(location),
@@ -95,8 +111,20 @@ HServiceEventSubscriber::HServiceEventSubscriber(
             m_asyncHttp(loggingIdentifier, this),
             m_socket(new QTcpSocket(this)),
             m_messagesToSend(),
+            m_maxQueueLength(conf.maxEventQueueLength()),
+            m_maxQueueSize(conf.maxEventQueueSize()),
+            m_queuedBytes(0),
+            m_coalescedCount(0),
+            m_sending(false),
+            m_failureThreshold(conf.eventDeliveryFailureThreshold()),
+            m_consecutiveFailures(0),
+            m_suspensionCount(0),
+            m_suspensionTimer(this),
             m_expired(false),
-            m_loggingIdentifier(loggingIdentifier)
+            m_loggingIdentifier(loggingIdentifier),
+            m_closingConnection(0),
+            m_initialMessage(),
+            m_localServer()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
@@ -113,6 +141,18 @@ HServiceEventSubscriber::HServiceEventSubscriber(
 
     Q_ASSERT(ok);
 
+    ok = connect(
+        m_socket.data(), SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(connectionFailed()));
+
+    Q_ASSERT(ok);
+
+    m_suspensionTimer.setSingleShot(true);
+    ok = connect(
+        &m_suspensionTimer, SIGNAL(timeout()), this, SLOT(suspensionTimeout()));
+
+    Q_ASSERT(ok);
+
     ok = connect(
         &m_asyncHttp, SIGNAL(msgIoComplete(HHttpAsyncOperation*)),
         this, SLOT(msgIoComplete(HHttpAsyncOperation*)));
@@ -130,6 +170,12 @@ HServiceEventSubscriber::~HServiceEventSubscriber()
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
     Q_ASSERT(thread() == QThread::currentThread());
 
+    if (m_closingConnection)
+    {
+        m_closingConnection->socket().disconnect(this);
+        delete m_closingConnection;
+    }
+
     HLOG_DBG(QString(
         "Subscription from [%1] with SID %2 cancelled").arg(
             m_location.toString(), m_sid.toString()));
@@ -154,19 +200,147 @@ bool HServiceEventSubscriber::connectToHost()
         return false;
     }
 
+    if (!m_localServer.isEmpty())
+    {
+        if (state != QTcpSocket::UnconnectedState)
+        {
+            m_socket->abort();
+        }
+
+        // connecting to a local endpoint completes immediately and no
+        // connected() signal is emitted
+        if (HHttpUtils::connectToLocalServer(*m_socket, m_localServer))
+        {
+            return true;
+        }
+
+        HLOG_WARN(QString(
+            "Cannot connect to the local endpoint [%1] of subscriber [%2]. "
+            "Using [%3] instead.").arg(
+                m_localServer, m_sid.toString(), m_location.toString()));
+
+        m_localServer.clear();
+    }
+
     m_socket->connectToHost(m_location.host(), m_location.port());
 
     return false;
 }
 
+void HServiceEventSubscriber::enqueue(const QByteArray& msgBody)
+{
+    m_messagesToSend.enqueue(msgBody);
+    m_queuedBytes += msgBody.size();
+}
+
+void HServiceEventSubscriber::dequeue()
+{
+    if (!m_messagesToSend.isEmpty())
+    {
+        m_queuedBytes -= m_messagesToSend.dequeue().size();
+    }
+}
+
+void HServiceEventSubscriber::coalesce(bool keepHead)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    qint32 keep = keepHead ? 2 : 1;
+    if (m_messagesToSend.size() <= keep)
+    {
+        return;
+    }
+
+    QByteArray latest = m_messagesToSend.last();
+    qint32 dropped = m_messagesToSend.size() - keep;
+
+    while(m_messagesToSend.size() > keep - 1)
+    {
+        m_queuedBytes -= m_messagesToSend.takeLast().size();
+    }
+    enqueue(latest);
+
+    m_coalescedCount += dropped;
+
+    HLOG_DBG(QString(
+        "Collapsed [%1] undelivered notifications to subscriber [%2] @ [%3]").arg(
+            QString::number(dropped), m_sid.toString(), m_location.toString()));
+}
+
+void HServiceEventSubscriber::deliveryFailed()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    ++m_consecutiveFailures;
+
+    if (m_failureThreshold <= 0 || m_consecutiveFailures < m_failureThreshold)
+    {
+        return;
+    }
+
+    qint32 timeout =
+        SuspensionMsecs << qMin(m_suspensionCount, MaxSuspensionShift);
+
+    ++m_suspensionCount;
+
+    m_suspensionTimer.start(timeout);
+
+    HLOG_WARN(QString(
+        "[%1] notifications in a row to subscriber [%2] @ [%3] failed. "
+        "Suspending notifications for [%4] seconds.").arg(
+            QString::number(m_consecutiveFailures), m_sid.toString(),
+            m_location.toString(), QString::number(timeout / 1000)));
+}
+
+void HServiceEventSubscriber::connectionFailed()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    if (m_sending || isSuspended() || m_messagesToSend.isEmpty())
+    {
+        // a failure during message exchange is reported through
+        // msgIoComplete() and errors on an idle connection are of no concern
+        return;
+    }
+
+    HLOG_FIELD(Sid, m_sid.toString());
+    HLOG_FIELD(Peer, m_location.toString());
+    HLOG_WARN(QString(
+        "Could not connect to subscriber [%1] @ [%2]: %3.").arg(
+            m_sid.toString(), m_location.toString(), m_socket->errorString()));
+
+    // the message is left at the head of the queue. it is sent once the next
+    // notification is queued or once the suspension of deliveries ends.
+    deliveryFailed();
+    if (isSuspended())
+    {
+        coalesce(false);
+    }
+}
+
+void HServiceEventSubscriber::suspensionTimeout()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    HLOG_DBG(QString(
+        "Resuming notifications to subscriber [%1] @ [%2]").arg(
+            m_sid.toString(), m_location.toString()));
+
+    send();
+}
+
 void HServiceEventSubscriber::msgIoComplete(HHttpAsyncOperation* operation)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
     operation->deleteLater();
 
+    m_sending = false;
+
     if (operation->state() == HHttpAsyncOperation::Failed)
     {
+        HLOG_FIELD(Sid, m_sid.toString());
+        HLOG_FIELD(Peer, m_location.toString());
         HLOG_WARN(QString(
             "Notification [seq: %1, sid: %2] to host @ [%3] failed: %4.").arg(
                 QString::number(m_seq-1),
@@ -174,10 +348,16 @@ void HServiceEventSubscriber::msgIoComplete(HHttpAsyncOperation* operation)
                 m_location.toString(),
                 operation->messagingInfo()->lastErrorDescription()));
 
+        deliveryFailed();
+
         if (m_seq == 1)
         {
+            // the initial message has to be delivered before anything else
             m_seq--;
-            send();
+            if (!isSuspended())
+            {
+                send();
+            }
             return;
         }
     }
@@ -186,14 +366,18 @@ void HServiceEventSubscriber::msgIoComplete(HHttpAsyncOperation* operation)
         HLOG_DBG(QString(
             "Notification [seq: %1] successfully sent to subscriber [%2] @ [%3]").arg(
                 QString::number(m_seq-1), m_sid.toString(), m_location.toString()));
+
+        m_consecutiveFailures = 0;
+        m_suspensionCount = 0;
     }
 
-    if (!m_messagesToSend.isEmpty())
+    dequeue();
+
+    if (isSuspended())
     {
-        m_messagesToSend.dequeue();
+        coalesce(false);
     }
-
-    if (!m_messagesToSend.isEmpty())
+    else if (!m_messagesToSend.isEmpty())
     {
         send();
     }
@@ -203,7 +387,8 @@ void HServiceEventSubscriber::send()
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    if (m_messagesToSend.isEmpty() || !connectToHost() || !m_socket->isValid())
+    if (m_sending || isSuspended() || m_messagesToSend.isEmpty() ||
+        !connectToHost() || !m_socket->isValid())
     {
         return;
     }
@@ -237,7 +422,12 @@ void HServiceEventSubscriber::send()
             "Could not send notify [seq: %1, sid: %2] to host @ [%3].").arg(
                 QString::number(seq), m_sid.toString(),
                 m_location.toString()));
+
+        dequeue();
+        return;
     }
+
+    m_sending = true;
 }
 
 void HServiceEventSubscriber::subscriptionTimeout()
@@ -260,7 +450,10 @@ bool HServiceEventSubscriber::isInterested(const HServerService* service) const
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    return !expired() && m_seq && m_service->isEvented() &&
+    // a subscriber whose initial event message is waiting for the
+    // subscription connection to close is interested in the changes too
+    return !expired() && (m_seq || m_closingConnection) &&
+            m_service->isEvented() &&
             m_service->info().serviceId() == service->info().serviceId();
 }
 
@@ -288,13 +481,33 @@ void HServiceEventSubscriber::notify(const QByteArray& msgBody)
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
     Q_ASSERT(QThread::currentThread() == thread());
 
-    m_messagesToSend.enqueue(msgBody);
-    if (m_messagesToSend.size() <= 1)
+    if (m_closingConnection)
     {
-        // if there's more messages to send the sending process is active and
-        // this message is enqueued to be sent once it's turn comes
-        send();
+        // the initial event message has not been sent yet. every message
+        // contains the current values of all the evented state variables,
+        // which is why the latest one replaces it
+        m_initialMessage = msgBody;
+        return;
     }
+
+    enqueue(msgBody);
+
+    if (isSuspended())
+    {
+        coalesce(false);
+        return;
+    }
+
+    if (m_messagesToSend.size() > m_maxQueueLength ||
+        (m_maxQueueSize > 0 && m_queuedBytes > m_maxQueueSize))
+    {
+        // the head of the queue may be in delivery, in which case it has
+        // already been assigned a seq and it cannot be dropped
+        coalesce(true);
+    }
+
+    // if a message is being sent, this message is sent once its turn comes
+    send();
 }
 
 bool HServiceEventSubscriber::initialNotify(
@@ -304,7 +517,7 @@ bool HServiceEventSubscriber::initialNotify(
 
     Q_ASSERT(!m_seq);
 
-    m_messagesToSend.enqueue(msg);
+    enqueue(msg);
 
     if (!mi) { send()  ; }
     else     { send(mi); }
@@ -312,5 +525,50 @@ bool HServiceEventSubscriber::initialNotify(
     return true;
 }
 
+void HServiceEventSubscriber::initialNotifyOnClose(
+    const QByteArray& msg, HMessagingInfo* mi)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    Q_ASSERT(mi);
+    Q_ASSERT(!m_closingConnection);
+
+    m_closingConnection = mi;
+    m_initialMessage = msg;
+
+    bool ok = connect(
+        &mi->socket(), SIGNAL(disconnected()),
+        this, SLOT(subscriptionConnectionClosed()));
+
+    Q_ASSERT(ok); Q_UNUSED(ok)
+
+    ok = connect(
+        &mi->socket(), SIGNAL(error(QAbstractSocket::SocketError)),
+        this, SLOT(subscriptionConnectionClosed()));
+
+    Q_ASSERT(ok);
+}
+
+void HServiceEventSubscriber::subscriptionConnectionClosed()
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+
+    if (!m_closingConnection)
+    {
+        return;
+    }
+
+    HMessagingInfo* mi = m_closingConnection;
+    m_closingConnection = 0;
+
+    mi->socket().disconnect(this);
+    delete mi;
+
+    QByteArray msg = m_initialMessage;
+    m_initialMessage.clear();
+
+    initialNotify(msg);
+}
+
 }
 }
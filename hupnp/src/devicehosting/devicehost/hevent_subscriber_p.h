@@ -47,6 +47,7 @@ namespace Upnp
 {
 
 class HMessagingInfo;
+class HDeviceHostConfiguration;
 
 //
 // Internal class used to maintain information about a single event subscriber.
@@ -70,17 +71,60 @@ private: // attributes
     QScopedPointer<QTcpSocket> m_socket;
     QQueue<QByteArray> m_messagesToSend;
 
+    const qint32 m_maxQueueLength;
+    const qint32 m_maxQueueSize;
+    qint32 m_queuedBytes;
+    // the limits and the current size of m_messagesToSend. once a limit is
+    // exceeded the undelivered messages are collapsed into the latest one.
+    // this is fine, since every message contains the current values of all the
+    // evented state variables and the seq is assigned only when a message
+    // is sent.
+
+    qint32 m_coalescedCount;
+    // the number of messages dropped due to coalescing
+
+    bool m_sending;
+    // true when the message at the head of the queue has been sent and
+    // the response is being waited
+
+    const qint32 m_failureThreshold;
+    qint32 m_consecutiveFailures;
+    qint32 m_suspensionCount;
+    QTimer m_suspensionTimer;
+    // when m_failureThreshold deliveries in a row have failed, the deliveries
+    // are suspended until m_suspensionTimer fires. during that time only
+    // the latest message is kept.
+
     bool m_expired;
 
     const QByteArray m_loggingIdentifier;
 
+    HMessagingInfo* m_closingConnection;
+    QByteArray m_initialMessage;
+    // the connection of the subscription request that has to be closed
+    // before the initial event message can be sent. the changes made in
+    // the meantime replace the initial event message
+
+    QString m_localServer;
+    // the local endpoint of the subscriber running on the same host. used
+    // instead of the callback URL until connecting to it fails.
+
     bool connectToHost();
 
+    void enqueue(const QByteArray&);
+    void dequeue();
+    void coalesce(bool keepHead);
+
+    void deliveryFailed();
+
 private Q_SLOTS:
 
     void send();
+    void connectionFailed();
     void msgIoComplete(HHttpAsyncOperation*);
     void subscriptionTimeout();
+    void subscriptionConnectionClosed();
+    void suspensionTimeout();
 
 private:
 
@@ -91,13 +135,17 @@ public:
     HServiceEventSubscriber(
         const QByteArray& loggingIdentifier,
         HServerService* service, const QUrl location, const HTimeout& timeout,
-        QObject* parent = 0);
+        const HDeviceHostConfiguration&, QObject* parent = 0);
 
     virtual ~HServiceEventSubscriber();
 
     void notify(const QByteArray& msgBody);
     bool initialNotify(const QByteArray& msgBody, HMessagingInfo* = 0);
 
+    // sends the initial event message once the specified connection, on
+    // which the subscription request was received, has been closed.
+    void initialNotifyOnClose(const QByteArray& msgBody, HMessagingInfo*);
+
     bool isInterested(const HServerService* service) const;
 
     inline QUrl      location() const { return m_location; }
@@ -107,7 +155,20 @@ public:
     inline HServerService* service () const { return m_service;  }
     inline bool      expired () const { return m_expired;  }
 
+    inline qint32 queueLength   () const { return m_messagesToSend.size(); }
+    inline qint32 queuedBytes   () const { return m_queuedBytes;    }
+    inline qint32 coalescedCount() const { return m_coalescedCount; }
+    inline bool   isSuspended   () const
+    {
+        return m_suspensionTimer.isActive();
+    }
+
     void renew(const HTimeout&);
+
+    inline void setLocalServer(const QString& localServer)
+    {
+        m_localServer = localServer;
+    }
 };
 
 }
@@ -46,7 +46,8 @@
 
 #include "../../general/hlogger_p.h"
 
-#include <QtXml/QDomElement>
+#include <QtCore/QUuid>
+#include <QtCore/QCryptographicHash>
 
 namespace Herqq
 {
@@ -54,12 +55,30 @@ namespace Herqq
 namespace Upnp
 {
 
+/*******************************************************************************
+ * HServiceModelTemplate
+ ******************************************************************************/
+HServiceModelTemplate::HServiceModelTemplate() :
+    m_description(), m_stateVariables(), m_actions()
+{
+}
+
+/*******************************************************************************
+ * HServerModelTemplate
+ ******************************************************************************/
+HServerModelTemplate::HServerModelTemplate() :
+    m_deviceDescription(), m_rootDevice(), m_configId(0), m_parsed(false),
+    m_services()
+{
+}
+
 /*******************************************************************************
  * HServerModelCreationArgs
  ******************************************************************************/
 HServerModelCreationArgs::HServerModelCreationArgs(
     HDeviceModelCreator* creator) :
-        m_deviceModelCreator(creator), m_infoProvider(0), m_ddPostFix()
+        m_deviceModelCreator(creator), m_infoProvider(0), m_ddPostFix(),
+        m_template(0), m_udn(), m_friendlyName()
 {
 }
 
@@ -72,7 +91,10 @@ HServerModelCreationArgs::HServerModelCreationArgs(
         HModelCreationArgs(other),
             m_deviceModelCreator(other.m_deviceModelCreator),
             m_infoProvider(other.m_infoProvider),
-            m_ddPostFix(other.m_ddPostFix)
+            m_ddPostFix(other.m_ddPostFix),
+            m_template(other.m_template),
+            m_udn(other.m_udn),
+            m_friendlyName(other.m_friendlyName)
 {
 }
 
@@ -86,6 +108,9 @@ HServerModelCreationArgs& HServerModelCreationArgs::operator=(
     m_deviceModelCreator = other.m_deviceModelCreator;
     m_infoProvider = other.m_infoProvider;
     m_ddPostFix = other.m_ddPostFix;
+    m_template = other.m_template;
+    m_udn = other.m_udn;
+    m_friendlyName = other.m_friendlyName;
 
     return *this;
 }
@@ -97,7 +122,7 @@ HServerModelCreator::HServerModelCreator(
     const HServerModelCreationArgs& creationParameters) :
         m_creationParameters(new HServerModelCreationArgs(creationParameters)),
         m_docParser(creationParameters.m_loggingIdentifier, StrictChecks),
-        m_lastErrorDescription()
+        m_lastErrorDescription(), m_lastError(NoError), m_substitutions()
 {
     Q_ASSERT(creationParameters.m_serviceDescriptionFetcher);
     Q_ASSERT(creationParameters.m_deviceLocations.size() > 0);
@@ -150,22 +175,14 @@ HDevicesSetupData HServerModelCreator::getDevicesSetupData(
     return HDevicesSetupData();
 }
 
-bool HServerModelCreator::parseStateVariables(
-    HServerService* service, QDomElement stateVariableElement)
+bool HServerModelCreator::createStateVariables(
+    HServerService* service, const QList<HStateVariableInfo>& svInfos)
 {
     HStateVariablesSetupData stateVariablesSetup =
         getStateVariablesSetupData(service);
 
-    while(!stateVariableElement.isNull())
+    foreach(const HStateVariableInfo& svInfo, svInfos)
     {
-        HStateVariableInfo svInfo;
-        if (!m_docParser.parseStateVariable(stateVariableElement, &svInfo))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
-
         QString name = svInfo.name();
         HStateVariableInfo setupData = stateVariablesSetup.get(name);
         if (!setupData.isValid() &&
@@ -197,18 +214,20 @@ bool HServerModelCreator::parseStateVariables(
 
         service->h_ptr->addStateVariable(sv);
 
-        bool ok = QObject::connect(
-            sv,
-            SIGNAL(valueChanged(
-                Herqq::Upnp::HServerStateVariable*,
-                const Herqq::Upnp::HStateVariableEvent&)),
-            service,
-            SLOT(notifyListeners()));
-
-        Q_ASSERT(ok); Q_UNUSED(ok)
-
-        stateVariableElement =
-            stateVariableElement.nextSiblingElement("stateVariable");
+        // the changes of the other state variables are not sent to the
+        // subscribers, so these do not cause an event either
+        if (svInfo.eventingType() != HStateVariableInfo::NoEvents)
+        {
+            bool ok = QObject::connect(
+                sv,
+                SIGNAL(valueChanged(
+                    Herqq::Upnp::HServerStateVariable*,
+                    const Herqq::Upnp::HStateVariableEvent&)),
+                service,
+                SLOT(notifyListeners()));
+
+            Q_ASSERT(ok); Q_UNUSED(ok)
+        }
 
         stateVariablesSetup.remove(name);
     }
@@ -234,25 +253,15 @@ bool HServerModelCreator::parseStateVariables(
     return true;
 }
 
-bool HServerModelCreator::parseActions(
-    HServerService* service, QDomElement actionElement,
-    const HStateVariableInfos& svInfos)
+bool HServerModelCreator::createActions(
+    HServerService* service, const QList<HActionInfo>& actionInfos)
 {
     HActionsSetupData actionsSetupData = getActionsSetupData(service);
 
     QHash<QString, HActionInvoke> actionInvokes = service->createActionInvokes();
 
-    while(!actionElement.isNull())
+    foreach(const HActionInfo& actionInfo, actionInfos)
     {
-        HActionInfo actionInfo;
-        if (!m_docParser.parseActionInfo(
-                actionElement, svInfos, &actionInfo))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
-
         QString name = actionInfo.name();
 
         HActionInvoke actionInvoke = actionInvokes.value(name);
@@ -283,8 +292,6 @@ bool HServerModelCreator::parseActions(
 
         service->h_ptr->m_actions.insert(name, action.take());
 
-        actionElement = actionElement.nextSiblingElement("action");
-
         actionsSetupData.remove(name);
     }
 
@@ -309,60 +316,50 @@ bool HServerModelCreator::parseActions(
     return true;
 }
 
-bool HServerModelCreator::parseServiceDescription(HServerService* service)
+bool HServerModelCreator::parseServiceDescription(
+    HServerService* service, HServiceModelTemplate* serviceTemplate)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
     Q_ASSERT(service);
+    Q_ASSERT(serviceTemplate);
 
-    QDomDocument doc;
-    QDomElement firstSv, firstAction;
-    if (!m_docParser.parseServiceDescription(
-        service->h_ptr->m_serviceDescription, &doc, &firstSv, &firstAction))
+    if (serviceTemplate->m_description.isNull())
     {
-        m_lastError = convert(m_docParser.lastError());
-        m_lastErrorDescription = m_docParser.lastErrorDescription();
-        return false;
-    }
+        // The template is filled only once the description has been parsed
+        // successfully, since it may be shared by other devices.
+        HServiceModelTemplate parsed;
+        parsed.m_description = service->h_ptr->m_serviceDescription;
 
-    if (!parseStateVariables(service, firstSv))
-    {
-        return false;
-    }
+        if (!m_docParser.parseServiceDescription(
+            parsed.m_description, &parsed.m_stateVariables, &parsed.m_actions))
+        {
+            m_lastError = convert(m_docParser.lastError());
+            m_lastErrorDescription = m_docParser.lastErrorDescription();
+            return false;
+        }
 
-    HStateVariableInfos svInfos;
-    HServerStateVariables svs = service->stateVariables();
-    foreach(const QString& key, svs.keys())
-    {
-        svInfos.insert(key, svs.value(key)->info());
+        *serviceTemplate = parsed;
     }
 
-    return parseActions(service, firstAction, svInfos);
+    return createStateVariables(service, serviceTemplate->m_stateVariables) &&
+           createActions(service, serviceTemplate->m_actions);
 }
 
-bool HServerModelCreator::parseServiceList(
-    const QDomElement& serviceListElement, HServerDevice* device,
+bool HServerModelCreator::createServices(
+    const QList<HServiceInfo>& serviceInfos, HServerDevice* device,
     QList<HServerService*>* retVal)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
     Q_ASSERT(device);
-    Q_ASSERT(!serviceListElement.isNull());
-
-    QDomElement serviceElement =
-        serviceListElement.firstChildElement("service");
 
     HServicesSetupData setupData = getServicesSetupData(device);
 
-    while(!serviceElement.isNull())
-    {
-        HServiceInfo info;
-        if (!m_docParser.parseServiceInfo(serviceElement, &info))
-        {
-            m_lastError = convert(m_docParser.lastError());
-            m_lastErrorDescription = m_docParser.lastErrorDescription();
-            return false;
-        }
+    HServerModelTemplate* deviceTemplate =
+        m_creationParameters->deviceTemplate();
 
+    foreach(const HServiceInfo& info, serviceInfos)
+    {
         QScopedPointer<HServerService> service(
             m_creationParameters->creator()->createService(info, device->info()));
 
@@ -386,7 +383,16 @@ bool HServerModelCreator::parseServiceList(
             return false;
         }
 
-        if (!m_creationParameters->m_serviceDescriptionFetcher(
+        HServiceModelTemplate serviceModel;
+        HServiceModelTemplate* serviceTemplate = deviceTemplate ?
+            &deviceTemplate->m_services[info.scpdUrl().toString()] :
+            &serviceModel;
+
+        if (!serviceTemplate->m_description.isNull())
+        {
+            service->h_ptr->m_serviceDescription = serviceTemplate->m_description;
+        }
+        else if (!m_creationParameters->m_serviceDescriptionFetcher(
                 extractBaseUrl(m_creationParameters->m_deviceLocations[0]),
                 info.scpdUrl(), &service->h_ptr->m_serviceDescription))
         {
@@ -398,7 +404,7 @@ bool HServerModelCreator::parseServiceList(
             return false;
         }
 
-        if (!parseServiceDescription(service.data()))
+        if (!parseServiceDescription(service.data(), serviceTemplate))
         {
             return false;
         }
@@ -414,8 +420,6 @@ bool HServerModelCreator::parseServiceList(
 
         retVal->push_back(service.take());
 
-        serviceElement = serviceElement.nextSiblingElement("service");
-
         setupData.remove(info.serviceId());
     }
 
@@ -443,6 +447,56 @@ bool HServerModelCreator::parseServiceList(
 
 namespace
 {
+// the namespace of the name-based UUIDs of the embedded devices of templates
+const QUuid EmbeddedUdnNamespace(
+    0x0f454396, 0xf450, 0x4cf1, 0x88, 0x12, 0x77, 0xa8, 0xfa, 0x2a, 0x1d, 0xc1);
+
+void appendBigEndian(QByteArray& data, quint32 value, qint32 bytes)
+{
+    for(qint32 i = bytes - 1; i >= 0; --i)
+    {
+        data.append(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+//
+// Returns the name-based (version 5) UUID of the specified name, as
+// specified in RFC 4122.
+//
+QUuid createNameBasedUuid(const QUuid& nameSpace, const QByteArray& name)
+{
+    QByteArray data;
+    appendBigEndian(data, nameSpace.data1, 4);
+    appendBigEndian(data, nameSpace.data2, 2);
+    appendBigEndian(data, nameSpace.data3, 2);
+    data.append(reinterpret_cast<const char*>(nameSpace.data4), 8);
+    data.append(name);
+
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    const uchar* h = reinterpret_cast<const uchar*>(hash.constData());
+
+    return QUuid(
+        (quint32(h[0]) << 24) | (quint32(h[1]) << 16) | (quint32(h[2]) << 8) | h[3],
+        (quint16(h[4]) << 8) | h[5],
+        ((quint16(h[6] & 0x0f) | 0x50) << 8) | h[7],
+        (h[8] & 0x3f) | 0x80, h[9], h[10], h[11], h[12], h[13], h[14], h[15]);
+}
+
+HUdn deriveUdn(const HUdn& instanceUdn, const HUdn& templateUdn)
+{
+    // The UDN of an embedded device has to be unique and it has to stay
+    // the same for as long as the UDN of the root device stays the same,
+    // whether or not the UDNs are UUIDs.
+    return HUdn(createNameBasedUuid(
+        EmbeddedUdnNamespace,
+        QString("%1 %2").arg(instanceUdn.toString(), templateUdn.toString()).toUtf8()));
+}
+
+QString escapeXml(QString str)
+{
+    return str.replace('&', "&amp;").replace('<', "&lt;").replace('>', "&gt;");
+}
+
 QList<QUrl> generateLocations(
     const HUdn& udn, const QList<QUrl>& locations, const QString& ddPostFix)
 {
@@ -462,17 +516,73 @@ QList<QUrl> generateLocations(
 }
 }
 
-HServerDevice* HServerModelCreator::parseDevice(
-    const QDomElement& deviceElement, HServerDevice* parentDevice)
+void HServerModelCreator::setSubstitutions(
+    HServerDevice* device, const QList<QPair<QString, QString> >& substitutions)
+{
+    device->h_ptr->m_descriptionSubstitutions = substitutions;
+    foreach(HServerDevice* embeddedDevice, device->embeddedDevices())
+    {
+        setSubstitutions(embeddedDevice, substitutions);
+    }
+}
+
+HDeviceInfo HServerModelCreator::instantiate(
+    const HDeviceInfo& info, HServerDevice* parentDevice)
+{
+    HUdn udn;
+    QString friendlyName = info.friendlyName();
+
+    if (!parentDevice)
+    {
+        udn = m_creationParameters->udn();
+
+        QString newName = m_creationParameters->friendlyName();
+        if (!newName.isEmpty() && newName != friendlyName)
+        {
+            // the friendly name of the root device is the first one
+            // in the description
+            const QString& description = m_creationParameters->m_deviceDescription;
+            qint32 begin = description.indexOf("<friendlyName>");
+            qint32 end = description.indexOf("</friendlyName>", begin);
+            if (begin >= 0 && end > begin)
+            {
+                m_substitutions.append(qMakePair(
+                    description.mid(begin, end - begin),
+                    QString("<friendlyName>%1").arg(escapeXml(newName))));
+            }
+
+            friendlyName = newName;
+        }
+    }
+    else
+    {
+        udn = deriveUdn(m_creationParameters->udn(), info.udn());
+    }
+
+    m_substitutions.append(qMakePair(info.udn().toString(), udn.toString()));
+
+    return HDeviceInfo(
+        info.deviceType(), friendlyName, info.manufacturer(),
+        info.manufacturerUrl(), info.modelDescription(), info.modelName(),
+        info.modelNumber(), info.modelUrl(), info.serialNumber(), udn,
+        info.upc(), info.icons(), info.presentationUrl(), StrictChecks,
+        &m_lastErrorDescription);
+}
+
+HServerDevice* HServerModelCreator::createDevice(
+    const HParsedDevice& parsedDevice, HServerDevice* parentDevice)
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
-    HDeviceInfo deviceInfo;
-    if (!m_docParser.parseDeviceInfo(deviceElement, &deviceInfo))
+    HDeviceInfo deviceInfo = parsedDevice.m_info;
+    if (m_creationParameters->deviceTemplate())
     {
-        m_lastError = convert(m_docParser.lastError());
-        m_lastErrorDescription = m_docParser.lastErrorDescription();
-        return 0;
+        deviceInfo = instantiate(deviceInfo, parentDevice);
+        if (!deviceInfo.isValid(StrictChecks))
+        {
+            m_lastError = InvalidDeviceDescription;
+            return 0;
+        }
     }
 
     QScopedPointer<HServerDevice> device(
@@ -499,13 +609,10 @@ HServerDevice* HServerModelCreator::parseDevice(
     device->h_ptr->m_deviceDescription =
         m_creationParameters->m_deviceDescription;
 
-    QDomElement serviceListElement =
-        deviceElement.firstChildElement("serviceList");
-
-    if (!serviceListElement.isNull())
+    if (parsedDevice.m_hasServiceList)
     {
         HServerServices services;
-        if (!parseServiceList(serviceListElement, device.data(), &services))
+        if (!createServices(parsedDevice.m_services, device.data(), &services))
         {
             qDeleteAll(services);
             return 0;
@@ -516,18 +623,14 @@ HServerDevice* HServerModelCreator::parseDevice(
 
     HDevicesSetupData setupData = getDevicesSetupData(device.data());
 
-    QDomElement deviceListElement = deviceElement.firstChildElement("deviceList");
-    if (!deviceListElement.isNull())
+    if (parsedDevice.m_hasDeviceList)
     {
         QList<HServerDevice*> embeddedDevices;
 
-        QDomElement embeddedDeviceElement =
-            deviceListElement.firstChildElement("device");
-
-        while(!embeddedDeviceElement.isNull())
+        foreach(const HParsedDevice& parsedEmbedded, parsedDevice.m_embeddedDevices)
         {
             HServerDevice* embeddedDevice =
-                parseDevice(embeddedDeviceElement, device.data());
+                createDevice(parsedEmbedded, device.data());
 
             if (!embeddedDevice)
             {
@@ -536,9 +639,6 @@ HServerDevice* HServerModelCreator::parseDevice(
             }
 
             embeddedDevices.push_back(embeddedDevice);
-
-            embeddedDeviceElement =
-                embeddedDeviceElement.nextSiblingElement("device");
         }
 
         device->h_ptr->m_embeddedDevices = embeddedDevices;
@@ -578,25 +678,46 @@ HServerDevice* HServerModelCreator::createRootDevice()
 {
     HLOG2(H_AT, H_FUN, m_creationParameters->m_loggingIdentifier);
 
-    QDomDocument doc;
-    QDomElement rootElement;
-    if (!m_docParser.parseRoot(
-            m_creationParameters->m_deviceDescription, &doc, &rootElement))
+    HServerModelTemplate* deviceTemplate = m_creationParameters->deviceTemplate();
+
+    HParsedDevice parsedDevice;
+    qint32 configId = 0;
+    if (deviceTemplate && deviceTemplate->m_parsed)
+    {
+        // the parsed description of a template is only stored once
+        // it has been parsed successfully
+        parsedDevice = deviceTemplate->m_rootDevice;
+        configId = deviceTemplate->m_configId;
+    }
+    else if (!m_docParser.parseDeviceDescription(
+            m_creationParameters->m_deviceDescription, &parsedDevice, &configId))
     {
         m_lastError = convert(m_docParser.lastError());
         m_lastErrorDescription = m_docParser.lastErrorDescription();
         return 0;
     }
+    else if (deviceTemplate)
+    {
+        deviceTemplate->m_rootDevice = parsedDevice;
+        deviceTemplate->m_configId = configId;
+        deviceTemplate->m_parsed = true;
+    }
+
+    m_substitutions.clear();
 
-    QScopedPointer<HServerDevice> createdDevice(parseDevice(rootElement, 0));
+    QScopedPointer<HServerDevice> createdDevice(createDevice(parsedDevice, 0));
     if (!createdDevice)
     {
         return 0;
     }
 
+    if (!m_substitutions.isEmpty())
+    {
+        setSubstitutions(createdDevice.data(), m_substitutions);
+    }
+
     createdDevice->h_ptr->m_deviceStatus.reset(new HDeviceStatus());
-    createdDevice->h_ptr->m_deviceStatus->setConfigId(
-        m_docParser.readConfigId(rootElement));
+    createdDevice->h_ptr->m_deviceStatus->setConfigId(configId);
 
     createdDevice->h_ptr->m_locations =
         generateLocations(
@@ -34,12 +34,56 @@
 #include "../hmodelcreation_p.h"
 #include "../../devicemodel/hactioninvoke.h"
 
+#include "../../dataelements/hudn.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+
 namespace Herqq
 {
 
 namespace Upnp
 {
 
+//
+// The parsed service description of a device template
+//
+class HServiceModelTemplate
+{
+public:
+
+    QString m_description;
+    QList<HStateVariableInfo> m_stateVariables;
+    QList<HActionInfo> m_actions;
+    // in the order they appear in the description
+
+    HServiceModelTemplate();
+};
+
+//
+// The parsed descriptions of a device template. These are shared by every
+// device created from the same device description and they are never modified
+// once the first device has been successfully created.
+//
+class HServerModelTemplate
+{
+H_DISABLE_COPY(HServerModelTemplate)
+
+public:
+
+    QString m_deviceDescription;
+
+    HParsedDevice m_rootDevice;
+    qint32 m_configId;
+    bool m_parsed;
+    // the parsed device description
+
+    QHash<QString, HServiceModelTemplate> m_services;
+    // the parsed service descriptions keyed by their SCPD URLs
+
+    HServerModelTemplate();
+};
+
 //
 //
 //
@@ -56,6 +100,13 @@ private:
 
     QString m_ddPostFix;
 
+    HServerModelTemplate* m_template;
+    // Not owned.
+
+    HUdn m_udn;
+    QString m_friendlyName;
+    // the per-instance values of a device created from a template
+
 public:
 
     HServerModelCreationArgs(HDeviceModelCreator*);
@@ -89,6 +140,29 @@ public:
     {
         return m_ddPostFix;
     }
+
+    inline void setTemplate(
+        HServerModelTemplate* arg, const HUdn& udn, const QString& friendlyName)
+    {
+        m_template = arg;
+        m_udn = udn;
+        m_friendlyName = friendlyName;
+    }
+
+    inline HServerModelTemplate* deviceTemplate() const
+    {
+        return m_template;
+    }
+
+    inline const HUdn& udn() const
+    {
+        return m_udn;
+    }
+
+    inline QString friendlyName() const
+    {
+        return m_friendlyName;
+    }
 };
 
 //
@@ -120,6 +194,9 @@ private:
     QString m_lastErrorDescription;
     ErrorType m_lastError;
 
+    QList<QPair<QString, QString> > m_substitutions;
+    // the per-instance values to be substituted into a template description
+
 private:
 
     HStateVariablesSetupData getStateVariablesSetupData(HServerService*);
@@ -127,25 +204,24 @@ private:
     HServicesSetupData getServicesSetupData(HServerDevice*);
     HDevicesSetupData getDevicesSetupData(HServerDevice*);
 
-    QList<QPair<QUrl, QByteArray> > parseIconList(
-        const QDomElement& iconListElement);
+    bool createStateVariables(
+        HServerService* service, const QList<HStateVariableInfo>&);
+
+    bool createActions(HServerService* service, const QList<HActionInfo>&);
 
-    bool parseStateVariables(
-        HServerService* service, QDomElement stateVariableElement);
+    bool parseServiceDescription(HServerService*, HServiceModelTemplate*);
 
-    bool parseActions(
-        HServerService* service,
-        QDomElement actionElement,
-        const HStateVariableInfos& svInfos);
+    HDeviceInfo instantiate(const HDeviceInfo&, HServerDevice* parentDevice);
 
-    bool parseServiceDescription(HServerService*);
+    static void setSubstitutions(
+        HServerDevice*, const QList<QPair<QString, QString> >&);
 
-    bool parseServiceList(
-        const QDomElement& serviceListElement, HServerDevice*,
+    bool createServices(
+        const QList<HServiceInfo>&, HServerDevice*,
         QList<HServerService*>* retVal);
 
-    HServerDevice* parseDevice(
-        const QDomElement& deviceElement, HServerDevice* parentDevice);
+    HServerDevice* createDevice(
+        const HParsedDevice&, HServerDevice* parentDevice);
 
     inline ErrorType convert(DocumentErrorTypes type)
     {
@@ -3,6 +3,7 @@ HEADERS += \
     $$SRC_LOC/devicehosting/hdevicestorage_p.h \
     $$SRC_LOC/devicehosting/hddoc_parser_p.h \
     $$SRC_LOC/devicehosting/hmodelcreation_p.h \
+    $$SRC_LOC/devicehosting/hlocaldevice_registry_p.h \
     $$SRC_LOC/devicehosting/messages/hcontrol_messages_p.h \
     $$SRC_LOC/devicehosting/messages/hevent_messages_p.h \
     $$SRC_LOC/devicehosting/messages/hnt_p.h \
@@ -15,8 +16,12 @@ HEADERS += \
     $$SRC_LOC/devicehosting/controlpoint/hcontrolpoint_configuration.h \
     $$SRC_LOC/devicehosting/controlpoint/hcontrolpoint_configuration_p.h \
     $$SRC_LOC/devicehosting/controlpoint/hcontrolpoint_dataretriever_p.h \
+    $$SRC_LOC/devicehosting/controlpoint/hdevicemodel_snapshot.h \
+    $$SRC_LOC/devicehosting/controlpoint/hdevicemodel_snapshot_p.h \
     $$SRC_LOC/devicehosting/controlpoint/hevent_subscription_p.h \
     $$SRC_LOC/devicehosting/controlpoint/hevent_subscriptionmanager_p.h \
+    $$SRC_LOC/devicehosting/controlpoint/hmulticast_eventreceiver_p.h \
+    $$SRC_LOC/devicehosting/controlpoint/hservicemodel_loader_p.h \
     $$SRC_LOC/devicehosting/devicehost/hdevicehost_p.h \
     $$SRC_LOC/devicehosting/devicehost/hdevicehost.h \
     $$SRC_LOC/devicehosting/devicehost/hserverdevicecontroller_p.h \
@@ -35,6 +40,7 @@ SOURCES += \
     $$SRC_LOC/devicehosting/hdevicestorage_p.cpp \
     $$SRC_LOC/devicehosting/hddoc_parser_p.cpp \
     $$SRC_LOC/devicehosting/hmodelcreation_p.cpp \
+    $$SRC_LOC/devicehosting/hlocaldevice_registry_p.cpp \
     $$SRC_LOC/devicehosting/messages/hcontrol_messages_p.cpp \
     $$SRC_LOC/devicehosting/messages/hevent_messages_p.cpp \
     $$SRC_LOC/devicehosting/messages/hnt_p.cpp \
@@ -45,8 +51,11 @@ SOURCES += \
     $$SRC_LOC/devicehosting/controlpoint/hdevicebuild_p.cpp \
     $$SRC_LOC/devicehosting/controlpoint/hcontrolpoint_configuration.cpp \
     $$SRC_LOC/devicehosting/controlpoint/hcontrolpoint_dataretriever_p.cpp \
+    $$SRC_LOC/devicehosting/controlpoint/hdevicemodel_snapshot.cpp \
     $$SRC_LOC/devicehosting/controlpoint/hevent_subscription_p.cpp \
     $$SRC_LOC/devicehosting/controlpoint/hevent_subscriptionmanager_p.cpp \
+    $$SRC_LOC/devicehosting/controlpoint/hmulticast_eventreceiver_p.cpp \
+    $$SRC_LOC/devicehosting/controlpoint/hservicemodel_loader_p.cpp \
     $$SRC_LOC/devicehosting/devicehost/hdevicehost.cpp \
     $$SRC_LOC/devicehosting/devicehost/hservermodel_creator_p.cpp \
     $$SRC_LOC/devicehosting/devicehost/hdevicehost_dataretriever_p.cpp \
@@ -30,12 +30,72 @@
 
 #include "../general/hlogger_p.h"
 
+#include <QtCore/QXmlStreamReader>
+
 namespace Herqq
 {
 
 namespace Upnp
 {
 
+namespace
+{
+//
+// Reads the text of the current element including the text of its child
+// elements, which is what QDomElement::text() returns.
+//
+inline QString readText(QXmlStreamReader& reader)
+{
+    return reader.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
+//
+// Reads the child elements of the current element into a hash of element names
+// and values. Only the first occurrence of each element is stored, which is
+// the one QDomElement::firstChildElement() would find.
+//
+void readChildElements(QXmlStreamReader& reader, QHash<QString, QString>* retVal)
+{
+    while(reader.readNextStartElement())
+    {
+        QString name = reader.name().toString();
+        if (retVal->contains(name))
+        {
+            reader.skipCurrentElement();
+        }
+        else
+        {
+            retVal->insert(name, readText(reader));
+        }
+    }
+}
+
+//
+// Returns the source of the element that started at the specified offset and
+// that the reader has just finished. This is used in error messages.
+//
+QString elementSource(
+    const QXmlStreamReader& reader, const QString& docStr, qint64 startOffset)
+{
+    qint32 begin = docStr.lastIndexOf('<', static_cast<qint32>(startOffset) - 1);
+    if (begin < 0)
+    {
+        return QString();
+    }
+
+    return docStr.mid(begin, static_cast<qint32>(reader.characterOffset()) - begin);
+}
+}
+
+/*******************************************************************************
+ * HParsedDevice
+ ******************************************************************************/
+HParsedDevice::HParsedDevice() :
+    m_info(), m_services(), m_hasServiceList(false), m_embeddedDevices(),
+    m_hasDeviceList(false)
+{
+}
+
 /*******************************************************************************
  * HDocParser
  ******************************************************************************/
@@ -46,52 +106,42 @@ HDocParser::HDocParser(
 {
 }
 
-HStateVariableInfo HDocParser::parseStateVariableInfo_str(
-    const QString& name, const QVariant& defValue, const QDomElement& svElement,
-    HStateVariableInfo::EventingType evType, HInclusionRequirement incReq)
+bool HDocParser::setParseError(
+    const QXmlStreamReader& reader, DocumentErrorTypes type)
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-
-    QStringList allowedValues;
-
-    QDomElement allowedValueListElement =
-        svElement.firstChildElement("allowedValueList");
-
-    if (!allowedValueListElement.isNull())
-    {
-        QDomElement allowedValueElement =
-            allowedValueListElement.firstChildElement("allowedValue");
-
-        while(!allowedValueElement.isNull())
-        {
-            allowedValues.push_back(allowedValueElement.text());
+    m_lastError = type;
+    m_lastErrorDescription = QString(
+        "Failed to parse the %1 description: [%2] @ line [%3].").arg(
+            type == InvalidDeviceDescriptionError ? "device" : "service",
+            reader.errorString(), QString::number(reader.lineNumber()));
 
-            allowedValueElement =
-                allowedValueElement.nextSiblingElement("allowedValue");
-        }
-    }
+    return false;
+}
 
+HStateVariableInfo HDocParser::parseStateVariableInfo_str(
+    const QString& name, const QVariant& defValue,
+    const QStringList& allowedValues,
+    HStateVariableInfo::EventingType evType, HInclusionRequirement incReq)
+{
     return HStateVariableInfo(
         name, defValue, allowedValues, evType, incReq, &m_lastErrorDescription);
 }
 
 HStateVariableInfo HDocParser::parseStateVariableInfo_numeric(
-    const QString& name, const QVariant& defValue, const QDomElement& svElement,
+    const QString& name, const QVariant& defValue,
+    bool hasAllowedValueRange, const QHash<QString, QString>& allowedValueRange,
     HStateVariableInfo::EventingType evType, HInclusionRequirement incReq,
     HUpnpDataTypes::DataType dataTypeEnumValue)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    QDomElement allowedValueRangeElement =
-        svElement.firstChildElement("allowedValueRange");
-
-    if (allowedValueRangeElement.isNull())
+    if (!hasAllowedValueRange)
     {
         return HStateVariableInfo(
             name, dataTypeEnumValue, defValue, evType, incReq, &m_lastErrorDescription);
     }
 
-    QString minimumStr = readElementValue("minimum", allowedValueRangeElement);
+    QString minimumStr = allowedValueRange.value("minimum");
 
     if (minimumStr.isEmpty())
     {
@@ -112,7 +162,7 @@ HStateVariableInfo HDocParser::parseStateVariableInfo_numeric(
         }
     }
 
-    QString maximumStr = readElementValue("maximum", allowedValueRangeElement);
+    QString maximumStr = allowedValueRange.value("maximum");
 
     if (maximumStr.isEmpty())
     {
@@ -133,7 +183,7 @@ HStateVariableInfo HDocParser::parseStateVariableInfo_numeric(
         }
     }
 
-    QString stepStr = readElementValue("step", allowedValueRangeElement);
+    QString stepStr = allowedValueRange.value("step");
 
     if (stepStr.isEmpty())
     {
@@ -162,7 +212,7 @@ HStateVariableInfo HDocParser::parseStateVariableInfo_numeric(
 }
 
 bool HDocParser::parseActionArguments(
-    const QDomElement& argListElement,
+    const QList<ActionArgument>& arguments,
     const QHash<QString, HStateVariableInfo>& stateVars,
     QVector<HActionArgument>* inArgs,
     QVector<HActionArgument>* outArgs,
@@ -172,17 +222,11 @@ bool HDocParser::parseActionArguments(
 
     bool firstOutArgFound  = false;
 
-    QDomElement argumentElement = argListElement.firstChildElement("argument");
-    while(!argumentElement.isNull())
+    foreach(const ActionArgument& argument, arguments)
     {
-        QString name = readElementValue("name", argumentElement);
-        QString dirStr = readElementValue("direction", argumentElement);
-
-        bool retValWasDefined = false;
-        readElementValue("retval", argumentElement, &retValWasDefined);
-
-        QString relatedSvStr =
-            readElementValue("relatedStateVariable", argumentElement);
+        const QString& name = argument.m_name;
+        const QString& dirStr = argument.m_direction;
+        const QString& relatedSvStr = argument.m_relatedStateVariable;
 
         if (!stateVars.contains(relatedSvStr))
         {
@@ -197,7 +241,7 @@ bool HDocParser::parseActionArguments(
         HActionArgument createdArg;
         if (dirStr.compare("out", Qt::CaseInsensitive) == 0)
         {
-            if (retValWasDefined)
+            if (argument.m_retval)
             {
                 if (firstOutArgFound)
                 {
@@ -262,158 +306,217 @@ bool HDocParser::parseActionArguments(
 
             return false;
         }
-
-        argumentElement = argumentElement.nextSiblingElement("argument");
     }
 
     return true;
 }
 
-QList<QUrl> HDocParser::parseIconList(const QDomElement& iconListElement)
+bool HDocParser::readSpecVersion(QXmlStreamReader& reader, QString* err)
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    QHash<QString, QString> specVersion;
+    readChildElements(reader, &specVersion);
 
-    QList<QUrl> retVal;
+    bool ok;
+    qint32 major = specVersion.value("major").toInt(&ok);
+    if (!ok || major != 1)
+    {
+        if (err) { *err = "Major element of <specVersion> is not 1."; }
+        return false;
+    }
 
-    QDomElement iconElement = iconListElement.firstChildElement("icon");
-    while(!iconElement.isNull())
+    qint32 minor = specVersion.value("minor").toInt(&ok);
+    if (!ok || (minor != 1 && minor != 0))
     {
-        QUrl iconUrl = readElementValue("url", iconElement);
+        if (err) { *err = "Minor element of <specVersion> is not 0 or 1."; }
+        return false;
+    }
+
+    return true;
+}
 
-        QString iconUrlAsStr = iconUrl.toString();
-        retVal.append(QUrl(iconUrlAsStr));
+QList<QUrl> HDocParser::parseIconList(QXmlStreamReader& reader)
+{
+    QList<QUrl> retVal;
 
-        iconElement = iconElement.nextSiblingElement("icon");
+    while(reader.readNextStartElement())
+    {
+        if (reader.name() == "icon")
+        {
+            QHash<QString, QString> icon;
+            readChildElements(reader, &icon);
+            retVal.append(QUrl(icon.value("url")));
+        }
+        else
+        {
+            reader.skipCurrentElement();
+        }
     }
 
     return retVal;
 }
 
-bool HDocParser::parseRoot(
-    const QString& docStr, QDomDocument* doc, QDomElement* rootEl)
+bool HDocParser::parseServiceInfo(
+    QXmlStreamReader& reader, const QString& docStr, HServiceInfo* serviceInfo)
 {
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    Q_ASSERT(serviceInfo);
 
-    Q_ASSERT(doc);
-    Q_ASSERT(rootEl);
+    qint64 startOffset = reader.characterOffset();
 
-    QString errMsg; qint32 errLine = 0;
-    if (!doc->setContent(docStr, false, &errMsg, &errLine))
-    {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Failed to parse the device description: [%1] @ line [%2].").arg(
-                errMsg, QString::number(errLine));
+    QHash<QString, QString> service;
+    readChildElements(reader, &service);
 
-        return false;
+    if (reader.hasError())
+    {
+        return setParseError(reader, InvalidDeviceDescriptionError);
     }
 
-    QDomElement rootElement = doc->firstChildElement("root");
-
-    // "urn:schemas-upnp-org:device-1-0",
-
-    if (rootElement.isNull())
+    static const char* const mandatoryElements[] =
     {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription =
-            "Invalid device description: missing <root> element.";
+        "serviceId", "serviceType", "SCPDURL", "controlURL", "eventSubURL"
+    };
 
-        return false;
-    }
-
-    if (!verifySpecVersion(rootElement, &m_lastErrorDescription))
+    for(quint32 i = 0; i < sizeof(mandatoryElements) / sizeof(char*); ++i)
     {
-        if (m_cLevel == StrictChecks)
+        if (!service.contains(mandatoryElements[i]))
         {
             m_lastError = InvalidDeviceDescriptionError;
+            m_lastErrorDescription = QString(
+                "Invalid <service> definition. "
+                "Missing mandatory <%1> element:\n%2").arg(
+                    mandatoryElements[i],
+                    elementSource(reader, docStr, startOffset));
+
             return false;
         }
-        else
-        {
-            HLOG_WARN_NONSTD(QString(
-                "Error in device description: %1").arg(m_lastErrorDescription));
-        }
     }
 
-    QDomElement rootDeviceElement = rootElement.firstChildElement("device");
-    if (rootDeviceElement.isNull())
+    HServiceInfo tmpServiceInfo(
+        HServiceId(service.value("serviceId")),
+        HResourceType(service.value("serviceType")),
+        QUrl(service.value("controlURL")),
+        QUrl(service.value("eventSubURL")),
+        QUrl(service.value("SCPDURL")),
+        InclusionMandatory, m_cLevel, &m_lastErrorDescription);
+
+    if (!tmpServiceInfo.isValid(m_cLevel))
     {
         m_lastError = InvalidDeviceDescriptionError;
         m_lastErrorDescription =
-            "Invalid device description: no valid root device definition "
-            "was found.";
+            QString("%1:\n%2").arg(
+                m_lastErrorDescription,
+                elementSource(reader, docStr, startOffset));
 
         return false;
     }
 
-    *rootEl = rootDeviceElement;
+    *serviceInfo = tmpServiceInfo;
     return true;
 }
 
-qint32 HDocParser::readConfigId(const QDomElement& rootElement)
+bool HDocParser::parseDevice(
+    QXmlStreamReader& reader, const QString& docStr, HParsedDevice* device,
+    qint32* configId)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    Q_ASSERT(device);
 
-    bool ok = false;
-
-    QString cid = readElementValue("configId", rootElement);
-    qint32 retVal = cid.toInt(&ok);
-    if (!ok || retVal < 0 || retVal > ((1 << 24)-1))
-    {
-        return 0;
-    }
+    QHash<QString, QString> elements;
 
-    return retVal;
-}
-
-bool HDocParser::parseDeviceInfo(
-    const QDomElement& deviceElement, HDeviceInfo* info)
-{
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-    Q_ASSERT(info);
-
-    QString deviceType       =
-        readElementValue("deviceType"      , deviceElement);
-
-    QString friendlyName     =
-        readElementValue("friendlyName"    , deviceElement);
-
-    QString manufacturer     =
-        readElementValue("manufacturer"    , deviceElement);
-
-    QString manufacturerURL  =
-        readElementValue("manufacturerURL" , deviceElement);
-
-    QString modelDescription =
-        readElementValue("modelDescription", deviceElement);
-
-    QString modelName        =
-        readElementValue("modelName"       , deviceElement);
+    QList<QUrl> icons;
+    bool iconListFound = false;
 
-    QString modelNumber      =
-        readElementValue("modelNumber"     , deviceElement);
+    while(reader.readNextStartElement())
+    {
+        QString name = reader.name().toString();
+        if (name == "iconList")
+        {
+            if (!iconListFound)
+            {
+                iconListFound = true;
+                icons = parseIconList(reader);
+            }
+            else
+            {
+                reader.skipCurrentElement();
+            }
+        }
+        else if (name == "serviceList")
+        {
+            if (device->m_hasServiceList)
+            {
+                reader.skipCurrentElement();
+                continue;
+            }
 
-    QUrl    modelUrl         =
-        readElementValue("modelURL"        , deviceElement);
+            device->m_hasServiceList = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() != "service")
+                {
+                    reader.skipCurrentElement();
+                    continue;
+                }
 
-    QString serialNumber     =
-        readElementValue("serialNumber"    , deviceElement);
+                HServiceInfo info;
+                if (!parseServiceInfo(reader, docStr, &info))
+                {
+                    return false;
+                }
+                device->m_services.append(info);
+            }
+        }
+        else if (name == "deviceList")
+        {
+            if (device->m_hasDeviceList)
+            {
+                reader.skipCurrentElement();
+                continue;
+            }
 
-    HUdn udn(readElementValue("UDN"        , deviceElement));
+            device->m_hasDeviceList = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() != "device")
+                {
+                    reader.skipCurrentElement();
+                    continue;
+                }
 
-    QString upc              =
-        readElementValue("UPC"             , deviceElement);
+                HParsedDevice embeddedDevice;
+                if (!parseDevice(reader, docStr, &embeddedDevice, 0))
+                {
+                    return false;
+                }
+                device->m_embeddedDevices.append(embeddedDevice);
+            }
+        }
+        else if (!elements.contains(name))
+        {
+            elements.insert(name, readText(reader));
+        }
+        else
+        {
+            reader.skipCurrentElement();
+        }
+    }
 
-    QDomElement iconListElement = deviceElement.firstChildElement("iconList");
-    QList<QUrl> icons;
-    if (!iconListElement.isNull())
+    if (reader.hasError())
     {
-        icons = parseIconList(iconListElement);
+        return setParseError(reader, InvalidDeviceDescriptionError);
     }
 
-    bool wasDefined = false;
+    if (configId)
+    {
+        bool ok = false;
+        *configId = elements.value("configId").toInt(&ok);
+        if (!ok || *configId < 0 || *configId > ((1 << 24)-1))
+        {
+            *configId = 0;
+        }
+    }
 
-    QString tmp = readElementValue("presentationURL", deviceElement, &wasDefined);
+    bool wasDefined = elements.contains("presentationURL");
+    QString tmp = elements.value("presentationURL");
 
     if (wasDefined && tmp.isEmpty())
     {
@@ -432,26 +535,24 @@ bool HDocParser::parseDeviceInfo(
         }
     }
 
-    QUrl presentationUrl(tmp);
-
-    *info = HDeviceInfo(
-        HResourceType(deviceType),
-        friendlyName,
-        manufacturer,
-        manufacturerURL,
-        modelDescription,
-        modelName,
-        modelNumber,
-        modelUrl,
-        serialNumber,
-        udn,
-        upc,
+    device->m_info = HDeviceInfo(
+        HResourceType(elements.value("deviceType")),
+        elements.value("friendlyName"),
+        elements.value("manufacturer"),
+        QUrl(elements.value("manufacturerURL")),
+        elements.value("modelDescription"),
+        elements.value("modelName"),
+        elements.value("modelNumber"),
+        QUrl(elements.value("modelURL")),
+        elements.value("serialNumber"),
+        HUdn(elements.value("UDN")),
+        elements.value("UPC"),
         icons,
-        presentationUrl,
+        QUrl(tmp),
         m_cLevel,
         &m_lastErrorDescription);
 
-    if (!info->isValid(m_cLevel))
+    if (!device->m_info.isValid(m_cLevel))
     {
         m_lastError = InvalidDeviceDescriptionError;
         m_lastErrorDescription = QString(
@@ -463,220 +564,165 @@ bool HDocParser::parseDeviceInfo(
     return true;
 }
 
-bool HDocParser::parseServiceInfo(
-    const QDomElement& serviceDefinition, HServiceInfo* serviceInfo)
+bool HDocParser::parseDeviceDescription(
+    const QString& docStr, HParsedDevice* rootDevice, qint32* configId)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    Q_ASSERT(serviceInfo);
-    Q_ASSERT(!serviceDefinition.isNull());
-
-    bool wasDefined = false;
+    Q_ASSERT(rootDevice);
+    Q_ASSERT(configId);
 
-    HServiceId serviceId =
-        readElementValue("serviceId", serviceDefinition, &wasDefined);
+    QXmlStreamReader reader(docStr);
+    reader.setNamespaceProcessing(false);
 
-    if (!wasDefined)
+    if (!reader.readNextStartElement())
+    {
+        return setParseError(reader, InvalidDeviceDescriptionError);
+    }
+    else if (reader.name() != "root")
     {
         m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Invalid <service> definition. "
-            "Missing mandatory <serviceId> element:\n%1").arg(
-                toString(serviceDefinition));
+        m_lastErrorDescription =
+            "Invalid device description: missing <root> element.";
 
         return false;
     }
 
-    HResourceType resourceType =
-        readElementValue("serviceType", serviceDefinition, &wasDefined);
+    QString specVersionError = "Missing mandatory <specVersion> element.";
+    bool specVersionFound = false, specVersionOk = false, deviceFound = false;
 
-    if (!wasDefined)
+    while(reader.readNextStartElement())
     {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Invalid <service> definition. "
-            "Missing mandatory <serviceType> element:\n%1").arg(
-                toString(serviceDefinition));
-
-        return false;
+        if (reader.name() == "specVersion" && !specVersionFound)
+        {
+            specVersionFound = true;
+            specVersionOk = readSpecVersion(reader, &specVersionError);
+        }
+        else if (reader.name() == "device" && !deviceFound)
+        {
+            deviceFound = true;
+            if (!parseDevice(reader, docStr, rootDevice, configId))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            reader.skipCurrentElement();
+        }
     }
 
-    QUrl scpdUrl = readElementValue("SCPDURL", serviceDefinition, &wasDefined);
-    if (!wasDefined)
+    while(!reader.atEnd())
     {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Invalid <service> definition. "
-            "Missing mandatory <SCPDURL> element:\n%1").arg(
-                toString(serviceDefinition));
-
-        return false;
+        // the rest of the document has to be well-formed as well
+        reader.readNext();
     }
 
-    QUrl controlUrl =
-        readElementValue("controlURL" , serviceDefinition, &wasDefined);
-
-    if (!wasDefined)
+    if (reader.hasError())
     {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Invalid <service> definition. "
-            "Missing mandatory <controlURL> element:\n%1").arg(
-                toString(serviceDefinition));
-
-        return false;
+        return setParseError(reader, InvalidDeviceDescriptionError);
     }
 
-    QUrl eventSubUrl =
-        readElementValue("eventSubURL", serviceDefinition, &wasDefined);
-
-    if (!wasDefined)
+    if (!specVersionOk)
     {
-        m_lastError = InvalidDeviceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Invalid <service> definition. "
-            "Missing mandatory <eventSubURL> element:\n%1").arg(
-                toString(serviceDefinition));
-
-        return false;
+        m_lastErrorDescription = specVersionError;
+        if (m_cLevel == StrictChecks)
+        {
+            m_lastError = InvalidDeviceDescriptionError;
+            return false;
+        }
+        else
+        {
+            HLOG_WARN_NONSTD(QString(
+                "Error in device description: %1").arg(m_lastErrorDescription));
+        }
     }
 
-    HServiceInfo tmpServiceInfo(
-        serviceId, resourceType, controlUrl, eventSubUrl, scpdUrl,
-        InclusionMandatory, m_cLevel, &m_lastErrorDescription);
-
-    if (!tmpServiceInfo.isValid(m_cLevel))
+    if (!deviceFound)
     {
         m_lastError = InvalidDeviceDescriptionError;
         m_lastErrorDescription =
-            QString("%1:\n%2").arg(
-                m_lastErrorDescription, toString(serviceDefinition));
+            "Invalid device description: no valid root device definition "
+            "was found.";
 
         return false;
     }
 
-    *serviceInfo = tmpServiceInfo;
     return true;
 }
 
-bool HDocParser::parseServiceDescription(
-    const QString& docStr, QDomDocument* doc,
-    QDomElement* stateVarElement, QDomElement* retVal)
+bool HDocParser::parseStateVariable(
+    QXmlStreamReader& reader, const QString& docStr, HStateVariableInfo* svInfo)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    Q_ASSERT(stateVarElement);
-    Q_ASSERT(retVal);
+    Q_ASSERT(svInfo);
 
-    qint32 errLine;
-    QString errMsg;
-    if (!doc->setContent(docStr, false, &errMsg, &errLine))
-    {
-        m_lastError = InvalidServiceDescriptionError;
-        m_lastErrorDescription = QString(
-            "Failed to parse the service description: [%1] @ line [%2].").arg(
-                errMsg, QString::number(errLine));
+    qint64 startOffset = reader.characterOffset();
+    QXmlStreamAttributes attributes = reader.attributes();
 
-        return false;
-    }
-    //QDomNodeList scpdElementNodeList =
-        //tmp.elementsByTagNameNS("urn:schemas-upnp-org:service-1-0","scpd");
+    QHash<QString, QString> elements;
 
-    QDomElement scpdElement = doc->firstChildElement("scpd");
-    if (scpdElement.isNull())
-    {
-        m_lastError = InvalidServiceDescriptionError;
-        m_lastErrorDescription =
-            "Invalid service description: missing <scpd> element.";
+    QStringList allowedValues;
+    bool allowedValueListFound = false;
 
-        return false;
-    }
+    QHash<QString, QString> allowedValueRange;
+    bool allowedValueRangeFound = false;
 
-    if (!verifySpecVersion(scpdElement, &m_lastErrorDescription))
+    while(reader.readNextStartElement())
     {
-        if (m_cLevel == StrictChecks)
+        QString name = reader.name().toString();
+        if (name == "allowedValueList")
         {
-            m_lastError = InvalidServiceDescriptionError;
-            return false;
+            if (allowedValueListFound)
+            {
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            allowedValueListFound = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() == "allowedValue")
+                {
+                    allowedValues.append(readText(reader));
+                }
+                else
+                {
+                    reader.skipCurrentElement();
+                }
+            }
         }
-        else
+        else if (name == "allowedValueRange")
         {
-            HLOG_WARN_NONSTD(QString("Error in service description: %1").arg(
-                m_lastErrorDescription));
-        }
-    }
-
-    QDomElement serviceStateTableElement =
-        scpdElement.firstChildElement("serviceStateTable");
-
-    if (serviceStateTableElement.isNull())
-    {
-        m_lastError = InvalidServiceDescriptionError;
-        m_lastErrorDescription =
-            "Service description is missing a mandatory <serviceStateTable> element.";
-
-        return false;
-    }
-
-    QDomElement stateVariableElement =
-        serviceStateTableElement.firstChildElement("stateVariable");
-
-    if (stateVariableElement.isNull())
-    {
-        QString err = "Service description document does not have a "
-                      "single <stateVariable> element. "
-                      "Each service MUST have at least one state variable.";
+            if (allowedValueRangeFound)
+            {
+                reader.skipCurrentElement();
+                continue;
+            }
 
-        if (m_cLevel == StrictChecks)
+            allowedValueRangeFound = true;
+            readChildElements(reader, &allowedValueRange);
+        }
+        else if (!elements.contains(name))
         {
-            m_lastError = InvalidServiceDescriptionError;
-            m_lastErrorDescription = err;
-            return false;
+            elements.insert(name, readText(reader));
         }
         else
         {
-            HLOG_WARN_NONSTD(err);
+            reader.skipCurrentElement();
         }
     }
 
-    QDomElement actionListElement = scpdElement.firstChildElement("actionList");
-    if (actionListElement.isNull())
+    if (reader.hasError())
     {
-        return true;
+        return setParseError(reader, InvalidServiceDescriptionError);
     }
 
-    QDomElement actionElement = actionListElement.firstChildElement("action");
-    if (actionElement.isNull())
-    {
-        QString err = "Service description document has <actionList> "
-                      "element that has no <action> elements.";
+    QString strSendEvents = attributes.hasAttribute("sendEvents") ?
+        attributes.value("sendEvents").toString() : QString("no");
 
-        if (m_cLevel == StrictChecks)
-        {
-            m_lastError = InvalidServiceDescriptionError;
-            m_lastErrorDescription = err;
-            return false;
-        }
-        else
-        {
-            HLOG_WARN(err);
-        }
-    }
-
-    *stateVarElement = stateVariableElement;
-    *retVal = actionElement;
-    return true;
-}
-
-bool HDocParser::parseStateVariable(
-    const QDomElement& stateVariableElement, HStateVariableInfo* svInfo)
-{
-    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
-
-    Q_ASSERT(svInfo);
-
-    QString strSendEvents = stateVariableElement.attribute("sendEvents", "no");
-    bool bSendEvents      = false;
+    bool bSendEvents = false;
     if (strSendEvents.compare("yes", Qt::CaseInsensitive) == 0)
     {
         bSendEvents = true;
@@ -687,13 +733,15 @@ bool HDocParser::parseStateVariable(
         m_lastErrorDescription = QString(
             "Invalid <stateVariable> definition: "
             "invalid value for [sendEvents] attribute:\n%1.").arg(
-                toString(stateVariableElement));
+                elementSource(reader, docStr, startOffset));
 
         return false;
     }
 
-    QString strMulticast  = stateVariableElement.attribute("multicast", "no");
-    bool bMulticast       = false;
+    QString strMulticast = attributes.hasAttribute("multicast") ?
+        attributes.value("multicast").toString() : QString("no");
+
+    bool bMulticast = false;
     if (strMulticast.compare("yes", Qt::CaseInsensitive) == 0)
     {
         bMulticast = true;
@@ -704,7 +752,7 @@ bool HDocParser::parseStateVariable(
         m_lastErrorDescription = QString(
             "Invalid <stateVariable> definition: "
             "invalid value for [multicast]: %1.").arg(
-                toString(stateVariableElement));
+                elementSource(reader, docStr, startOffset));
 
         return false;
     }
@@ -716,14 +764,13 @@ bool HDocParser::parseStateVariable(
             HStateVariableInfo::UnicastAndMulticast : HStateVariableInfo::UnicastOnly;
     }
 
-    QString name = readElementValue("name", stateVariableElement);
-    QString dataType = readElementValue("dataType", stateVariableElement);
+    QString name = elements.value("name");
+    QString dataType = elements.value("dataType");
 
     HUpnpDataTypes::DataType dtEnumValue = HUpnpDataTypes::dataType(dataType);
 
-    bool defValueWasDefined = false;
-    QString defaultValueStr = readElementValue(
-        "defaultValue", stateVariableElement, &defValueWasDefined);
+    bool defValueWasDefined = elements.contains("defaultValue");
+    QString defaultValueStr = elements.value("defaultValue");
 
     QVariant defaultValue =
         defValueWasDefined ?
@@ -737,7 +784,7 @@ bool HDocParser::parseStateVariable(
         parsedInfo = parseStateVariableInfo_str(
             name,
             defValueWasDefined ? defaultValueStr : QVariant(),
-            stateVariableElement,
+            allowedValues,
             evType,
             InclusionMandatory);
     }
@@ -746,7 +793,8 @@ bool HDocParser::parseStateVariable(
         parsedInfo = parseStateVariableInfo_numeric(
             name,
             defaultValue,
-            stateVariableElement,
+            allowedValueRangeFound,
+            allowedValueRange,
             evType,
             InclusionMandatory,
             dtEnumValue);
@@ -776,37 +824,74 @@ bool HDocParser::parseStateVariable(
     return true;
 }
 
-bool HDocParser::parseActionInfo(
-    const QDomElement& actionElement,
+void HDocParser::parseAction(QXmlStreamReader& reader, Action* action)
+{
+    Q_ASSERT(action);
+
+    bool nameFound = false, argumentListFound = false;
+    while(reader.readNextStartElement())
+    {
+        if (reader.name() == "name" && !nameFound)
+        {
+            nameFound = true;
+            action->m_name = readText(reader);
+        }
+        else if (reader.name() == "argumentList" && !argumentListFound)
+        {
+            argumentListFound = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() != "argument")
+                {
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                QHash<QString, QString> elements;
+                readChildElements(reader, &elements);
+
+                ActionArgument argument;
+                argument.m_name = elements.value("name");
+                argument.m_direction = elements.value("direction");
+                argument.m_relatedStateVariable =
+                    elements.value("relatedStateVariable");
+                argument.m_retval = elements.contains("retval");
+
+                action->m_arguments.append(argument);
+            }
+        }
+        else
+        {
+            reader.skipCurrentElement();
+        }
+    }
+}
+
+bool HDocParser::createActionInfo(
+    const Action& action,
     const QHash<QString, HStateVariableInfo>& stateVars,
     HActionInfo* ai)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    QString name = readElementValue("name", actionElement);
+    const QString& name = action.m_name;
 
     bool hasRetVal = false;
     QVector<HActionArgument> inputArguments;
     QVector<HActionArgument> outputArguments;
 
-    QDomElement argumentListElement =
-        actionElement.firstChildElement("argumentList");
-
-    if (!argumentListElement.isNull())
+    if (!parseActionArguments(
+            action.m_arguments,
+            stateVars,
+            &inputArguments,
+            &outputArguments,
+            &hasRetVal))
     {
-        if (!parseActionArguments(
-                argumentListElement,
-                stateVars,
-                &inputArguments,
-                &outputArguments,
-                &hasRetVal))
-        {
-            m_lastErrorDescription = QString(
-                "Invalid action [%1] definition: %2").arg(
-                    name, m_lastErrorDescription);
+        m_lastErrorDescription = QString(
+            "Invalid action [%1] definition: %2").arg(
+                name, m_lastErrorDescription);
 
-            return false;
-        }
+        return false;
     }
 
     HActionArguments inArgs(inputArguments);
@@ -829,35 +914,179 @@ bool HDocParser::parseActionInfo(
     return true;
 }
 
-bool HDocParser::verifySpecVersion(const QDomElement& rootElement, QString* err)
+bool HDocParser::parseServiceDescription(
+    const QString& docStr,
+    QList<HStateVariableInfo>* stateVariables, QList<HActionInfo>* actions)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
 
-    QDomElement specVersionElement = rootElement.firstChildElement("specVersion");
-    if (specVersionElement.isNull())
+    Q_ASSERT(stateVariables);
+    Q_ASSERT(actions);
+
+    QXmlStreamReader reader(docStr);
+    reader.setNamespaceProcessing(false);
+
+    if (!reader.readNextStartElement())
     {
-        if (err) { *err = "Missing mandatory <specVersion> element."; }
+        return setParseError(reader, InvalidServiceDescriptionError);
+    }
+    else if (reader.name() != "scpd")
+    {
+        m_lastError = InvalidServiceDescriptionError;
+        m_lastErrorDescription =
+            "Invalid service description: missing <scpd> element.";
+
         return false;
     }
 
-    QString minorVersion = readElementValue("minor", specVersionElement);
-    QString majorVersion = readElementValue("major", specVersionElement);
+    QString specVersionError = "Missing mandatory <specVersion> element.";
+    bool specVersionFound = false, specVersionOk = false;
+    bool serviceStateTableFound = false, actionListFound = false;
 
-    bool ok;
-    qint32 major = majorVersion.toInt(&ok);
-    if (!ok || major != 1)
+    QList<HStateVariableInfo> parsedStateVariables;
+
+    // The actions are resolved once the document has been read, since the
+    // <actionList> usually precedes the <serviceStateTable> the actions
+    // refer to.
+    QList<Action> parsedActions;
+
+    while(reader.readNextStartElement())
     {
-        if (err) { *err = "Major element of <specVersion> is not 1."; }
-        return false;
+        if (reader.name() == "specVersion" && !specVersionFound)
+        {
+            specVersionFound = true;
+            specVersionOk = readSpecVersion(reader, &specVersionError);
+        }
+        else if (reader.name() == "serviceStateTable" && !serviceStateTableFound)
+        {
+            serviceStateTableFound = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() != "stateVariable")
+                {
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                HStateVariableInfo svInfo;
+                if (!parseStateVariable(reader, docStr, &svInfo))
+                {
+                    return false;
+                }
+                parsedStateVariables.append(svInfo);
+            }
+        }
+        else if (reader.name() == "actionList" && !actionListFound)
+        {
+            actionListFound = true;
+            while(reader.readNextStartElement())
+            {
+                if (reader.name() != "action")
+                {
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                Action action;
+                parseAction(reader, &action);
+                parsedActions.append(action);
+            }
+        }
+        else
+        {
+            reader.skipCurrentElement();
+        }
     }
 
-    qint32 minor = minorVersion.toInt(&ok);
-    if (!ok || (minor != 1 && minor != 0))
+    while(!reader.atEnd())
     {
-        if (err) { *err = "Minor element of <specVersion> is not 0 or 1."; }
+        reader.readNext();
+    }
+
+    if (reader.hasError())
+    {
+        return setParseError(reader, InvalidServiceDescriptionError);
+    }
+
+    if (!specVersionOk)
+    {
+        m_lastErrorDescription = specVersionError;
+        if (m_cLevel == StrictChecks)
+        {
+            m_lastError = InvalidServiceDescriptionError;
+            return false;
+        }
+        else
+        {
+            HLOG_WARN_NONSTD(QString("Error in service description: %1").arg(
+                m_lastErrorDescription));
+        }
+    }
+
+    if (!serviceStateTableFound)
+    {
+        m_lastError = InvalidServiceDescriptionError;
+        m_lastErrorDescription =
+            "Service description is missing a mandatory <serviceStateTable> element.";
+
         return false;
     }
 
+    if (parsedStateVariables.isEmpty())
+    {
+        QString err = "Service description document does not have a "
+                      "single <stateVariable> element. "
+                      "Each service MUST have at least one state variable.";
+
+        if (m_cLevel == StrictChecks)
+        {
+            m_lastError = InvalidServiceDescriptionError;
+            m_lastErrorDescription = err;
+            return false;
+        }
+        else
+        {
+            HLOG_WARN_NONSTD(err);
+        }
+    }
+
+    if (actionListFound && parsedActions.isEmpty())
+    {
+        QString err = "Service description document has <actionList> "
+                      "element that has no <action> elements.";
+
+        if (m_cLevel == StrictChecks)
+        {
+            m_lastError = InvalidServiceDescriptionError;
+            m_lastErrorDescription = err;
+            return false;
+        }
+        else
+        {
+            HLOG_WARN(err);
+        }
+    }
+
+    HStateVariableInfos svInfos;
+    foreach(const HStateVariableInfo& svInfo, parsedStateVariables)
+    {
+        svInfos.insert(svInfo.name(), svInfo);
+    }
+
+    QList<HActionInfo> actionInfos;
+    foreach(const Action& action, parsedActions)
+    {
+        HActionInfo actionInfo;
+        if (!createActionInfo(action, svInfos, &actionInfo))
+        {
+            return false;
+        }
+        actionInfos.append(actionInfo);
+    }
+
+    *stateVariables = parsedStateVariables;
+    *actions = actionInfos;
+
     return true;
 }
 
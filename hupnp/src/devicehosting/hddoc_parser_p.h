@@ -34,6 +34,7 @@
 #include "../general/hupnp_fwd.h"
 #include "../general/hupnp_global.h"
 #include "../dataelements/hserviceid.h"
+#include "../dataelements/hdeviceinfo.h"
 #include "../dataelements/hactioninfo.h"
 #include "../dataelements/hserviceinfo.h"
 #include "../dataelements/hstatevariableinfo.h"
@@ -43,11 +44,13 @@
 
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QVector>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
-class QDomElement;
-class QDomDocument;
+class QXmlStreamReader;
 
 namespace Herqq
 {
@@ -66,7 +69,27 @@ enum DocumentErrorTypes
 };
 
 //
-// The class that creates the HUPnP's device model from description files
+// The contents of a <device> element of a device description
+//
+class HParsedDevice
+{
+public:
+
+    HDeviceInfo m_info;
+
+    QList<HServiceInfo> m_services;
+    bool m_hasServiceList;
+
+    QList<HParsedDevice> m_embeddedDevices;
+    bool m_hasDeviceList;
+
+    HParsedDevice();
+};
+
+//
+// The parser of UPnP device and service descriptions. The descriptions are
+// read in a single pass with QXmlStreamReader and the information elements
+// are created directly, without building a DOM of the documents.
 //
 class HDocParser
 {
@@ -74,27 +97,61 @@ H_DISABLE_COPY(HDocParser)
 
 private:
 
-    QList<QUrl> parseIconList(
-        const QDomElement& iconListElement);
+    struct ActionArgument
+    {
+        QString m_name;
+        QString m_direction;
+        QString m_relatedStateVariable;
+        bool m_retval;
+    };
+
+    struct Action
+    {
+        QString m_name;
+        QList<ActionArgument> m_arguments;
+    };
+
+    bool setParseError(const QXmlStreamReader&, DocumentErrorTypes);
+
+    bool readSpecVersion(QXmlStreamReader&, QString* err);
+
+    QList<QUrl> parseIconList(QXmlStreamReader&);
+
+    bool parseServiceInfo(
+        QXmlStreamReader&, const QString& docStr, HServiceInfo*);
+
+    bool parseDevice(
+        QXmlStreamReader&, const QString& docStr, HParsedDevice*,
+        qint32* configId);
 
     bool parseActionArguments(
-        const QDomElement& argListElement,
+        const QList<ActionArgument>&,
         const QHash<QString, HStateVariableInfo>&,
         QVector<HActionArgument>* inArgs,
         QVector<HActionArgument>* outArgs,
         bool* hasRetVal);
 
+    bool parseStateVariable(
+        QXmlStreamReader&, const QString& docStr, HStateVariableInfo*);
+
+    void parseAction(QXmlStreamReader&, Action*);
+
+    bool createActionInfo(
+        const Action&, const QHash<QString, HStateVariableInfo>&,
+        HActionInfo*);
+
     HStateVariableInfo parseStateVariableInfo_str(
         const QString& name,
         const QVariant& defValue,
-        const QDomElement& svElement,
+        const QStringList& allowedValues,
         HStateVariableInfo::EventingType,
         HInclusionRequirement);
 
     HStateVariableInfo parseStateVariableInfo_numeric(
         const QString& name,
         const QVariant& defValue,
-        const QDomElement& svElement,
+        bool hasAllowedValueRange,
+        const QHash<QString, QString>& allowedValueRange,
         HStateVariableInfo::EventingType,
         HInclusionRequirement,
         HUpnpDataTypes::DataType dataTypeEnumValue);
@@ -113,27 +170,21 @@ public:
     inline QString lastErrorDescription() const { return m_lastErrorDescription; }
     inline DocumentErrorTypes lastError() const { return m_lastError; }
 
-    bool parseRoot(const QString& doc, QDomDocument*, QDomElement*);
-    qint32 readConfigId(const QDomElement&);
-    bool parseDeviceInfo(const QDomElement&, HDeviceInfo*);
-    bool parseServiceInfo(const QDomElement& serviceDefinition, HServiceInfo*);
-
+    //
+    // Parses a device description into the information elements of the
+    // root device and its embedded devices.
+    //
+    bool parseDeviceDescription(
+        const QString& docStr, HParsedDevice* rootDevice, qint32* configId);
+
+    //
+    // Parses a service description into the information elements of the
+    // state variables and actions in the order they appear in the description.
+    //
     bool parseServiceDescription(
         const QString& docStr,
-        QDomDocument* doc,
-        QDomElement* stateVarElement,
-        QDomElement* actionElement);
-
-    bool parseStateVariable(
-        const QDomElement& stateVariableElement,
-        HStateVariableInfo*);
-
-    bool parseActionInfo(
-        const QDomElement& actionElement,
-        const QHash<QString, HStateVariableInfo>&,
-        HActionInfo*);
-
-    bool verifySpecVersion(const QDomElement&, QString* err = 0);
+        QList<HStateVariableInfo>* stateVariables,
+        QList<HActionInfo>* actions);
 };
 
 //
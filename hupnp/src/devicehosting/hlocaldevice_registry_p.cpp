@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hlocaldevice_registry_p.h"
+
+#include "../dataelements/hudn.h"
+#include "../dataelements/hdeviceinfo.h"
+#include "../devicemodel/server/hserverdevice.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QMutexLocker>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace
+{
+QMutex s_registryMutex;
+QHash<HUdn, HServerDevice*> s_devices;
+
+void addDevice(HServerDevice* device)
+{
+    s_devices.insert(device->info().udn(), device);
+
+    foreach(HServerDevice* embeddedDevice, device->embeddedDevices())
+    {
+        addDevice(embeddedDevice);
+    }
+}
+
+void removeDevice(HServerDevice* device)
+{
+    QHash<HUdn, HServerDevice*>::iterator it =
+        s_devices.find(device->info().udn());
+
+    // another device host of the process may have published a device with
+    // the same UDN afterwards
+    if (it != s_devices.end() && it.value() == device)
+    {
+        s_devices.erase(it);
+    }
+
+    foreach(HServerDevice* embeddedDevice, device->embeddedDevices())
+    {
+        removeDevice(embeddedDevice);
+    }
+}
+}
+
+/*******************************************************************************
+ * HLocalDeviceRegistry
+ ******************************************************************************/
+void HLocalDeviceRegistry::add(HServerDevice* rootDevice)
+{
+    Q_ASSERT(rootDevice);
+
+    QMutexLocker lock(&s_registryMutex);
+    addDevice(rootDevice);
+}
+
+void HLocalDeviceRegistry::remove(HServerDevice* rootDevice)
+{
+    Q_ASSERT(rootDevice);
+
+    QMutexLocker lock(&s_registryMutex);
+    removeDevice(rootDevice);
+}
+
+HServerDevice* HLocalDeviceRegistry::device(const HUdn& udn)
+{
+    QMutexLocker lock(&s_registryMutex);
+
+    // the device cannot be deleted while the lock is held, since it is
+    // unregistered before that. once it is known to live in this thread,
+    // it cannot be deleted before the caller returns to the event loop.
+    HServerDevice* device = s_devices.value(udn);
+    return device && device->thread() == QThread::currentThread() ? device : 0;
+}
+
+}
+}
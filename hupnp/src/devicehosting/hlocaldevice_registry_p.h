@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HLOCALDEVICE_REGISTRY_P_H_
+#define HLOCALDEVICE_REGISTRY_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "../general/hupnp_defs.h"
+#include "../general/hupnp_fwd.h"
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+//
+// The process-wide registry of the devices published by the device hosts of
+// this process. A control point uses this to talk to a device hosted in the
+// same process directly instead of through the network.
+//
+class HLocalDeviceRegistry
+{
+H_DISABLE_COPY(HLocalDeviceRegistry)
+
+private:
+
+    HLocalDeviceRegistry();
+
+public:
+
+    // registers the specified root device and its embedded devices
+    static void add(HServerDevice* rootDevice);
+
+    // unregisters the specified root device and its embedded devices. this
+    // has to be called before the device is deleted.
+    static void remove(HServerDevice* rootDevice);
+
+    // returns the device with the specified UDN if it is hosted in this
+    // process and it lives in the calling thread. the device may be used
+    // only in its own thread and thus any other device is of no use.
+    static HServerDevice* device(const HUdn&);
+};
+
+}
+}
+
+#endif /* HLOCALDEVICE_REGISTRY_P_H_ */
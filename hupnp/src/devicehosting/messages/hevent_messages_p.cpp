@@ -23,10 +23,9 @@
 
 #include "../../general/hlogger_p.h"
 
-#include <QtXml/QDomDocument>
-
 #include <QtCore/QRegExp>
 #include <QtCore/QStringList>
+#include <QtCore/QXmlStreamReader>
 
 #include <QtNetwork/QHostAddress>
 
@@ -55,13 +54,15 @@ inline bool isValidEventUrl(const QUrl& eventUrl)
 }
 
 HSubscribeRequest::HSubscribeRequest() :
-    m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent()
+    m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent(),
+    m_localServer()
 {
 }
 
 HSubscribeRequest::HSubscribeRequest(
     const QUrl& eventUrl, const HSid& sid, const HTimeout& timeout) :
-        m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent()
+        m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent(),
+        m_localServer()
 {
     HLOG(H_AT, H_FUN);
 
@@ -84,7 +85,8 @@ HSubscribeRequest::HSubscribeRequest(
 HSubscribeRequest::HSubscribeRequest(
     const QUrl& eventUrl, const HProductTokens& userAgent, const QUrl& callback,
     const HTimeout& timeout) :
-        m_callbacks (), m_timeout(), m_sid(), m_eventUrl(), m_userAgent()
+        m_callbacks (), m_timeout(), m_sid(), m_eventUrl(), m_userAgent(),
+        m_localServer()
 {
     HLOG(H_AT, H_FUN);
 
@@ -109,7 +111,8 @@ HSubscribeRequest::HSubscribeRequest(
 HSubscribeRequest::HSubscribeRequest(
     const QUrl& eventUrl, const HProductTokens& userAgent,
     const QList<QUrl>& callbacks, const HTimeout& timeout) :
-        m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent()
+        m_callbacks(), m_timeout(), m_sid(), m_eventUrl(), m_userAgent(),
+        m_localServer()
 {
     HLOG(H_AT, H_FUN);
 
@@ -293,41 +296,42 @@ HNotifyRequest::RetVal parseData(
 {
     HLOG(H_AT, H_FUN);
 
-    QDomDocument dd;
-    if (!dd.setContent(data, true))
-    {
-        return HNotifyRequest::InvalidContents;
-    }
-
-    //QDomNodeList propertySetNodes =
-      //  dd.elementsByTagNameNS("urn:schemas-upnp.org:event-1-0", "propertyset");
+    // the bodies of some services, such as the LastChange events of the
+    // AV services, are large and they are received frequently. A stream reader
+    // is used instead of a DOM to avoid building a tree for every message.
+    QXmlStreamReader reader(data);
 
-    QDomElement propertySetElement = dd.firstChildElement("propertyset");
-
-    if (propertySetElement.isNull())
+    if (!reader.readNextStartElement() ||
+        reader.name() != QLatin1String("propertyset"))
     {
         return HNotifyRequest::InvalidContents;
     }
 
-    QDomElement propertyElement =
-        propertySetElement.firstChildElement("property");
-        //propertySetNodes.at(0).toElement().elementsByTagNameNS(
-          //  "urn:schemas-upnp.org:event-1-0", "property");
-
     QList<QPair<QString, QString> > tmp;
-    while(!propertyElement.isNull())
+    while(reader.readNextStartElement())
     {
-        QDomElement variableElement = propertyElement.firstChildElement();
-        if (variableElement.isNull())
+        if (reader.name() != QLatin1String("property"))
+        {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        if (!reader.readNextStartElement())
         {
             return HNotifyRequest::InvalidContents;
         }
 
-        QDomText variableValue = variableElement.firstChild().toText();
-        tmp.push_back(
-            qMakePair(variableElement.localName(), variableValue.data()));
+        QString name = reader.name().toString();
+        tmp.push_back(qMakePair(
+            name, reader.readElementText(QXmlStreamReader::SkipChildElements)));
+
+        // skips anything following the variable inside the property
+        reader.skipCurrentElement();
+    }
 
-        propertyElement = propertyElement.nextSiblingElement("property");
+    if (reader.hasError())
+    {
+        return HNotifyRequest::InvalidContents;
     }
 
     parsedData = tmp;
@@ -417,5 +421,96 @@ HNotifyRequest::RetVal HNotifyRequest::setContents(
     return Success;
 }
 
+/*******************************************************************************
+ * HMulticastNotifyRequest
+ *******************************************************************************/
+HMulticastNotifyRequest::HMulticastNotifyRequest() :
+    m_usn(), m_serviceId(), m_seq(0), m_level(), m_bootId(-1),
+    m_dataAsVariables(), m_data()
+{
+}
+
+HMulticastNotifyRequest::HMulticastNotifyRequest(
+    const HDiscoveryType& usn, const HServiceId& serviceId, quint32 seq,
+    const QString& level, qint32 bootId, const QByteArray& contents) :
+        m_usn(), m_serviceId(), m_seq(0), m_level(), m_bootId(-1),
+        m_dataAsVariables(), m_data()
+{
+    HLOG(H_AT, H_FUN);
+
+    if (usn.type() != HDiscoveryType::SpecificServiceWithType ||
+        !serviceId.isValid(LooseChecks) || contents.isEmpty())
+    {
+        return;
+    }
+
+    // the contents are created by the sender and they are not parsed again
+    // just to fill the variables, which only the receiver uses
+
+    m_usn       = usn;
+    m_serviceId = serviceId;
+    m_seq       = seq;
+    m_level     = level;
+    m_bootId    = bootId;
+    m_data      = contents;
+}
+
+HMulticastNotifyRequest::~HMulticastNotifyRequest()
+{
+}
+
+HMulticastNotifyRequest::RetVal HMulticastNotifyRequest::setContents(
+    const QString& nt, const QString& nts, const QString& usn,
+    const QString& serviceId, const QString& seq, const QString& level,
+    const QString& bootId, const QByteArray& contents)
+{
+    HLOG(H_AT, H_FUN);
+
+    HNt tmpNt(nt, nts);
+    if (tmpNt.type   () != HNt::Type_UpnpEvent ||
+        tmpNt.subType() != HNt::SubType_UpnpPropChange)
+    {
+        return PreConditionFailed;
+    }
+
+    HMulticastNotifyRequest tmp;
+
+    tmp.m_usn = HDiscoveryType(usn.trimmed(), LooseChecks);
+    if (tmp.m_usn.type() != HDiscoveryType::SpecificServiceWithType)
+    {
+        return BadRequest;
+    }
+
+    tmp.m_serviceId = HServiceId(serviceId.trimmed());
+    if (!tmp.m_serviceId.isValid(LooseChecks))
+    {
+        return BadRequest;
+    }
+
+    bool ok = false;
+    tmp.m_seq = seq.trimmed().toUInt(&ok);
+    if (!ok)
+    {
+        return InvalidSequenceNr;
+    }
+
+    tmp.m_bootId = bootId.trimmed().toInt(&ok);
+    if (!ok)
+    {
+        tmp.m_bootId = -1;
+    }
+
+    tmp.m_level = level.trimmed();
+    tmp.m_data  = contents;
+
+    if (parseData(tmp.m_data, tmp.m_dataAsVariables) != HNotifyRequest::Success)
+    {
+        return InvalidContents;
+    }
+
+    *this = tmp;
+    return Success;
+}
+
 }
 }
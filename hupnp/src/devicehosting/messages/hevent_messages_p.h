@@ -34,11 +34,14 @@
 #include "hsid_p.h"
 #include "htimeout_p.h"
 
+#include <HUpnpCore/HServiceId>
+#include <HUpnpCore/HDiscoveryType>
 #include <HUpnpCore/HProductTokens>
 
 #include <QtCore/QUrl>
 #include <QtCore/QList>
 #include <QtCore/QPair>
+#include <QtCore/QString>
 #include <QtCore/QDateTime>
 #include <QtCore/QByteArray>
 
@@ -63,6 +66,9 @@ private:
     QUrl           m_eventUrl;
     HProductTokens m_userAgent;
 
+    QString        m_localServer;
+    // the local endpoint of the subscriber, if it runs on the same host
+
 public:
 
     enum RetVal
@@ -145,6 +151,16 @@ public:
     {
         return !m_userAgent.isEmpty();
     }
+
+    inline QString localServer() const
+    {
+        return m_localServer;
+    }
+
+    inline void setLocalServer(const QString& localServer)
+    {
+        m_localServer = localServer;
+    }
 };
 
 //
@@ -299,6 +315,73 @@ public:
     inline Variables  variables() const { return m_dataAsVariables; }
 };
 
+//
+// Class that represents a UDA 2.0 multicast event message, which is sent
+// over UDP to 239.255.255.246:7900 and contains the values of the
+// state variables that are marked as multicast evented.
+//
+class HMulticastNotifyRequest
+{
+public:
+
+    enum RetVal
+    {
+        Success = 0,
+        PreConditionFailed = -1,
+        InvalidContents = -2,
+        InvalidSequenceNr = -3,
+        BadRequest = -4
+    };
+
+    typedef HNotifyRequest::Variables Variables;
+
+private:
+
+    HDiscoveryType m_usn;
+    HServiceId     m_serviceId;
+    quint32        m_seq;
+    QString        m_level;
+    qint32         m_bootId;
+    Variables      m_dataAsVariables;
+    QByteArray     m_data;
+
+public:
+
+    HMulticastNotifyRequest();
+
+    // used by the sender. the contents are not parsed, which is why
+    // variables() returns an empty list
+    HMulticastNotifyRequest(
+        const HDiscoveryType& usn, const HServiceId& serviceId, quint32 seq,
+        const QString& level, qint32 bootId, const QByteArray& contents);
+
+    ~HMulticastNotifyRequest();
+
+    RetVal setContents(
+        const QString& nt, const QString& nts, const QString& usn,
+        const QString& serviceId, const QString& seq, const QString& level,
+        const QString& bootId, const QByteArray& contents);
+
+    inline bool isValid(bool strict) const
+    {
+        return m_usn.type() == HDiscoveryType::SpecificServiceWithType &&
+               m_serviceId.isValid(strict ? StrictChecks : LooseChecks);
+    }
+
+    inline HNt nt() const
+    {
+        return HNt(HNt::Type_UpnpEvent, HNt::SubType_UpnpPropChange);
+    }
+
+    inline HDiscoveryType usn      () const { return m_usn            ; }
+    inline HServiceId     serviceId() const { return m_serviceId      ; }
+    inline quint32        seq      () const { return m_seq            ; }
+    inline QString        level    () const { return m_level          ; }
+    inline qint32         bootId   () const { return m_bootId         ; }
+    inline QByteArray     data     () const { return m_data           ; }
+    inline Variables      variables() const { return m_dataAsVariables; }
+};
+
 }
 }
 
@@ -28,10 +28,18 @@
 #include "hdefault_clientservice_p.h"
 
 #include "../../general/hlogger_p.h"
+#include "../../general/hmetrics_p.h"
+
+#include "../../http/hhttp_utils_p.h"
+#include "../../http/hhttp_asynchandler_p.h"
+#include "../../http/hhttp_messagecreator_p.h"
 
 #include "../../general/hupnp_global_p.h"
 #include "../../general/hupnp_datatypes_p.h"
 
+#include "../hactioncodec.h"
+#include "../hactionarguments_p.h"
+
 #include "../../dataelements/hudn.h"
 #include "../../dataelements/hactioninfo.h"
 #include "../../dataelements/hdeviceinfo.h"
@@ -40,6 +48,10 @@
 #include "../../general/hlogger_p.h"
 
 #include <QtCore/QList>
+#include <QtCore/QDataStream>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
+#include <QtNetwork/QTcpSocket>
 #include <QtSoapMessage>
 
 namespace Herqq
@@ -48,6 +60,43 @@ namespace Herqq
 namespace Upnp
 {
 
+namespace
+{
+// the number of distinct input argument combinations cached per action
+const qint32 MaxCachedResults = 64;
+
+const char* const SoapEnvelopeNs = "http://schemas.xmlsoap.org/soap/envelope/";
+const char* const SoapEncodingNs = "http://schemas.xmlsoap.org/soap/encoding/";
+
+//
+// Positions the reader at the start of the first child element of the SOAP
+// body, which is either the response element of the action or a fault.
+//
+bool readToBodyContent(QXmlStreamReader& reader)
+{
+    if (!reader.readNextStartElement() ||
+        reader.name() != QLatin1String("Envelope") ||
+        reader.namespaceUri() != QLatin1String(SoapEnvelopeNs))
+    {
+        return false;
+    }
+
+    while(reader.readNextStartElement())
+    {
+        if (reader.name() == QLatin1String("Body") &&
+            reader.namespaceUri() == QLatin1String(SoapEnvelopeNs))
+        {
+            return reader.readNextStartElement();
+        }
+
+        // the optional header
+        reader.skipCurrentElement();
+    }
+
+    return false;
+}
+}
+
 /*******************************************************************************
  * HActionProxy
  ******************************************************************************/
@@ -59,7 +108,16 @@ HActionProxy::HActionProxy(
             m_iNextLocationToTry(0),
             m_nam(nam),
             m_reply(0),
-            m_owner(owner)
+            m_owner(owner),
+            m_inArgs(0),
+            m_invocationTimer(),
+            m_durations(0),
+            m_localAction(),
+            m_localInvocationPending(false),
+            m_localSocket(0),
+            m_localHttp(0),
+            m_localOp(0),
+            m_failedLocalServer()
 {
     Q_ASSERT(m_owner);
     bool ok = connect(
@@ -74,12 +132,104 @@ HActionProxy::~HActionProxy()
 {
 }
 
-void HActionProxy::invocationDone(qint32 rc, const HActionArguments* outArgs)
+void HActionProxy::invocationDone(qint32 rc, HActionArguments* outArgs)
 {
+    if (m_invocationTimer.isValid())
+    {
+        if (!m_durations)
+        {
+            m_durations = HMetricsRegistry::histogram(QString(
+                "hupnp_action_duration_milliseconds{side=\"client\",action=\"%1\"}").arg(
+                    HMetricsRegistry::label(m_owner->info().name())));
+        }
+
+        m_durations->add(static_cast<qint32>(m_invocationTimer.elapsed()));
+        m_invocationTimer.invalidate();
+    }
+
     deleteReply();
     m_owner->invokeCompleted(rc, outArgs);
 }
 
+void HActionProxy::cachedResultsReady()
+{
+    m_owner->deliverCachedResults();
+}
+
+void HActionProxy::invokeLocally()
+{
+    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+
+    if (!m_localInvocationPending)
+    {
+        // the invocation was aborted
+        return;
+    }
+
+    m_localInvocationPending = false;
+
+    if (!m_localAction || m_localAction->thread() != thread())
+    {
+        // the device host was shut down or moved to another thread after
+        // the invocation was dispatched
+        m_localAction = 0;
+        if (!send())
+        {
+            invocationDone(UpnpUndefinedFailure);
+        }
+        return;
+    }
+
+    // the arguments are matched by name, as the server-side action has
+    // arguments of its own. the values are passed as such.
+    HActionArguments iargs = m_localAction->info().inputArguments();
+    HActionArgumentsPrivate* iargsData = HActionArgumentsPrivate::get(iargs);
+    for(qint32 i = 0; i < iargsData->size(); ++i)
+    {
+        bool ok = false;
+        QVariant value = m_inArgs->value(iargsData->nameAt(i), &ok);
+        if (!ok || !iargsData->setValueAt(i, value))
+        {
+            invocationDone(UpnpInvalidArgs);
+            return;
+        }
+    }
+
+    HActionArguments serverOutArgs;
+    qint32 rc = m_localAction->invoke(iargs, &serverOutArgs);
+    if (rc != UpnpSuccess)
+    {
+        HLOG_WARN(QString("Action invocation failed: [%1]").arg(
+            QString::number(rc)));
+
+        invocationDone(rc);
+        return;
+    }
+
+    if (m_owner->info().outputArguments().size() == 0)
+    {
+        invocationDone(UpnpSuccess);
+        return;
+    }
+
+    HActionArguments outArgs = m_owner->info().outputArguments();
+    HActionArgumentsPrivate* outArgsData = HActionArgumentsPrivate::get(outArgs);
+    for(qint32 i = 0; i < outArgsData->size(); ++i)
+    {
+        bool ok = false;
+        QVariant value = serverOutArgs.value(outArgsData->nameAt(i), &ok);
+        if (!ok)
+        {
+            invocationDone(UpnpUndefinedFailure);
+            return;
+        }
+
+        outArgsData->setValueAt(i, value);
+    }
+
+    invocationDone(UpnpSuccess, &outArgs);
+}
+
 void HActionProxy::deleteReply()
 {
     if (m_reply)
@@ -89,10 +239,141 @@ void HActionProxy::deleteReply()
     }
 }
 
+void HActionProxy::closeLocalConnection()
+{
+    if (m_localHttp)
+    {
+        // the operation in progress, if any, is deleted along with the handler
+        m_localHttp->disconnect(this);
+        m_localHttp->deleteLater();
+        m_localHttp = 0;
+    }
+
+    if (m_localSocket)
+    {
+        m_localSocket->abort();
+        m_localSocket->deleteLater();
+        m_localSocket = 0;
+    }
+
+    m_localOp = 0;
+}
+
 void HActionProxy::locationsChanged()
 {
     m_locations = m_owner->parentService()->parentDevice()->locations(BaseUrl);
     m_iNextLocationToTry = 0;
+    m_failedLocalServer.clear();
+
+    if (!m_localOp)
+    {
+        // the local endpoint may have changed
+        closeLocalConnection();
+    }
+}
+
+bool HActionProxy::sendLocally(
+    const QString& localServer, const QUrl& url, const QString& soapAction,
+    const QByteArray& body)
+{
+    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+
+    if (m_localSocket && m_localSocket->state() != QTcpSocket::ConnectedState)
+    {
+        // the device host closed the connection after the previous invocation
+        closeLocalConnection();
+    }
+
+    if (!m_localSocket)
+    {
+        m_localSocket = new QTcpSocket(this);
+        if (!HHttpUtils::connectToLocalServer(*m_localSocket, localServer))
+        {
+            HLOG_WARN(QString(
+                "Cannot connect to the local endpoint [%1]. Using TCP instead.").arg(
+                    localServer));
+
+            m_failedLocalServer = localServer;
+            closeLocalConnection();
+            return false;
+        }
+
+        m_localHttp = new HHttpAsyncHandler(m_owner->loggingIdentifier(), this);
+
+        bool ok = connect(
+            m_localHttp, SIGNAL(msgIoComplete(HHttpAsyncOperation*)),
+            this, SLOT(localMsgIoComplete(HHttpAsyncOperation*)));
+
+        Q_ASSERT(ok); Q_UNUSED(ok)
+    }
+
+    HHttpRequestHeader reqHdr("POST", extractRequestPart(url));
+    reqHdr.setValue("SOAPACTION", soapAction);
+
+    HMessagingInfo* mi = new HMessagingInfo(*m_localSocket, true, 30000);
+    mi->setHostInfo(url);
+
+    m_localOp = m_localHttp->msgIo(mi,
+        HHttpMessageCreator::setupData(reqHdr, body, *mi, ContentType_TextXml));
+    if (!m_localOp)
+    {
+        // the messaging info was deleted along with the failed operation
+        closeLocalConnection();
+        return false;
+    }
+
+    return true;
+}
+
+void HActionProxy::localMsgIoComplete(HHttpAsyncOperation* op)
+{
+    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+
+    Q_ASSERT(op == m_localOp);
+    m_localOp = 0;
+
+    if (op->state() == HHttpAsyncOperation::Failed)
+    {
+        HLOG_WARN(QString(
+            "Action invocation through the local endpoint failed: [%1]").arg(
+                op->messagingInfo()->lastErrorDescription()));
+
+        delete op;
+
+        // the request may have reached the device, so the invocation is not
+        // retried. the next invocation reconnects.
+        closeLocalConnection();
+        invocationDone(UpnpUndefinedFailure);
+        return;
+    }
+
+    const HHttpResponseHeader* hdr =
+        static_cast<const HHttpResponseHeader*>(op->headerRead());
+
+    qint32 statusCode = hdr->statusCode();
+    QString reasonPhrase = hdr->reasonPhrase();
+    QByteArray data = op->dataRead();
+    bool keepAlive = op->messagingInfo()->keepAlive();
+
+    delete op;
+
+    if (!keepAlive)
+    {
+        closeLocalConnection();
+    }
+
+    if (statusCode != 200 && statusCode != 500)
+    {
+        // a SOAP fault is sent with the status code 500
+        HLOG_WARN(QString(
+            "Action invocation failed. Server responded: [%1, %2]").arg(
+                QString::number(statusCode), reasonPhrase));
+
+        invocationDone(statusCode);
+        return;
+    }
+
+    processResponse(data);
 }
 
 void HActionProxy::error(QNetworkReply::NetworkError err)
@@ -164,7 +445,41 @@ void HActionProxy::finished()
         return;
     }
 
-    QByteArray data = m_reply->readAll();
+    processResponse(m_reply->readAll());
+}
+
+bool HActionProxy::decodeResponse(const QByteArray& data)
+{
+    const HActionCodec* codec = m_owner->codec();
+    Q_ASSERT(codec);
+
+    QXmlStreamReader reader(data);
+    if (!readToBodyContent(reader) ||
+        reader.name() != m_owner->info().name() + "Response")
+    {
+        // most likely a fault
+        return false;
+    }
+
+    HActionArguments outArgs = m_owner->info().outputArguments();
+    if (!codec->readOutputArguments(reader, &outArgs) || reader.hasError())
+    {
+        return false;
+    }
+
+    invocationDone(UpnpSuccess, &outArgs);
+    return true;
+}
+
+void HActionProxy::processResponse(const QByteArray& data)
+{
+    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+
+    if (m_owner->codec() && decodeResponse(data))
+    {
+        return;
+    }
+
     QtSoapMessage response;
     if (!response.setContent(data))
     {
@@ -208,47 +523,58 @@ void HActionProxy::finished()
         return;
     }
 
+    // the copy shares the argument names with the action information and
+    // only the values are set here
     HActionArguments outArgs = m_owner->info().outputArguments();
-    HActionArguments::const_iterator ci = outArgs.constBegin();
-    for(; ci != outArgs.constEnd(); ++ci)
+    HActionArgumentsPrivate* outArgsData = HActionArgumentsPrivate::get(outArgs);
+    for(qint32 i = 0; i < outArgsData->size(); ++i)
     {
-        HActionArgument oarg = *ci;
-
-        const QtSoapType& arg = root[oarg.name()];
+        const QtSoapType& arg = root[outArgsData->nameAt(i)];
         if (!arg.isValid())
         {
             invocationDone(UpnpUndefinedFailure);
             return;
         }
 
-        HActionArgument userArg = outArgs.get(oarg.name());
-
-        userArg.setValue(
+        outArgsData->setValueAt(i,
             HUpnpDataTypes::convertToRightVariantType(
-                arg.value().toString(), oarg.dataType()));
+                arg.value().toString(),
+                outArgsData->stateVariableAt(i).dataType()));
     }
 
     invocationDone(UpnpSuccess, &outArgs);
 }
 
-bool HActionProxy::send()
+bool HActionProxy::encodeRequest(QByteArray* body) const
 {
-    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+    const HActionCodec* codec = m_owner->codec();
+    Q_ASSERT(codec);
 
-    Q_ASSERT(!invocationInProgress());
+    QString serviceType =
+        m_owner->parentService()->info().serviceType().toString();
 
-    if (m_locations.isEmpty())
+    body->clear();
+
+    QXmlStreamWriter writer(body);
+    writer.writeStartDocument();
+    writer.writeNamespace(SoapEnvelopeNs, "s");
+    writer.writeStartElement(SoapEnvelopeNs, "Envelope");
+    writer.writeAttribute(SoapEnvelopeNs, "encodingStyle", SoapEncodingNs);
+    writer.writeStartElement(SoapEnvelopeNs, "Body");
+    writer.writeNamespace(serviceType, "u");
+    writer.writeStartElement(serviceType, m_owner->info().name());
+
+    if (!codec->writeInputArguments(*m_inArgs, writer))
     {
-        m_locations = m_owner->parentService()->parentDevice()->locations(BaseUrl);
-        m_iNextLocationToTry = 0;
-        if (m_locations.isEmpty())
-        {
-            return false;
-        }
+        return false;
     }
 
-    Q_ASSERT(m_iNextLocationToTry < m_locations.size());
+    writer.writeEndDocument();
+    return true;
+}
 
+QByteArray HActionProxy::createSoapRequest() const
+{
     QtSoapNamespaces::instance().registerNamespace(
         "u", m_owner->parentService()->info().serviceType().toString());
 
@@ -258,20 +584,58 @@ bool HActionProxy::send()
             m_owner->info().name(),
             m_owner->parentService()->info().serviceType().toString()));
 
-    HActionArguments::const_iterator ci = m_inArgs.constBegin();
-    for(; ci != m_inArgs.constEnd(); ++ci)
+    const HActionArgumentsPrivate* inArgsData =
+        HActionArgumentsPrivate::get(*m_inArgs);
+
+    for(qint32 i = 0; i < inArgsData->size(); ++i)
     {
-        HActionArgument iarg = *ci;
-        if (!m_inArgs.contains(iarg.name()))
+        QtSoapType* soapArg =
+            new SoapType(
+                inArgsData->nameAt(i),
+                inArgsData->stateVariableAt(i).dataType(),
+                inArgsData->valueAt(i));
+
+        soapMsg.addMethodArgument(soapArg);
+    }
+
+    return soapMsg.toXmlString().toUtf8();
+}
+
+bool HActionProxy::send()
+{
+    HLOG2(H_AT, H_FUN, m_owner->loggingIdentifier());
+
+    Q_ASSERT(!invocationInProgress());
+    Q_ASSERT(m_inArgs);
+
+    if (m_localAction)
+    {
+        if (!m_invocationTimer.isValid())
+        {
+            m_invocationTimer.start();
+        }
+
+        m_localInvocationPending = true;
+        QMetaObject::invokeMethod(this, "invokeLocally", Qt::QueuedConnection);
+        return true;
+    }
+
+    if (m_locations.isEmpty())
+    {
+        m_locations = m_owner->parentService()->parentDevice()->locations(BaseUrl);
+        m_iNextLocationToTry = 0;
+        if (m_locations.isEmpty())
         {
-            invocationDone(UpnpInvalidArgs);
             return false;
         }
+    }
 
-        QtSoapType* soapArg =
-            new SoapType(iarg.name(), iarg.dataType(), iarg.value());
+    Q_ASSERT(m_iNextLocationToTry < m_locations.size());
 
-        soapMsg.addMethodArgument(soapArg);
+    QByteArray body;
+    if (!m_owner->codec() || !encodeRequest(&body))
+    {
+        body = createSoapRequest();
     }
 
     QNetworkRequest req;
@@ -294,7 +658,22 @@ bool HActionProxy::send()
 
     req.setUrl(url);
 
-    m_reply = m_nam.post(req, soapMsg.toXmlString().toUtf8());
+    if (!m_invocationTimer.isValid())
+    {
+        // a retry to another location is part of the same invocation
+        m_invocationTimer.start();
+    }
+
+    QString localServer = static_cast<HDefaultClientDevice*>(
+        m_owner->parentService()->parentDevice())->localServer();
+
+    if (!localServer.isEmpty() && localServer != m_failedLocalServer &&
+        sendLocally(localServer, url, soapActionHdrField, body))
+    {
+        return true;
+    }
+
+    m_reply = m_nam.post(req, body);
 
     bool ok = connect(
         m_reply, SIGNAL(error(QNetworkReply::NetworkError)),
@@ -309,15 +688,138 @@ bool HActionProxy::send()
 
 void HActionProxy::abort()
 {
+    m_invocationTimer.invalidate();
+    m_localInvocationPending = false;
+    if (m_localOp)
+    {
+        // the response would arrive in the middle of the next invocation
+        closeLocalConnection();
+    }
     deleteReply();
     m_owner->invokeCompleted(UpnpInvocationAborted, 0);
 }
 
+void HActionProxy::scheduleCachedResults()
+{
+    QMetaObject::invokeMethod(this, "cachedResultsReady", Qt::QueuedConnection);
+}
+
+/*******************************************************************************
+ * HActionResultCache
+ ******************************************************************************/
+HActionResultCache::HActionResultCache(const QString& actionName, qint32 timeout) :
+    m_entries(),
+    m_clock(),
+    m_timeout(timeout),
+    m_generation(0),
+    m_hits(HMetricsRegistry::counter(QString(
+        "hupnp_action_cache_hits_total{action=\"%1\"}").arg(
+            HMetricsRegistry::label(actionName)))),
+    m_misses(HMetricsRegistry::counter(QString(
+        "hupnp_action_cache_misses_total{action=\"%1\"}").arg(
+            HMetricsRegistry::label(actionName)))),
+    m_invalidations(HMetricsRegistry::counter(QString(
+        "hupnp_action_cache_invalidations_total{action=\"%1\"}").arg(
+            HMetricsRegistry::label(actionName))))
+{
+    Q_ASSERT(m_timeout > 0);
+    m_clock.start();
+}
+
+QByteArray HActionResultCache::key(const HActionArguments& inArgs)
+{
+    QByteArray retVal;
+    QDataStream stream(&retVal, QIODevice::WriteOnly);
+
+    const HActionArgumentsPrivate* inArgsData =
+        HActionArgumentsPrivate::get(inArgs);
+
+    for(qint32 i = 0; i < inArgsData->size(); ++i)
+    {
+        stream << inArgsData->valueAt(i);
+    }
+
+    return retVal;
+}
+
+void HActionResultCache::purge()
+{
+    qint64 now = m_clock.elapsed();
+
+    QHash<QByteArray, Entry>::iterator it = m_entries.begin();
+    while(it != m_entries.end())
+    {
+        if (it->m_expires <= now)
+        {
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool HActionResultCache::get(const QByteArray& key, HActionArguments* outArgs)
+{
+    QHash<QByteArray, Entry>::iterator it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        if (it->m_expires > m_clock.elapsed())
+        {
+            *outArgs = it->m_outArgs;
+            m_hits->add();
+            return true;
+        }
+
+        m_entries.erase(it);
+    }
+
+    m_misses->add();
+    return false;
+}
+
+void HActionResultCache::insert(
+    const QByteArray& key, const HActionArguments& outArgs, quint32 generation)
+{
+    if (generation != m_generation)
+    {
+        return;
+    }
+
+    if (m_entries.size() >= MaxCachedResults)
+    {
+        purge();
+        if (m_entries.size() >= MaxCachedResults)
+        {
+            m_entries.clear();
+        }
+    }
+
+    Entry entry;
+    entry.m_outArgs = outArgs;
+    entry.m_expires = m_clock.elapsed() + m_timeout;
+
+    m_entries.insert(key, entry);
+}
+
+void HActionResultCache::invalidate()
+{
+    ++m_generation;
+
+    if (!m_entries.isEmpty())
+    {
+        m_entries.clear();
+        m_invalidations->add();
+    }
+}
+
 /*******************************************************************************
  * HClientActionPrivate
  ******************************************************************************/
 HClientActionPrivate::HClientActionPrivate() :
-    m_loggingIdentifier(), q_ptr(0), m_info(), m_proxy(0), m_invocations()
+    m_loggingIdentifier(), q_ptr(0), m_info(), m_proxy(0), m_invocations(),
+    m_resultCache(), m_cachedInvocations(), m_codec(0)
 {
 }
 
@@ -325,15 +827,81 @@ HClientActionPrivate::~HClientActionPrivate()
 {
 }
 
-void HClientActionPrivate::invokeCompleted(int rc, const HActionArguments* outArgs)
+void HClientActionPrivate::invokeCompleted(int rc, HActionArguments* outArgs)
 {
     Q_ASSERT(!m_invocations.isEmpty());
 
     HInvocationInfo inv = m_invocations.dequeue();
 
     inv.m_invokeId.setReturnValue(rc);
-    inv.m_invokeId.setOutputArguments(outArgs ? *outArgs : HActionArguments());
 
+    if (m_resultCache && rc == UpnpSuccess)
+    {
+        m_resultCache->insert(
+            inv.m_cacheKey, outArgs ? *outArgs : HActionArguments(),
+            inv.m_cacheGeneration);
+    }
+
+    if (outArgs)
+    {
+        inv.m_invokeId.swapOutputArguments(*outArgs);
+    }
+
+    complete(inv);
+
+    if (!m_invocations.isEmpty() && !m_proxy->invocationInProgress())
+    {
+        const HInvocationInfo& inv = m_invocations.head();
+        m_proxy->setInputArgs(&inv.m_invokeId.inputArguments());
+        m_proxy->send();
+    }
+}
+
+void HClientActionPrivate::deliverCachedResults()
+{
+    // only the invocations queued at this point are delivered, since
+    // the callbacks may issue new invocations that hit the cache as well
+    qint32 count = m_cachedInvocations.size();
+    while(count-- > 0 && !m_cachedInvocations.isEmpty())
+    {
+        HInvocationInfo inv = m_cachedInvocations.dequeue();
+        inv.m_invokeId.setReturnValue(UpnpSuccess);
+        complete(inv);
+    }
+
+    if (!m_cachedInvocations.isEmpty())
+    {
+        m_proxy->scheduleCachedResults();
+    }
+}
+
+bool HClientActionPrivate::invokeFromCache(HInvocationInfo& inv)
+{
+    Q_ASSERT(m_resultCache);
+
+    inv.m_cacheKey = HActionResultCache::key(inv.m_invokeId.inputArguments());
+    inv.m_cacheGeneration = m_resultCache->generation();
+
+    HActionArguments outArgs;
+    if (!m_resultCache->get(inv.m_cacheKey, &outArgs))
+    {
+        return false;
+    }
+
+    inv.m_invokeId.swapOutputArguments(outArgs);
+
+    if (m_cachedInvocations.isEmpty())
+    {
+        m_proxy->scheduleCachedResults();
+    }
+
+    m_cachedInvocations.enqueue(inv);
+    return true;
+}
+
+void HClientActionPrivate::complete(HInvocationInfo& inv)
+{
+    qint32 rc = inv.m_invokeId.returnValue();
     if (inv.execArgs.execType() != HExecArgs::FireAndForget)
     {
         bool sendEvent = true;
@@ -351,13 +919,6 @@ void HClientActionPrivate::invokeCompleted(int rc, const HActionArguments* outAr
             emit q_ptr->invokeComplete(q_ptr, inv.m_invokeId);
         }
     }
-
-    if (!m_invocations.isEmpty() && !m_proxy->invocationInProgress())
-    {
-        const HInvocationInfo& inv = m_invocations.head();
-        m_proxy->setInputArgs(inv.m_inArgs);
-        m_proxy->send();
-    }
 }
 
 bool HClientActionPrivate::setInfo(const HActionInfo& info)
@@ -387,11 +948,21 @@ void HClientActionPrivate::abort(unsigned int id)
                 if (it->m_invokeId.id() == id)
                 {
                     m_invocations.erase(it);
-                    break;
+                    return;
                 }
             }
         }
     }
+
+    QQueue<HInvocationInfo>::iterator it = m_cachedInvocations.begin();
+    for(; it != m_cachedInvocations.end(); ++it)
+    {
+        if (it->m_invokeId.id() == id)
+        {
+            m_cachedInvocations.erase(it);
+            break;
+        }
+    }
 }
 
 /*******************************************************************************
@@ -412,6 +983,12 @@ void HClientActionOp_::setRunner(HClientActionPrivate* runner)
     h->m_runner = runner;
 }
 
+void HClientActionOp_::swapOutputArguments(HActionArguments& outArgs)
+{
+    H_D(HClientActionOp);
+    swap(h->m_outArgs, outArgs);
+}
+
 /*******************************************************************************
  * HClientAction
  ******************************************************************************/
@@ -441,6 +1018,22 @@ const HActionInfo& HClientAction::info() const
     return *h_ptr->m_info;
 }
 
+bool HClientAction::setCodec(const HActionCodec* codec)
+{
+    if (codec && !codec->isCompatible(info()))
+    {
+        return false;
+    }
+
+    h_ptr->m_codec = codec;
+    return true;
+}
+
+const HActionCodec* HClientAction::codec() const
+{
+    return h_ptr->m_codec;
+}
+
 HClientActionOp HClientAction::beginInvoke(
     const HActionArguments& inArgs, HExecArgs* execArgs)
 {
@@ -453,11 +1046,20 @@ HClientActionOp HClientAction::beginInvoke(
 {
     HInvocationInfo inv(inArgs, cb, execArgs ? *execArgs : HExecArgs());
     inv.m_invokeId.setRunner(h_ptr);
+
+    if (h_ptr->m_resultCache && h_ptr->invokeFromCache(inv))
+    {
+        inv.m_invokeId.setReturnValue(UpnpInvocationInProgress);
+        return inv.m_invokeId;
+    }
+
     h_ptr->m_invocations.enqueue(inv);
 
     if (!h_ptr->m_proxy->invocationInProgress())
     {
-        h_ptr->m_proxy->setInputArgs(inArgs);
+        // the arguments are not copied again, since the operation holds them
+        // for as long as the invocation is in the queue
+        h_ptr->m_proxy->setInputArgs(&inv.m_invokeId.inputArguments());
         if (!h_ptr->m_proxy->send())
         {
             return HClientActionOp(UpnpActionFailed, "Failed to dispatch action invocation");
@@ -483,11 +1085,35 @@ const QByteArray& HDefaultClientAction::loggingIdentifier() const
     return h_ptr->m_loggingIdentifier;
 }
 
-void HDefaultClientAction::invokeCompleted(int rc, const HActionArguments* outArgs)
+void HDefaultClientAction::invokeCompleted(int rc, HActionArguments* outArgs)
 {
     h_ptr->invokeCompleted(rc, outArgs);
 }
 
+void HDefaultClientAction::deliverCachedResults()
+{
+    h_ptr->deliverCachedResults();
+}
+
+void HDefaultClientAction::setResultTimeout(qint32 timeout)
+{
+    h_ptr->m_resultCache.reset(
+        timeout > 0 ? new HActionResultCache(info().name(), timeout) : 0);
+}
+
+void HDefaultClientAction::setLocalAction(HServerAction* action)
+{
+    h_ptr->m_proxy->setLocalAction(action);
+}
+
+void HDefaultClientAction::invalidateResults()
+{
+    if (h_ptr->m_resultCache)
+    {
+        h_ptr->m_resultCache->invalidate();
+    }
+}
+
 HDefaultClientService* HDefaultClientAction::parentService() const
 {
     return static_cast<HDefaultClientService*>(HClientAction::parentService());
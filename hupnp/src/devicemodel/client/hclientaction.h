@@ -112,6 +112,42 @@ public:
      */
     const HActionInfo& info() const;
 
+    /*!
+     * \brief Sets the codec used to encode the invocation requests and to
+     * decode the responses of the action.
+     *
+     * Without a codec the arguments are encoded and decoded by HUPnP
+     * according to the action information, which is done for every
+     * invocation. A codec knows the argument layout of the action in advance,
+     * which makes the invocations cheaper. The codecs are normally generated
+     * with \c hupnp_scpdgen.
+     *
+     * The codec is used for every subsequent invocation of the action,
+     * regardless of who issues it. A response the codec cannot read, such as
+     * a SOAP fault, is handled as if there was no codec.
+     *
+     * \param codec specifies the codec. The ownership of the codec is not
+     * transferred and the codec has to exist as long as it is set.
+     * A null pointer restores the default encoding.
+     *
+     * \return \e true if the codec was set. The codec is not set if it is
+     * not compatible with the action, as indicated by
+     * HActionCodec::isCompatible().
+     *
+     * \sa codec()
+     */
+    bool setCodec(const HActionCodec* codec);
+
+    /*!
+     * \brief Returns the codec of the action.
+     *
+     * \return The codec of the action, or a null pointer if the action
+     * does not have one.
+     *
+     * \sa setCodec()
+     */
+    const HActionCodec* codec() const;
+
     /*!
      * Schedules the action to be invoked.
      *
@@ -35,16 +35,21 @@
 #include "../hexecargs.h"
 #include "../hactionarguments.h"
 #include "../hactioninvoke_callback.h"
+#include "../server/hserveraction.h"
 #include "../../dataelements/hactioninfo.h"
 
 #include <QtCore/QUrl>
+#include <QtCore/QHash>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
 #include <QtCore/QPointer>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QElapsedTimer>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkAccessManager>
 
+class QTcpSocket;
+
 namespace Herqq
 {
 
@@ -52,6 +57,10 @@ namespace Upnp
 {
 
 class HInvocationInfo;
+class HHttpAsyncHandler;
+class HHttpAsyncOperation;
+struct HMetricCounter;
+struct HMetricHistogram;
 class HDefaultClientAction;
 
 //
@@ -78,18 +87,61 @@ private:
 
     HDefaultClientAction* m_owner;
 
-    HActionArguments m_inArgs;
+    const HActionArguments* m_inArgs;
+    // the input arguments of the invocation in progress. Not owned; these are
+    // stored in the HClientActionOp at the head of the invocation queue.
+
+    QElapsedTimer m_invocationTimer;
+    HMetricHistogram* m_durations;
+    // the duration of the invocation in progress and the histogram in
+    // which the durations of the invocations of this action are collected
+
+    QPointer<HServerAction> m_localAction;
+    // the server-side action when the device is hosted in this process and
+    // in this thread. the invocations are then run directly without
+    // serializing anything.
+
+    bool m_localInvocationPending;
+    // the local invocation is run from the event loop, as the result
+    // of any invocation is delivered asynchronously
+
+    QTcpSocket* m_localSocket;
+    HHttpAsyncHandler* m_localHttp;
+    HHttpAsyncOperation* m_localOp;
+    // the connection to the local endpoint of the device host running on
+    // the same host and the invocation in progress through it
+
+    QString m_failedLocalServer;
+    // the local endpoint that could not be connected to. it is not tried
+    // again until the device host advertises another one.
 
 private:
 
-    void invocationDone(qint32 rc, const HActionArguments* outArgs = 0);
+    void invocationDone(qint32 rc, HActionArguments* outArgs = 0);
     void deleteReply();
+    void processResponse(const QByteArray& data);
+
+    // the request and the response are handled with the codec of the action,
+    // if it has one. the generic SOAP handling is used when the codec
+    // cannot handle a message, such as a fault.
+    bool encodeRequest(QByteArray* body) const;
+    bool decodeResponse(const QByteArray& data);
+    QByteArray createSoapRequest() const;
+
+    bool sendLocally(
+        const QString& localServer, const QUrl& url,
+        const QString& soapAction, const QByteArray& body);
+
+    void closeLocalConnection();
 
 private slots:
 
     void locationsChanged();
     void error(QNetworkReply::NetworkError);
     void finished();
+    void cachedResultsReady();
+    void invokeLocally();
+    void localMsgIoComplete(HHttpAsyncOperation*);
 
 public:
 
@@ -99,12 +151,74 @@ public:
     bool send();
     void abort();
 
-    inline void setInputArgs(const HActionArguments& inArgs)
+    inline void setInputArgs(const HActionArguments* inArgs)
     {
         m_inArgs = inArgs;
     }
 
-    inline bool invocationInProgress() const { return m_reply; }
+    inline bool invocationInProgress() const
+    {
+        return m_reply || m_localInvocationPending || m_localOp;
+    }
+
+    inline void setLocalAction(HServerAction* action)
+    {
+        m_localAction = action;
+    }
+
+    // the results of the invocations served from the cache are delivered
+    // through the event loop just like the results of any other invocation
+    void scheduleCachedResults();
+};
+
+//
+// The results of the successful invocations of an idempotent action, keyed by
+// the values of the input arguments. An entry is valid until it expires or
+// until the cache is invalidated, whichever comes first.
+//
+class HActionResultCache
+{
+H_DISABLE_COPY(HActionResultCache)
+
+private:
+
+    struct Entry
+    {
+        HActionArguments m_outArgs;
+        qint64 m_expires;
+    };
+
+    QHash<QByteArray, Entry> m_entries;
+
+    QElapsedTimer m_clock;
+    const qint32 m_timeout;
+
+    quint32 m_generation;
+    // incremented on every invalidation. a result is stored only if the cache
+    // has not been invalidated after the invocation was issued, since the
+    // result may then predate the change.
+
+    HMetricCounter* m_hits;
+    HMetricCounter* m_misses;
+    HMetricCounter* m_invalidations;
+
+    void purge();
+
+public:
+
+    HActionResultCache(const QString& actionName, qint32 timeout);
+
+    static QByteArray key(const HActionArguments& inArgs);
+
+    bool get(const QByteArray& key, HActionArguments* outArgs);
+
+    void insert(
+        const QByteArray& key, const HActionArguments& outArgs,
+        quint32 generation);
+
+    void invalidate();
+
+    inline quint32 generation() const { return m_generation; }
 };
 
 //
@@ -117,9 +231,16 @@ Q_OBJECT
 H_DECLARE_PUBLIC(HClientAction)
 H_DISABLE_COPY(HClientActionPrivate)
 
+private:
+
+    void complete(HInvocationInfo&);
+
 public:
 
-    void invokeCompleted(int rc, const HActionArguments* outArgs = 0);
+    void invokeCompleted(int rc, HActionArguments* outArgs = 0);
+    void deliverCachedResults();
+
+    bool invokeFromCache(HInvocationInfo&);
 
 public:
 
@@ -131,6 +252,15 @@ public:
     HActionProxy* m_proxy;
     QQueue<HInvocationInfo> m_invocations;
 
+    QScopedPointer<HActionResultCache> m_resultCache;
+    // null unless the action is configured to be idempotent
+
+    QQueue<HInvocationInfo> m_cachedInvocations;
+    // the invocations served from the cache waiting for their delivery
+
+    const HActionCodec* m_codec;
+    // the codec of the action, if one has been set. not owned.
+
 public:
 
     HClientActionPrivate();
@@ -151,6 +281,9 @@ public:
     HClientActionOp_();
     HClientActionOp_(const HActionArguments& inArgs);
     void setRunner(HClientActionPrivate* runner);
+
+    // the arguments are swapped in to avoid copying them
+    void swapOutputArguments(HActionArguments& outArgs);
 };
 
 //
@@ -164,10 +297,18 @@ public:
     HActionInvokeCallback callback;
     HExecArgs execArgs;
 
-    HActionArguments m_inArgs;
     HClientActionOp_ m_invokeId;
+    // the input arguments are stored only in the operation
+
+    QByteArray m_cacheKey;
+    quint32 m_cacheGeneration;
+    // set only when the action caches its results
+
+    inline HInvocationInfo() :
+        callback(), execArgs(), m_invokeId(), m_cacheKey(), m_cacheGeneration(0)
+    {
+    }
 
-    inline HInvocationInfo() : callback(), execArgs(), m_inArgs(), m_invokeId() { }
     inline ~HInvocationInfo() { }
 
     inline HInvocationInfo(
@@ -176,8 +317,9 @@ public:
         const HExecArgs& eargs) :
             callback(cb),
             execArgs(eargs),
-            m_inArgs(inArgs),
-            m_invokeId(inArgs)
+            m_invokeId(inArgs),
+            m_cacheKey(),
+            m_cacheGeneration(0)
     {
     }
 };
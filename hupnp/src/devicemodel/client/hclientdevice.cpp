@@ -31,7 +31,6 @@
 #include "../../dataelements/hdeviceinfo.h"
 #include "../../dataelements/hserviceinfo.h"
 
-#include <QtCore/QTimer>
 #include <QtCore/QString>
 
 namespace Herqq
@@ -138,19 +137,13 @@ HDefaultClientDevice::HDefaultClientDevice(
     qint32 deviceTimeoutInSecs,
     HDefaultClientDevice* parentDev) :
         HClientDevice(info, parentDev),
-            m_timedout(false),
-            m_statusNotifier(new QTimer(this)),
+            m_deviceTimeoutInSecs(deviceTimeoutInSecs),
             m_deviceStatus(new HDeviceStatus()),
-            m_configId(0)
+            m_configId(0),
+            m_localServer()
 {
     h_ptr->m_deviceDescription = description;
     h_ptr->m_locations = locations;
-
-    m_statusNotifier->setInterval(deviceTimeoutInSecs * 1000);
-    bool ok = connect(
-        m_statusNotifier.data(), SIGNAL(timeout()), this, SLOT(timeout_()));
-
-    Q_ASSERT(ok); Q_UNUSED(ok)
 }
 
 void HDefaultClientDevice::setServices(
@@ -173,85 +166,6 @@ void HDefaultClientDevice::setEmbeddedDevices(
     }
 }
 
-quint32 HDefaultClientDevice::deviceTimeoutInSecs() const
-{
-    return m_statusNotifier->interval() / 1000;
-}
-
-void HDefaultClientDevice::timeout_()
-{
-    HLOG(H_AT, H_FUN);
-
-    m_timedout = true;
-    stopStatusNotifier(HDefaultClientDevice::ThisOnly);
-
-    emit statusTimeout(this);
-}
-
-void HDefaultClientDevice::startStatusNotifier(SearchCriteria searchCriteria)
-{
-    HLOG(H_AT, H_FUN);
-
-    m_statusNotifier->start();
-    if (searchCriteria & Services)
-    {
-        // TODO
-    }
-    if (searchCriteria & EmbeddedDevices)
-    {
-        foreach(HClientDevice* dc, h_ptr->m_embeddedDevices)
-        {
-            static_cast<HDefaultClientDevice*>(dc)->startStatusNotifier(searchCriteria);
-        }
-    }
-
-    m_timedout = false;
-}
-
-void HDefaultClientDevice::stopStatusNotifier(SearchCriteria searchCriteria)
-{
-    HLOG(H_AT, H_FUN);
-
-    m_statusNotifier->stop();
-    if (searchCriteria & Services)
-    {
-        // TODO
-    }
-    if (searchCriteria & EmbeddedDevices)
-    {
-        foreach(HClientDevice* dc, h_ptr->m_embeddedDevices)
-        {
-            static_cast<HDefaultClientDevice*>(dc)->stopStatusNotifier(searchCriteria);
-        }
-    }
-}
-
-bool HDefaultClientDevice::isTimedout(SearchCriteria searchCriteria) const
-{
-    if (m_timedout)
-    {
-        return true;
-    }
-
-    if (searchCriteria & Services)
-    {
-        // TODO
-    }
-
-    if (searchCriteria & EmbeddedDevices)
-    {
-        foreach(HClientDevice* dc, h_ptr->m_embeddedDevices)
-        {
-            if (static_cast<HDefaultClientDevice*>(dc)->isTimedout(searchCriteria))
-            {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
 namespace
 {
 bool shouldAdd(const HClientDevice* device, const QUrl& location)
@@ -302,10 +216,33 @@ void HDefaultClientDevice::clearLocations()
     emit locationsChanged();
 }
 
+void HDefaultClientDevice::setLocalServer(const QString& localServer)
+{
+    Q_ASSERT(!parentDevice());
+    if (m_localServer != localServer)
+    {
+        m_localServer = localServer;
+        emit locationsChanged();
+    }
+}
+
 HDefaultClientDevice* HDefaultClientDevice::rootDevice() const
 {
     return static_cast<HDefaultClientDevice*>(HClientDevice::rootDevice());
 }
 
+void HDefaultClientDevice::invalidateActionResults()
+{
+    foreach(HClientService* service, h_ptr->m_services)
+    {
+        static_cast<HDefaultClientService*>(service)->invalidateActionResults();
+    }
+
+    foreach(HClientDevice* device, h_ptr->m_embeddedDevices)
+    {
+        static_cast<HDefaultClientDevice*>(device)->invalidateActionResults();
+    }
+}
+
 }
 }
@@ -23,9 +23,11 @@
 #include "hclientservice_p.h"
 
 #include "hclientaction.h"
+#include "hdefault_clientaction_p.h"
 #include "hdefault_clientdevice_p.h"
 #include "hdefault_clientservice_p.h"
 #include "hdefault_clientstatevariable_p.h"
+#include "../server/hserverservice.h"
 
 #include "../../dataelements/hactioninfo.h"
 
@@ -39,7 +41,8 @@ namespace Upnp
  * HClientServicePrivate
  ******************************************************************************/
 HClientServicePrivate::HClientServicePrivate() :
-    m_stateVariablesConst()
+    m_stateVariablesConst(), m_localService(),
+    m_modelLoaded(true)
 {
 }
 
@@ -61,8 +64,33 @@ bool HClientServicePrivate::addStateVariable(HDefaultClientStateVariable* sv)
 HClientServicePrivate::ReturnValue HClientServicePrivate::updateVariables(
     const QList<QPair<QString, QString> >& variables, bool sendEvent)
 {
-    ReturnValue rv =
-        HServicePrivate<HClientService, HClientAction, HDefaultClientStateVariable>::updateVariables(variables);
+    return variablesUpdated(
+        HServicePrivate<HClientService, HClientAction, HDefaultClientStateVariable>::updateVariables(variables),
+        sendEvent);
+}
+
+HClientServicePrivate::ReturnValue HClientServicePrivate::updateVariables(
+    const QList<QPair<QString, QVariant> >& variables, bool sendEvent)
+{
+    return variablesUpdated(
+        HServicePrivate<HClientService, HClientAction, HDefaultClientStateVariable>::updateVariables(variables),
+        sendEvent);
+}
+
+HClientServicePrivate::ReturnValue HClientServicePrivate::variablesUpdated(
+    ReturnValue rv, bool sendEvent)
+{
+    if (rv == Updated)
+    {
+        // Not only the results depending on the changed variables are
+        // invalidated, since a service may report the changes of variables
+        // that are not evented through another variable, such as the
+        // LastChange of the AV services.
+        foreach(HClientAction* action, m_actions)
+        {
+            static_cast<HDefaultClientAction*>(action)->invalidateResults();
+        }
+    }
 
     if (rv == Updated && sendEvent && m_evented)
     {
@@ -134,6 +162,11 @@ QVariant HClientService::value(const QString& stateVarName, bool* ok) const
     return h_ptr->value(stateVarName, ok);
 }
 
+bool HClientService::isModelLoaded() const
+{
+    return h_ptr->m_modelLoaded;
+}
+
 /*******************************************************************************
  * HDefaultClientService
  ******************************************************************************/
@@ -166,6 +199,43 @@ bool HDefaultClientService::updateVariables(
     return h_ptr->updateVariables(variables, sendEvent) != HClientServicePrivate::Failed;
 }
 
+bool HDefaultClientService::updateVariables(
+    const QList<QPair<QString, QVariant> >& variables, bool sendEvent)
+{
+    return h_ptr->updateVariables(variables, sendEvent) != HClientServicePrivate::Failed;
+}
+
+void HDefaultClientService::setModelLoaded(bool loaded)
+{
+    h_ptr->m_modelLoaded = loaded;
+}
+
+void HDefaultClientService::invalidateActionResults()
+{
+    // the actions are accessed directly, since an invalidation should
+    // not load the model of the service
+    foreach(HClientAction* action, h_ptr->m_actions)
+    {
+        static_cast<HDefaultClientAction*>(action)->invalidateResults();
+    }
+}
+
+void HDefaultClientService::setLocalService(HServerService* service)
+{
+    h_ptr->m_localService = service;
+
+    foreach(HClientAction* action, h_ptr->m_actions)
+    {
+        static_cast<HDefaultClientAction*>(action)->setLocalAction(
+            service ? service->actions().value(action->info().name()) : 0);
+    }
+}
+
+HServerService* HDefaultClientService::localService() const
+{
+    return h_ptr->m_localService;
+}
+
 HDefaultClientDevice* HDefaultClientService::parentDevice() const
 {
     return static_cast<HDefaultClientDevice*>(HClientService::parentDevice());
@@ -69,6 +69,15 @@ class HClientServicePrivate;
  * to the stateChanged() signal. You do not need to worry about UPnP eventing at all,
  * since HUPnP handles that for you.
  *
+ * When the HControlPoint that created the service builds the service models
+ * lazily, see HControlPointConfiguration::setLazyServiceModels(), the
+ * service description is not retrieved until the model is requested with
+ * HControlPoint::prefetchServiceModel(). Until then isModelLoaded() returns
+ * \e false, description() returns an empty string, actions() and
+ * stateVariables() return empty collections and isEvented() returns
+ * \e false. HControlPoint::serviceModelLoaded() is emitted once the model
+ * is available.
+ *
  * \headerfile hclientservice.h HClientService
  *
  * \ingroup hupnp_devicemodel
@@ -184,6 +193,18 @@ public:
      */
     QVariant value(const QString& stateVarName, bool* ok = 0) const;
 
+    /*!
+     * \brief Indicates whether the service description has been retrieved
+     * and the actions and the state variables of the service created.
+     *
+     * \return \e true unless the service model is built lazily and it
+     * has not been built yet, or building it has failed.
+     *
+     * \sa HControlPointConfiguration::setLazyServiceModels(),
+     * HControlPoint::prefetchServiceModel()
+     */
+    bool isModelLoaded() const;
+
 public Q_SLOTS:
 
     /*!
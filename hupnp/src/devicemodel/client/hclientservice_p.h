@@ -32,6 +32,8 @@
 
 #include "../hservice_p.h"
 
+#include <QtCore/QPointer>
+
 namespace Herqq
 {
 
@@ -53,6 +55,17 @@ public: // attributes
 
     QHash<QString, const HClientStateVariable*> m_stateVariablesConst;
 
+    QPointer<HServerService> m_localService;
+    // the server-side service when the device is hosted in this process
+
+    bool m_modelLoaded;
+    // false until the lazily built model of the service has been loaded.
+    // the model is loaded only by the control point, never by the getters
+
+private:
+
+    ReturnValue variablesUpdated(ReturnValue, bool sendEvent);
+
 public: // methods
 
     HClientServicePrivate();
@@ -62,6 +75,9 @@ public: // methods
 
     ReturnValue updateVariables(
         const QList<QPair<QString, QString> >& variables, bool sendEvent);
+
+    ReturnValue updateVariables(
+        const QList<QPair<QString, QVariant> >& variables, bool sendEvent);
 };
 
 }
@@ -57,7 +57,16 @@ public:
 
     const QByteArray& loggingIdentifier() const;
 
-    void invokeCompleted(int rc, const HActionArguments* outArgs = 0);
+    void invokeCompleted(int rc, HActionArguments* outArgs = 0);
+    void deliverCachedResults();
+
+    // enables caching the results of the action, which must be idempotent
+    void setResultTimeout(qint32 timeout);
+    void invalidateResults();
+
+    // binds the action to the specified server-side action, which has to
+    // live in the same thread. null restores invoking over the network.
+    void setLocalAction(HServerAction*);
 
     HDefaultClientService* parentService() const;
 };
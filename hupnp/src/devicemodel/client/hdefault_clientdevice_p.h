@@ -33,7 +33,8 @@
 #include <HUpnpCore/HClientDevice>
 #include <HUpnpCore/HDeviceStatus>
 
-#include <QtCore/QTimer>
+#include <QtCore/QString>
+#include <QtCore/QScopedPointer>
 
 namespace Herqq
 {
@@ -54,14 +55,13 @@ H_DISABLE_COPY(HDefaultClientDevice)
 
 private:
 
-    bool m_timedout;
-    QScopedPointer<QTimer> m_statusNotifier;
+    qint32 m_deviceTimeoutInSecs;
     QScopedPointer<HDeviceStatus> m_deviceStatus;
     qint32 m_configId;
 
-private Q_SLOTS:
-
-    void timeout_();
+    QString m_localServer;
+    // the local endpoint of the device host, if the device host runs on
+    // the same host. stored only in the root device.
 
 public:
 
@@ -78,15 +78,9 @@ public:
 
 public:
 
-    enum SearchCriteria
-    {
-        ThisOnly = 0,
-        EmbeddedDevices = 1,
-        Services = 2,
-        All = 3
-    };
-
-    quint32 deviceTimeoutInSecs() const;
+    // The expiration of the device is tracked by the control point
+    // that owns the device.
+    inline quint32 deviceTimeoutInSecs() const { return m_deviceTimeoutInSecs; }
 
     inline HDeviceStatus* deviceStatus() const
     {
@@ -94,18 +88,28 @@ public:
         return static_cast<HDefaultClientDevice*>(rootDevice())->deviceStatus();
     }
 
-    void startStatusNotifier(SearchCriteria searchCriteria);
-    void stopStatusNotifier(SearchCriteria searchCriteria);
-
     bool addLocation(const QUrl& location);
     void addLocations(const QList<QUrl>& locations);
     void clearLocations();
     HDefaultClientDevice* rootDevice() const;
-    bool isTimedout(SearchCriteria searchCriteria) const;
+
+    // invalidates the cached action results of this device and
+    // its embedded devices
+    void invalidateActionResults();
+
+    inline QString localServer() const
+    {
+        if (!parentDevice()) { return m_localServer; }
+        return static_cast<HDefaultClientDevice*>(rootDevice())->localServer();
+    }
+
+    // the action invocations and the event subscriptions to the device tree
+    // are sent through the specified local endpoint of the device host
+    // instead of TCP. an empty string reverts to TCP.
+    void setLocalServer(const QString& localServer);
 
 Q_SIGNALS:
 
-    void statusTimeout(HDefaultClientDevice* source);
     void locationsChanged();
 
 };
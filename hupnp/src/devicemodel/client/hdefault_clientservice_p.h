@@ -58,9 +58,23 @@ public:
     void addStateVariable(HDefaultClientStateVariable*);
     void setDescription(const QString& description);
 
+    // a service whose model is not loaded has no actions or state variables
+    // until the control point has loaded its description
+    void setModelLoaded(bool loaded);
+
+    void invalidateActionResults();
+
     bool updateVariables(
         const QList<QPair<QString, QString> >& variables, bool sendEvent);
 
+    bool updateVariables(
+        const QList<QPair<QString, QVariant> >& variables, bool sendEvent);
+
+    // binds the service and its actions to the specified server-side
+    // service, which has to live in the same thread. null unbinds them.
+    void setLocalService(HServerService*);
+    HServerService* localService() const;
+
     HDefaultClientDevice* parentDevice() const;
 };
 
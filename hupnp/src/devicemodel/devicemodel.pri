@@ -6,6 +6,7 @@ HEADERS += \
     $$SRC_LOC/devicemodel/hactioninvoke.h \
     $$SRC_LOC/devicemodel/hactioninvoke_callback.h \
     $$SRC_LOC/devicemodel/hactionarguments.h \
+    $$SRC_LOC/devicemodel/hactioncodec.h \
     $$SRC_LOC/devicemodel/hactionarguments_p.h \
     $$SRC_LOC/devicemodel/hdevicestatus.h \
     $$SRC_LOC/devicemodel/hservice_p.h \
@@ -42,6 +43,7 @@ HEADERS += \
     $$SRC_LOC/devicemodel/server/hserverservice.h \
     $$SRC_LOC/devicemodel/server/hserverservice_p.h \
     $$SRC_LOC/devicemodel/server/hserverstatevariable.h \
+    $$SRC_LOC/devicemodel/server/hserverstatetransaction.h \
     $$SRC_LOC/devicemodel/server/hdevicemodelcreator.h \
     $$SRC_LOC/devicemodel/server/hdefault_serverdevice_p.h \
     $$SRC_LOC/devicemodel/server/hdefault_serveraction_p.h \
@@ -62,6 +64,7 @@ SOURCES += \
     $$SRC_LOC/devicemodel/hasyncop.cpp \
     $$SRC_LOC/devicemodel/hexecargs.cpp \
     $$SRC_LOC/devicemodel/hactionarguments.cpp \
+    $$SRC_LOC/devicemodel/hactioncodec.cpp \
     $$SRC_LOC/devicemodel/hdevices_setupdata.cpp \
     $$SRC_LOC/devicemodel/hservices_setupdata.cpp \
     $$SRC_LOC/devicemodel/hstatevariable_event.cpp \
@@ -80,4 +83,5 @@ SOURCES += \
     $$SRC_LOC/devicemodel/server/hserverdevice.cpp \
     $$SRC_LOC/devicemodel/server/hserverservice.cpp \
     $$SRC_LOC/devicemodel/server/hserverstatevariable.cpp \
+    $$SRC_LOC/devicemodel/server/hserverstatetransaction.cpp \
     $$SRC_LOC/devicemodel/server/hdevicemodelcreator.cpp
@@ -179,24 +179,162 @@ bool operator!=(const HActionArgument& arg1, const HActionArgument& arg2)
     return !(arg1 == arg2);
 }
 
+/*******************************************************************************
+ * HActionArgumentsSchema
+ *******************************************************************************/
+void HActionArgumentsSchema::remove(qint32 index)
+{
+    m_names.remove(index);
+    m_stateVariables.remove(index);
+
+    m_indexes.clear();
+    m_indexes.reserve(m_names.size());
+
+    for(qint32 i = 0; i < m_names.size(); ++i)
+    {
+        m_indexes.insert(m_names.at(i), i);
+    }
+}
+
 /*******************************************************************************
  * HActionArgumentsPrivate
  *******************************************************************************/
-HActionArgumentsPrivate::HActionArgumentsPrivate()
+HActionArgumentsPrivate::HActionArgumentsPrivate() :
+    m_schema(new HActionArgumentsSchema()), m_values(), m_arguments(),
+    m_argumentsCreated(false)
 {
 }
 
-HActionArgumentsPrivate::HActionArgumentsPrivate(
-    const QVector<HActionArgument>& args)
+bool HActionArgumentsPrivate::setValueAt(qint32 index, const QVariant& value)
 {
-    QVector<HActionArgument>::const_iterator ci = args.constBegin();
+    if (m_argumentsCreated)
+    {
+        return m_arguments[index].setValue(value);
+    }
+
+    QVariant convertedValue;
+    if (stateVariableAt(index).isValidValue(value, &convertedValue))
+    {
+        m_values[index] = convertedValue;
+        return true;
+    }
+
+    return false;
+}
 
-    for (; ci != args.constEnd(); ++ci)
+void HActionArgumentsPrivate::storeValueAt(qint32 index, const QVariant& value)
+{
+    if (m_argumentsCreated)
+    {
+        m_arguments[index].h_ptr->m_value = value;
+    }
+    else
     {
-        append(*ci);
+        m_values[index] = value;
     }
 }
 
+void HActionArgumentsPrivate::append(const HActionArgument& arg)
+{
+    Q_ASSERT_X(arg.isValid(), H_AT, "A provided action argument has to be valid");
+    m_schema->append(arg.name(), arg.relatedStateVariable());
+
+    if (m_argumentsCreated)
+    {
+        HActionArgument copy = arg;
+        copy.detach();
+        m_arguments.push_back(copy);
+    }
+    else
+    {
+        m_values.push_back(arg.value());
+    }
+}
+
+void HActionArgumentsPrivate::remove(qint32 index)
+{
+    m_schema->remove(index);
+
+    if (m_argumentsCreated)
+    {
+        m_arguments.remove(index);
+    }
+    else
+    {
+        m_values.remove(index);
+    }
+}
+
+void HActionArgumentsPrivate::clear()
+{
+    m_schema = new HActionArgumentsSchema();
+    m_values.clear();
+    m_arguments.clear();
+    m_argumentsCreated = false;
+}
+
+void HActionArgumentsPrivate::createArguments() const
+{
+    if (m_argumentsCreated)
+    {
+        return;
+    }
+
+    qint32 count = size();
+    m_arguments.reserve(count);
+
+    for(qint32 i = 0; i < count; ++i)
+    {
+        HActionArgument arg;
+        arg.h_ptr->m_name = nameAt(i);
+        arg.h_ptr->m_stateVariableInfo = stateVariableAt(i);
+        arg.h_ptr->m_value = m_values.at(i);
+        m_arguments.push_back(arg);
+    }
+
+    m_values.clear();
+    m_argumentsCreated = true;
+}
+
+HActionArgumentsPrivate* HActionArgumentsPrivate::create(
+    const QVector<HActionArgument>& source)
+{
+    HActionArgumentsPrivate* contents = new HActionArgumentsPrivate();
+    contents->m_values.reserve(source.size());
+
+    QVector<HActionArgument>::const_iterator ci = source.constBegin();
+    for(; ci != source.constEnd(); ++ci)
+    {
+        contents->append(*ci);
+    }
+
+    return contents;
+}
+
+HActionArgumentsPrivate* HActionArgumentsPrivate::copy(
+    const HActionArgumentsPrivate& source)
+{
+    HActionArgumentsPrivate* contents = new HActionArgumentsPrivate();
+    contents->m_schema = source.m_schema;
+
+    if (source.m_argumentsCreated)
+    {
+        qint32 count = source.size();
+        contents->m_values.reserve(count);
+
+        for(qint32 i = 0; i < count; ++i)
+        {
+            contents->m_values.push_back(source.m_arguments.at(i).value());
+        }
+    }
+    else
+    {
+        contents->m_values = source.m_values;
+    }
+
+    return contents;
+}
+
 /*******************************************************************************
  * HActionArguments
  *******************************************************************************/
@@ -206,7 +344,7 @@ HActionArguments::HActionArguments() :
 }
 
 HActionArguments::HActionArguments(const QVector<HActionArgument>& args) :
-    h_ptr(HActionArgumentsPrivate::copy(args))
+    h_ptr(HActionArgumentsPrivate::create(args))
 {
 }
 
@@ -216,7 +354,7 @@ HActionArguments::~HActionArguments()
 }
 
 HActionArguments::HActionArguments(const HActionArguments& other) :
-    h_ptr(HActionArgumentsPrivate::copy(other))
+    h_ptr(HActionArgumentsPrivate::copy(*other.h_ptr))
 {
     Q_ASSERT(&other != this);
 }
@@ -224,104 +362,106 @@ HActionArguments::HActionArguments(const HActionArguments& other) :
 HActionArguments& HActionArguments::operator=(const HActionArguments& other)
 {
     Q_ASSERT(&other != this);
+    HActionArgumentsPrivate* newContents =
+        HActionArgumentsPrivate::copy(*other.h_ptr);
+
     delete h_ptr;
-    h_ptr = HActionArgumentsPrivate::copy(other);
+    h_ptr = newContents;
     return *this;
 }
 
 bool HActionArguments::contains(const QString& argumentName) const
 {
-    return h_ptr->m_arguments.contains(argumentName);
+    return h_ptr->indexOf(argumentName) >= 0;
 }
 
 HActionArgument HActionArguments::get(qint32 index) const
 {
-    return h_ptr->m_argumentsOrdered.at(index);
+    h_ptr->createArguments();
+    return h_ptr->m_arguments.at(index);
 }
 
 HActionArgument HActionArguments::get(const QString& argumentName) const
 {
-    return h_ptr->m_arguments.value(argumentName);
+    qint32 index = h_ptr->indexOf(argumentName);
+    return index >= 0 ? get(index) : HActionArgument();
 }
 
 HActionArguments::const_iterator HActionArguments::constBegin() const
 {
-    return h_ptr->m_argumentsOrdered.constBegin();
+    h_ptr->createArguments();
+    return h_ptr->m_arguments.constBegin();
 }
 
 HActionArguments::const_iterator HActionArguments::constEnd() const
 {
-    return h_ptr->m_argumentsOrdered.constEnd();
+    h_ptr->createArguments();
+    return h_ptr->m_arguments.constEnd();
 }
 
 HActionArguments::iterator HActionArguments::begin()
 {
-    return h_ptr->m_argumentsOrdered.begin();
+    h_ptr->createArguments();
+    return h_ptr->m_arguments.begin();
 }
 
 HActionArguments::iterator HActionArguments::end()
 {
-    return h_ptr->m_argumentsOrdered.end();
+    h_ptr->createArguments();
+    return h_ptr->m_arguments.end();
 }
 
 HActionArguments::const_iterator HActionArguments::begin() const
 {
-    return h_ptr->m_argumentsOrdered.begin();
+    return constBegin();
 }
 
 HActionArguments::const_iterator HActionArguments::end() const
 {
-    return h_ptr->m_argumentsOrdered.end();
+    return constEnd();
 }
 
 qint32 HActionArguments::size() const
 {
-    return h_ptr->m_argumentsOrdered.size();
+    return h_ptr->size();
 }
 
 HActionArgument HActionArguments::operator[](qint32 index) const
 {
-    return h_ptr->m_argumentsOrdered.at(index);
+    return get(index);
 }
 
 HActionArgument HActionArguments::operator[](const QString& argName) const
 {
-    return h_ptr->m_arguments.value(argName);
+    return get(argName);
 }
 
 QStringList HActionArguments::names() const
 {
-    return h_ptr->m_arguments.keys();
+    return h_ptr->schema().m_indexes.keys();
 }
 
 bool HActionArguments::isEmpty() const
 {
-    return h_ptr->m_argumentsOrdered.isEmpty();
+    return h_ptr->size() == 0;
 }
 
 void HActionArguments::clear()
 {
-    h_ptr->m_arguments.clear();
-    h_ptr->m_argumentsOrdered.clear();
+    h_ptr->clear();
 }
 
 bool HActionArguments::remove(const QString& name)
 {
-    if (h_ptr->m_arguments.contains(name))
+    qint32 index = h_ptr->indexOf(name);
+    if (index < 0)
     {
-        h_ptr->m_arguments.remove(name);
-        HActionArguments::iterator it = h_ptr->m_argumentsOrdered.begin();
-        for(; it != h_ptr->m_argumentsOrdered.end(); ++it)
-        {
-            if (it->name() == name)
-            {
-                h_ptr->m_argumentsOrdered.erase(it);
-                return true;
-            }
-        }
+        return false;
     }
 
-    return false;
+    h_ptr->remove(index);
+
+    return true;
 }
 
 bool HActionArguments::append(const HActionArgument& arg)
@@ -330,13 +470,12 @@ bool HActionArguments::append(const HActionArgument& arg)
     {
         return false;
     }
-    else if (h_ptr->m_arguments.contains(arg.name()))
+    else if (h_ptr->indexOf(arg.name()) >= 0)
     {
         return false;
     }
 
-    h_ptr->m_arguments.insert(arg.name(), arg);
-    h_ptr->m_argumentsOrdered.append(arg);
+    h_ptr->append(arg);
 
     return true;
 }
@@ -345,9 +484,10 @@ QVariant HActionArguments::value(const QString& name, bool* ok) const
 {
     QVariant retVal;
 
-    if (h_ptr->m_arguments.contains(name))
+    qint32 index = h_ptr->indexOf(name);
+    if (index >= 0)
     {
-        retVal = h_ptr->m_arguments.value(name).value();
+        retVal = h_ptr->valueAt(index);
         if (ok) { *ok = true; }
     }
     else
@@ -360,22 +500,39 @@ QVariant HActionArguments::value(const QString& name, bool* ok) const
 
 bool HActionArguments::setValue(const QString& name, const QVariant& value)
 {
-    if (h_ptr->m_arguments.contains(name))
+    qint32 index = h_ptr->indexOf(name);
+    if (index >= 0)
     {
-        return h_ptr->m_arguments[name].setValue(value);
+        return h_ptr->setValueAt(index, value);
     }
 
     return false;
 }
 
+QVariant HActionArguments::valueAt(qint32 index) const
+{
+    Q_ASSERT_X(index >= 0 && index < h_ptr->size(), H_AT, "Invalid index");
+    return h_ptr->valueAt(index);
+}
+
+bool HActionArguments::setValueAt(qint32 index, const QVariant& value)
+{
+    Q_ASSERT_X(index >= 0 && index < h_ptr->size(), H_AT, "Invalid index");
+    return h_ptr->setValueAt(index, value);
+}
+
 QString HActionArguments::toString() const
 {
     QString retVal;
 
-    HActionArguments::const_iterator ci = constBegin();
-    for (; ci != constEnd(); ++ci)
+    for(qint32 i = 0; i < h_ptr->size(); ++i)
     {
-        retVal.append(ci->toString()).append("\n");
+        QVariant value = h_ptr->valueAt(i);
+
+        retVal.append(QString("%1: %2").arg(
+            h_ptr->nameAt(i),
+            h_ptr->stateVariableAt(i).dataType() == HUpnpDataTypes::uri ?
+                value.toUrl().toString() : value.toString())).append("\n");
     }
 
     return retVal;
@@ -388,17 +545,23 @@ void swap(HActionArguments& a, HActionArguments& b)
 
 bool operator==(const HActionArguments& arg1, const HActionArguments& arg2)
 {
-    if (arg1.h_ptr->m_argumentsOrdered.size() !=
-        arg2.h_ptr->m_argumentsOrdered.size())
+    if (arg1.h_ptr->size() != arg2.h_ptr->size())
     {
         return false;
     }
 
-    qint32 size = arg1.h_ptr->m_argumentsOrdered.size();
+    bool sameSchema = arg1.h_ptr->m_schema == arg2.h_ptr->m_schema;
+
+    qint32 size = arg1.h_ptr->size();
     for(qint32 i = 0; i < size; ++i)
     {
-        if (arg1.h_ptr->m_argumentsOrdered.at(i) !=
-            arg2.h_ptr->m_argumentsOrdered.at(i))
+        if (!sameSchema &&
+            (arg1.h_ptr->nameAt(i) != arg2.h_ptr->nameAt(i) ||
+             arg1.h_ptr->stateVariableAt(i) != arg2.h_ptr->stateVariableAt(i)))
+        {
+            return false;
+        }
+        else if (arg1.h_ptr->valueAt(i) != arg2.h_ptr->valueAt(i))
         {
             return false;
         }
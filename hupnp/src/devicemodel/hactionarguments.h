@@ -115,6 +115,7 @@ class HActionArgumentPrivate;
  */
 class H_UPNP_CORE_EXPORT HActionArgument
 {
+friend class HActionArgumentsPrivate;
 friend H_UPNP_CORE_EXPORT bool operator==(
     const HActionArgument&, const HActionArgument&);
 
@@ -330,6 +331,7 @@ class HActionArgumentsPrivate;
  */
 class H_UPNP_CORE_EXPORT HActionArguments
 {
+friend class HActionArgumentsPrivate;
 friend H_UPNP_CORE_EXPORT bool operator==(
     const HActionArguments&, const HActionArguments&);
 
@@ -591,6 +593,42 @@ public:
      */
     bool setValue(const QString& name, const QVariant& value);
 
+    /*!
+     * \brief Returns the value of the argument at the specified index.
+     *
+     * This is the positional counterpart of value(). It neither looks up
+     * the argument by its name nor creates the HActionArgument objects, which
+     * makes it suitable for code that knows the argument layout of an action,
+     * such as the code generated by \c hupnp_scpdgen.
+     *
+     * \param index specifies the index of the argument. The
+     * index has to be valid position in the container, i.e. it must be
+     * 0 <= i < size().
+     *
+     * \return The value of the argument at the specified index.
+     *
+     * \sa setValueAt(), value()
+     */
+    QVariant valueAt(qint32 index) const;
+
+    /*!
+     * Attempts to set the value of the argument at the specified index.
+     *
+     * This is the positional counterpart of setValue(). The value is
+     * validated the same way.
+     *
+     * \param index specifies the index of the argument. The
+     * index has to be valid position in the container, i.e. it must be
+     * 0 <= i < size().
+     *
+     * \param value specifies the value of the argument.
+     *
+     * \return \e true in case the value of the argument was changed.
+     *
+     * \sa valueAt(), setValue()
+     */
+    bool setValueAt(qint32 index, const QVariant& value);
+
     /*!
      * \brief Returns a string representation of the object.
      *
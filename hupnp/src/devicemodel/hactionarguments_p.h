@@ -24,8 +24,11 @@
 
 #include "hactionarguments.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QVector>
 #include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QSharedData>
 
 //
 // !! Warning !!
@@ -41,45 +44,118 @@ namespace Herqq
 namespace Upnp
 {
 
+//
+// The names and the related state variables of a set of arguments in the order
+// they were specified and the positions of the arguments keyed by their names.
+// A schema is shared by every copy of a set of arguments, such as the arguments
+// of every invocation of an action, and it is copied only when an argument
+// is added or removed.
+//
+class HActionArgumentsSchema :
+    public QSharedData
+{
+public:
+
+    QVector<QString> m_names;
+    QVector<HStateVariableInfo> m_stateVariables;
+    QHash<QString, qint32> m_indexes;
+
+    inline void append(const QString& name, const HStateVariableInfo& info)
+    {
+        m_indexes.insert(name, m_names.size());
+        m_names.push_back(name);
+        m_stateVariables.push_back(info);
+    }
+
+    void remove(qint32 index);
+};
+
 //
 //
 //
 class HActionArgumentsPrivate
 {
+H_DISABLE_COPY(HActionArgumentsPrivate)
+
 public: // attributes
 
-    QVector<HActionArgument> m_argumentsOrdered;
+    QSharedDataPointer<HActionArgumentsSchema> m_schema;
     // UDA 1.1 mandates that action arguments are always transmitted in the order
     // they were specified in the service description.
 
-    QHash<QString, HActionArgument> m_arguments;
-    // for fast name-based lookups
+    mutable QVector<QVariant> m_values;
+    // the values of the arguments in the order of the schema. these are
+    // the only data a copy of the arguments does not share with the source
+
+    mutable QVector<HActionArgument> m_arguments;
+    mutable bool m_argumentsCreated;
+    // the HActionArgument objects are created only when the arguments are
+    // accessed through the iterators, get() or operator[], since they share their
+    // data with the caller. from then on the objects hold the values
+    // and m_values is empty
 
 public: // functions
 
     HActionArgumentsPrivate();
-    explicit HActionArgumentsPrivate(const QVector<HActionArgument>& args);
 
-    inline void append(const HActionArgument& arg)
+    inline const HActionArgumentsSchema& schema() const
+    {
+        return *m_schema.constData();
+    }
+
+    inline qint32 size() const
+    {
+        return schema().m_names.size();
+    }
+
+    inline qint32 indexOf(const QString& name) const
     {
-        Q_ASSERT_X(arg.isValid(), H_AT, "A provided action argument has to be valid");
-        m_argumentsOrdered.push_back(arg);
-        m_arguments[arg.name()] = arg;
+        return schema().m_indexes.value(name, -1);
     }
 
-    template<typename T>
-    static HActionArgumentsPrivate* copy(const T& source)
+    inline const QString& nameAt(qint32 index) const
     {
-        HActionArgumentsPrivate* contents = new HActionArgumentsPrivate();
+        return schema().m_names.at(index);
+    }
+
+    inline const HStateVariableInfo& stateVariableAt(qint32 index) const
+    {
+        return schema().m_stateVariables.at(index);
+    }
+
+    inline QVariant valueAt(qint32 index) const
+    {
+        return m_argumentsCreated ?
+            m_arguments.at(index).value() : m_values.at(index);
+    }
+
+    bool setValueAt(qint32 index, const QVariant& value);
 
-        for(typename T::const_iterator ci = source.constBegin(); ci != source.constEnd(); ++ci)
-        {
-            HActionArgument arg = *ci;
-            arg.detach();
-            contents->append(arg);
-        }
+    // stores a value that has been validated already, such as a value
+    // set by an HActionCodec
+    void storeValueAt(qint32 index, const QVariant& value);
 
-        return contents;
+    void append(const HActionArgument& arg);
+    void remove(qint32 index);
+    void clear();
+
+    void createArguments() const;
+
+    static HActionArgumentsPrivate* create(const QVector<HActionArgument>& source);
+
+    // the copy shares the schema, but it has its own argument values
+    static HActionArgumentsPrivate* copy(const HActionArgumentsPrivate& source);
+
+    // for the invocation paths that access the arguments by their positions
+    // without creating the HActionArgument objects
+    inline static HActionArgumentsPrivate* get(HActionArguments& args)
+    {
+        return args.h_ptr;
+    }
+
+    inline static const HActionArgumentsPrivate* get(const HActionArguments& args)
+    {
+        return args.h_ptr;
     }
 };
 
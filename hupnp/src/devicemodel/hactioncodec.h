@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HACTIONCODEC_H_
+#define HACTIONCODEC_H_
+
+#include <HUpnpCore/HUpnp>
+
+class QVariant;
+class QXmlStreamReader;
+class QXmlStreamWriter;
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+/*!
+ * \brief An interface for encoding and decoding the SOAP messages of a
+ * particular action with a fixed argument layout.
+ *
+ * By default HClientAction encodes the input arguments and decodes the
+ * output arguments of an invocation without knowing anything about them in
+ * advance: the arguments are looked up from the action information, the values
+ * are converted according to their data types and validated against their
+ * state variables on every call.
+ *
+ * A codec knows the argument layout of a single action at compile-time.
+ * It writes the input arguments directly to the SOAP request and reads the
+ * output arguments directly from the SOAP response, converting the values with
+ * the conversions and validating them with the checks that are known to be
+ * correct for the arguments. The codecs are normally generated from a service
+ * description with \c hupnp_scpdgen, but they can be written by hand as well.
+ *
+ * A codec is taken into use with HClientAction::setCodec().
+ *
+ * \headerfile hactioncodec.h HActionCodec
+ *
+ * \ingroup hupnp_devicemodel
+ *
+ * \sa HClientAction::setCodec()
+ *
+ * \remarks A codec is used from the thread of every action it is set to,
+ * so it should not have mutable state.
+ */
+class H_UPNP_CORE_EXPORT HActionCodec
+{
+H_DISABLE_COPY(HActionCodec)
+
+protected:
+
+    /*!
+     * \brief Creates a new instance.
+     */
+    HActionCodec();
+
+    /*!
+     * Stores the value of the argument at the specified index without
+     * validating it.
+     *
+     * This is meant for the codecs that have validated the value already.
+     * The value has to be of the type HUPnP uses for the data type of the
+     * argument and it has to be valid for the state variable of the argument.
+     *
+     * \param args specifies the arguments.
+     *
+     * \param index specifies the index of the argument. The index has to be
+     * valid position in the container, i.e. it must be 0 <= i < size().
+     *
+     * \param value specifies the value of the argument.
+     *
+     * \sa HActionArguments::setValueAt()
+     */
+    static void setValidatedValue(
+        HActionArguments* args, qint32 index, const QVariant& value);
+
+public:
+
+    /*!
+     * \brief Destroys the instance.
+     */
+    virtual ~HActionCodec() = 0;
+
+    /*!
+     * Indicates if the codec can encode and decode the arguments of the
+     * specified action.
+     *
+     * \param info specifies the action.
+     *
+     * \return \e true if the name of the action and the names and the data
+     * types of its arguments match the layout the codec was written for.
+     */
+    virtual bool isCompatible(const HActionInfo& info) const = 0;
+
+    /*!
+     * Writes the input arguments of an invocation to a SOAP request.
+     *
+     * \param inArgs specifies the input arguments. These have the layout
+     * of the action.
+     *
+     * \param writer specifies the writer, which is positioned within the
+     * element of the action in the SOAP body. The arguments are written as
+     * the child elements of that element.
+     *
+     * \return \e true if the arguments were written.
+     */
+    virtual bool writeInputArguments(
+        const HActionArguments& inArgs, QXmlStreamWriter& writer) const = 0;
+
+    /*!
+     * Reads the output arguments of an invocation from a SOAP response.
+     *
+     * \param reader specifies the reader, which is positioned at the
+     * start of the response element in the SOAP body. The child elements of
+     * that element are read.
+     *
+     * \param outArgs specifies the output arguments to which the read values
+     * are stored. These have the layout of the action.
+     *
+     * \return \e true if every output argument was read and it had a valid
+     * value. If \e false is returned, HUPnP parses the response again
+     * without the codec.
+     */
+    virtual bool readOutputArguments(
+        QXmlStreamReader& reader, HActionArguments* outArgs) const = 0;
+};
+
+}
+}
+
+#endif /* HACTIONCODEC_H_ */
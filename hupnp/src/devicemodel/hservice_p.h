@@ -36,8 +36,11 @@
 
 #include <QtCore/QUrl>
 #include <QtCore/QHash>
+#include <QtCore/QPair>
 #include <QtCore/QString>
+#include <QtCore/QVariant>
 #include <QtCore/QByteArray>
+#include <QtCore/QVarLengthArray>
 
 namespace Herqq
 {
@@ -123,7 +126,11 @@ public: // methods
     ReturnValue updateVariables(const QList<QPair<QString, QString> >& variables)
     {
         // before modifying anything, it is better to be sure that the incoming
-        // data is valid and it can be set completely.
+        // data is valid and it can be set completely. The state variables and
+        // the converted values are resolved once and reused when setting.
+        QVarLengthArray<QPair<StateVariable*, QVariant>, 16> resolved(
+            variables.size());
+
         for (int i = 0; i < variables.size(); ++i)
         {
             StateVariable* stateVar = m_stateVariables.value(variables[i].first);
@@ -138,9 +145,11 @@ public: // methods
             }
 
             const HStateVariableInfo& info = stateVar->info();
-            if (!info.isValidValue(
-                    HUpnpDataTypes::convertToRightVariantType(
-                        variables[i].second, info.dataType())))
+
+            QVariant value = HUpnpDataTypes::convertToRightVariantType(
+                variables[i].second, info.dataType());
+
+            if (!info.isValidValue(value))
             {
                 m_lastError = QString(
                     "Cannot update state variable [%1]. New value is invalid: [%2]").
@@ -148,20 +157,56 @@ public: // methods
 
                 return Failed;
             }
+
+            resolved[i] = qMakePair(stateVar, value);
         }
 
         bool changed = false;
+        for (int i = 0; i < resolved.size(); ++i)
+        {
+            if (resolved[i].first->setValue(resolved[i].second) && !changed)
+            {
+                changed = true;
+            }
+        }
+
+        return changed ? Updated : Ignored;
+    }
+
+    // same as above, but the values are already of the right type
+    ReturnValue updateVariables(const QList<QPair<QString, QVariant> >& variables)
+    {
+        QVarLengthArray<StateVariable*, 16> resolved(variables.size());
+
         for (int i = 0; i < variables.size(); ++i)
         {
             StateVariable* stateVar = m_stateVariables.value(variables[i].first);
-            Q_ASSERT(stateVar);
 
-            const HStateVariableInfo& info = stateVar->info();
+            if (!stateVar)
+            {
+                m_lastError = QString(
+                    "Cannot update state variable: no state variable [%1]").arg(
+                        variables[i].first);
 
-            if (stateVar->setValue(
-                    HUpnpDataTypes::convertToRightVariantType(
-                        variables[i].second, info.dataType())) &&
-                    !changed)
+                return Failed;
+            }
+
+            if (!stateVar->info().isValidValue(variables[i].second))
+            {
+                m_lastError = QString(
+                    "Cannot update state variable [%1]. New value is invalid: [%2]").
+                        arg(variables[i].first, variables[i].second.toString());
+
+                return Failed;
+            }
+
+            resolved[i] = stateVar;
+        }
+
+        bool changed = false;
+        for (int i = 0; i < resolved.size(); ++i)
+        {
+            if (resolved[i]->setValue(variables[i].second) && !changed)
             {
                 changed = true;
             }
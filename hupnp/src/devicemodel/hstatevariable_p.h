@@ -35,6 +35,7 @@
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 #include <QtCore/QByteArray>
+#include <QtCore/QAtomicPointer>
 
 namespace Herqq
 {
@@ -54,10 +55,35 @@ public:
     HStateVariableInfo m_info;
     QVariant m_value;
 
+    QAtomicPointer<QVariant> m_publishedValue;
+    // the latest value published from another thread and not yet collected
+    // by the thread of the state variable. used only on the server-side.
+
 public:
 
-    HStateVariablePrivate() : m_info(), m_value() {}
-    ~HStateVariablePrivate(){}
+    HStateVariablePrivate() : m_info(), m_value(), m_publishedValue(0) {}
+    ~HStateVariablePrivate()
+    {
+        delete m_publishedValue.fetchAndStoreAcquire(0);
+    }
+
+    // stores a value to be collected later, replacing the previous one that
+    // has not been collected. returns true in case there was no previous value.
+    bool publish(const QVariant& value)
+    {
+        QVariant* previous =
+            m_publishedValue.fetchAndStoreOrdered(new QVariant(value));
+
+        delete previous;
+        return !previous;
+    }
+
+    // takes the latest published value. returns null in case no value has
+    // been published since the previous call.
+    QVariant* takePublished()
+    {
+        return m_publishedValue.fetchAndStoreAcquire(0);
+    }
 
     bool setValue(const QVariant& value, QString* err)
     {
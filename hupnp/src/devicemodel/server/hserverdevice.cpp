@@ -128,7 +128,26 @@ const HDeviceInfo& HServerDevice::info() const
 
 QString HServerDevice::description() const
 {
-    return h_ptr->m_deviceDescription;
+    if (h_ptr->m_descriptionSubstitutions.isEmpty())
+    {
+        return h_ptr->m_deviceDescription;
+    }
+
+    QString retVal = h_ptr->m_deviceDescription;
+
+    QList<QPair<QString, QString> >::const_iterator ci =
+        h_ptr->m_descriptionSubstitutions.constBegin();
+
+    for(; ci != h_ptr->m_descriptionSubstitutions.constEnd(); ++ci)
+    {
+        qint32 index = retVal.indexOf(ci->first);
+        if (index >= 0)
+        {
+            retVal.replace(index, ci->first.size(), ci->second);
+        }
+    }
+
+    return retVal;
 }
 
 QList<QUrl> HServerDevice::locations(LocationUrlType urlType) const
@@ -33,6 +33,8 @@
 #include <HUpnpCore/HServerDevice>
 #include <HUpnpCore/private/hdevice_p.h>
 
+#include <QtCore/QPair>
+
 namespace Herqq
 {
 
@@ -49,7 +51,14 @@ H_DISABLE_COPY(HServerDevicePrivate)
 
 public:
 
-    HServerDevicePrivate(){}
+    QList<QPair<QString, QString> > m_descriptionSubstitutions;
+    // The per-instance values of a device created from a template. These
+    // are substituted into the shared template description when the
+    // description is requested.
+
+public:
+
+    HServerDevicePrivate() : m_descriptionSubstitutions() {}
     virtual ~HServerDevicePrivate(){}
 };
 
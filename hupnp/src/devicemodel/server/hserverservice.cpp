@@ -22,9 +22,11 @@
 #include "hserverservice.h"
 #include "hserverservice_p.h"
 
+#include "../hstatevariable_p.h"
 #include "../../general/hlogger_p.h"
 
 #include <QtCore/QMetaMethod>
+#include <QtCore/QMetaObject>
 
 namespace Herqq
 {
@@ -35,7 +37,10 @@ namespace Upnp
 /*******************************************************************************
  * HServerServicePrivate
  ******************************************************************************/
-HServerServicePrivate::HServerServicePrivate()
+HServerServicePrivate::HServerServicePrivate() :
+    m_collectionPending(0),
+    m_notificationsDeferred(false),
+    m_notificationPending(false)
 {
 }
 
@@ -43,18 +48,89 @@ HServerServicePrivate::~HServerServicePrivate()
 {
 }
 
+bool HServerServicePrivate::beginDeferral()
+{
+    bool wasDeferred = m_notificationsDeferred;
+    m_notificationsDeferred = true;
+    return wasDeferred;
+}
+
+void HServerServicePrivate::endDeferral(bool wasDeferred, bool sendEvent)
+{
+    if (wasDeferred)
+    {
+        // the outermost deferral sends the event
+        return;
+    }
+
+    m_notificationsDeferred = false;
+
+    if (m_notificationPending)
+    {
+        m_notificationPending = false;
+        if (sendEvent)
+        {
+            q_ptr->notifyListeners();
+        }
+    }
+}
+
 HServerServicePrivate::ReturnValue HServerServicePrivate::updateVariables(
     const QList<QPair<QString, QString> >& variables, bool sendEvent)
 {
+    bool wasDeferred = beginDeferral();
+
+    ReturnValue rv =
+        HServicePrivate<HServerService, HServerAction, HServerStateVariable>::updateVariables(variables);
+
+    endDeferral(wasDeferred, sendEvent);
+    return rv;
+}
+
+HServerServicePrivate::ReturnValue HServerServicePrivate::updateVariables(
+    const QList<QPair<QString, QVariant> >& variables, bool sendEvent)
+{
+    bool wasDeferred = beginDeferral();
+
     ReturnValue rv =
         HServicePrivate<HServerService, HServerAction, HServerStateVariable>::updateVariables(variables);
 
-    if (rv == Updated && sendEvent && m_evented)
+    endDeferral(wasDeferred, sendEvent);
+    return rv;
+}
+
+void HServerServicePrivate::scheduleCollection()
+{
+    if (m_collectionPending.testAndSetOrdered(0, 1))
     {
-        emit q_ptr->stateChanged(q_ptr);
+        QMetaObject::invokeMethod(
+            q_ptr, "collectPublishedValues", Qt::QueuedConnection);
     }
+}
 
-    return rv;
+void HServerServicePrivate::collectPublishedValues()
+{
+    // the flag is cleared before the values are taken, so that a value
+    // published after its state variable has been visited schedules
+    // another collection
+    m_collectionPending.fetchAndStoreOrdered(0);
+
+    bool wasDeferred = beginDeferral();
+
+    QHash<QString, HServerStateVariable*>::const_iterator ci =
+        m_stateVariables.constBegin();
+
+    for(; ci != m_stateVariables.constEnd(); ++ci)
+    {
+        QVariant* value = ci.value()->h_ptr->takePublished();
+        if (value)
+        {
+            ci.value()->setValue(*value);
+            delete value;
+        }
+    }
+
+    endDeferral(wasDeferred, true);
 }
 
 /*******************************************************************************
@@ -227,7 +303,11 @@ const HServerStateVariables& HServerService::stateVariables() const
 
 void HServerService::notifyListeners()
 {
-    if (h_ptr->m_evented)
+    if (h_ptr->m_notificationsDeferred)
+    {
+        h_ptr->m_notificationPending = true;
+    }
+    else if (h_ptr->m_evented)
     {
         emit stateChanged(this);
     }
@@ -248,5 +328,17 @@ bool HServerService::setValue(const QString& stateVarName, const QVariant& value
     return h_ptr->setValue(stateVarName, value);
 }
 
+bool HServerService::publishValue(
+    const QString& stateVarName, const QVariant& value)
+{
+    HServerStateVariable* sv = h_ptr->m_stateVariables.value(stateVarName);
+    return sv ? sv->publishValue(value) : false;
+}
+
+void HServerService::collectPublishedValues()
+{
+    h_ptr->collectPublishedValues();
+}
+
 }
 }
@@ -89,7 +89,8 @@ class HServerServicePrivate;
  *
  * \sa hupnp_devicemodel
  *
- * \remarks This class is not thread-safe.
+ * \remarks This class is not thread-safe, with the exception of
+ * publishValue().
  */
 class H_UPNP_CORE_EXPORT HServerService :
     public QObject
@@ -98,6 +99,8 @@ Q_OBJECT
 H_DISABLE_COPY(HServerService)
 H_DECLARE_PRIVATE(HServerService)
 friend class HServerModelCreator;
+friend class HServerStateVariable;
+friend class HServerStateTransaction;
 
 protected:
 
@@ -294,9 +297,38 @@ public:
      *
      * \return \e true in case the specified state variable was found and its
      * value was changed.
+     *
+     * \remarks In case the state variable is evented, stateChanged() is
+     * emitted for every call. Use HServerStateTransaction to change several
+     * state variables with a single event.
      */
     bool setValue(const QString& stateVarName, const QVariant& value);
 
+    /*!
+     * \brief Publishes a new value for the specified state variable from
+     * any thread.
+     *
+     * This is a convenience method for retrieving a state variable by name and
+     * calling HServerStateVariable::publishValue().
+     *
+     * \param stateVarName specifies the name of the state variable.
+     *
+     * \param value specifies the new value of the state variable.
+     *
+     * \return \e true in case the specified state variable was found and the
+     * value was published.
+     *
+     * \remarks This method is thread-safe and it never waits for the thread
+     * of the service.
+     *
+     * \sa HServerStateVariable::publishValue()
+     */
+    bool publishValue(const QString& stateVarName, const QVariant& value);
+
+private Q_SLOTS:
+
+    void collectPublishedValues();
+
 public Q_SLOTS:
 
     /*!
@@ -308,8 +340,8 @@ public Q_SLOTS:
 Q_SIGNALS:
 
     /*!
-     * \brief This signal is emitted when the state of one or more state variables
-     * has changed.
+     * \brief This signal is emitted when the state of one or more evented
+     * state variables has changed.
      *
      * \param source specifies the source of the event.
      *
@@ -36,6 +36,8 @@
 #include <HUpnpCore/HServerService>
 #include <HUpnpCore/HServerStateVariable>
 
+#include <QtCore/QAtomicInt>
+
 namespace Herqq
 {
 
@@ -51,13 +53,46 @@ class H_UPNP_CORE_EXPORT HServerServicePrivate :
 H_DECLARE_PUBLIC(HServerService)
 H_DISABLE_COPY(HServerServicePrivate)
 
+public: // attributes
+
+    QAtomicInt m_collectionPending;
+    // set when a value has been published from another thread and the
+    // collection of the published values has been scheduled
+
+    bool m_notificationsDeferred;
+    bool m_notificationPending;
+    // while the notifications are deferred, notifyListeners() only records
+    // that stateChanged() should be emitted
+
 public: // methods
 
     HServerServicePrivate();
     virtual ~HServerServicePrivate();
 
+    // schedules collectPublishedValues() in the thread of the service,
+    // unless it is scheduled already. this can be called from any thread.
+    void scheduleCollection();
+
+    // sets the values published from other threads and emits stateChanged()
+    // once, if any of the values changed
+    void collectPublishedValues();
+
+    // the stateChanged() signals caused by the state variables are suppressed
+    // until endDeferral(). returns whether they were suppressed already.
+    bool beginDeferral();
+
+    // ends the suppression begun by the matching beginDeferral() call. unless
+    // the suppression is nested, stateChanged() is emitted once if
+    // it was suppressed and sendEvent is true.
+    void endDeferral(bool wasDeferred, bool sendEvent);
+
+    // these validate every value before setting any and emit stateChanged()
+    // at most once
     ReturnValue updateVariables(
         const QList<QPair<QString, QString> >& variables, bool sendEvent);
+
+    ReturnValue updateVariables(
+        const QList<QPair<QString, QVariant> >& variables, bool sendEvent);
 };
 
 }
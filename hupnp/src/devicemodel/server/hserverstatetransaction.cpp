@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hserverstatetransaction.h"
+#include "hserverservice_p.h"
+
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+/*******************************************************************************
+ * HServerStateTransactionPrivate
+ ******************************************************************************/
+class HServerStateTransactionPrivate
+{
+H_DISABLE_COPY(HServerStateTransactionPrivate)
+
+public:
+
+    HServerService* m_service;
+    QList<QPair<QString, QVariant> > m_values;
+    QString m_errorDescription;
+    bool m_valid;
+
+    HServerStateTransactionPrivate(HServerService* service);
+};
+
+HServerStateTransactionPrivate::HServerStateTransactionPrivate(
+    HServerService* service) :
+        m_service(service), m_values(), m_errorDescription(), m_valid(true)
+{
+}
+
+/*******************************************************************************
+ * HServerStateTransaction
+ ******************************************************************************/
+HServerStateTransaction::HServerStateTransaction(HServerService* service) :
+    h_ptr(new HServerStateTransactionPrivate(service))
+{
+    Q_ASSERT_X(service, H_AT, "Service must be defined.");
+}
+
+HServerStateTransaction::~HServerStateTransaction()
+{
+    delete h_ptr;
+}
+
+bool HServerStateTransaction::setValue(
+    const QString& stateVarName, const QVariant& value)
+{
+    const HServerStateVariable* sv =
+        h_ptr->m_service->stateVariables().value(stateVarName);
+
+    if (!sv)
+    {
+        h_ptr->m_errorDescription = QString(
+            "No state variable [%1]").arg(stateVarName);
+
+        h_ptr->m_valid = false;
+        return false;
+    }
+    else if (!sv->info().isValidValue(value))
+    {
+        h_ptr->m_errorDescription = QString(
+            "Invalid value for state variable [%1]: [%2]").arg(
+                stateVarName, value.toString());
+
+        h_ptr->m_valid = false;
+        return false;
+    }
+
+    QList<QPair<QString, QVariant> >& values = h_ptr->m_values;
+    for(qint32 i = 0; i < values.size(); ++i)
+    {
+        if (values[i].first == stateVarName)
+        {
+            values[i].second = value;
+            return true;
+        }
+    }
+
+    values.append(qMakePair(stateVarName, value));
+    return true;
+}
+
+bool HServerStateTransaction::commit()
+{
+    if (!h_ptr->m_valid)
+    {
+        rollback();
+        return false;
+    }
+
+    HServerService* service = h_ptr->m_service;
+    HServerServicePrivate::ReturnValue rv =
+        service->h_ptr->updateVariables(h_ptr->m_values, true);
+
+    if (rv == HServerServicePrivate::Failed)
+    {
+        // the values were validated already, so this is not expected
+        h_ptr->m_errorDescription = service->h_ptr->m_lastError;
+    }
+
+    h_ptr->m_values.clear();
+    return rv != HServerServicePrivate::Failed;
+}
+
+void HServerStateTransaction::rollback()
+{
+    h_ptr->m_values.clear();
+    h_ptr->m_valid = true;
+}
+
+bool HServerStateTransaction::isEmpty() const
+{
+    return h_ptr->m_values.isEmpty();
+}
+
+QString HServerStateTransaction::errorDescription() const
+{
+    return h_ptr->m_errorDescription;
+}
+
+}
+}
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSERVER_STATETRANSACTION_H_
+#define HSERVER_STATETRANSACTION_H_
+
+#include <HUpnpCore/HUpnp>
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+class HServerStateTransactionPrivate;
+
+/*!
+ * \brief This class updates several state variables of a server-side service
+ * as a single change.
+ *
+ * Setting the value of an evented state variable makes the
+ * HServerService emit HServerService::stateChanged(), which
+ * in turn causes an event to be sent to every subscriber of the service.
+ * When several related state variables change together, a transaction
+ * can be used to set all of them and to send only one event:
+ *
+ * \code
+ *
+ * HServerStateTransaction transaction(service);
+ * transaction.setValue("Volume", 50);
+ * transaction.setValue("Mute", false);
+ *
+ * if (!transaction.commit())
+ * {
+ *     qWarning() << transaction.errorDescription();
+ * }
+ *
+ * \endcode
+ *
+ * The values are validated as they are given to setValue(), but none of them
+ * is set until commit() is called. If any of the values is invalid, commit()
+ * sets none of them. A transaction that is destroyed without calling
+ * commit() sets nothing.
+ *
+ * \headerfile hserverstatetransaction.h HServerStateTransaction
+ *
+ * \ingroup hupnp_devicemodel
+ *
+ * \remarks This class is not thread-safe. It has to be used in the thread
+ * of the service. To update state variables from other threads, see
+ * HServerStateVariable::publishValue().
+ *
+ * \sa HServerService::setValue()
+ */
+class H_UPNP_CORE_EXPORT HServerStateTransaction
+{
+H_DISABLE_COPY(HServerStateTransaction)
+
+private:
+
+    HServerStateTransactionPrivate* h_ptr;
+
+public:
+
+    /*!
+     * \brief Begins a new transaction.
+     *
+     * \param service specifies the service whose state variables are
+     * updated. The service has to exist as long as this object does.
+     */
+    explicit HServerStateTransaction(HServerService* service);
+
+    /*!
+     * \brief Destroys the instance.
+     *
+     * The values that have not been committed are discarded.
+     */
+    ~HServerStateTransaction();
+
+    /*!
+     * \brief Sets the value the specified state variable receives when the
+     * transaction is committed.
+     *
+     * \param stateVarName specifies the name of the state variable.
+     *
+     * \param value specifies the new value of the state variable. This
+     * replaces any value set earlier for the same state variable in this
+     * transaction.
+     *
+     * \return \e true in case the service has the specified state variable
+     * and the value is valid for it. Otherwise the transaction cannot
+     * be committed.
+     *
+     * \sa commit(), errorDescription()
+     */
+    bool setValue(const QString& stateVarName, const QVariant& value);
+
+    /*!
+     * \brief Sets the values of the transaction.
+     *
+     * The values are set in the order they were given. In case any of the
+     * values changed, the service emits HServerService::stateChanged() once.
+     * Either way, the transaction is empty afterwards and it can be reused.
+     *
+     * \return \e true in case the values were set. \e false is returned if
+     * setValue() failed at least once, in which case none of the values is set.
+     */
+    bool commit();
+
+    /*!
+     * \brief Discards the values of the transaction.
+     *
+     * The transaction is empty afterwards and it can be reused.
+     */
+    void rollback();
+
+    /*!
+     * \brief Indicates whether the transaction contains any values.
+     *
+     * \return \e true in case the transaction contains no values.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Returns a description of the error that occurred last.
+     *
+     * \return a description of the error that occurred last.
+     */
+    QString errorDescription() const;
+};
+
+}
+}
+
+#endif /* HSERVER_STATETRANSACTION_H_ */
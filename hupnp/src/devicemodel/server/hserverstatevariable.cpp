@@ -22,6 +22,8 @@
 #include "hserverstatevariable.h"
 #include "hdefault_serverstatevariable_p.h"
 
+#include "hserverservice_p.h"
+
 #include "../hstatevariable_p.h"
 #include "../hstatevariable_event.h"
 
@@ -85,6 +87,25 @@ bool HServerStateVariable::setValue(const QVariant& newValue)
     return true;
 }
 
+bool HServerStateVariable::publishValue(const QVariant& newValue)
+{
+    // the info is never modified after construction and thus it can be
+    // read from any thread
+    if (!h_ptr->m_info.isValidValue(newValue))
+    {
+        return false;
+    }
+
+    if (h_ptr->publish(newValue))
+    {
+        // no value was waiting for collection, which means that the
+        // collection may not have been scheduled yet
+        parentService()->h_ptr->scheduleCollection();
+    }
+
+    return true;
+}
+
 /*******************************************************************************
  * HDefaultServerStateVariable
  *******************************************************************************/
@@ -58,13 +58,14 @@ class HStateVariablePrivate;
  *
  * \sa HServerStateVariable
  *
- * \remarks This class is not thread-safe.
+ * \remarks This class is not thread-safe, with the exception of publishValue().
  */
 class H_UPNP_CORE_EXPORT HServerStateVariable :
     public QObject
 {
 Q_OBJECT
 H_DISABLE_COPY(HServerStateVariable)
+friend class HServerServicePrivate;
 
 protected:
 
@@ -139,6 +140,31 @@ public:
      */
     bool setValue(const QVariant& newValue);
 
+    /*!
+     * \brief Publishes a new value for the state variable from any thread.
+     *
+     * The value is stored and this call returns immediately. The thread of the
+     * state variable sets the latest published value later, as if by calling
+     * setValue(). If several values are published before that, only the latest
+     * one is set. The values published to the state variables of a service are
+     * set together and the service emits HServerService::stateChanged() only
+     * once for all of them.
+     *
+     * \param newValue specifies the new value of the state variable.
+     *
+     * \return \e true in case the value is valid for the state variable and
+     * it was published.
+     *
+     * \remarks
+     * \li This method is thread-safe and it never waits for the thread of the
+     * state variable.
+     * \li The state variable has to exist until the calling thread has
+     * returned from this method.
+     *
+     * \sa setValue(), HServerService::publishValue()
+     */
+    bool publishValue(const QVariant& newValue);
+
 Q_SIGNALS:
 
     /*!
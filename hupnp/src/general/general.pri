@@ -3,6 +3,9 @@ HEADERS += \
     $$SRC_LOC/general/hupnp_defs.h \
     $$SRC_LOC/general/hupnp_fwd.h \
     $$SRC_LOC/general/hlogger_p.h \
+    $$SRC_LOC/general/hlogsink.h \
+    $$SRC_LOC/general/hmetrics.h \
+    $$SRC_LOC/general/hmetrics_p.h \
     $$SRC_LOC/general/hupnp_global_p.h \
     $$SRC_LOC/general/hupnp_global.h \
     $$SRC_LOC/general/hclonable.h \
@@ -14,6 +17,9 @@ SOURCES += \
     $$SRC_LOC/general/hupnp_global.cpp \
     $$SRC_LOC/general/hclonable.cpp \
     $$SRC_LOC/general/hlogger_p.cpp \
+    $$SRC_LOC/general/hlogsink.cpp \
+    $$SRC_LOC/general/hmetrics.cpp \
+    $$SRC_LOC/general/hmetrics_p.cpp \
     $$SRC_LOC/general/hupnpinfo.cpp \
     $$SRC_LOC/general/hupnp_datatypes.cpp
 
@@ -20,10 +20,16 @@
  */
 
 #include "hlogger_p.h"
+#include "hlogsink.h"
 
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
 #include <QtCore/QtDebug>
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QCoreApplication>
 
 namespace Herqq
 {
@@ -31,81 +37,525 @@ namespace Herqq
 volatile int HLogger::s_logLevel = static_cast<qint32>(Critical);
 volatile bool HLogger::s_nonStdWarningsEnabled = true;
 
-HLogger::HLogger() :
-    m_methodName(0), m_logPrefix(0)
+struct HLogFields
+{
+    QString m_peer;
+    QString m_sid;
+    QString m_usn;
+};
+
+namespace
+{
+
+inline qint32 loadAcquire(QAtomicInt& value)
 {
+    return value.fetchAndAddAcquire(0);
 }
 
-HLogger::HLogger(const char* at, const char* methodName, const char* logPrefix) :
-    m_methodName(methodName), m_logPrefix(logPrefix)
+//
+// A bounded multiple-producer, single-consumer queue. Producers claim a slot
+// by advancing the enqueue position and publish the record by advancing the
+// sequence number of the slot, so they never wait for each other or for the
+// consumer. When the queue is full, push() fails immediately.
+//
+class HLogQueue
 {
-    if (traceLevel() == All)
+H_DISABLE_COPY(HLogQueue)
+
+private:
+
+    enum
+    {
+        Capacity = 1024,
+        Mask = Capacity - 1
+    };
+
+    struct Slot
     {
-        QString stmt = (m_logPrefix ? QString(m_logPrefix) : QString()).append(
-            QString("Entering %1 @ %2").arg(m_methodName, at));
+        QAtomicInt m_seq;
+        Upnp::HLogRecord m_record;
+    };
 
-        qDebug() << stmt;
+    Slot m_slots[Capacity];
+    QAtomicInt m_enqueuePos;
+    quint32 m_dequeuePos;
+
+public:
+
+    HLogQueue() :
+        m_enqueuePos(0), m_dequeuePos(0)
+    {
+        for(qint32 i = 0; i < Capacity; ++i)
+        {
+            m_slots[i].m_seq = i;
+        }
+    }
+
+    bool push(const Upnp::HLogRecord& record)
+    {
+        for(;;)
+        {
+            quint32 pos = static_cast<quint32>(loadAcquire(m_enqueuePos));
+            Slot& slot = m_slots[pos & Mask];
+
+            qint32 diff = static_cast<qint32>(
+                static_cast<quint32>(loadAcquire(slot.m_seq)) - pos);
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.testAndSetOrdered(
+                    static_cast<qint32>(pos), static_cast<qint32>(pos + 1)))
+                {
+                    slot.m_record = record;
+                    slot.m_seq.fetchAndStoreRelease(static_cast<qint32>(pos + 1));
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    // called only by the consumer, like pop()
+    bool isEmpty()
+    {
+        Slot& slot = m_slots[m_dequeuePos & Mask];
+
+        return static_cast<qint32>(
+            static_cast<quint32>(loadAcquire(slot.m_seq)) - (m_dequeuePos + 1)) < 0;
+    }
+
+    // called only by a single consumer at a time
+    bool pop(Upnp::HLogRecord* record)
+    {
+        Slot& slot = m_slots[m_dequeuePos & Mask];
+
+        qint32 diff = static_cast<qint32>(
+            static_cast<quint32>(loadAcquire(slot.m_seq)) - (m_dequeuePos + 1));
+
+        if (diff < 0)
+        {
+            return false;
+        }
+
+        *record = slot.m_record;
+        slot.m_record = Upnp::HLogRecord();
+        slot.m_seq.fetchAndStoreRelease(
+            static_cast<qint32>(m_dequeuePos + Capacity));
+
+        ++m_dequeuePos;
+        return true;
+    }
+};
+
+void writeDefault(const Upnp::HLogRecord& record)
+{
+    switch(record.level())
+    {
+    case Upnp::Fatal:
+    case Upnp::Critical:
+        qCritical() << record.toString();
+        break;
+    case Upnp::Warning:
+        qWarning() << record.toString();
+        break;
+    default:
+        qDebug() << record.toString();
+        break;
     }
 }
 
-HLogger::~HLogger()
+//
+// The thread that writes the log records to the sink, so that the threads
+// generating log output never block on I/O.
+//
+// The writer sleeps on a wait condition while the queue is empty. The
+// producers take the mutex of the condition only when the writer has
+// announced that it is going to sleep, which is why logging does not
+// serialize the producers while the writer is busy.
+//
+class HLogWriter :
+    public QThread
 {
-    if (traceLevel() == All)
+private:
+
+    HLogQueue m_queue;
+
+    QAtomicInt m_enqueued;
+    QAtomicInt m_written;
+    QAtomicInt m_dropped;
+    QAtomicInt m_stopped;
+
+    QAtomicInt m_sleeping;
+    QMutex m_waitMutex;
+    QWaitCondition m_recordsAvailable;
+    QWaitCondition m_recordsWritten;
+    // the writer waits for m_recordsAvailable and flush() for
+    // m_recordsWritten, both with m_waitMutex
+
+    QMutex m_drainMutex;
+    // held while the queue is drained. the writer is the only consumer until
+    // it is stopped, after which the producers drain the records that were
+    // pushed after the writer did its final drain
+
+    QMutex m_sinkMutex;
+    Upnp::HLogSink* m_sink;
+
+    void drain()
+    {
+        QMutexLocker lock(&m_drainMutex);
+
+        bool wrote = false;
+
+        Upnp::HLogRecord record;
+        while(m_queue.pop(&record))
+        {
+            write(record);
+            m_written.ref();
+            wrote = true;
+        }
+
+        qint32 dropped = m_dropped.fetchAndStoreRelaxed(0);
+        if (dropped > 0)
+        {
+            write(HLogger::createRecord(
+                HLogger::Warning, 0, 0,
+                QString("[%1] log messages were dropped, "
+                        "because the log buffer was full").arg(
+                            QString::number(dropped))));
+        }
+
+        if (wrote)
+        {
+            QMutexLocker waitLock(&m_waitMutex);
+            m_recordsWritten.wakeAll();
+        }
+    }
+
+    // called only by the writer, while it is the only consumer
+    bool hasWork()
+    {
+        return !m_queue.isEmpty() || loadAcquire(m_dropped) > 0;
+    }
+
+    void wakeUp()
+    {
+        // the ordered operations pair with the ones in run(): either the
+        // writer sees the pushed record before it sleeps, or this sees that
+        // it is about to sleep
+        if (m_sleeping.fetchAndAddOrdered(0))
+        {
+            QMutexLocker lock(&m_waitMutex);
+            m_recordsAvailable.wakeOne();
+        }
+    }
+
+protected:
+
+    virtual void run()
+    {
+        for(;;)
+        {
+            drain();
+
+            if (loadAcquire(m_stopped))
+            {
+                // the records pushed since the previous drain
+                drain();
+                break;
+            }
+
+            QMutexLocker lock(&m_waitMutex);
+
+            m_sleeping.fetchAndStoreOrdered(1);
+            if (!hasWork() && !loadAcquire(m_stopped))
+            {
+                m_recordsAvailable.wait(&m_waitMutex);
+            }
+            m_sleeping.fetchAndStoreOrdered(0);
+        }
+    }
+
+public:
+
+    HLogWriter() :
+        m_enqueued(0), m_written(0), m_dropped(0), m_stopped(0),
+        m_sleeping(0), m_sink(0)
+    {
+    }
+
+    void write(const Upnp::HLogRecord& record)
+    {
+        QMutexLocker lock(&m_sinkMutex);
+        if (m_sink)
+        {
+            m_sink->write(record);
+        }
+        else
+        {
+            writeDefault(record);
+        }
+    }
+
+    void push(const Upnp::HLogRecord& record)
     {
-        QString stmt = (m_logPrefix ? QString(m_logPrefix) : QString()).append(
-            QString("Exiting %1").arg(m_methodName));
+        if (loadAcquire(m_stopped))
+        {
+            write(record);
+            return;
+        }
+
+        if (m_queue.push(record))
+        {
+            m_enqueued.ref();
+        }
+        else
+        {
+            m_dropped.ref();
+        }
 
-        qDebug() << stmt;
+        if (m_stopped.fetchAndAddOrdered(0))
+        {
+            // the writer was stopped while the record was pushed and it may
+            // have done its final drain already
+            if (QThread::currentThread() != this)
+            {
+                wait();
+                drain();
+            }
+        }
+        else
+        {
+            wakeUp();
+        }
+    }
+
+    void flush()
+    {
+        if (QThread::currentThread() == this)
+        {
+            return;
+        }
+
+        qint32 enqueued = loadAcquire(m_enqueued);
+
+        QMutexLocker lock(&m_waitMutex);
+        while(isRunning() && loadAcquire(m_written) - enqueued < 0)
+        {
+            m_recordsWritten.wait(&m_waitMutex);
+        }
+    }
+
+    void stop()
+    {
+        m_stopped.fetchAndStoreOrdered(1);
+
+        {
+            QMutexLocker lock(&m_waitMutex);
+            m_recordsAvailable.wakeOne();
+        }
+
+        wait();
+    }
+
+    void setSink(Upnp::HLogSink* sink)
+    {
+        QMutexLocker lock(&m_sinkMutex);
+        m_sink = sink;
+    }
+};
+
+QBasicAtomicPointer<HLogWriter> s_writer = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+void stopWriter()
+{
+    HLogWriter* w = s_writer;
+    if (w)
+    {
+        w->stop();
     }
 }
 
-namespace
+HLogWriter* writer()
+{
+    HLogWriter* w = s_writer;
+    if (w)
+    {
+        return w;
+    }
+
+    w = new HLogWriter();
+    if (!s_writer.testAndSetOrdered(0, w))
+    {
+        delete w;
+        return s_writer;
+    }
+
+    // the writer is intentionally never deleted, since log output may be
+    // generated during static destruction. it is only stopped, after which
+    // the records are written synchronously.
+    qAddPostRoutine(stopWriter);
+    w->start(QThread::LowPriority);
+
+    return w;
+}
+
+inline QString suppressedText(const QString& text, qint32 suppressed)
+{
+    if (suppressed <= 0)
+    {
+        return text;
+    }
+
+    return QString("%1 [%2 similar messages suppressed]").arg(
+        text, QString::number(suppressed));
+}
+
+const char NonStdPrefix[] = "**NON-STANDARD BEHAVIOR**: ";
+}
+
+/*******************************************************************************
+ * HLogger
+ ******************************************************************************/
+HLogger::HLogger() :
+    m_methodName(0), m_logPrefix(0), m_fields(0)
+{
+}
+
+void HLogger::traceEntry(const char* at)
+{
+    dispatch(createRecord(Debug, m_logPrefix, m_methodName,
+        QString("Entering %1 @ %2").arg(m_methodName, at)));
+}
+
+void HLogger::traceExit()
+{
+    dispatch(createRecord(Debug, m_logPrefix, m_methodName,
+        QString("Exiting %1").arg(m_methodName)));
+}
+
+void HLogger::setField(Field field, const QString& value)
+{
+    if (!m_fields)
+    {
+        m_fields = new HLogFields();
+    }
+
+    switch(field)
+    {
+    case Peer:
+        m_fields->m_peer = value;
+        break;
+    case Sid:
+        m_fields->m_sid = value;
+        break;
+    case Usn:
+        m_fields->m_usn = value;
+        break;
+    }
+}
+
+void HLogger::clearFields()
+{
+    delete m_fields;
+    m_fields = 0;
+}
+
+Upnp::HLogRecord HLogger::createRecord(
+    qint32 level, const char* logPrefix, const char* methodName,
+    const QString& text)
+{
+    Upnp::HLogRecord record;
+    record.m_level = static_cast<Upnp::HLogLevel>(level);
+    record.m_timestamp = QDateTime::currentDateTimeUtc();
+    if (logPrefix)
+    {
+        record.m_identifier = QString::fromLatin1(logPrefix);
+    }
+    if (methodName)
+    {
+        record.m_function = QString::fromLatin1(methodName);
+    }
+    record.m_message = text;
+    return record;
+}
+
+void HLogger::dispatch(const Upnp::HLogRecord& record)
 {
-inline QString stmt(const char* prefix, const QString& text)
+    writer()->push(record);
+}
+
+void HLogger::flush()
+{
+    HLogWriter* w = s_writer;
+    if (w)
+    {
+        w->flush();
+    }
+}
+
+void HLogger::setSink(Upnp::HLogSink* sink)
 {
-    return (prefix ? QString(prefix) : QString()).append(text);
+    writer()->setSink(sink);
 }
+
+void HLogger::output(qint32 level, const QString& text, qint32 suppressed)
+{
+    Upnp::HLogRecord record = createRecord(
+        level, m_logPrefix, m_methodName, suppressedText(text, suppressed));
+
+    if (m_fields)
+    {
+        record.m_peer = m_fields->m_peer;
+        record.m_sid = m_fields->m_sid;
+        record.m_usn = m_fields->m_usn;
+    }
+
+    dispatch(record);
 }
 
-void HLogger::logDebug(const QString& text)
+void HLogger::logDebug(const QString& text, qint32 suppressed)
 {
-    qDebug() << stmt(m_logPrefix, text);
+    output(Debug, text, suppressed);
 }
 
-void HLogger::logWarning(const QString& text)
+void HLogger::logWarning(const QString& text, qint32 suppressed)
 {
-    qWarning() << stmt(m_logPrefix, text);
+    output(Warning, text, suppressed);
 }
 
-void HLogger::logWarningNonStd(const QString& text)
+void HLogger::logWarningNonStd(const QString& text, qint32 suppressed)
 {
     if (s_nonStdWarningsEnabled)
     {
-        qWarning() << stmt(
-            m_logPrefix, QString("**NON-STANDARD BEHAVIOR**: %1").arg(text));
+        output(Warning, QString(NonStdPrefix).append(text), suppressed);
     }
 }
 
-void HLogger::logInformation(const QString& text)
+void HLogger::logInformation(const QString& text, qint32 suppressed)
 {
-    qDebug() << stmt(m_logPrefix, text);
+    output(Information, text, suppressed);
 }
 
 void HLogger::logFatal(const QString& text)
 {
-    qFatal("%s", stmt(m_logPrefix, text).toLocal8Bit().data());
+    flush();
+    qFatal("%s", createRecord(Fatal, m_logPrefix, m_methodName, text).
+        toString().toLocal8Bit().data());
 }
 
 void HLogger::logCritical(const QString& text)
 {
-    qCritical() << stmt(m_logPrefix, text);
+    output(Critical, text, 0);
 }
 
 void HLogger::logDebug_(const QString& text)
 {
     if (traceLevel() >= Debug)
     {
-        qDebug() << text;
+        dispatch(createRecord(Debug, 0, 0, text));
     }
 }
 
@@ -113,7 +563,7 @@ void HLogger::logWarning_(const QString& text)
 {
     if (traceLevel() >= Warning)
     {
-        qWarning() << text;
+        dispatch(createRecord(Warning, 0, 0, text));
     }
 }
 
@@ -121,7 +571,8 @@ void HLogger::logWarningNonStd_(const QString& text)
 {
     if (traceLevel() && s_nonStdWarningsEnabled)
     {
-        qWarning() << QString("**NON-STANDARD BEHAVIOR**: %1").arg(text);
+        dispatch(createRecord(
+            Warning, 0, 0, QString(NonStdPrefix).append(text)));
     }
 }
 
@@ -129,7 +580,7 @@ void HLogger::logInformation_(const QString& text)
 {
     if (traceLevel() >= Information)
     {
-        qDebug() << text;
+        dispatch(createRecord(Information, 0, 0, text));
     }
 }
 
@@ -137,7 +588,7 @@ void HLogger::logCritical_(const QString& text)
 {
     if (traceLevel() >= Critical)
     {
-        qCritical() << text;
+        dispatch(createRecord(Critical, 0, 0, text));
     }
 }
 
@@ -145,6 +596,7 @@ void HLogger::logFatal_(const QString& text)
 {
     if (traceLevel() >= Fatal)
     {
+        flush();
         qFatal("%s", text.toLocal8Bit().data());
     }
 }
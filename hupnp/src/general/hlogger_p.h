@@ -32,11 +32,65 @@
 
 #include <HUpnpCore/HUpnp>
 
+#include <QtCore/QAtomicInt>
+
+#include <ctime>
+
 class QString;
 
 namespace Herqq
 {
 
+namespace Upnp
+{
+class HLogSink;
+class HLogRecord;
+}
+
+//
+// Limits the number of messages a single call site may output per second.
+// This is an aggregate so that a function-local static instance is
+// initialized statically and is thus safe to use from multiple threads.
+// It is defined inline, since the call sites are expanded in the code of
+// the other HUPnP libraries as well.
+//
+struct HLogRateLimit
+{
+    QBasicAtomicInt m_window;
+    QBasicAtomicInt m_count;
+
+    enum
+    {
+        MaxMessagesPerSecond = 20
+    };
+
+    // returns -1 if the message should be suppressed. otherwise returns
+    // the number of messages suppressed since the last message output.
+    inline qint32 acquire()
+    {
+        qint32 now = static_cast<qint32>(time(0));
+        qint32 window = m_window;
+
+        if (window != now && m_window.testAndSetRelaxed(window, now))
+        {
+            qint32 count = m_count.fetchAndStoreRelaxed(1);
+            return count > MaxMessagesPerSecond ?
+                count - MaxMessagesPerSecond : 0;
+        }
+
+        return m_count.fetchAndAddRelaxed(1) < MaxMessagesPerSecond ? 0 : -1;
+    }
+};
+
+#define H_LOG_RATE_LIMIT_INITIALIZER \
+    { Q_BASIC_ATOMIC_INITIALIZER(0), Q_BASIC_ATOMIC_INITIALIZER(0) }
+
+//
+// The structured fields of a log message. These are allocated only when
+// a call site sets a field.
+//
+struct HLogFields;
+
 //
 //
 //
@@ -48,10 +102,16 @@ private:
 
     const char* m_methodName;
     const char* m_logPrefix;
+    HLogFields* m_fields;
 
     static volatile int s_logLevel;
     static volatile bool s_nonStdWarningsEnabled;
 
+    void traceEntry(const char* at);
+    void traceExit();
+
+    void output(qint32 level, const QString& text, qint32 suppressed);
+
 public:
 
     enum HLogLevel
@@ -65,18 +125,56 @@ public:
         All = 6
     };
 
+    enum Field
+    {
+        Peer,
+        Sid,
+        Usn
+    };
+
 public:
 
     HLogger ();
-    HLogger (const char* at, const char* methodName, const char* logPrefix = 0);
-    ~HLogger();
+
+    inline HLogger(
+        const char* at, const char* methodName, const char* logPrefix = 0) :
+            m_methodName(methodName), m_logPrefix(logPrefix), m_fields(0)
+    {
+#ifndef H_DISABLE_TRACING
+        if (traceLevel() == All)
+        {
+            traceEntry(at);
+        }
+#else
+        Q_UNUSED(at)
+#endif
+    }
+
+    inline ~HLogger()
+    {
+#ifndef H_DISABLE_TRACING
+        if (traceLevel() == All)
+        {
+            traceExit();
+        }
+#endif
+        if (m_fields)
+        {
+            clearFields();
+        }
+    }
+
+    // sets a structured field for the messages subsequently logged through
+    // this instance.
+    void setField(Field field, const QString& value);
+    void clearFields();
 
     // the instance methods log the method name if it was specified. static
     // equivalents do not.
-    void logDebug        (const QString& text);
-    void logWarning      (const QString& text);
-    void logWarningNonStd(const QString& text);
-    void logInformation  (const QString& text);
+    void logDebug        (const QString& text, qint32 suppressed = 0);
+    void logWarning      (const QString& text, qint32 suppressed = 0);
+    void logWarningNonStd(const QString& text, qint32 suppressed = 0);
+    void logInformation  (const QString& text, qint32 suppressed = 0);
     void logCritical     (const QString& text);
     void logFatal        (const QString& text);
 
@@ -101,8 +199,26 @@ public:
     static void logInformation_  (const QString& text);
     static void logCritical_     (const QString& text);
     static void logFatal_        (const QString& text);
+
+    static Upnp::HLogRecord createRecord(
+        qint32 level, const char* logPrefix, const char* methodName,
+        const QString& text);
+
+    // passes the record to the writer thread, or writes it directly if the
+    // writer is no longer running.
+    static void dispatch(const Upnp::HLogRecord&);
+
+    // waits until the messages logged so far have been written.
+    static void flush();
+
+    static void setSink(Upnp::HLogSink*);
 };
 
+//
+// Entry and exit tracing can be compiled out by defining H_DISABLE_TRACING
+// (CONFIG += DISABLE_TRACING when running qmake). The HLOG_ macros that
+// output messages remain functional.
+//
 #define HLOG(at, fun) \
     Herqq::HLogger herqqLog__(at, fun);
 
@@ -113,26 +229,41 @@ public:
     if (Herqq::HLogger::traceLevel() < Herqq::HLogger::level) ; \
     else
 
+#define CHECK_RATE(level, call) \
+    CHECK_LEVEL(level) \
+    { \
+        static Herqq::HLogRateLimit herqqRateLimit__ = \
+            H_LOG_RATE_LIMIT_INITIALIZER; \
+        qint32 herqqSuppressed__ = herqqRateLimit__.acquire(); \
+        if (herqqSuppressed__ >= 0) \
+        { \
+            herqqLog__.call; \
+        } \
+    }
+
+#define HLOG_FIELD(field, value) \
+    CHECK_LEVEL(Warning) herqqLog__.setField(Herqq::HLogger::field, value);
+
 #define HLOG_WARN(text) \
-    CHECK_LEVEL(Warning) herqqLog__.logWarning(text);
+    CHECK_RATE(Warning, logWarning(text, herqqSuppressed__))
 
 #define HLOG_WARN_AT(text, at) \
     CHECK_LEVEL(Warning) herqqLog__.logWarning(text, at);
 
 #define HLOG_WARN_NONSTD(text) \
-    CHECK_LEVEL(Warning) herqqLog__.logWarningNonStd(text);
+    CHECK_RATE(Warning, logWarningNonStd(text, herqqSuppressed__))
 
 #define HLOG_WARN_NONSTD_AT(text, at) \
     CHECK_LEVEL(Warning) herqqLog__.logWarning(text, at);
 
 #define HLOG_DBG(text) \
-    CHECK_LEVEL(Debug) herqqLog__.logDebug(text);
+    CHECK_RATE(Debug, logDebug(text, herqqSuppressed__))
 
 #define HLOG_DBG_AT(text, at) \
     CHECK_LEVEL(Debug) herqqLog__.logDebug(text, at);
 
 #define HLOG_INFO(text) \
-    CHECK_LEVEL(Information) herqqLog__.logInformation(text);
+    CHECK_RATE(Information, logInformation(text, herqqSuppressed__))
 
 #define HLOG_INFO_AT(text, at) \
     CHECK_LEVEL(Information) herqqLog__.logInformation(text, at);
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HLOGSINK_H_
+#define HLOGSINK_H_
+
+#include <HUpnpCore/HUpnp>
+
+#include <QtCore/QString>
+#include <QtCore/QDateTime>
+
+/*!
+ * \file
+ * This file contains the types used to direct the log output of HUPnP.
+ */
+
+namespace Herqq
+{
+
+class HLogger;
+
+namespace Upnp
+{
+
+/*!
+ * \brief This class contains a single log message generated by HUPnP.
+ *
+ * Besides the message text, a log record contains the structured information
+ * HUPnP knows of the context in which the message was generated, such as the
+ * logging identifier of the component and the network peer, subscription
+ * identifier and unique service name the message concerns. The fields that
+ * are not known are empty.
+ *
+ * \headerfile hlogsink.h HLogRecord
+ *
+ * \ingroup hupnp_common
+ *
+ * \sa HLogSink
+ */
+class H_UPNP_CORE_EXPORT HLogRecord
+{
+friend class Herqq::HLogger;
+
+private:
+
+    HLogLevel m_level;
+    QDateTime m_timestamp;
+    QString m_identifier;
+    QString m_function;
+    QString m_message;
+    QString m_peer;
+    QString m_sid;
+    QString m_usn;
+
+public:
+
+    /*!
+     * \brief Creates a new, empty instance.
+     */
+    HLogRecord();
+
+    /*!
+     * \brief Returns the level of the message.
+     *
+     * \return The level of the message.
+     */
+    inline HLogLevel level() const { return m_level; }
+
+    /*!
+     * \brief Returns the time the message was generated.
+     *
+     * \return The time the message was generated.
+     */
+    inline QDateTime timestamp() const { return m_timestamp; }
+
+    /*!
+     * \brief Returns the logging identifier of the component that generated
+     * the message.
+     *
+     * \return The logging identifier of the component that generated
+     * the message, such as <c>__DEVICE HOST__: </c>.
+     */
+    inline QString identifier() const { return m_identifier; }
+
+    /*!
+     * \brief Returns the name of the function that generated the message.
+     *
+     * \return The name of the function that generated the message.
+     */
+    inline QString function() const { return m_function; }
+
+    /*!
+     * \brief Returns the text of the message.
+     *
+     * \return The text of the message.
+     */
+    inline QString message() const { return m_message; }
+
+    /*!
+     * \brief Returns the network peer the message concerns.
+     *
+     * \return The network peer the message concerns, usually in the
+     * format <c>address:port</c>.
+     */
+    inline QString peer() const { return m_peer; }
+
+    /*!
+     * \brief Returns the event subscription identifier the message concerns.
+     *
+     * \return The event subscription identifier the message concerns.
+     */
+    inline QString sid() const { return m_sid; }
+
+    /*!
+     * \brief Returns the unique service name the message concerns.
+     *
+     * \return The unique service name the message concerns.
+     */
+    inline QString usn() const { return m_usn; }
+
+    /*!
+     * \brief Returns the message formatted the way HUPnP outputs it by default.
+     *
+     * \return The message formatted the way HUPnP outputs it by default, which
+     * is the identifier followed by the message text.
+     */
+    QString toString() const;
+};
+
+/*!
+ * \brief This is an abstract base class for receiving the log output of HUPnP.
+ *
+ * By default HUPnP writes its log output using \c qDebug(), \c qWarning()
+ * and \c qCritical(). You can direct the output elsewhere by deriving from
+ * this class and setting an instance with SetLogSink().
+ *
+ * The messages are delivered to the sink from a dedicated thread. The threads
+ * generating the messages only copy them into a fixed-size buffer and never
+ * wait for the sink. If the buffer is full, messages are dropped and
+ * the number of dropped messages is reported in a subsequent message.
+ * Once the dedicated thread has been stopped, which happens when the
+ * QCoreApplication instance is destroyed, the messages are written
+ * synchronously by the threads generating them.
+ *
+ * \headerfile hlogsink.h HLogSink
+ *
+ * \ingroup hupnp_common
+ *
+ * \sa SetLogSink(), HLogRecord
+ */
+class H_UPNP_CORE_EXPORT HLogSink
+{
+H_DISABLE_COPY(HLogSink)
+
+protected:
+
+    /*!
+     * \brief Creates a new instance.
+     */
+    HLogSink();
+
+public:
+
+    /*!
+     * \brief Destroys the instance.
+     */
+    virtual ~HLogSink() = 0;
+
+    /*!
+     * \brief Writes a log message.
+     *
+     * \param record specifies the log message.
+     *
+     * \remarks This is called from the thread dedicated for logging until
+     * that thread is stopped when the QCoreApplication instance is destroyed.
+     * After that this is called from the threads generating the messages.
+     * In either case the calls never overlap.
+     */
+    virtual void write(const HLogRecord& record) = 0;
+};
+
+/*!
+ * \brief Sets the object that receives the log output of HUPnP.
+ *
+ * \param sink specifies the object that receives the log output of HUPnP.
+ * If this is null, the default output is restored.
+ *
+ * \remarks
+ * \li the ownership of the sink is \b not transferred. However, once this
+ * function returns, the previous sink is no longer used and it can be deleted.
+ * \li fatal messages are always output with \c qFatal() from the thread
+ * that generated them.
+ * \li The function is thread-safe.
+ *
+ * \ingroup hupnp_common
+ */
+void H_UPNP_CORE_EXPORT SetLogSink(HLogSink* sink);
+
+}
+}
+
+#endif /* HLOGSINK_H_ */
@@ -0,0 +1,270 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hmetrics.h"
+#include "hmetrics_p.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace
+{
+// splits "name{labels}" into "name" and "labels"
+void splitName(const QString& name, QString* base, QString* labels)
+{
+    qint32 index = name.indexOf('{');
+    if (index < 0)
+    {
+        *base = name;
+        labels->clear();
+    }
+    else
+    {
+        *base = name.left(index);
+        *labels = name.mid(index + 1, name.size() - index - 2);
+    }
+}
+
+void writeValues(
+    QTextStream& out, const QMap<QString, qint64>& values, const char* type)
+{
+    QSet<QString> typesWritten;
+
+    QMap<QString, qint64>::const_iterator it = values.constBegin();
+    for(; it != values.constEnd(); ++it)
+    {
+        QString base, labels;
+        splitName(it.key(), &base, &labels);
+
+        if (!typesWritten.contains(base))
+        {
+            out << "# TYPE " << base << " " << type << "\n";
+            typesWritten.insert(base);
+        }
+
+        out << it.key() << " " << it.value() << "\n";
+    }
+}
+
+inline QString withLabels(
+    const QString& name, const QString& labels, const QString& extra = QString())
+{
+    if (labels.isEmpty() && extra.isEmpty())
+    {
+        return name;
+    }
+    else if (labels.isEmpty())
+    {
+        return QString("%1{%2}").arg(name, extra);
+    }
+    else if (extra.isEmpty())
+    {
+        return QString("%1{%2}").arg(name, labels);
+    }
+
+    return QString("%1{%2,%3}").arg(name, labels, extra);
+}
+}
+
+/*******************************************************************************
+ * HLatencyHistogramPrivate
+ ******************************************************************************/
+HLatencyHistogramPrivate::HLatencyHistogramPrivate() :
+    m_upperBounds(), m_bucketCounts(), m_sum(0), m_count(0)
+{
+}
+
+/*******************************************************************************
+ * HLatencyHistogram
+ ******************************************************************************/
+HLatencyHistogram::HLatencyHistogram() :
+    h_ptr(new HLatencyHistogramPrivate())
+{
+}
+
+HLatencyHistogram::HLatencyHistogram(const HLatencyHistogram& other) :
+    h_ptr(other.h_ptr)
+{
+    Q_ASSERT(&other != this);
+}
+
+HLatencyHistogram::~HLatencyHistogram()
+{
+}
+
+HLatencyHistogram& HLatencyHistogram::operator=(const HLatencyHistogram& other)
+{
+    Q_ASSERT(&other != this);
+    h_ptr = other.h_ptr;
+    return *this;
+}
+
+bool HLatencyHistogram::isEmpty() const
+{
+    return !h_ptr->m_count;
+}
+
+QList<qint32> HLatencyHistogram::upperBounds() const
+{
+    return h_ptr->m_upperBounds;
+}
+
+QList<qint64> HLatencyHistogram::bucketCounts() const
+{
+    return h_ptr->m_bucketCounts;
+}
+
+qint64 HLatencyHistogram::sum() const
+{
+    return h_ptr->m_sum;
+}
+
+qint64 HLatencyHistogram::count() const
+{
+    return h_ptr->m_count;
+}
+
+/*******************************************************************************
+ * HMetricsPrivate
+ ******************************************************************************/
+HMetricsPrivate::HMetricsPrivate() :
+    m_counters(), m_gauges(), m_histograms()
+{
+}
+
+/*******************************************************************************
+ * HMetrics
+ ******************************************************************************/
+HMetrics::HMetrics() :
+    h_ptr(new HMetricsPrivate())
+{
+}
+
+HMetrics::HMetrics(const HMetrics& other) :
+    h_ptr(other.h_ptr)
+{
+    Q_ASSERT(&other != this);
+}
+
+HMetrics::~HMetrics()
+{
+}
+
+HMetrics& HMetrics::operator=(const HMetrics& other)
+{
+    Q_ASSERT(&other != this);
+    h_ptr = other.h_ptr;
+    return *this;
+}
+
+QStringList HMetrics::counterNames() const
+{
+    return h_ptr->m_counters.keys();
+}
+
+QStringList HMetrics::gaugeNames() const
+{
+    return h_ptr->m_gauges.keys();
+}
+
+QStringList HMetrics::histogramNames() const
+{
+    return h_ptr->m_histograms.keys();
+}
+
+qint64 HMetrics::counter(const QString& name) const
+{
+    return h_ptr->m_counters.value(name);
+}
+
+qint64 HMetrics::gauge(const QString& name) const
+{
+    return h_ptr->m_gauges.value(name);
+}
+
+HLatencyHistogram HMetrics::histogram(const QString& name) const
+{
+    return h_ptr->m_histograms.value(name);
+}
+
+void HMetrics::setGauge(const QString& name, qint64 value)
+{
+    h_ptr->m_gauges.insert(name, value);
+}
+
+QString HMetrics::toPrometheusText() const
+{
+    QString retVal;
+    QTextStream out(&retVal);
+
+    writeValues(out, h_ptr->m_counters, "counter");
+    writeValues(out, h_ptr->m_gauges, "gauge");
+
+    QSet<QString> typesWritten;
+
+    QMap<QString, HLatencyHistogram>::const_iterator it =
+        h_ptr->m_histograms.constBegin();
+
+    for(; it != h_ptr->m_histograms.constEnd(); ++it)
+    {
+        QString base, labels;
+        splitName(it.key(), &base, &labels);
+
+        if (!typesWritten.contains(base))
+        {
+            out << "# TYPE " << base << " histogram\n";
+            typesWritten.insert(base);
+        }
+
+        const HLatencyHistogram& hist = it.value();
+
+        QList<qint32> upperBounds = hist.upperBounds();
+        QList<qint64> bucketCounts = hist.bucketCounts();
+
+        qint64 cumulative = 0;
+        for(qint32 i = 0; i < bucketCounts.size(); ++i)
+        {
+            cumulative += bucketCounts.at(i);
+
+            QString le = i < upperBounds.size() ?
+                QString::number(upperBounds.at(i)) : QString("+Inf");
+
+            out << withLabels(
+                base + "_bucket", labels, QString("le=\"%1\"").arg(le))
+                << " " << cumulative << "\n";
+        }
+
+        out << withLabels(base + "_sum", labels) << " " << hist.sum() << "\n";
+        out << withLabels(base + "_count", labels) << " " << hist.count() << "\n";
+    }
+
+    out.flush();
+    return retVal;
+}
+
+}
+}
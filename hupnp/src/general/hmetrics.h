@@ -0,0 +1,282 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HMETRICS_H_
+#define HMETRICS_H_
+
+#include <HUpnpCore/HUpnp>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QSharedDataPointer>
+
+/*!
+ * \file
+ * This file contains the types used to inspect the runtime metrics of HUPnP.
+ */
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+class HMetricsRegistry;
+class HMetricsPrivate;
+class HLatencyHistogramPrivate;
+
+/*!
+ * \brief This class contains the distribution of the durations of an operation.
+ *
+ * The durations are counted in buckets specified in milliseconds. A duration
+ * is counted in the first bucket whose upper bound it does not exceed.
+ * The last bucket has no upper bound.
+ *
+ * \headerfile hmetrics.h HLatencyHistogram
+ *
+ * \ingroup hupnp_common
+ *
+ * \sa HMetrics
+ */
+class H_UPNP_CORE_EXPORT HLatencyHistogram
+{
+friend class HMetricsRegistry;
+
+private:
+
+    QSharedDataPointer<HLatencyHistogramPrivate> h_ptr;
+
+public:
+
+    /*!
+     * \brief Creates a new, empty instance.
+     *
+     * \sa isEmpty()
+     */
+    HLatencyHistogram();
+
+    /*!
+     * \brief Copy constructor.
+     *
+     * Creates a copy of \c other.
+     */
+    HLatencyHistogram(const HLatencyHistogram& other);
+
+    /*!
+     * \brief Destroys the instance.
+     */
+    ~HLatencyHistogram();
+
+    /*!
+     * \brief Assignment operator.
+     *
+     * Copies the contents of \c other to this.
+     */
+    HLatencyHistogram& operator=(const HLatencyHistogram& other);
+
+    /*!
+     * \brief Indicates whether the histogram contains any durations.
+     *
+     * \return \e true in case the histogram contains no durations.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Returns the upper bounds of the buckets in milliseconds.
+     *
+     * \return The upper bounds of the buckets in milliseconds. The last
+     * bucket has no upper bound and thus it is not included.
+     */
+    QList<qint32> upperBounds() const;
+
+    /*!
+     * \brief Returns the number of durations in each bucket.
+     *
+     * \return The number of durations in each bucket. The list contains one
+     * item more than upperBounds().
+     */
+    QList<qint64> bucketCounts() const;
+
+    /*!
+     * \brief Returns the sum of the durations in milliseconds.
+     *
+     * \return The sum of the durations in milliseconds.
+     */
+    qint64 sum() const;
+
+    /*!
+     * \brief Returns the number of durations.
+     *
+     * \return The number of durations.
+     */
+    qint64 count() const;
+};
+
+/*!
+ * \brief This class contains a snapshot of the runtime metrics of HUPnP.
+ *
+ * The metrics are named using the conventions of Prometheus. The name of a
+ * metric may contain labels, as in
+ * <c>hupnp_http_requests_total{method="GET"}</c>. The following metrics
+ * are available:
+ *
+ * - \c hupnp_http_requests_total{method}: HTTP requests received
+ * - \c hupnp_http_responses_total{status}: HTTP responses sent
+ * - \c hupnp_http_failures_total: HTTP messaging failures
+ * - \c hupnp_ssdp_messages_received_total: SSDP messages received
+ * - \c hupnp_ssdp_messages_dropped_total: SSDP messages ignored
+ * as invalid
+ * - \c hupnp_ssdp_messages_sent_total and
+ * \c hupnp_ssdp_send_failures_total: SSDP messages sent
+ * - \c hupnp_gena_notifications_total: event messages queued for
+ * subscribers
+ * - \c hupnp_gena_multicast_notifications_total: multicast event
+ * messages sent
+ * - \c hupnp_action_duration_milliseconds{side,action}: the durations of
+ * action invocations. The \c side is \c server for actions invoked on
+ * a device host and \c client for actions invoked by a control point.
+ * - \c hupnp_action_cache_hits_total{action},
+ * \c hupnp_action_cache_misses_total{action} and
+ * \c hupnp_action_cache_invalidations_total{action}: the use of the cached
+ * results of the idempotent actions of a control point. Every hit is a
+ * round-trip saved.
+ *
+ * In addition, the snapshot of an HDeviceHost contains the gauges
+ * \c hupnp_gena_subscriber_queue_length{sid,callback} and
+ * \c hupnp_gena_subscribers_suspended, and the snapshot of an HControlPoint
+ * contains the gauges \c hupnp_root_devices and \c hupnp_gena_subscriptions.
+ *
+ * \headerfile hmetrics.h HMetrics
+ *
+ * \ingroup hupnp_common
+ *
+ * \remarks The counters and histograms are shared by all the HDeviceHost
+ * and HControlPoint instances in a process.
+ *
+ * \sa HDeviceHost::metrics(), HControlPoint::metrics()
+ */
+class H_UPNP_CORE_EXPORT HMetrics
+{
+friend class HMetricsRegistry;
+
+private:
+
+    QSharedDataPointer<HMetricsPrivate> h_ptr;
+
+public:
+
+    /*!
+     * \brief Creates a new, empty instance.
+     */
+    HMetrics();
+
+    /*!
+     * \brief Copy constructor.
+     *
+     * Creates a copy of \c other.
+     */
+    HMetrics(const HMetrics& other);
+
+    /*!
+     * \brief Destroys the instance.
+     */
+    ~HMetrics();
+
+    /*!
+     * \brief Assignment operator.
+     *
+     * Copies the contents of \c other to this.
+     */
+    HMetrics& operator=(const HMetrics& other);
+
+    /*!
+     * \brief Returns the names of the counters.
+     *
+     * \return The names of the counters.
+     */
+    QStringList counterNames() const;
+
+    /*!
+     * \brief Returns the names of the gauges.
+     *
+     * \return The names of the gauges.
+     */
+    QStringList gaugeNames() const;
+
+    /*!
+     * \brief Returns the names of the histograms.
+     *
+     * \return The names of the histograms.
+     */
+    QStringList histogramNames() const;
+
+    /*!
+     * \brief Returns the value of the specified counter.
+     *
+     * \param name specifies the name of the counter, including the labels.
+     *
+     * \return The value of the specified counter, or zero if the counter
+     * does not exist.
+     */
+    qint64 counter(const QString& name) const;
+
+    /*!
+     * \brief Returns the value of the specified gauge.
+     *
+     * \param name specifies the name of the gauge, including the labels.
+     *
+     * \return The value of the specified gauge, or zero if the gauge
+     * does not exist.
+     */
+    qint64 gauge(const QString& name) const;
+
+    /*!
+     * \brief Returns the specified histogram.
+     *
+     * \param name specifies the name of the histogram, including the labels.
+     *
+     * \return The specified histogram, which is empty if the histogram
+     * does not exist.
+     */
+    HLatencyHistogram histogram(const QString& name) const;
+
+    /*!
+     * \brief Sets the value of a gauge.
+     *
+     * \param name specifies the name of the gauge, including the labels.
+     *
+     * \param value specifies the value of the gauge.
+     */
+    void setGauge(const QString& name, qint64 value);
+
+    /*!
+     * \brief Returns the metrics in the Prometheus text exposition format.
+     *
+     * \return The metrics in the Prometheus text exposition format.
+     */
+    QString toPrometheusText() const;
+};
+
+}
+}
+
+#endif /* HMETRICS_H_ */
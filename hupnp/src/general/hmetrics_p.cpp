@@ -0,0 +1,221 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hmetrics_p.h"
+#include "hmetrics.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QMutexLocker>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace
+{
+const char* const CounterNames[HMetricsRegistry::CounterCount] =
+{
+    "hupnp_ssdp_messages_received_total",
+    "hupnp_ssdp_messages_dropped_total",
+    "hupnp_ssdp_messages_sent_total",
+    "hupnp_ssdp_send_failures_total",
+    "hupnp_http_failures_total",
+    "hupnp_gena_notifications_total",
+    "hupnp_gena_multicast_notifications_total"
+};
+
+// the sum shards of the histograms are updated rarely enough for a spin lock
+inline void lockShard(QBasicAtomicInt& lock)
+{
+    while(!lock.testAndSetAcquire(0, 1))
+    {
+        QThread::yieldCurrentThread();
+    }
+}
+
+inline void unlockShard(QBasicAtomicInt& lock)
+{
+    lock.fetchAndStoreRelease(0);
+}
+
+QMutex s_registryMutex;
+QHash<QString, HMetricCounter*> s_namedCounters;
+QHash<QString, HMetricHistogram*> s_namedHistograms;
+}
+
+/*******************************************************************************
+ * HMetricCounter
+ ******************************************************************************/
+qint32 HMetricCounter::shardIndex()
+{
+    quintptr id = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    // thread identifiers are often aligned addresses, so the low bits
+    // alone would map most threads to the same shard
+    id ^= id >> 16;
+    id *= 0x45d9f3b;
+    id ^= id >> 16;
+
+    return static_cast<qint32>(id & (ShardCount - 1));
+}
+
+qint64 HMetricCounter::value() const
+{
+    qint64 retVal = 0;
+    for(qint32 i = 0; i < ShardCount; ++i)
+    {
+        qint32 value = m_shards[i].m_value;
+        retVal += static_cast<quint32>(value);
+    }
+    return retVal;
+}
+
+/*******************************************************************************
+ * HMetricHistogram
+ ******************************************************************************/
+const qint32 HMetricHistogram::UpperBounds[BucketCount - 1] =
+{
+    1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000
+};
+
+void HMetricHistogram::add(qint32 msecs)
+{
+    qint32 i = 0;
+    for(; i < BucketCount - 1; ++i)
+    {
+        if (msecs <= UpperBounds[i])
+        {
+            break;
+        }
+    }
+
+    m_buckets[i].fetchAndAddRelaxed(1);
+    m_count.fetchAndAddRelaxed(1);
+
+    SumShard& shard = m_sums[HMetricCounter::shardIndex()];
+    lockShard(shard.m_lock);
+    shard.m_value += msecs;
+    unlockShard(shard.m_lock);
+}
+
+qint64 HMetricHistogram::sum()
+{
+    qint64 retVal = 0;
+    for(qint32 i = 0; i < HMetricCounter::ShardCount; ++i)
+    {
+        SumShard& shard = m_sums[i];
+        lockShard(shard.m_lock);
+        retVal += shard.m_value;
+        unlockShard(shard.m_lock);
+    }
+    return retVal;
+}
+
+/*******************************************************************************
+ * HMetricsRegistry
+ ******************************************************************************/
+HMetricCounter HMetricsRegistry::s_counters[CounterCount];
+
+HMetricCounter* HMetricsRegistry::counter(const QString& name)
+{
+    QMutexLocker lock(&s_registryMutex);
+
+    HMetricCounter*& counter = s_namedCounters[name];
+    if (!counter)
+    {
+        counter = new HMetricCounter();
+    }
+
+    return counter;
+}
+
+HMetricHistogram* HMetricsRegistry::histogram(const QString& name)
+{
+    QMutexLocker lock(&s_registryMutex);
+
+    HMetricHistogram*& histogram = s_namedHistograms[name];
+    if (!histogram)
+    {
+        histogram = new HMetricHistogram();
+    }
+
+    return histogram;
+}
+
+QString HMetricsRegistry::label(const QString& value)
+{
+    QString retVal(value);
+    retVal.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return retVal;
+}
+
+HMetrics HMetricsRegistry::snapshot()
+{
+    HMetrics retVal;
+
+    for(qint32 i = 0; i < CounterCount; ++i)
+    {
+        retVal.h_ptr->m_counters.insert(CounterNames[i], s_counters[i].value());
+    }
+
+    QMutexLocker lock(&s_registryMutex);
+
+    QHash<QString, HMetricCounter*>::const_iterator cit =
+        s_namedCounters.constBegin();
+
+    for(; cit != s_namedCounters.constEnd(); ++cit)
+    {
+        retVal.h_ptr->m_counters.insert(cit.key(), cit.value()->value());
+    }
+
+    QHash<QString, HMetricHistogram*>::const_iterator hit =
+        s_namedHistograms.constBegin();
+
+    for(; hit != s_namedHistograms.constEnd(); ++hit)
+    {
+        HMetricHistogram* source = hit.value();
+
+        HLatencyHistogram hist;
+        HLatencyHistogramPrivate* histData = hist.h_ptr.data();
+        for(qint32 i = 0; i < HMetricHistogram::BucketCount; ++i)
+        {
+            if (i < HMetricHistogram::BucketCount - 1)
+            {
+                histData->m_upperBounds.append(HMetricHistogram::UpperBounds[i]);
+            }
+            histData->m_bucketCounts.append(source->m_buckets[i]);
+        }
+
+        histData->m_sum = source->sum();
+        histData->m_count = source->m_count;
+
+        retVal.h_ptr->m_histograms.insert(hit.key(), hist);
+    }
+
+    return retVal;
+}
+
+}
+}
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HMETRICS_P_H_
+#define HMETRICS_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "hmetrics.h"
+
+#include <QtCore/QMap>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSharedData>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+//
+// A counter split into shards, each on its own cache line. A thread always
+// increments the same shard, which keeps threads from contending on a single
+// cache line. This is an aggregate so that it can be zero-initialized
+// statically.
+//
+struct HMetricCounter
+{
+    enum
+    {
+        ShardCount = 16,
+        CacheLineSize = 64
+    };
+
+    struct Shard
+    {
+        QBasicAtomicInt m_value;
+        char m_padding[CacheLineSize - sizeof(QBasicAtomicInt)];
+    };
+
+    Shard m_shards[ShardCount];
+
+    static qint32 shardIndex();
+
+    inline void add(qint32 value = 1)
+    {
+        m_shards[shardIndex()].m_value.fetchAndAddRelaxed(value);
+    }
+
+    qint64 value() const;
+};
+
+//
+// Distribution of durations in milliseconds. The operations measured are
+// orders of magnitude more expensive than contention on these atomics,
+// so the buckets are not sharded.
+//
+// Qt 4 has no 64-bit atomics and a 32-bit sum of milliseconds wraps once
+// the durations add up to 24 days. The sum is therefore kept in 64-bit
+// shards, each guarded by a spin lock of its own and indexed the same way
+// as the shards of HMetricCounter.
+//
+struct HMetricHistogram
+{
+    enum
+    {
+        BucketCount = 14
+    };
+
+    struct SumShard
+    {
+        qint64 m_value;
+        QBasicAtomicInt m_lock;
+        char m_padding[
+            HMetricCounter::CacheLineSize - sizeof(qint64) - sizeof(QBasicAtomicInt)];
+    };
+
+    static const qint32 UpperBounds[BucketCount - 1];
+
+    QBasicAtomicInt m_buckets[BucketCount];
+    QBasicAtomicInt m_count;
+    SumShard m_sums[HMetricCounter::ShardCount];
+
+    void add(qint32 msecs);
+
+    qint64 sum();
+};
+
+//
+// Implementation details of HLatencyHistogram
+//
+class HLatencyHistogramPrivate :
+    public QSharedData
+{
+public:
+
+    QList<qint32> m_upperBounds;
+    QList<qint64> m_bucketCounts;
+    qint64 m_sum;
+    qint64 m_count;
+
+    HLatencyHistogramPrivate();
+};
+
+//
+// Implementation details of HMetrics
+//
+class HMetricsPrivate :
+    public QSharedData
+{
+public:
+
+    QMap<QString, qint64> m_counters;
+    QMap<QString, qint64> m_gauges;
+    QMap<QString, HLatencyHistogram> m_histograms;
+
+    HMetricsPrivate();
+};
+
+//
+// The process-wide registry of the metrics HUPnP collects.
+//
+class H_UPNP_CORE_EXPORT HMetricsRegistry
+{
+H_DISABLE_COPY(HMetricsRegistry)
+
+public:
+
+    enum Counter
+    {
+        SsdpMessagesReceived = 0,
+        SsdpMessagesDropped,
+        SsdpMessagesSent,
+        SsdpSendFailures,
+        HttpFailures,
+        GenaNotifications,
+        GenaMulticastNotifications,
+        CounterCount
+    };
+
+private:
+
+    static HMetricCounter s_counters[CounterCount];
+
+    HMetricsRegistry();
+
+public:
+
+    inline static void add(Counter counter, qint32 value = 1)
+    {
+        s_counters[counter].add(value);
+    }
+
+    // returns the counter with the specified name. the counter is created
+    // on the first call and it is never deleted.
+    static HMetricCounter* counter(const QString& name);
+
+    // returns the histogram with the specified name. the histogram is created
+    // on the first call and it is never deleted.
+    static HMetricHistogram* histogram(const QString& name);
+
+    // escapes a value for use as a label value
+    static QString label(const QString& value);
+
+    static HMetrics snapshot();
+};
+
+}
+}
+
+#endif /* HMETRICS_P_H_ */
@@ -77,6 +77,7 @@ class HDeviceInfo;
 class HServiceInfo;
 class HActionArgument;
 class HActionArguments;
+class HActionCodec;
 class HStateVariableInfo;
 class HStateVariableEvent;
 
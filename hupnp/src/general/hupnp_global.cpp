@@ -152,6 +152,16 @@ namespace Upnp
  * function Herqq::Upnp::SetLoggingLevel() with a desired \e level argument.
  * Include \c HUpnp to use the Herqq::Upnp::SetLoggingLevel().
  *
+ * The log output is written from a dedicated thread and by default it is
+ * output using \c qDebug(), \c qWarning() and \c qCritical(). You can direct
+ * the output elsewhere by calling Herqq::Upnp::SetLogSink() with an instance
+ * of your own Herqq::Upnp::HLogSink. A single message repeated very frequently
+ * is output at most 20 times per second.
+ *
+ * In addition, the function enter and exit messages of the \c All level can be
+ * removed from the build entirely by running
+ * <c>qmake -recursive "CONFIG += DISABLE_TRACING"</c>.
+ *
  * \subsection deployment Deployment
  *
  * You can run \c make \c install after compiling the project to copy the
@@ -172,6 +172,8 @@ public:
     // the data of the response
     inline QByteArray dataRead() const { return m_dataRead; }
 
+    inline QByteArray dataToSend() const { return m_dataToSend; }
+
     // the header of the response
     inline const HHttpHeader* headerRead() const { return m_headerRead; }
 
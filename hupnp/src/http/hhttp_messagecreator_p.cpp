@@ -32,6 +32,8 @@
 
 #include <QtSoapMessage>
 
+#include <QtCore/QTextStream>
+
 namespace Herqq
 {
 
@@ -360,6 +362,11 @@ QByteArray HHttpMessageCreator::create(
         }
         requestHdr.setValue("CALLBACK", HHttpUtils::callbackAsStr(req.callbacks()));
         requestHdr.setValue("NT", req.nt().typeToString());
+
+        if (!req.localServer().isEmpty())
+        {
+            requestHdr.setValue(HHttpUtils::localServerHeader(), req.localServer());
+        }
     }
     else
     {
@@ -444,6 +451,62 @@ int HHttpMessageCreator::create(
     return retVal;
 }
 
+QByteArray HHttpMessageCreator::create(const HMulticastNotifyRequest& req)
+{
+    Q_ASSERT(req.isValid(false));
+
+    QString retVal;
+    QTextStream ts(&retVal);
+
+    ts << "NOTIFY * HTTP/1.0\r\n"
+       << "HOST: 239.255.255.246:7900\r\n"
+       << "CONTENT-TYPE: text/xml; charset=\"utf-8\"\r\n"
+       << "USN: "   << req.usn().toString() << "\r\n"
+       << "SVCID: " << req.serviceId().toString() << "\r\n"
+       << "NT: upnp:event\r\n"
+       << "NTS: upnp:propchange\r\n"
+       << "SEQ: "   << req.seq() << "\r\n"
+       << "LVL: "   << req.level() << "\r\n";
+
+    if (req.bootId() >= 0)
+    {
+        ts << "BOOTID.UPNP.ORG: " << req.bootId() << "\r\n";
+    }
+
+    ts << "CONTENT-LENGTH: " << req.data().size() << "\r\n"
+       << "\r\n";
+
+    ts.flush();
+
+    return retVal.toUtf8().append(req.data());
+}
+
+int HHttpMessageCreator::create(
+    const HHttpRequestHeader& reqHdr, const QByteArray& body,
+    HMulticastNotifyRequest& req)
+{
+    HLOG(H_AT, H_FUN);
+
+    HMulticastNotifyRequest nreq;
+    HMulticastNotifyRequest::RetVal retVal =
+        nreq.setContents(
+            reqHdr.value("NT"),
+            reqHdr.value("NTS"),
+            reqHdr.value("USN"),
+            reqHdr.value("SVCID"),
+            reqHdr.value("SEQ"),
+            reqHdr.value("LVL"),
+            reqHdr.value("BOOTID.UPNP.ORG"),
+            body);
+
+    if (retVal == HMulticastNotifyRequest::Success)
+    {
+        req = nreq;
+    }
+
+    return retVal;
+}
+
 int HHttpMessageCreator::create(
     const HHttpRequestHeader& reqHdr, HSubscribeRequest& req)
 {
@@ -483,6 +546,8 @@ int HHttpMessageCreator::create(
         retVal = HSubscribeRequest::BadRequest;
     }
 
+    sreq.setLocalServer(reqHdr.value(HHttpUtils::localServerHeader()).trimmed());
+
     req = sreq;
     return retVal;
 }
@@ -45,6 +45,7 @@ namespace Upnp
 {
 
 class HNotifyRequest;
+class HMulticastNotifyRequest;
 class HSubscribeRequest;
 class HUnsubscribeRequest;
 class HSubscribeResponse;
@@ -97,11 +98,16 @@ public:
     static QByteArray create(const HSubscribeRequest&  , const HMessagingInfo&);
     static QByteArray create(const HUnsubscribeRequest&, HMessagingInfo*);
     static QByteArray create(const HSubscribeResponse& , const HMessagingInfo&);
+    static QByteArray create(const HMulticastNotifyRequest&);
 
     static int create(
         const HHttpRequestHeader& reqHdr, const QByteArray& body,
         HNotifyRequest& req);
 
+    static int create(
+        const HHttpRequestHeader& reqHdr, const QByteArray& body,
+        HMulticastNotifyRequest& req);
+
     static int create(
         const HHttpRequestHeader& reqHdr, HSubscribeRequest& req);
 
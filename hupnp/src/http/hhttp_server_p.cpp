@@ -27,6 +27,7 @@
 #include "hhttp_messagecreator_p.h"
 
 #include "../general/hlogger_p.h"
+#include "../general/hmetrics_p.h"
 #include "../utils/hmisc_utils_p.h"
 
 #include "../socket/hendpoint.h"
@@ -39,6 +40,7 @@
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
 #include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QLocalSocket>
 
 namespace Herqq
 {
@@ -59,12 +61,28 @@ void HHttpServer::Server::incomingConnection(qint32 socketDescriptor)
     m_owner->processRequest(socketDescriptor);
 }
 
+/*******************************************************************************
+ * HHttpServer::LocalServer
+ ******************************************************************************/
+HHttpServer::LocalServer::LocalServer(HHttpServer* owner) :
+    QLocalServer(owner), m_owner(owner)
+{
+}
+
+void HHttpServer::LocalServer::incomingConnection(quintptr socketDescriptor)
+{
+    m_owner->processRequest(static_cast<qint32>(socketDescriptor));
+}
+
 /*******************************************************************************
  * HHttpServer
  ******************************************************************************/
 HHttpServer::HHttpServer(const QByteArray& loggingIdentifier, QObject* parent) :
     QObject(parent),
         m_servers(),
+        m_localServer(0),
+        m_requestCounters(),
+        m_responseCounters(),
         m_loggingIdentifier(loggingIdentifier),
         m_httpHandler(new HHttpAsyncHandler(m_loggingIdentifier, this)),
         m_chunkedInfo(),
@@ -117,6 +135,8 @@ void HHttpServer::processRequest(HHttpAsyncOperation* op)
     mi->setKeepAlive(HHttpUtils::keepAlive(*hdr));
 
     QString method = hdr->method();
+    countRequest(method);
+
     if (method.compare("GET", Qt::CaseInsensitive) == 0)
     {
         processGet(op->takeMessagingInfo(), *hdr);
@@ -171,6 +191,7 @@ void HHttpServer::msgIoComplete(HHttpAsyncOperation* op)
     HMessagingInfo* mi = op->messagingInfo();
     if (op->state() == HHttpAsyncOperation::Failed)
     {
+        HMetricsRegistry::add(HMetricsRegistry::HttpFailures);
         HLOG_DBG(QString("HTTP failure: [%1]").arg(mi->lastErrorDescription()));
         return;
     }
@@ -178,6 +199,7 @@ void HHttpServer::msgIoComplete(HHttpAsyncOperation* op)
     switch(op->opType())
     {
     case HHttpAsyncOperation::SendOnly:
+        countResponse(op->dataToSend());
         if (sendComplete(op))
         {
             if (mi->keepAlive() && mi->socket().state() == QTcpSocket::ConnectedState)
@@ -206,6 +228,61 @@ void HHttpServer::msgIoComplete(HHttpAsyncOperation* op)
     }
 }
 
+void HHttpServer::countRequest(const QString& method)
+{
+    static const char* const knownMethods[] =
+    {
+        "GET", "HEAD", "POST", "NOTIFY", "SUBSCRIBE", "UNSUBSCRIBE", 0
+    };
+
+    // unknown methods are counted together to keep the number of
+    // counters bounded regardless of what the clients send
+    QString label("OTHER");
+    for(qint32 i = 0; knownMethods[i]; ++i)
+    {
+        if (method.compare(knownMethods[i], Qt::CaseInsensitive) == 0)
+        {
+            label = knownMethods[i];
+            break;
+        }
+    }
+
+    HMetricCounter*& counter = m_requestCounters[label];
+    if (!counter)
+    {
+        counter = HMetricsRegistry::counter(
+            QString("hupnp_http_requests_total{method=\"%1\"}").arg(label));
+    }
+
+    counter->add();
+}
+
+void HHttpServer::countResponse(const QByteArray& data)
+{
+    // the status line is of the form "HTTP/1.1 200 OK"
+    if (!data.startsWith("HTTP/") || data.size() < 12)
+    {
+        return;
+    }
+
+    bool ok = false;
+    qint32 status = data.mid(9, 3).toInt(&ok);
+    if (!ok)
+    {
+        return;
+    }
+
+    HMetricCounter*& counter = m_responseCounters[status];
+    if (!counter)
+    {
+        counter = HMetricsRegistry::counter(
+            QString("hupnp_http_responses_total{status=\"%1\"}").arg(
+                QString::number(status)));
+    }
+
+    counter->add();
+}
+
 void HHttpServer::processRequest(qint32 socketDescriptor)
 {
     HLOG2(H_AT, H_FUN, m_loggingIdentifier);
@@ -625,6 +702,76 @@ void HHttpServer::close()
             server->close();
         }
     }
+
+    if (m_localServer)
+    {
+        m_localServer->close();
+    }
+}
+
+bool HHttpServer::listenLocal(const QString& name)
+{
+    HLOG2(H_AT, H_FUN, m_loggingIdentifier);
+    Q_ASSERT(thread() == QThread::currentThread());
+
+    if (name.isEmpty())
+    {
+        return false;
+    }
+
+#ifndef Q_OS_UNIX
+    // the accepted connections are served as TCP sockets, which works only
+    // with the Unix domain sockets
+    HLOG_WARN("Local endpoints are not supported on this platform.");
+    return false;
+#endif
+
+    if (!m_localServer)
+    {
+        m_localServer = new LocalServer(this);
+    }
+    else if (m_localServer->isListening())
+    {
+        return false;
+    }
+
+    // a socket left behind by a process that did not exit cleanly would
+    // prevent listening. it is removed only if nothing accepts connections
+    // at it, since removing the socket of a running server would silently
+    // take its endpoint away.
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(100))
+    {
+        probe.abort();
+
+        HLOG_WARN(QString(
+            "Cannot listen for local connections at [%1]: the name is in use").arg(
+                name));
+
+        return false;
+    }
+
+    QLocalServer::removeServer(name);
+
+    if (!m_localServer->listen(name))
+    {
+        HLOG_WARN(QString("Cannot listen for local connections at [%1]: %2").arg(
+            name, m_localServer->errorString()));
+
+        return false;
+    }
+
+    HLOG_DBG(QString("Listening for local connections at [%1]").arg(
+        m_localServer->fullServerName()));
+
+    return true;
+}
+
+QString HHttpServer::localServerName() const
+{
+    return m_localServer && m_localServer->isListening() ?
+        m_localServer->fullServerName() : QString();
 }
 
 qint32 HHttpServer::maxBytesToLoad() const
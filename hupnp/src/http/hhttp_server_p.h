@@ -34,7 +34,9 @@
 #include <HUpnpCore/private/hhttp_asynchandler_p.h>
 #include <HUpnpCore/private/hhttp_messaginginfo_p.h>
 
+#include <QtCore/QHash>
 #include <QtNetwork/QTcpServer>
+#include <QtNetwork/QLocalServer>
 
 class QUrl;
 class QString;
@@ -50,6 +52,7 @@ class HNotifyRequest;
 class HSubscribeRequest;
 class HUnsubscribeRequest;
 class HInvokeActionRequest;
+struct HMetricCounter;
 
 //
 // Private class for handling HTTP server duties needed in UPnP messaging
@@ -60,6 +63,7 @@ class H_UPNP_CORE_EXPORT HHttpServer :
 Q_OBJECT
 H_DISABLE_COPY(HHttpServer)
 friend class Server;
+friend class LocalServer;
 
 private:
 
@@ -78,6 +82,26 @@ private:
         Server(HHttpServer* owner);
     };
 
+    //
+    // Accepts connections from the processes of the same host. On Unix the
+    // accepted sockets are AF_UNIX sockets that are served like any TCP
+    // connection.
+    //
+    class LocalServer :
+        public QLocalServer
+    {
+    H_DISABLE_COPY(LocalServer)
+
+    private:
+        HHttpServer* m_owner;
+
+    protected:
+        virtual void incomingConnection(quintptr socketDescriptor);
+
+    public:
+        LocalServer(HHttpServer* owner);
+    };
+
 private Q_SLOTS:
 
     void msgIoComplete(HHttpAsyncOperation* op);
@@ -86,6 +110,14 @@ private:
 
     QList<Server*> m_servers;
 
+    LocalServer* m_localServer;
+    // null unless the server listens for local connections as well
+
+    QHash<QString, HMetricCounter*> m_requestCounters;
+    QHash<qint32, HMetricCounter*> m_responseCounters;
+    // the counters of the requests by method and the responses by status.
+    // cached here to avoid locking the metrics registry for every message.
+
 protected:
 
     const QByteArray m_loggingIdentifier;
@@ -120,6 +152,9 @@ private:
 
     bool setupIface(const HEndpoint&);
 
+    void countRequest(const QString& method);
+    void countResponse(const QByteArray& data);
+
 protected:
 
     virtual void incomingSubscriptionRequest(
@@ -163,6 +198,15 @@ public:
     bool isInitialized() const;
     void close();
 
+    // starts to listen for connections from the same host in addition to the
+    // TCP endpoints. the name is either a plain name or a file system path
+    // to the socket. a stale socket of the same name is removed.
+    bool listenLocal(const QString& name);
+
+    // the full name of the local endpoint, or an empty string if the
+    // server does not listen for local connections
+    QString localServerName() const;
+
     qint32 maxBytesToLoad() const;
 };
 
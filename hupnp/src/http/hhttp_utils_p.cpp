@@ -20,11 +20,23 @@
  */
 
 #include "hhttp_utils_p.h"
+#include "../general/hupnp_global_p.h"
 
 #include <QtCore/QUrl>
 #include <QtCore/QList>
+#include <QtCore/QFile>
 #include <QtCore/QByteArray>
 #include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QHostAddress>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 namespace Herqq
 {
@@ -78,5 +90,90 @@ bool HHttpUtils::readLines(
     return linesRead >= lineCount;
 }
 
+bool HHttpUtils::isSameHost(const QUrl& url)
+{
+    QHostAddress ha(url.host());
+    if (ha.isNull())
+    {
+        return false;
+    }
+
+    return ha == QHostAddress::LocalHost ||
+           HSysInfo::instance().areLocalAddresses(QList<QHostAddress>() << ha);
+}
+
+bool HHttpUtils::isLocalPeer(const QTcpSocket& socket)
+{
+    QHostAddress ha = socket.peerAddress();
+    if (ha.isNull())
+    {
+        // the peer of a Unix domain socket has no address
+        return socket.state() == QAbstractSocket::ConnectedState &&
+               socket.localAddress().isNull();
+    }
+
+    return ha == QHostAddress::LocalHost ||
+           HSysInfo::instance().areLocalAddresses(QList<QHostAddress>() << ha);
+}
+
+bool HHttpUtils::connectToLocalServer(QTcpSocket& socket, const QString& name)
+{
+#ifdef Q_OS_UNIX
+    Q_ASSERT(socket.state() == QAbstractSocket::UnconnectedState);
+
+    QByteArray path = QFile::encodeName(name);
+
+    struct sockaddr_un addr;
+    if (path.isEmpty() ||
+        path.size() >= static_cast<qint32>(sizeof(addr.sun_path)))
+    {
+        return false;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    ::memcpy(addr.sun_path, path.constData(), path.size());
+
+    // a blocking connect() of a Unix domain socket waits for room in the
+    // backlog of a busy server, which would stall the calling thread. without
+    // blocking the connect either completes right away or fails with EAGAIN
+    // (or EINPROGRESS), in which case the caller falls back to TCP.
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    int rc;
+    do
+    {
+        rc = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    }
+    while(rc < 0 && errno == EINTR);
+
+    // any failure, including a full backlog, is reported to the caller.
+    // the socket engine of Qt does not care about the address family of the
+    // descriptor. this is what QLocalSocket does as well.
+    if (rc < 0 || !socket.setSocketDescriptor(fd))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED(socket)
+    Q_UNUSED(name)
+    return false;
+#endif
+}
+
 }
 }
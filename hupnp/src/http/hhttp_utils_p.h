@@ -85,6 +85,31 @@ public:
     // reads byte by byte to the target bytearray until \r\n\r\n is found,
     // in which case true is returned
     static bool readLines(QTcpSocket&, QByteArray& target, qint32 lineCount = 2);
+
+    // the vendor header through which a HHttpServer advertises its local
+    // endpoint to the peers running on the same host
+    inline static QString localServerHeader()
+    {
+        QString retVal = "LOCALSERVER.HERQQ.ORG";
+        return retVal;
+    }
+
+    // true when the host of the URL is an address of this host, in which case
+    // the local endpoint advertised by the peer can be used instead
+    static bool isSameHost(const QUrl&);
+
+    // true when the peer of the connected socket runs on this host. this is
+    // the case with the connections accepted from a local endpoint as well.
+    static bool isLocalPeer(const QTcpSocket&);
+
+    //
+    // connects the socket to the local endpoint of a HHttpServer running on the
+    // same host. the socket has to be unconnected. on success the socket is in
+    // connected state and it can be used like any TCP socket. the call never
+    // blocks: if the server cannot take the connection right away false is
+    // returned and the caller should use TCP instead. this is supported only
+    // on Unix, elsewhere false is always returned.
+    static bool connectToLocalServer(QTcpSocket&, const QString& name);
 };
 
 }
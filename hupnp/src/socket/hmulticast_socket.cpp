@@ -223,5 +223,46 @@ bool HMulticastSocket::setMulticastTtl(quint8 ttl)
     return true;
 }
 
+bool HMulticastSocket::setMulticastInterface(const QHostAddress& localAddress)
+{
+    HLOG(H_AT, H_FUN);
+
+    if (localAddress.protocol() != QAbstractSocket::IPv4Protocol)
+    {
+        // TODO: IPv6 multicast
+        HLOG_WARN("IPv6 is not supported.");
+        setSocketError(QAbstractSocket::UnknownSocketError);
+        return false;
+    }
+
+    if (socketDescriptor() == -1)
+    {
+        HLOG_WARN("Socket descriptor is invalid.");
+        setSocketError(QAbstractSocket::UnknownSocketError);
+        return false;
+    }
+
+    struct in_addr addr;
+    memset(&addr, 0, sizeof(in_addr));
+    addr.s_addr = inet_addr(localAddress.toString().toUtf8());
+
+    if (setsockopt(
+            socketDescriptor(),
+            IPPROTO_IP,
+            IP_MULTICAST_IF,
+            reinterpret_cast<char*>(&addr),
+            sizeof(addr)) < 0)
+    {
+        HLOG_WARN(QString(
+            "Could not set the multicast interface to [%1].").arg(
+                localAddress.toString()));
+
+        setSocketError(QAbstractSocket::UnknownSocketError);
+        return false;
+    }
+
+    return true;
+}
+
 }
 }
@@ -132,6 +132,20 @@ public:
      */
     bool setMulticastTtl(quint8 arg);
 
+    /*!
+     * Attempts to set the local interface from which the multicast messages
+     * are sent.
+     *
+     * \param localAddress specifies the address of the local interface.
+     *
+     * \return \e true in case the operation succeeded.
+     *
+     * \remarks Without this the operating system chooses the interface
+     * by the route of the multicast group, regardless of the address to which
+     * the socket is bound.
+     */
+    bool setMulticastInterface(const QHostAddress& localAddress);
+
     /*!
      * Attempts to bind the socket into the specified port using BindMode flags
      * and a QHostAddress value that are suitable for a multicast socket.
@@ -30,6 +30,7 @@
 #include "../socket/hendpoint.h"
 
 #include "../general/hlogger_p.h"
+#include "../general/hmetrics_p.h"
 #include "../utils/hmisc_utils_p.h"
 
 #include <QtCore/QUrl>
@@ -448,7 +449,14 @@ bool HSsdpPrivate::send(const QByteArray& data, const HEndpoint& receiver)
     qint64 retVal = m_unicastSocket->writeDatagram(
         data, receiver.hostAddress(), port);
 
-    return retVal == data.size();
+    if (retVal == data.size())
+    {
+        HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesSent);
+        return true;
+    }
+
+    HMetricsRegistry::add(HMetricsRegistry::SsdpSendFailures);
+    return false;
 }
 
 void HSsdpPrivate::processResponse(const QString& msg, const HEndpoint& source)
@@ -458,6 +466,7 @@ void HSsdpPrivate::processResponse(const QString& msg, const HEndpoint& source)
     HHttpResponseHeader hdr(msg);
     if (!hdr.isValid())
     {
+        HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
         HLOG_WARN("Ignoring a malformed HTTP response.");
         return;
     }
@@ -467,6 +476,8 @@ void HSsdpPrivate::processResponse(const QString& msg, const HEndpoint& source)
         HDiscoveryResponse rcvdMsg;
         if (!parseDiscoveryResponse(hdr, &rcvdMsg))
         {
+            HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
+            HLOG_FIELD(Peer, source.toString());
             HLOG_WARN(QString("Ignoring invalid message from [%1]: %2").arg(
                 source.toString(), msg));
         }
@@ -484,6 +495,7 @@ void HSsdpPrivate::processNotify(const QString& msg, const HEndpoint& source)
     HHttpRequestHeader hdr(msg);
     if (!hdr.isValid())
     {
+        HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
         HLOG_WARN("Ignoring an invalid HTTP NOTIFY request.");
         return;
     }
@@ -496,6 +508,7 @@ void HSsdpPrivate::processNotify(const QString& msg, const HEndpoint& source)
             HResourceAvailable rcvdMsg;
             if (!parseDeviceAvailable(hdr, &rcvdMsg))
             {
+                HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
                 HLOG_WARN(QString(
                     "Ignoring an invalid ssdp:alive announcement:\n%1").arg(msg));
             }
@@ -512,6 +525,7 @@ void HSsdpPrivate::processNotify(const QString& msg, const HEndpoint& source)
             HResourceUnavailable rcvdMsg;
             if (!parseDeviceUnavailable(hdr, &rcvdMsg))
             {
+                HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
                 HLOG_WARN(QString(
                     "Ignoring an invalid ssdp:byebye announcement:\n%1").arg(msg));
             }
@@ -528,6 +542,7 @@ void HSsdpPrivate::processNotify(const QString& msg, const HEndpoint& source)
             HResourceUpdate rcvdMsg;
             if (!parseDeviceUpdate(hdr, &rcvdMsg))
             {
+                HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
                 HLOG_WARN(QString(
                     "Ignoring invalid ssdp:update announcement:\n%1").arg(msg));
             }
@@ -539,6 +554,7 @@ void HSsdpPrivate::processNotify(const QString& msg, const HEndpoint& source)
     }
     else
     {
+        HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
         HLOG_WARN(QString(
             "Ignoring an invalid SSDP presence announcement: [%1].").arg(nts));
     }
@@ -552,6 +568,7 @@ void HSsdpPrivate::processSearch(
     HHttpRequestHeader hdr(msg);
     if (!hdr.isValid())
     {
+        HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
         HLOG_WARN("Ignoring an invalid HTTP M-SEARCH request.");
         return;
     }
@@ -564,6 +581,8 @@ void HSsdpPrivate::processSearch(
         HDiscoveryRequest rcvdMsg;
         if (!parseDiscoveryRequest(hdr, &rcvdMsg))
         {
+            HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesDropped);
+            HLOG_FIELD(Peer, source.toString());
             HLOG_WARN(QString("Ignoring invalid message from [%1]: %2").arg(
                 source.toString(), msg));
         }
@@ -678,6 +697,8 @@ void HSsdpPrivate::messageReceived(QUdpSocket* socket, const HEndpoint* dest)
         return;
     }
 
+    HMetricsRegistry::add(HMetricsRegistry::SsdpMessagesReceived);
+
     QString msg(QString::fromUtf8(buf, read));
     HEndpoint source(ha, port);
     HEndpoint destination(
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hdeadline_scheduler_p.h"
+
+#include <QtCore/QTimerEvent>
+
+#include <algorithm>
+#include <functional>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+/*******************************************************************************
+ * HDeadlineScheduler
+ ******************************************************************************/
+HDeadlineScheduler::HDeadlineScheduler(
+    qint32 granularityInMsecs, QObject* parent) :
+        QObject(parent),
+            m_heap(), m_deadlines(), m_clock(), m_timer(), m_timerDeadline(0),
+            m_granularity(granularityInMsecs > 0 ? granularityInMsecs : 1)
+{
+    m_clock.start();
+}
+
+HDeadlineScheduler::~HDeadlineScheduler()
+{
+}
+
+void HDeadlineScheduler::push(qint64 deadline, void* key)
+{
+    Entry entry = { deadline, key };
+    m_heap.append(entry);
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+}
+
+void HDeadlineScheduler::rearm()
+{
+    if (m_heap.isEmpty())
+    {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 deadline = m_heap.first().m_deadline;
+    deadline = ((deadline + m_granularity - 1) / m_granularity) * m_granularity;
+
+    if (m_timer.isActive() && m_timerDeadline <= deadline)
+    {
+        // The timer fires early enough already.
+        return;
+    }
+
+    qint64 wait = deadline - m_clock.elapsed();
+    m_timerDeadline = deadline;
+    m_timer.start(static_cast<int>(wait > 0 ? wait : 0), this);
+}
+
+void HDeadlineScheduler::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != m_timer.timerId())
+    {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    m_timer.stop();
+
+    qint64 now = m_clock.elapsed();
+    while(!m_heap.isEmpty() && m_heap.first().m_deadline <= now)
+    {
+        Entry entry = m_heap.first();
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Entry>());
+        m_heap.pop_back();
+
+        QHash<void*, qint64>::iterator it = m_deadlines.find(entry.m_key);
+        if (it == m_deadlines.end())
+        {
+            // removed after the entry was queued
+            continue;
+        }
+        else if (it.value() > now)
+        {
+            // the deadline was postponed after the entry was queued
+            if (it.value() > entry.m_deadline)
+            {
+                push(it.value(), entry.m_key);
+            }
+            continue;
+        }
+
+        m_deadlines.erase(it);
+
+        // The receiver may schedule and remove keys, which is why the heap
+        // is re-examined after every emission.
+        emit expired(entry.m_key);
+    }
+
+    rearm();
+}
+
+void HDeadlineScheduler::schedule(void* key, qint32 timeoutInMsecs)
+{
+    Q_ASSERT(key);
+
+    qint64 deadline = m_clock.elapsed() + (timeoutInMsecs > 0 ? timeoutInMsecs : 0);
+
+    QHash<void*, qint64>::iterator it = m_deadlines.find(key);
+    if (it != m_deadlines.end())
+    {
+        bool postponed = deadline >= it.value();
+        it.value() = deadline;
+        if (postponed)
+        {
+            // The entry already in the heap comes due first and it is
+            // re-queued at that point. Nothing else to do.
+            return;
+        }
+    }
+    else
+    {
+        m_deadlines.insert(key, deadline);
+    }
+
+    push(deadline, key);
+    rearm();
+}
+
+bool HDeadlineScheduler::remove(void* key)
+{
+    // The heap entries of the key are discarded when they come due.
+    return m_deadlines.remove(key) > 0;
+}
+
+void HDeadlineScheduler::clear()
+{
+    m_timer.stop();
+    m_heap.clear();
+    m_deadlines.clear();
+}
+
+qint64 HDeadlineScheduler::remainingTime(void* key) const
+{
+    QHash<void*, qint64>::const_iterator ci = m_deadlines.constFind(key);
+    if (ci == m_deadlines.constEnd())
+    {
+        return -1;
+    }
+
+    qint64 retVal = ci.value() - m_clock.elapsed();
+    return retVal > 0 ? retVal : 0;
+}
+
+}
+}
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2010, 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP (HUPnP) library.
+ *
+ *  Herqq UPnP is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with Herqq UPnP. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HDEADLINE_SCHEDULER_P_H_
+#define HDEADLINE_SCHEDULER_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include "../general/hupnp_defs.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+//
+// A single-timer deadline scheduler for a large number of keys.
+//
+// The pending deadlines are kept in a min-heap and a single timer is armed
+// for the earliest one. Postponing the deadline of a key that is already
+// scheduled only updates a hash entry; the stale heap entry is re-queued
+// lazily when it comes due. Wake-ups are rounded up to the specified
+// granularity so that deadlines close to each other are handled in one go.
+//
+class HDeadlineScheduler :
+    public QObject
+{
+Q_OBJECT
+H_DISABLE_COPY(HDeadlineScheduler)
+
+private:
+
+    struct Entry
+    {
+        qint64 m_deadline;
+        void* m_key;
+
+        inline bool operator>(const Entry& other) const
+        {
+            return m_deadline > other.m_deadline;
+        }
+    };
+
+    QVector<Entry> m_heap;
+    QHash<void*, qint64> m_deadlines;
+
+    QElapsedTimer m_clock;
+    QBasicTimer m_timer;
+    qint64 m_timerDeadline;
+    qint32 m_granularity;
+
+    void push(qint64 deadline, void* key);
+    void rearm();
+
+protected:
+
+    virtual void timerEvent(QTimerEvent*);
+
+public:
+
+    explicit HDeadlineScheduler(
+        qint32 granularityInMsecs = 1000, QObject* parent = 0);
+
+    virtual ~HDeadlineScheduler();
+
+    // Schedules the key to expire after the specified time. If the key is
+    // already scheduled, its deadline is replaced.
+    void schedule(void* key, qint32 timeoutInMsecs);
+
+    bool remove(void* key);
+    void clear();
+
+    inline bool contains(void* key) const { return m_deadlines.contains(key); }
+    inline qint32 count() const { return m_deadlines.size(); }
+
+    // The number of milliseconds until the key expires, or -1 if the key
+    // is not scheduled.
+    qint64 remainingTime(void* key) const;
+
+Q_SIGNALS:
+
+    void expired(void* key);
+};
+
+}
+}
+
+#endif /* HDEADLINE_SCHEDULER_P_H_ */
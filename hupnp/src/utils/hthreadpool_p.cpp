@@ -38,8 +38,9 @@ HRunnable::HRunnable() :
 
 HRunnable::~HRunnable()
 {
-    if (!m_doNotInform)
+    if (!m_doNotInform && m_owner)
     {
+        // a runnable that was never started has no owner
         m_owner->exiting(this);
     }
 }
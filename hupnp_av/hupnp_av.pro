@@ -14,6 +14,8 @@ INCLUDEPATH += ./include/
 INCLUDEPATH += ../hupnp/include
 LIBS += -L"./../hupnp/bin/" -lHUpnp
 
+CONFIG(DISABLE_TRACING) : DEFINES += H_DISABLE_TRACING
+
 OBJECTS_DIR = obj
 DESTDIR     = ./bin
 MOC_DIR     = obj
@@ -35,6 +35,7 @@ HEADERS += \
     $$SRC_LOC/cds_model/model_mgmt/hcdsproperty.h \
     $$SRC_LOC/cds_model/model_mgmt/hcdspropertyinfo.h \
     $$SRC_LOC/cds_model/model_mgmt/hcds_dlite_serializer_p.h \
+    $$SRC_LOC/cds_model/model_mgmt/hcds_dlite_reader_p.h \
     $$SRC_LOC/cds_model/cds_objects/hobject.h \
     $$SRC_LOC/cds_model/cds_objects/hobject_p.h \
     $$SRC_LOC/cds_model/cds_objects/hitem.h \
@@ -137,6 +138,7 @@ SOURCES += \
     $$SRC_LOC/cds_model/model_mgmt/hcdsproperty.cpp \
     $$SRC_LOC/cds_model/model_mgmt/hcdspropertyinfo.cpp \
     $$SRC_LOC/cds_model/model_mgmt/hcds_dlite_serializer.cpp \
+    $$SRC_LOC/cds_model/model_mgmt/hcds_dlite_reader_p.cpp \
     $$SRC_LOC/cds_model/cds_objects/hobject.cpp \
     $$SRC_LOC/cds_model/cds_objects/hitem.cpp \
     $$SRC_LOC/cds_model/cds_objects/haudioitem.cpp \
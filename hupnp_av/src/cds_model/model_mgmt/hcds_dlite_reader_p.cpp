@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP Av (HUPnPAv) library.
+ *
+ *  Herqq UPnP Av is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP Av is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Herqq UPnP Av. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hcds_dlite_reader_p.h"
+#include "hcds_dlite_serializer_p.h"
+
+#include "../cds_objects/hobject.h"
+
+#include <HUpnpCore/private/hlogger_p.h>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace Av
+{
+
+/*******************************************************************************
+ * HCdsDidlLiteReader
+ ******************************************************************************/
+HCdsDidlLiteReader::HCdsDidlLiteReader(
+    const QString& didlLiteDoc, HCdsDidlLiteSerializer::XmlType inputType,
+    qint32 chunkSize) :
+        m_serializer(new HCdsDidlLiteSerializerPrivate()),
+        m_inputType(inputType),
+        m_data(didlLiteDoc),
+        m_dataOffset(0),
+        m_chunkSize(chunkSize > 0 ? chunkSize : DefaultChunkSize),
+        m_reader(),
+        m_rootChecked(inputType != HCdsDidlLiteSerializer::Document),
+        m_lastErrorDescription()
+{
+    if (inputType == HCdsDidlLiteSerializer::Document)
+    {
+        HCdsDidlLiteSerializerPrivate::addNamespaces(m_reader);
+    }
+    else
+    {
+        m_reader.setNamespaceProcessing(false);
+    }
+
+    feedNextChunk();
+}
+
+HCdsDidlLiteReader::~HCdsDidlLiteReader()
+{
+    delete m_serializer;
+}
+
+bool HCdsDidlLiteReader::feedNextChunk()
+{
+    if (m_dataOffset >= m_data.size())
+    {
+        return false;
+    }
+
+    qint32 end = m_data.size();
+    qint32 searchFrom = m_dataOffset + m_chunkSize;
+    if (searchFrom < end)
+    {
+        // The chunk is extended to the end of the first object that closes
+        // after the nominal chunk size. This way an object is always fully
+        // available to the QXmlStreamReader once its start element is read.
+        static const QString itemEnd = "</item>";
+        static const QString containerEnd = "</container>";
+
+        qint32 itemIdx = m_data.indexOf(itemEnd, searchFrom);
+        qint32 containerIdx = m_data.indexOf(containerEnd, searchFrom);
+
+        if (itemIdx >= 0 && (containerIdx < 0 || itemIdx < containerIdx))
+        {
+            end = itemIdx + itemEnd.size();
+        }
+        else if (containerIdx >= 0)
+        {
+            end = containerIdx + containerEnd.size();
+        }
+    }
+
+    m_reader.addData(m_data.mid(m_dataOffset, end - m_dataOffset));
+    m_dataOffset = end;
+
+    if (m_dataOffset >= m_data.size())
+    {
+        // All the data is now owned by the QXmlStreamReader
+        m_data.clear();
+        m_dataOffset = 0;
+    }
+
+    return true;
+}
+
+HCdsDidlLiteReader::ReadStatus HCdsDidlLiteReader::read(
+    HObjects* retVal, qint32 maxObjects)
+{
+    HLOG(H_AT, H_FUN);
+    Q_ASSERT(retVal);
+
+    if (!m_rootChecked)
+    {
+        m_rootChecked = true;
+
+        bool found = false;
+        for(;;)
+        {
+            found = m_reader.readNextStartElement();
+            if (found || m_reader.error() !=
+                QXmlStreamReader::PrematureEndOfDocumentError || !feedNextChunk())
+            {
+                break;
+            }
+        }
+
+        if (found &&
+            m_reader.name().compare("DIDL-Lite", Qt::CaseInsensitive) != 0)
+        {
+            m_lastErrorDescription = "Missing mandatory DIDL-Lite element";
+            return Failed;
+        }
+    }
+
+    qint32 count = 0;
+    for(;;)
+    {
+        if (m_reader.atEnd())
+        {
+            if (m_reader.error() ==
+                QXmlStreamReader::PrematureEndOfDocumentError && feedNextChunk())
+            {
+                continue;
+            }
+            break;
+        }
+        else if (maxObjects >= 0 && count >= maxObjects)
+        {
+            return MoreAvailable;
+        }
+
+        if (m_reader.readNext() == QXmlStreamReader::StartElement)
+        {
+            QStringRef name = m_reader.name();
+            if (name == "item" || name == "container")
+            {
+                HObject* obj = m_serializer->parseObject(m_reader, m_inputType);
+                if (!obj)
+                {
+                    m_lastErrorDescription =
+                        m_serializer->m_lastErrorDescription;
+                    return Failed;
+                }
+                retVal->append(obj);
+                ++count;
+            }
+        }
+    }
+
+    if (m_reader.error() != QXmlStreamReader::NoError)
+    {
+        m_lastErrorDescription =
+            QString("Parse failed: [%1]").arg(m_reader.errorString());
+
+        return Failed;
+    }
+
+    return Finished;
+}
+
+}
+}
+}
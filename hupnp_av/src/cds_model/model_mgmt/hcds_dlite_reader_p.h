@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP Av (HUPnPAv) library.
+ *
+ *  Herqq UPnP Av is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP Av is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Herqq UPnP Av. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HCDS_DLITE_READER_P_H_
+#define HCDS_DLITE_READER_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include <HUpnpAv/HCdsDidlLiteSerializer>
+
+#include <QtCore/QString>
+#include <QtCore/QXmlStreamReader>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace Av
+{
+
+class HCdsDidlLiteSerializerPrivate;
+
+//
+// Incremental DIDL-Lite reader that produces HObjects in batches.
+//
+// The source document is fed to the underlying QXmlStreamReader in chunks that
+// end at object boundaries, which means the XML reader never has to hold a
+// complete copy of a large Browse / Search result. Parsing can be suspended
+// after any number of objects and resumed later, e.g. on the next iteration
+// of the event loop.
+//
+class HCdsDidlLiteReader
+{
+H_DISABLE_COPY(HCdsDidlLiteReader)
+
+public:
+
+    enum ReadStatus
+    {
+        Failed = -1,
+        Finished = 0,
+        MoreAvailable = 1
+    };
+
+    enum
+    {
+        DefaultChunkSize = 64 * 1024
+    };
+
+private:
+
+    HCdsDidlLiteSerializerPrivate* m_serializer;
+    HCdsDidlLiteSerializer::XmlType m_inputType;
+
+    QString m_data;
+    qint32 m_dataOffset;
+    qint32 m_chunkSize;
+
+    QXmlStreamReader m_reader;
+    bool m_rootChecked;
+
+    QString m_lastErrorDescription;
+
+    bool feedNextChunk();
+
+public:
+
+    HCdsDidlLiteReader(
+        const QString& didlLiteDoc,
+        HCdsDidlLiteSerializer::XmlType inputType =
+            HCdsDidlLiteSerializer::Document,
+        qint32 chunkSize = DefaultChunkSize);
+
+    ~HCdsDidlLiteReader();
+
+    // Reads at most maxObjects objects from the document and appends them to
+    // retVal. A negative maxObjects reads the remainder of the document.
+    // The ownership of the created objects is passed to the caller.
+    ReadStatus read(HObjects* retVal, qint32 maxObjects = -1);
+
+    inline QString lastErrorDescription() const
+    {
+        return m_lastErrorDescription;
+    }
+};
+
+}
+}
+}
+
+#endif /* HCDS_DLITE_READER_P_H_ */
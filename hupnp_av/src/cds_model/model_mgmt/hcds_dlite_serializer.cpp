@@ -21,6 +21,7 @@
 
 #include "hcds_dlite_serializer.h"
 #include "hcds_dlite_serializer_p.h"
+#include "hcds_dlite_reader_p.h"
 #include "hcdsproperty_db.h"
 #include "hcdsproperty.h"
 
@@ -85,23 +86,6 @@ namespace Av
 
 namespace
 {
-void addNamespaces(QXmlStreamReader& reader)
-{
-    QXmlStreamNamespaceDeclaration didl(
-        "DIDL-Lite", "urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/");
-    QXmlStreamNamespaceDeclaration dc(
-        "dc", "http://purl.org/dc/elements/1.1/");
-    QXmlStreamNamespaceDeclaration upnp(
-        "upnp", "urn:schemas-upnp-org:metadata-1-0/upnp/");
-    QXmlStreamNamespaceDeclaration xsi(
-        "xsi", "http://www.w3.org/2001/XMLSchema-instance");
-
-    reader.addExtraNamespaceDeclaration(didl);
-    reader.addExtraNamespaceDeclaration(dc);
-    reader.addExtraNamespaceDeclaration(upnp);
-    reader.addExtraNamespaceDeclaration(xsi);
-}
-
 QString saveItemToXml(QXmlStreamReader& reader)
 {
     Q_ASSERT(reader.name() == "item" || reader.name() == "container");
@@ -237,6 +221,23 @@ HCdsDidlLiteSerializerPrivate::~HCdsDidlLiteSerializerPrivate()
 {
 }
 
+void HCdsDidlLiteSerializerPrivate::addNamespaces(QXmlStreamReader& reader)
+{
+    QXmlStreamNamespaceDeclaration didl(
+        "DIDL-Lite", "urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/");
+    QXmlStreamNamespaceDeclaration dc(
+        "dc", "http://purl.org/dc/elements/1.1/");
+    QXmlStreamNamespaceDeclaration upnp(
+        "upnp", "urn:schemas-upnp-org:metadata-1-0/upnp/");
+    QXmlStreamNamespaceDeclaration xsi(
+        "xsi", "http://www.w3.org/2001/XMLSchema-instance");
+
+    reader.addExtraNamespaceDeclaration(didl);
+    reader.addExtraNamespaceDeclaration(dc);
+    reader.addExtraNamespaceDeclaration(upnp);
+    reader.addExtraNamespaceDeclaration(xsi);
+}
+
 bool HCdsDidlLiteSerializerPrivate::serializePropertyFromAttribute(
     HObject* object, const QString& xmlTokenName, const QString& attributeValue)
 {
@@ -561,54 +562,12 @@ bool HCdsDidlLiteSerializer::serializeFromXml(
     HLOG(H_AT, H_FUN);
     Q_ASSERT(retVal);
 
-    QXmlStreamReader reader(didlLiteDoc);
-
-    if (inputType == Document)
-    {
-        addNamespaces(reader);
-        if (reader.readNextStartElement())
-        {
-            if (reader.name().compare("DIDL-Lite", Qt::CaseInsensitive) != 0)
-            {
-                h_ptr->m_lastErrorDescription = "Missing mandatory DIDL-Lite element";
-                return false;
-            }
-        }
-    }
-    else
-    {
-        reader.setNamespaceProcessing(false);
-    }
-
     HObjects tmp;
-    while(!reader.atEnd() && reader.readNext())
+    HCdsDidlLiteReader reader(didlLiteDoc, inputType);
+    if (reader.read(&tmp) != HCdsDidlLiteReader::Finished)
     {
-        switch(reader.tokenType())
-        {
-        case QXmlStreamReader::StartElement:
-            {
-                QStringRef name = reader.name();
-                if (name == "item" || name == "container")
-                {
-                     HObject* obj = h_ptr->parseObject(reader, inputType);
-                     if (!obj)
-                     {
-                         return false;
-                     }
-                     tmp.append(obj);
-                }
-            }
-            break;
-        default:
-            break;
-        }
-    }
-
-    if (reader.error() != QXmlStreamReader::NoError)
-    {
-        h_ptr->m_lastErrorDescription =
-            QString("Parse failed: [%1]").arg(reader.errorString());
-
+        h_ptr->m_lastErrorDescription = reader.lastErrorDescription();
+        qDeleteAll(tmp);
         return false;
     }
 
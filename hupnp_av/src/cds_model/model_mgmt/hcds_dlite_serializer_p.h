@@ -63,6 +63,8 @@ public:
     HCdsDidlLiteSerializerPrivate();
     ~HCdsDidlLiteSerializerPrivate();
 
+    static void addNamespaces(QXmlStreamReader&);
+
     bool serializePropertyFromAttribute(
         HObject* object, const QString& xmlTokenName,
         const QString& attributeValue);
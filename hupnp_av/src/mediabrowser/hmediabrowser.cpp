@@ -159,6 +159,9 @@ HMediaBrowserPrivate::HMediaBrowserPrivate(
             m_dataSource(new HCdsDataSource()),
             m_currentUserOp(0),
             m_currentAutoOp(0),
+            m_autoOpQueue(),
+            m_batchSize(DefaultBatchSize),
+            m_batchesScheduled(false),
             m_lastErrorCode(0),
             m_lastErrorDescription(),
             q_ptr(0)
@@ -208,31 +211,98 @@ void HMediaBrowserPrivate::browseCompleted(
         browseOp = m_currentUserOp.data();
     }
 
-    HSearchResult result = op.value();
+    if (!browseOp)
+    {
+        return;
+    }
+
+    browseOp->m_resultStartIndex = browseOp->m_loadedObjects.size();
+    browseOp->m_reader.reset(new HCdsDidlLiteReader(op.value().result()));
+
+    // The first batch is processed right away and the rest, if any,
+    // on the following iterations of the event loop. If a queued invocation
+    // is already pending, it picks up this result as well; calling
+    // processBatches() here would clear the flag and schedule a second one.
+    if (!m_batchesScheduled)
+    {
+        processBatches();
+    }
+}
+
+void HMediaBrowserPrivate::processBatches()
+{
+    m_batchesScheduled = false;
+
+    bool morePending = false;
+    if (m_currentUserOp && m_currentUserOp->m_reader)
+    {
+        morePending = processBatch(m_currentUserOp.data());
+    }
+    if (m_currentAutoOp && m_currentAutoOp->m_reader)
+    {
+        morePending = processBatch(m_currentAutoOp.data()) || morePending;
+    }
+
+    if (morePending && !m_batchesScheduled)
+    {
+        m_batchesScheduled = true;
+        bool ok = QMetaObject::invokeMethod(
+            this, "processBatches", Qt::QueuedConnection);
+        Q_ASSERT(ok); Q_UNUSED(ok)
+    }
+}
+
+bool HMediaBrowserPrivate::processBatch(HBrowseOp* browseOp)
+{
+    HLOG(H_AT, H_FUN);
+    Q_ASSERT(browseOp->m_reader);
 
     HObjects objects;
-    HCdsDidlLiteSerializer serializer;
-    if (!serializer.serializeFromXml(result.result(), &objects))
+    HCdsDidlLiteReader::ReadStatus status =
+        browseOp->m_reader->read(&objects, m_batchSize);
+
+    if (status == HCdsDidlLiteReader::Failed)
     {
-        browseFailed(browseOp, serializer.lastErrorDescription());
-        return;
+        qDeleteAll(objects);
+        browseFailed(browseOp, browseOp->m_reader->lastErrorDescription());
+        return false;
     }
     else if (objects.size() > 0)
     {
         browseOp->m_loadedObjects.append(objects);
         m_dataSource->add(objects);
 
-        QSet<QString> ids;
-        foreach(HObject* object, objects)
-        {
-            ids.insert(object->id());
-        }
         if (browseOp == m_currentUserOp.data())
         {
+            QSet<QString> ids;
+            foreach(HObject* object, objects)
+            {
+                ids.insert(object->id());
+            }
+
             emit owner()->objectsBrowsed(owner(), ids);
+
+            if (browseOp != m_currentUserOp.data())
+            {
+                // The operation was canceled by the user.
+                return false;
+            }
         }
     }
 
+    if (status == HCdsDidlLiteReader::MoreAvailable)
+    {
+        return true;
+    }
+
+    browseOp->m_reader.reset(0);
+    resultProcessed(browseOp);
+
+    return false;
+}
+
+void HMediaBrowserPrivate::resultProcessed(HBrowseOp* browseOp)
+{
     HBrowseParams::BrowseType loadType = browseOp->m_loadParams.browseType();
     switch(loadType)
     {
@@ -242,14 +312,16 @@ void HMediaBrowserPrivate::browseCompleted(
         break;
 
     case HBrowseParams::ObjectAndDirectChildren:
-        if (browseOp->m_indexUnderProcessing >= 0)
+        if (browseOp->m_indexUnderProcessing >= 0 ||
+            browseOp->m_resultStartIndex >= browseOp->m_loadedObjects.size())
         {
             browseComplete(browseOp);
         }
         else
         {
             browseOp->m_indexUnderProcessing = 0;
-            browseOp->m_loadParams.setObjectId(objects.at(0)->id());
+            browseOp->m_loadParams.setObjectId(
+                browseOp->m_loadedObjects.at(browseOp->m_resultStartIndex)->id());
             browse(browseOp);
         }
         break;
@@ -614,6 +686,16 @@ void HMediaBrowser::cancel()
     }
 }
 
+void HMediaBrowser::setBatchSize(qint32 count)
+{
+    h_ptr->m_batchSize = count > 0 ? count : -1;
+}
+
+qint32 HMediaBrowser::batchSize() const
+{
+    return h_ptr->m_batchSize;
+}
+
 bool HMediaBrowser::isAutoUpdateEnabled()
 {
     return h_ptr->m_autoUpdateEnabled;
@@ -377,6 +377,35 @@ public:
      */
     void cancel();
 
+    /*!
+     * Specifies the maximum number of CDS objects processed per iteration of
+     * the event loop.
+     *
+     * A browse result is parsed and inserted into the dataSource()
+     * incrementally in batches of at most \a count objects. The event loop
+     * is allowed to run between the batches and objectsBrowsed() is emitted
+     * for each batch, which keeps the application responsive
+     * when a single browse result contains a large number of objects.
+     *
+     * \param count specifies the maximum number of objects in a batch.
+     * A value less than or equal to zero disables batching, in which case every
+     * browse result is processed in full before returning to the event loop.
+     *
+     * \sa batchSize()
+     */
+    void setBatchSize(qint32 count);
+
+    /*!
+     * Returns the maximum number of CDS objects processed per iteration of
+     * the event loop.
+     *
+     * \return the maximum number of CDS objects processed per iteration of
+     * the event loop. A negative value means that batching is disabled.
+     *
+     * \sa setBatchSize()
+     */
+    qint32 batchSize() const;
+
     /*!
      * Indicates if the object should automatically process LastChange events and
      * attempt to update its data source.
@@ -425,11 +454,11 @@ Q_SIGNALS:
      * \brief This signal is emitted when new objects have been browsed and cached
      * by the instance.
      *
-     * \brief This signal is emitted whenever the contents of a single CDS container
-     * have been browsed and cached. This signal is especially useful in situations
-     * where the browse operation involves multiple CDS containers, as it enables
-     * progressive processing of the results while the operation is running
-     * (before the browseComplete() is emitted).
+     * \brief This signal is emitted whenever a batch of CDS objects has
+     * been browsed and cached. This signal is especially useful in situations
+     * where the browse operation involves multiple CDS containers or large
+     * containers, as it enables progressive processing of the results while
+     * the operation is running (before the browseComplete() is emitted).
      *
      * \param source specifies the source of the event.
      *
@@ -31,6 +31,7 @@
 //
 
 #include "hmediabrowser.h"
+#include "../cds_model/model_mgmt/hcds_dlite_reader_p.h"
 
 #include <HUpnpAv/HSearchResult>
 #include <HUpnpCore/HClientAdapterOp>
@@ -61,11 +62,18 @@ public:
     qint32 m_indexUnderProcessing;
     QScopedPointer<HClientAdapterOp<HSearchResult> > m_currentOp;
 
+    // The DIDL-Lite reader of the result currently being processed and the
+    // index in m_loadedObjects of the first object of that result.
+    QScopedPointer<HCdsDidlLiteReader> m_reader;
+    qint32 m_resultStartIndex;
+
     HBrowseOp() :
         m_loadParams(),
         m_loadedObjects(),
         m_indexUnderProcessing(-1),
-        m_currentOp(0)
+        m_currentOp(0),
+        m_reader(0),
+        m_resultStartIndex(0)
     {
     }
 
@@ -73,7 +81,9 @@ public:
         m_loadParams(arg),
         m_loadedObjects(),
         m_indexUnderProcessing(arg.browseType() != HBrowseParams::DirectChildren ? -1 : 0),
-        m_currentOp(0)
+        m_currentOp(0),
+        m_reader(0),
+        m_resultStartIndex(0)
     {
     }
 
@@ -81,7 +91,9 @@ public:
         m_loadParams(other.m_loadParams),
         m_loadedObjects(other.m_loadedObjects),
         m_indexUnderProcessing(other.m_indexUnderProcessing),
-        m_currentOp(new HClientAdapterOp<HSearchResult>(*m_currentOp))
+        m_currentOp(new HClientAdapterOp<HSearchResult>(*m_currentOp)),
+        m_reader(0),
+        m_resultStartIndex(other.m_resultStartIndex)
     {
     }
 };
@@ -104,8 +116,15 @@ private Q_SLOTS:
     void lastChangeReceived(
         Herqq::Upnp::Av::HContentDirectoryAdapter* source, const QString& data);
 
+    void processBatches();
+
 public:
 
+    enum
+    {
+        DefaultBatchSize = 256
+    };
+
     HContentDirectoryAdapter* m_contentDirectory;
     bool m_hasOwnershipOfCds;
     bool m_autoUpdateEnabled;
@@ -116,6 +135,9 @@ public:
     QScopedPointer<HBrowseOp> m_currentAutoOp;
     QQueue<HBrowseOp*> m_autoOpQueue;
 
+    qint32 m_batchSize;
+    bool m_batchesScheduled;
+
     qint32 m_lastErrorCode;
     QString m_lastErrorDescription;
 
@@ -126,6 +148,9 @@ public:
 
     void checkNextAutoOp();
 
+    bool processBatch(HBrowseOp*);
+    void resultProcessed(HBrowseOp*);
+
     void autoBrowse(const HBrowseParams&);
 
     void update(const HCdsLastChangeInfos&);
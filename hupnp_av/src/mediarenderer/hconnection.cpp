@@ -139,6 +139,13 @@ void HConnection::lastChangeReceived(
 {
     HLOG(H_AT, H_FUN);
 
+    // the nested LastChange document is decoded only if someone is listening
+    if (!receivers(SIGNAL(renderingControlStateChanged(
+        Herqq::Upnp::Av::HConnection*, Herqq::Upnp::Av::HRcsLastChangeInfos))))
+    {
+        return;
+    }
+
     QXmlStreamReader reader(data.trimmed());
     //addNamespaces(reader);
 
@@ -200,6 +207,12 @@ void HConnection::lastChangeReceived(HAvTransportAdapter*, const QString& data)
 {
     HLOG(H_AT, H_FUN);
 
+    if (!receivers(SIGNAL(avTransportStateChanged(
+        Herqq::Upnp::Av::HConnection*, Herqq::Upnp::Av::HAvtLastChangeInfos))))
+    {
+        return;
+    }
+
     QXmlStreamReader reader(data.trimmed());
     //addNamespaces(reader);
 
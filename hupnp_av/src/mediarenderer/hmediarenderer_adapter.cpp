@@ -69,7 +69,7 @@ HPrepareForConnectionOp::HPrepareForConnectionOp(
 HMediaRendererAdapterPrivate::HMediaRendererAdapterPrivate() :
     HClientDeviceAdapterPrivate(HMediaRendererInfo::supportedDeviceType()),
         m_cm(0), m_transportService(0), m_renderingControlService(0),
-        m_cachedConnections()
+        m_cachedConnections(), m_positionPollInterval(0)
 {
 }
 
@@ -200,6 +200,11 @@ void HMediaRendererAdapter::prepareForConnectionCompleted(
 
         bool ok = transport->setService(h->m_transportService, HClientServiceAdapter::MinimalValidation);
         Q_ASSERT_X(ok, "", transport->lastErrorDescription().toLocal8Bit()); Q_UNUSED(ok)
+
+        if (h->m_positionPollInterval > 0)
+        {
+            transport->startPositionTracking(h->m_positionPollInterval);
+        }
     }
 
     HRenderingControlAdapter* rc = 0;
@@ -284,6 +289,11 @@ void HMediaRendererAdapter::getCurrentConnectionInfoCompleted(
     bool ok = transport->setService(h->m_transportService);
     Q_ASSERT_X(ok, "", transport->lastErrorDescription().toLocal8Bit());
 
+    if (h->m_positionPollInterval > 0)
+    {
+        transport->startPositionTracking(h->m_positionPollInterval);
+    }
+
     HRenderingControlAdapter* rc = new HRenderingControlAdapter(result.rcsId());
     ok = rc->setService(h->m_renderingControlService);
     Q_ASSERT_X(ok, "", rc->lastErrorDescription().toLocal8Bit());
@@ -503,6 +513,18 @@ HConnection* HMediaRendererAdapter::takeConnection(qint32 id)
     return retVal;
 }
 
+void HMediaRendererAdapter::setPositionPollInterval(qint32 interval)
+{
+    H_D(HMediaRendererAdapter);
+    h->m_positionPollInterval = interval > 0 ? interval : 0;
+}
+
+qint32 HMediaRendererAdapter::positionPollInterval() const
+{
+    const H_D(HMediaRendererAdapter);
+    return h->m_positionPollInterval;
+}
+
 HConnections HMediaRendererAdapter::takeConnections()
 {
     H_D(HMediaRendererAdapter);
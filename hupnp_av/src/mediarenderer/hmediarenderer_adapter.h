@@ -248,6 +248,31 @@ public:
      */
     HConnections takeConnections();
 
+    /*!
+     * \brief Specifies whether the position of the current track is tracked
+     * in the connections that are created after this call.
+     *
+     * \param interval specifies the interval in milliseconds at which the
+     * position is polled while the transport is playing. A value less than or
+     * equal to zero disables the position tracking of new connections,
+     * which is the default.
+     *
+     * \sa positionPollInterval(), HAvTransportAdapter::startPositionTracking()
+     */
+    void setPositionPollInterval(qint32 interval);
+
+    /*!
+     * \brief Returns the interval at which the position of the current track
+     * is polled in new connections.
+     *
+     * \return The interval in milliseconds at which the position of the
+     * current track is polled in new connections, or zero when the position
+     * is not tracked.
+     *
+     * \sa setPositionPollInterval()
+     */
+    qint32 positionPollInterval() const;
+
 Q_SIGNALS:
 
     /*!
@@ -94,6 +94,9 @@ public:
 
     QHash<qint32, HConnection*> m_cachedConnections;
 
+    qint32 m_positionPollInterval;
+    // zero when the positions of new connections are not tracked
+
     HMediaRendererAdapterPrivate();
 
     virtual ~HMediaRendererAdapterPrivate();
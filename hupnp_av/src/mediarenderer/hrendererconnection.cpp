@@ -67,24 +67,8 @@ namespace Av
  * HRendererConnectionPrivate
  ******************************************************************************/
 HRendererConnectionPrivate::HRendererConnectionPrivate() :
-    m_info(0), m_connectionInfo(0), m_service(0), q_ptr(0), m_valueSetters()
-{
-    m_valueSetters.insert("Brightness", ValueSetter(this, &HRendererConnectionPrivate::setBrightness));
-    m_valueSetters.insert("Contrast", ValueSetter(this, &HRendererConnectionPrivate::setContrast));
-    m_valueSetters.insert("Sharpness", ValueSetter(this, &HRendererConnectionPrivate::setSharpness));
-    m_valueSetters.insert("RedVideoGain", ValueSetter(this, &HRendererConnectionPrivate::setRedVideoGain));
-    m_valueSetters.insert("GreenVideoGain", ValueSetter(this, &HRendererConnectionPrivate::setGreenVideoGain));
-    m_valueSetters.insert("BlueVideoGain", ValueSetter(this, &HRendererConnectionPrivate::setBlueVideoGain));
-    m_valueSetters.insert("RedVideoBlackLevel", ValueSetter(this, &HRendererConnectionPrivate::setRedVideoBlackLevel));
-    m_valueSetters.insert("GreenVideoBlackLevel", ValueSetter(this, &HRendererConnectionPrivate::setGreenVideoBlackLevel));
-    m_valueSetters.insert("BlueVideoBlackLevel", ValueSetter(this, &HRendererConnectionPrivate::setBlueVideoBlackLevel));
-    m_valueSetters.insert("ColorTemperature", ValueSetter(this, &HRendererConnectionPrivate::setColorTemperature));
-    m_valueSetters.insert("HorizontalKeystone", ValueSetter(this, &HRendererConnectionPrivate::setHorizontalKeystone));
-    m_valueSetters.insert("VerticalKeystone", ValueSetter(this, &HRendererConnectionPrivate::setVerticalKeystone));
-    m_valueSetters.insert("Mute", ValueSetter(this, &HRendererConnectionPrivate::setMute));
-    m_valueSetters.insert("Volume", ValueSetter(this, &HRendererConnectionPrivate::setVolume));
-    m_valueSetters.insert("VolumeDB", ValueSetter(this, &HRendererConnectionPrivate::setVolumeDB));
-    m_valueSetters.insert("Loudness", ValueSetter(this, &HRendererConnectionPrivate::setLoudness));
+    m_info(0), m_connectionInfo(0), m_service(0), q_ptr(0)
+{
 }
 
 HRendererConnectionPrivate::~HRendererConnectionPrivate()
@@ -92,6 +76,48 @@ HRendererConnectionPrivate::~HRendererConnectionPrivate()
     delete m_info;
 }
 
+ValueSetter HRendererConnectionPrivate::valueSetter(
+    HRendererConnectionInfo::StateVariable sv)
+{
+    switch(sv)
+    {
+    case HRendererConnectionInfo::RcsBrightness:
+        return &HRendererConnectionPrivate::setBrightness;
+    case HRendererConnectionInfo::RcsContrast:
+        return &HRendererConnectionPrivate::setContrast;
+    case HRendererConnectionInfo::RcsSharpness:
+        return &HRendererConnectionPrivate::setSharpness;
+    case HRendererConnectionInfo::RcsRedVideoGain:
+        return &HRendererConnectionPrivate::setRedVideoGain;
+    case HRendererConnectionInfo::RcsGreenVideoGain:
+        return &HRendererConnectionPrivate::setGreenVideoGain;
+    case HRendererConnectionInfo::RcsBlueVideoGain:
+        return &HRendererConnectionPrivate::setBlueVideoGain;
+    case HRendererConnectionInfo::RcsRedVideoBlackLevel:
+        return &HRendererConnectionPrivate::setRedVideoBlackLevel;
+    case HRendererConnectionInfo::RcsGreenVideoBlackLevel:
+        return &HRendererConnectionPrivate::setGreenVideoBlackLevel;
+    case HRendererConnectionInfo::RcsBlueVideoBlackLevel:
+        return &HRendererConnectionPrivate::setBlueVideoBlackLevel;
+    case HRendererConnectionInfo::RcsColorTemperature:
+        return &HRendererConnectionPrivate::setColorTemperature;
+    case HRendererConnectionInfo::RcsHorizontalKeystone:
+        return &HRendererConnectionPrivate::setHorizontalKeystone;
+    case HRendererConnectionInfo::RcsVerticalKeystone:
+        return &HRendererConnectionPrivate::setVerticalKeystone;
+    case HRendererConnectionInfo::RcsMute:
+        return &HRendererConnectionPrivate::setMute;
+    case HRendererConnectionInfo::RcsVolume:
+        return &HRendererConnectionPrivate::setVolume;
+    case HRendererConnectionInfo::RcsVolumeDB:
+        return &HRendererConnectionPrivate::setVolumeDB;
+    case HRendererConnectionInfo::RcsLoudness:
+        return &HRendererConnectionPrivate::setLoudness;
+    default:
+        return 0;
+    }
+}
+
 bool HRendererConnectionPrivate::setBrightness(const QString& value, const HChannel&)
 {
     qint32 rc = q_ptr->setRcsValue(HRendererConnectionInfo::Brightness, value.toUShort());
@@ -803,13 +829,16 @@ bool HRendererConnection::setValue(const QString& svName, const QString& value)
 
 bool HRendererConnection::setValue(const QString& svName, const HChannel& ch, const QString& value)
 {
-    if (h_ptr->m_valueSetters.contains(svName))
+    HRendererConnectionInfo::StateVariable sv =
+        HRendererConnectionInfo::stateVariableFromString(svName);
+
+    ValueSetter setter = HRendererConnectionPrivate::valueSetter(sv);
+    if (setter)
     {
-        ValueSetter setter = h_ptr->m_valueSetters.value(svName);
-        setter(value, ch);
+        (h_ptr->*setter)(value, ch);
         return true;
     }
-    return h_ptr->m_info->setValue(svName, ch, value);
+    return h_ptr->m_info->setValue(sv, ch, value);
 }
 
 }
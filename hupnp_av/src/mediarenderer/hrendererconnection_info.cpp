@@ -165,14 +165,130 @@ bool operator==(const HRendererConnectionEventInfo& obj1, const HRendererConnect
            obj1.channel() == obj2.channel();
 }
 
+namespace
+{
+struct PropertyEntry
+{
+    const char* m_name;
+    ValueSetter m_setter;
+    ValueGetter m_getter;
+};
+
+// The order of the entries matches HRendererConnectionInfo::StateVariable,
+// which is used to index the table.
+const PropertyEntry PropertyTable[] =
+{
+    { 0, 0, 0 },
+    { "TransportState", &HRendererConnectionInfoPrivate::setTransportState, &HRendererConnectionInfoPrivate::getTransportState },
+    { "TransportStatus", &HRendererConnectionInfoPrivate::setTransportStatus, &HRendererConnectionInfoPrivate::getTransportStatus },
+    { "CurrentMediaCategory", &HRendererConnectionInfoPrivate::setCurrentMediaCategory, &HRendererConnectionInfoPrivate::getCurrentMediaCategory },
+    { "PlaybackStorageMedium", &HRendererConnectionInfoPrivate::setPlaybackStorageMedium, &HRendererConnectionInfoPrivate::getPlaybackStorageMedium },
+    { "RecordStorageMedium", &HRendererConnectionInfoPrivate::setRecordStorageMedium, &HRendererConnectionInfoPrivate::getRecordStorageMedium },
+    { "PossiblePlaybackStorageMedia", &HRendererConnectionInfoPrivate::setPossiblePlaybackStorageMedia, &HRendererConnectionInfoPrivate::getPossiblePlaybackStorageMedia },
+    { "PossibleRecordStorageMedia", &HRendererConnectionInfoPrivate::setPossibleRecordStorageMedia, &HRendererConnectionInfoPrivate::getPossibleRecordStorageMedia },
+    { "CurrentPlayMode", &HRendererConnectionInfoPrivate::setCurrentPlayMode, &HRendererConnectionInfoPrivate::getCurrentPlayMode },
+    { "TransportPlaySpeed", &HRendererConnectionInfoPrivate::setTransportPlaySpeed, &HRendererConnectionInfoPrivate::getTransportPlaySpeed },
+    { "RecordMediumWriteStatus", &HRendererConnectionInfoPrivate::setRecordMediumWriteStatus, &HRendererConnectionInfoPrivate::getRecordMediumWriteStatus },
+    { "CurrentRecordQualityMode", &HRendererConnectionInfoPrivate::setCurrentRecordQualityMode, &HRendererConnectionInfoPrivate::getCurrentRecordQualityMode },
+    { "PossibleRecordQualityModes", &HRendererConnectionInfoPrivate::setPossibleRecordQualityModes, &HRendererConnectionInfoPrivate::getPossibleRecordQualityModes },
+    { "NumberOfTracks", &HRendererConnectionInfoPrivate::setNumberOfTracks, &HRendererConnectionInfoPrivate::getNumberOfTracks },
+    { "CurrentTrack", &HRendererConnectionInfoPrivate::setCurrentTrack, &HRendererConnectionInfoPrivate::getCurrentTrack },
+    { "CurrentTrackDuration", &HRendererConnectionInfoPrivate::setCurrentTrackDuration, &HRendererConnectionInfoPrivate::getCurrentTrackDuration },
+    { "CurrentMediaDuration", &HRendererConnectionInfoPrivate::setCurrentMediaDuration, &HRendererConnectionInfoPrivate::getCurrentMediaDuration },
+    { "CurrentTrackMetaData", &HRendererConnectionInfoPrivate::setCurrentTrackMetaData, &HRendererConnectionInfoPrivate::getCurrentTrackMetaData },
+    { "CurrentTrackURI", &HRendererConnectionInfoPrivate::setCurrentTrackURI, &HRendererConnectionInfoPrivate::getCurrentTrackURI },
+    { "AVTransportURI", &HRendererConnectionInfoPrivate::setAVTransportURI, &HRendererConnectionInfoPrivate::getAVTransportURI },
+    { "AVTransportURIMetaData", &HRendererConnectionInfoPrivate::setAVTransportURIMetaData, &HRendererConnectionInfoPrivate::getAVTransportURIMetaData },
+    { "NextAVTransportURI", &HRendererConnectionInfoPrivate::setNextAVTransportURI, &HRendererConnectionInfoPrivate::getNextAVTransportURI },
+    { "NextAVTransportURIMetaData", &HRendererConnectionInfoPrivate::setNextAVTransportURIMetaData, &HRendererConnectionInfoPrivate::getNextAVTransportURIMetaData },
+    { "RelativeTimePosition", &HRendererConnectionInfoPrivate::setRelativeTimePosition, &HRendererConnectionInfoPrivate::getRelativeTimePosition },
+    { "AbsoluteTimePosition", &HRendererConnectionInfoPrivate::setAbsoluteTimePosition, &HRendererConnectionInfoPrivate::getAbsoluteTimePosition },
+    { "RelativeCounterPosition", &HRendererConnectionInfoPrivate::setRelativeCounterPosition, &HRendererConnectionInfoPrivate::getRelativeCounterPosition },
+    { "AbsoluteCounterPosition", &HRendererConnectionInfoPrivate::setAbsoluteCounterPosition, &HRendererConnectionInfoPrivate::getAbsoluteCounterPosition },
+    { "CurrentTransportActions", &HRendererConnectionInfoPrivate::setCurrentTransportActions, &HRendererConnectionInfoPrivate::getCurrentTransportActions },
+    { "DRMState", &HRendererConnectionInfoPrivate::setDrmState, &HRendererConnectionInfoPrivate::getDrmState },
+    { "Brightness", &HRendererConnectionInfoPrivate::setBrightness, &HRendererConnectionInfoPrivate::getBrightness },
+    { "Contrast", &HRendererConnectionInfoPrivate::setContrast, &HRendererConnectionInfoPrivate::getContrast },
+    { "Sharpness", &HRendererConnectionInfoPrivate::setSharpness, &HRendererConnectionInfoPrivate::getSharpness },
+    { "RedVideoGain", &HRendererConnectionInfoPrivate::setRedVideoGain, &HRendererConnectionInfoPrivate::getRedVideoGain },
+    { "GreenVideoGain", &HRendererConnectionInfoPrivate::setGreenVideoGain, &HRendererConnectionInfoPrivate::getGreenVideoGain },
+    { "BlueVideoGain", &HRendererConnectionInfoPrivate::setBlueVideoGain, &HRendererConnectionInfoPrivate::getBlueVideoGain },
+    { "RedVideoBlackLevel", &HRendererConnectionInfoPrivate::setRedVideoBlackLevel, &HRendererConnectionInfoPrivate::getRedVideoBlackLevel },
+    { "GreenVideoBlackLevel", &HRendererConnectionInfoPrivate::setGreenVideoBlackLevel, &HRendererConnectionInfoPrivate::getGreenVideoBlackLevel },
+    { "BlueVideoBlackLevel", &HRendererConnectionInfoPrivate::setBlueVideoBlackLevel, &HRendererConnectionInfoPrivate::getBlueVideoBlackLevel },
+    { "ColorTemperature", &HRendererConnectionInfoPrivate::setColorTemperature, &HRendererConnectionInfoPrivate::getColorTemperature },
+    { "HorizontalKeystone", &HRendererConnectionInfoPrivate::setHorizontalKeystone, &HRendererConnectionInfoPrivate::getHorizontalKeystone },
+    { "VerticalKeystone", &HRendererConnectionInfoPrivate::setVerticalKeystone, &HRendererConnectionInfoPrivate::getVerticalKeystone },
+    { "Mute", &HRendererConnectionInfoPrivate::setMute, &HRendererConnectionInfoPrivate::getMute },
+    { "Volume", &HRendererConnectionInfoPrivate::setVolume, &HRendererConnectionInfoPrivate::getVolume },
+    { "VolumeDB", &HRendererConnectionInfoPrivate::setVolumeDB, &HRendererConnectionInfoPrivate::getVolumeDB },
+    { "Loudness", &HRendererConnectionInfoPrivate::setLoudness, &HRendererConnectionInfoPrivate::getLoudness }
+};
+
+// The state variables sorted by name for binary search.
+const HRendererConnectionInfo::StateVariable PropertiesByName[] =
+{
+    HRendererConnectionInfo::AvtAVTransportURI,
+    HRendererConnectionInfo::AvtAVTransportURIMetaData,
+    HRendererConnectionInfo::AvtAbsoluteCounterPosition,
+    HRendererConnectionInfo::AvtAbsoluteTimePosition,
+    HRendererConnectionInfo::RcsBlueVideoBlackLevel,
+    HRendererConnectionInfo::RcsBlueVideoGain,
+    HRendererConnectionInfo::RcsBrightness,
+    HRendererConnectionInfo::RcsColorTemperature,
+    HRendererConnectionInfo::RcsContrast,
+    HRendererConnectionInfo::AvtCurrentMediaCategory,
+    HRendererConnectionInfo::AvtCurrentMediaDuration,
+    HRendererConnectionInfo::AvtCurrentPlayMode,
+    HRendererConnectionInfo::AvtCurrentRecordQualityMode,
+    HRendererConnectionInfo::AvtCurrentTrack,
+    HRendererConnectionInfo::AvtCurrentTrackDuration,
+    HRendererConnectionInfo::AvtCurrentTrackMetaData,
+    HRendererConnectionInfo::AvtCurrentTrackURI,
+    HRendererConnectionInfo::AvtCurrentTransportActions,
+    HRendererConnectionInfo::AvtDRMState,
+    HRendererConnectionInfo::RcsGreenVideoBlackLevel,
+    HRendererConnectionInfo::RcsGreenVideoGain,
+    HRendererConnectionInfo::RcsHorizontalKeystone,
+    HRendererConnectionInfo::RcsLoudness,
+    HRendererConnectionInfo::RcsMute,
+    HRendererConnectionInfo::AvtNextAVTransportURI,
+    HRendererConnectionInfo::AvtNextAVTransportURIMetaData,
+    HRendererConnectionInfo::AvtNumberOfTracks,
+    HRendererConnectionInfo::AvtPlaybackStorageMedium,
+    HRendererConnectionInfo::AvtPossiblePlaybackStorageMedia,
+    HRendererConnectionInfo::AvtPossibleRecordQualityModes,
+    HRendererConnectionInfo::AvtPossibleRecordStorageMedia,
+    HRendererConnectionInfo::AvtRecordMediumWriteStatus,
+    HRendererConnectionInfo::AvtRecordStorageMedium,
+    HRendererConnectionInfo::RcsRedVideoBlackLevel,
+    HRendererConnectionInfo::RcsRedVideoGain,
+    HRendererConnectionInfo::AvtRelativeCounterPosition,
+    HRendererConnectionInfo::AvtRelativeTimePosition,
+    HRendererConnectionInfo::RcsSharpness,
+    HRendererConnectionInfo::AvtTransportPlaySpeed,
+    HRendererConnectionInfo::AvtTransportState,
+    HRendererConnectionInfo::AvtTransportStatus,
+    HRendererConnectionInfo::RcsVerticalKeystone,
+    HRendererConnectionInfo::RcsVolume,
+    HRendererConnectionInfo::RcsVolumeDB
+};
+
+const qint32 PropertyCount =
+    sizeof(PropertiesByName) / sizeof(PropertiesByName[0]);
+
+inline bool isValidStateVariable(HRendererConnectionInfo::StateVariable sv)
+{
+    return sv > HRendererConnectionInfo::Undefined && sv <= PropertyCount;
+}
+}
+
 /*******************************************************************************
  * HRendererConnectionInfoPrivate
  ******************************************************************************/
 HRendererConnectionInfoPrivate::HRendererConnectionInfoPrivate() :
     q_ptr(0),
     m_parent(0),
-    m_valueSetters(),
-    m_valueGetters(),
     m_transportActions(),
     m_drmState(HAvTransportInfo::DrmState_Unknown),
     m_deviceCapabilities(),
@@ -186,97 +302,6 @@ HRendererConnectionInfoPrivate::HRendererConnectionInfoPrivate() :
     m_verticalKeystone(0),
     m_channelInfo()
 {
-    m_valueSetters.insert("TransportState", ValueSetter(this, &HRendererConnectionInfoPrivate::setTransportState));
-    m_valueSetters.insert("TransportStatus", ValueSetter(this, &HRendererConnectionInfoPrivate::setTransportStatus));
-    m_valueSetters.insert("CurrentMediaCategory", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentMediaCategory));
-    m_valueSetters.insert("PlaybackStorageMedium", ValueSetter(this, &HRendererConnectionInfoPrivate::setPlaybackStorageMedium));
-    m_valueSetters.insert("RecordStorageMedium", ValueSetter(this, &HRendererConnectionInfoPrivate::setRecordStorageMedium));
-    m_valueSetters.insert("PossiblePlaybackStorageMedia", ValueSetter(this, &HRendererConnectionInfoPrivate::setPossiblePlaybackStorageMedia));
-    m_valueSetters.insert("PossibleRecordStorageMedia", ValueSetter(this, &HRendererConnectionInfoPrivate::setPossibleRecordStorageMedia));
-    m_valueSetters.insert("CurrentPlayMode", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentPlayMode));
-    m_valueSetters.insert("TransportPlaySpeed", ValueSetter(this, &HRendererConnectionInfoPrivate::setTransportPlaySpeed));
-    m_valueSetters.insert("RecordMediumWriteStatus", ValueSetter(this, &HRendererConnectionInfoPrivate::setRecordMediumWriteStatus));
-    m_valueSetters.insert("CurrentRecordQualityMode", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentRecordQualityMode));
-    m_valueSetters.insert("PossibleRecordQualityModes", ValueSetter(this, &HRendererConnectionInfoPrivate::setPossibleRecordQualityModes));
-    m_valueSetters.insert("NumberOfTracks", ValueSetter(this, &HRendererConnectionInfoPrivate::setNumberOfTracks));
-    m_valueSetters.insert("CurrentTrack", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentTrack));
-    m_valueSetters.insert("CurrentTrackDuration", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentTrackDuration));
-    m_valueSetters.insert("CurrentMediaDuration", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentMediaDuration));
-    m_valueSetters.insert("CurrentTrackMetaData", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentTrackMetaData));
-    m_valueSetters.insert("CurrentTrackURI", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentTrackURI));
-    m_valueSetters.insert("AVTransportURI", ValueSetter(this, &HRendererConnectionInfoPrivate::setAVTransportURI));
-    m_valueSetters.insert("AVTransportURIMetaData", ValueSetter(this, &HRendererConnectionInfoPrivate::setAVTransportURIMetaData));
-    m_valueSetters.insert("NextAVTransportURI", ValueSetter(this, &HRendererConnectionInfoPrivate::setNextAVTransportURI));
-    m_valueSetters.insert("NextAVTransportURIMetaData", ValueSetter(this, &HRendererConnectionInfoPrivate::setNextAVTransportURIMetaData));
-    m_valueSetters.insert("RelativeTimePosition", ValueSetter(this, &HRendererConnectionInfoPrivate::setRelativeTimePosition));
-    m_valueSetters.insert("AbsoluteTimePosition", ValueSetter(this, &HRendererConnectionInfoPrivate::setAbsoluteTimePosition));
-    m_valueSetters.insert("RelativeCounterPosition", ValueSetter(this, &HRendererConnectionInfoPrivate::setRelativeCounterPosition));
-    m_valueSetters.insert("AbsoluteCounterPosition", ValueSetter(this, &HRendererConnectionInfoPrivate::setAbsoluteCounterPosition));
-    m_valueSetters.insert("CurrentTransportActions", ValueSetter(this, &HRendererConnectionInfoPrivate::setCurrentTransportActions));
-    m_valueSetters.insert("DRMState", ValueSetter(this, &HRendererConnectionInfoPrivate::setDrmState));
-
-    m_valueSetters.insert("Brightness", ValueSetter(this, &HRendererConnectionInfoPrivate::setBrightness));
-    m_valueSetters.insert("Contrast", ValueSetter(this, &HRendererConnectionInfoPrivate::setContrast));
-    m_valueSetters.insert("Sharpness", ValueSetter(this, &HRendererConnectionInfoPrivate::setSharpness));
-    m_valueSetters.insert("RedVideoGain", ValueSetter(this, &HRendererConnectionInfoPrivate::setRedVideoGain));
-    m_valueSetters.insert("GreenVideoGain", ValueSetter(this, &HRendererConnectionInfoPrivate::setGreenVideoGain));
-    m_valueSetters.insert("BlueVideoGain", ValueSetter(this, &HRendererConnectionInfoPrivate::setBlueVideoGain));
-    m_valueSetters.insert("RedVideoBlackLevel", ValueSetter(this, &HRendererConnectionInfoPrivate::setRedVideoBlackLevel));
-    m_valueSetters.insert("GreenVideoBlackLevel", ValueSetter(this, &HRendererConnectionInfoPrivate::setGreenVideoBlackLevel));
-    m_valueSetters.insert("BlueVideoBlackLevel", ValueSetter(this, &HRendererConnectionInfoPrivate::setBlueVideoBlackLevel));
-    m_valueSetters.insert("ColorTemperature", ValueSetter(this, &HRendererConnectionInfoPrivate::setColorTemperature));
-    m_valueSetters.insert("HorizontalKeystone", ValueSetter(this, &HRendererConnectionInfoPrivate::setHorizontalKeystone));
-    m_valueSetters.insert("VerticalKeystone", ValueSetter(this, &HRendererConnectionInfoPrivate::setVerticalKeystone));
-    m_valueSetters.insert("Mute", ValueSetter(this, &HRendererConnectionInfoPrivate::setMute));
-    m_valueSetters.insert("Volume", ValueSetter(this, &HRendererConnectionInfoPrivate::setVolume));
-    m_valueSetters.insert("VolumeDB", ValueSetter(this, &HRendererConnectionInfoPrivate::setVolumeDB));
-    m_valueSetters.insert("Loudness", ValueSetter(this, &HRendererConnectionInfoPrivate::setLoudness));
-
-    m_valueGetters.insert("TransportState", ValueGetter(this, &HRendererConnectionInfoPrivate::getTransportState));
-    m_valueGetters.insert("TransportStatus", ValueGetter(this, &HRendererConnectionInfoPrivate::getTransportStatus));
-    m_valueGetters.insert("CurrentMediaCategory", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentMediaCategory));
-    m_valueGetters.insert("PlaybackStorageMedium", ValueGetter(this, &HRendererConnectionInfoPrivate::getPlaybackStorageMedium));
-    m_valueGetters.insert("RecordStorageMedium", ValueGetter(this, &HRendererConnectionInfoPrivate::getRecordStorageMedium));
-    m_valueGetters.insert("PossiblePlaybackStorageMedia", ValueGetter(this, &HRendererConnectionInfoPrivate::getPossiblePlaybackStorageMedia));
-    m_valueGetters.insert("PossibleRecordStorageMedia", ValueGetter(this, &HRendererConnectionInfoPrivate::getPossibleRecordStorageMedia));
-    m_valueGetters.insert("CurrentPlayMode", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentPlayMode));
-    m_valueGetters.insert("TransportPlaySpeed", ValueGetter(this, &HRendererConnectionInfoPrivate::getTransportPlaySpeed));
-    m_valueGetters.insert("RecordMediumWriteStatus", ValueGetter(this, &HRendererConnectionInfoPrivate::getRecordMediumWriteStatus));
-    m_valueGetters.insert("CurrentRecordQualityMode", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentRecordQualityMode));
-    m_valueGetters.insert("PossibleRecordQualityModes", ValueGetter(this, &HRendererConnectionInfoPrivate::getPossibleRecordQualityModes));
-    m_valueGetters.insert("NumberOfTracks", ValueGetter(this, &HRendererConnectionInfoPrivate::getNumberOfTracks));
-    m_valueGetters.insert("CurrentTrack", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentTrack));
-    m_valueGetters.insert("CurrentTrackDuration", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentTrackDuration));
-    m_valueGetters.insert("CurrentMediaDuration", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentMediaDuration));
-    m_valueGetters.insert("CurrentTrackMetaData", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentTrackMetaData));
-    m_valueGetters.insert("CurrentTrackURI", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentTrackURI));
-    m_valueGetters.insert("AVTransportURI", ValueGetter(this, &HRendererConnectionInfoPrivate::getAVTransportURI));
-    m_valueGetters.insert("AVTransportURIMetaData", ValueGetter(this, &HRendererConnectionInfoPrivate::getAVTransportURIMetaData));
-    m_valueGetters.insert("NextAVTransportURI", ValueGetter(this, &HRendererConnectionInfoPrivate::getNextAVTransportURI));
-    m_valueGetters.insert("NextAVTransportURIMetaData", ValueGetter(this, &HRendererConnectionInfoPrivate::getNextAVTransportURIMetaData));
-    m_valueGetters.insert("RelativeTimePosition", ValueGetter(this, &HRendererConnectionInfoPrivate::getRelativeTimePosition));
-    m_valueGetters.insert("AbsoluteTimePosition", ValueGetter(this, &HRendererConnectionInfoPrivate::getAbsoluteTimePosition));
-    m_valueGetters.insert("RelativeCounterPosition", ValueGetter(this, &HRendererConnectionInfoPrivate::getRelativeCounterPosition));
-    m_valueGetters.insert("AbsoluteCounterPosition", ValueGetter(this, &HRendererConnectionInfoPrivate::getAbsoluteCounterPosition));
-    m_valueGetters.insert("CurrentTransportActions", ValueGetter(this, &HRendererConnectionInfoPrivate::getCurrentTransportActions));
-    m_valueGetters.insert("DRMState", ValueGetter(this, &HRendererConnectionInfoPrivate::getDrmState));
-
-    m_valueGetters.insert("Brightness", ValueGetter(this, &HRendererConnectionInfoPrivate::getBrightness));
-    m_valueGetters.insert("Contrast", ValueGetter(this, &HRendererConnectionInfoPrivate::getContrast));
-    m_valueGetters.insert("Sharpness", ValueGetter(this, &HRendererConnectionInfoPrivate::getSharpness));
-    m_valueGetters.insert("RedVideoGain", ValueGetter(this, &HRendererConnectionInfoPrivate::getRedVideoGain));
-    m_valueGetters.insert("GreenVideoGain", ValueGetter(this, &HRendererConnectionInfoPrivate::getGreenVideoGain));
-    m_valueGetters.insert("BlueVideoGain", ValueGetter(this, &HRendererConnectionInfoPrivate::getBlueVideoGain));
-    m_valueGetters.insert("RedVideoBlackLevel", ValueGetter(this, &HRendererConnectionInfoPrivate::getRedVideoBlackLevel));
-    m_valueGetters.insert("GreenVideoBlackLevel", ValueGetter(this, &HRendererConnectionInfoPrivate::getGreenVideoBlackLevel));
-    m_valueGetters.insert("BlueVideoBlackLevel", ValueGetter(this, &HRendererConnectionInfoPrivate::getBlueVideoBlackLevel));
-    m_valueGetters.insert("ColorTemperature", ValueGetter(this, &HRendererConnectionInfoPrivate::getColorTemperature));
-    m_valueGetters.insert("HorizontalKeystone", ValueGetter(this, &HRendererConnectionInfoPrivate::getHorizontalKeystone));
-    m_valueGetters.insert("VerticalKeystone", ValueGetter(this, &HRendererConnectionInfoPrivate::getVerticalKeystone));
-    m_valueGetters.insert("Mute", ValueGetter(this, &HRendererConnectionInfoPrivate::getMute));
-    m_valueGetters.insert("Volume", ValueGetter(this, &HRendererConnectionInfoPrivate::getVolume));
-    m_valueGetters.insert("VolumeDB", ValueGetter(this, &HRendererConnectionInfoPrivate::getVolumeDB));
-    m_valueGetters.insert("Loudness", ValueGetter(this, &HRendererConnectionInfoPrivate::getLoudness));
 }
 
 HRendererConnectionInfoPrivate::~HRendererConnectionInfoPrivate()
@@ -1546,15 +1571,21 @@ QString HRendererConnectionInfo::value(const QString& svName, bool* ok) const
 QString HRendererConnectionInfo::value(
     const QString& svName, const HChannel& channel, bool* ok) const
 {
-    if (h_ptr->m_valueGetters.contains(svName))
+    StateVariable sv = stateVariableFromString(svName);
+    if (ok) { *ok = sv != Undefined; }
+    return value(sv, channel);
+}
+
+QString HRendererConnectionInfo::value(
+    StateVariable sv, const HChannel& channel) const
+{
+    if (!isValidStateVariable(sv))
     {
-        if (ok) { *ok = true; }
-        ValueGetter getter = h_ptr->m_valueGetters.value(svName);
-        return getter(channel);
+        return QString();
     }
 
-    if (ok) { *ok = false; }
-    return QString();
+    ValueGetter getter = PropertyTable[sv].m_getter;
+    return (h_ptr->*getter)(channel);
 }
 
 bool HRendererConnectionInfo::setValue(const QString& svName, const QString& value)
@@ -1565,13 +1596,60 @@ bool HRendererConnectionInfo::setValue(const QString& svName, const QString& val
 bool HRendererConnectionInfo::setValue(
     const QString& svName, const HChannel& channel, const QString& value)
 {
-    if (h_ptr->m_valueSetters.contains(svName))
+    return setValue(stateVariableFromString(svName), channel, value);
+}
+
+bool HRendererConnectionInfo::setValue(StateVariable sv, const QString& value)
+{
+    return setValue(sv, HChannel(), value);
+}
+
+bool HRendererConnectionInfo::setValue(
+    StateVariable sv, const HChannel& channel, const QString& value)
+{
+    if (!isValidStateVariable(sv))
+    {
+        return false;
+    }
+
+    ValueSetter setter = PropertyTable[sv].m_setter;
+    (h_ptr->*setter)(value, channel);
+    return true;
+}
+
+HRendererConnectionInfo::StateVariable
+    HRendererConnectionInfo::stateVariableFromString(const QString& svName)
+{
+    qint32 low = 0, high = PropertyCount - 1;
+    while(low <= high)
+    {
+        qint32 mid = (low + high) / 2;
+        StateVariable sv = PropertiesByName[mid];
+
+        qint32 cmp = svName.compare(QLatin1String(PropertyTable[sv].m_name));
+        if (cmp < 0)
+        {
+            high = mid - 1;
+        }
+        else if (cmp > 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            return sv;
+        }
+    }
+    return Undefined;
+}
+
+QString HRendererConnectionInfo::stateVariableToString(StateVariable sv)
+{
+    if (!isValidStateVariable(sv))
     {
-        ValueSetter setter = h_ptr->m_valueSetters.value(svName);
-        setter(value, channel);
-        return true;
+        return QString();
     }
-    return false;
+    return QString::fromLatin1(PropertyTable[sv].m_name);
 }
 
 bool HRendererConnectionInfo::hasChannelAssociated(const QString& svName)
@@ -1193,6 +1193,271 @@ public:
      */
     bool setLoudness(const HChannel& channel, bool enabled);
 
+    /*!
+     * \brief This enumeration defines the AVTransport and RenderingControl
+     * state variables, which values can be set and retrieved using
+     * value() and setValue().
+     *
+     * \sa stateVariableFromString(), stateVariableToString()
+     */
+    enum StateVariable
+    {
+        /*!
+         * The state variable is not known.
+         */
+        Undefined = 0,
+
+        /*!
+         * AVTransport:TransportState.
+         */
+        AvtTransportState,
+
+        /*!
+         * AVTransport:TransportStatus.
+         */
+        AvtTransportStatus,
+
+        /*!
+         * AVTransport:CurrentMediaCategory.
+         */
+        AvtCurrentMediaCategory,
+
+        /*!
+         * AVTransport:PlaybackStorageMedium.
+         */
+        AvtPlaybackStorageMedium,
+
+        /*!
+         * AVTransport:RecordStorageMedium.
+         */
+        AvtRecordStorageMedium,
+
+        /*!
+         * AVTransport:PossiblePlaybackStorageMedia.
+         */
+        AvtPossiblePlaybackStorageMedia,
+
+        /*!
+         * AVTransport:PossibleRecordStorageMedia.
+         */
+        AvtPossibleRecordStorageMedia,
+
+        /*!
+         * AVTransport:CurrentPlayMode.
+         */
+        AvtCurrentPlayMode,
+
+        /*!
+         * AVTransport:TransportPlaySpeed.
+         */
+        AvtTransportPlaySpeed,
+
+        /*!
+         * AVTransport:RecordMediumWriteStatus.
+         */
+        AvtRecordMediumWriteStatus,
+
+        /*!
+         * AVTransport:CurrentRecordQualityMode.
+         */
+        AvtCurrentRecordQualityMode,
+
+        /*!
+         * AVTransport:PossibleRecordQualityModes.
+         */
+        AvtPossibleRecordQualityModes,
+
+        /*!
+         * AVTransport:NumberOfTracks.
+         */
+        AvtNumberOfTracks,
+
+        /*!
+         * AVTransport:CurrentTrack.
+         */
+        AvtCurrentTrack,
+
+        /*!
+         * AVTransport:CurrentTrackDuration.
+         */
+        AvtCurrentTrackDuration,
+
+        /*!
+         * AVTransport:CurrentMediaDuration.
+         */
+        AvtCurrentMediaDuration,
+
+        /*!
+         * AVTransport:CurrentTrackMetaData.
+         */
+        AvtCurrentTrackMetaData,
+
+        /*!
+         * AVTransport:CurrentTrackURI.
+         */
+        AvtCurrentTrackURI,
+
+        /*!
+         * AVTransport:AVTransportURI.
+         */
+        AvtAVTransportURI,
+
+        /*!
+         * AVTransport:AVTransportURIMetaData.
+         */
+        AvtAVTransportURIMetaData,
+
+        /*!
+         * AVTransport:NextAVTransportURI.
+         */
+        AvtNextAVTransportURI,
+
+        /*!
+         * AVTransport:NextAVTransportURIMetaData.
+         */
+        AvtNextAVTransportURIMetaData,
+
+        /*!
+         * AVTransport:RelativeTimePosition.
+         */
+        AvtRelativeTimePosition,
+
+        /*!
+         * AVTransport:AbsoluteTimePosition.
+         */
+        AvtAbsoluteTimePosition,
+
+        /*!
+         * AVTransport:RelativeCounterPosition.
+         */
+        AvtRelativeCounterPosition,
+
+        /*!
+         * AVTransport:AbsoluteCounterPosition.
+         */
+        AvtAbsoluteCounterPosition,
+
+        /*!
+         * AVTransport:CurrentTransportActions.
+         */
+        AvtCurrentTransportActions,
+
+        /*!
+         * AVTransport:DRMState.
+         */
+        AvtDRMState,
+
+        /*!
+         * RenderingControl:Brightness.
+         */
+        RcsBrightness,
+
+        /*!
+         * RenderingControl:Contrast.
+         */
+        RcsContrast,
+
+        /*!
+         * RenderingControl:Sharpness.
+         */
+        RcsSharpness,
+
+        /*!
+         * RenderingControl:RedVideoGain.
+         */
+        RcsRedVideoGain,
+
+        /*!
+         * RenderingControl:GreenVideoGain.
+         */
+        RcsGreenVideoGain,
+
+        /*!
+         * RenderingControl:BlueVideoGain.
+         */
+        RcsBlueVideoGain,
+
+        /*!
+         * RenderingControl:RedVideoBlackLevel.
+         */
+        RcsRedVideoBlackLevel,
+
+        /*!
+         * RenderingControl:GreenVideoBlackLevel.
+         */
+        RcsGreenVideoBlackLevel,
+
+        /*!
+         * RenderingControl:BlueVideoBlackLevel.
+         */
+        RcsBlueVideoBlackLevel,
+
+        /*!
+         * RenderingControl:ColorTemperature.
+         */
+        RcsColorTemperature,
+
+        /*!
+         * RenderingControl:HorizontalKeystone.
+         */
+        RcsHorizontalKeystone,
+
+        /*!
+         * RenderingControl:VerticalKeystone.
+         */
+        RcsVerticalKeystone,
+
+        /*!
+         * RenderingControl:Mute.
+         */
+        RcsMute,
+
+        /*!
+         * RenderingControl:Volume.
+         */
+        RcsVolume,
+
+        /*!
+         * RenderingControl:VolumeDB.
+         */
+        RcsVolumeDB,
+
+        /*!
+         * RenderingControl:Loudness.
+         */
+        RcsLoudness
+    };
+
+    /*!
+     * \brief Returns the StateVariable value corresponding to the
+     * specified state variable name.
+     *
+     * The lookup is a binary search over a static table shared by all
+     * instances and it does not allocate memory.
+     *
+     * \param svName specifies the name of the state variable. The name is
+     * case-sensitive.
+     *
+     * \return the StateVariable value corresponding to the specified
+     * state variable name, or HRendererConnectionInfo::Undefined if the
+     * name is not recognized.
+     *
+     * \sa stateVariableToString()
+     */
+    static StateVariable stateVariableFromString(const QString& svName);
+
+    /*!
+     * \brief Returns the name of the specified state variable.
+     *
+     * \param sv specifies the state variable.
+     *
+     * \return the name of the specified state variable, or an empty string
+     * if \a sv is HRendererConnectionInfo::Undefined.
+     *
+     * \sa stateVariableFromString()
+     */
+    static QString stateVariableToString(StateVariable sv);
+
     /*!
      * \brief Returns the value of the specified property.
      *
@@ -1225,6 +1490,24 @@ public:
      */
     QString value(const QString& svName, const HChannel& channel, bool* ok = 0) const;
 
+    /*!
+     * \brief Returns the value of the specified property.
+     *
+     * This is faster than value(const QString&, const HChannel&, bool*),
+     * as the property does not have to be looked up by name.
+     *
+     * \param sv specifies the property, which value should be returned.
+     *
+     * \param channel specifies the audio channel of which the property value
+     * is retrieved.
+     *
+     * \return the value of the specified property. The returned string is
+     * empty if \a sv is HRendererConnectionInfo::Undefined.
+     *
+     * \sa setValue()
+     */
+    QString value(StateVariable sv, const HChannel& channel = HChannel()) const;
+
     /*!
      * \brief Specifies a new value for the specified property.
      *
@@ -1255,6 +1538,37 @@ public:
      */
     bool setValue(const QString& svName, const HChannel& channel, const QString& value);
 
+    /*!
+     * \brief Specifies a new value for the specified property.
+     *
+     * \param sv specifies the property, which value should be set.
+     *
+     * \param value specifies the new value for the property.
+     *
+     * \return \e true if the value of the specified property was set.
+     *
+     * \sa value()
+     */
+    bool setValue(StateVariable sv, const QString& value);
+
+    /*!
+     * \brief Specifies a new value for the specified property.
+     *
+     * This is faster than setValue(const QString&, const HChannel&, const QString&),
+     * as the property does not have to be looked up by name.
+     *
+     * \param sv specifies the property, which value should be set.
+     *
+     * \param channel specifies the audio channel of which property should be set.
+     *
+     * \param value specifies a new value for the property.
+     *
+     * \return \e true if the value of the specified property was set.
+     *
+     * \sa value()
+     */
+    bool setValue(StateVariable sv, const HChannel& channel, const QString& value);
+
     /*!
      * Indicates if the specified state variable is associated with an
      * audio channel.
@@ -48,8 +48,6 @@
 
 #include "../renderingcontrol/hchannel.h"
 
-#include <HUpnpCore/HFunctor>
-
 #include <QtCore/QSet>
 #include <QtCore/QList>
 #include <QtCore/QHash>
@@ -84,8 +82,13 @@ public:
     inline const HChannel& channel() const { return m_channel; }
 };
 
-typedef Functor<void, H_TYPELIST_2(const QString&, const HChannel&)> ValueSetter;
-typedef Functor<QString, H_TYPELIST_1(const HChannel&)> ValueGetter;
+class HRendererConnectionInfoPrivate;
+
+typedef void (HRendererConnectionInfoPrivate::*ValueSetter)(
+    const QString&, const HChannel&);
+
+typedef QString (HRendererConnectionInfoPrivate::*ValueGetter)(
+    const HChannel&) const;
 
 //
 //
@@ -193,9 +196,6 @@ public:
     HRendererConnectionInfo* q_ptr;
     HRendererConnection* m_parent;
 
-    QHash<QString, ValueSetter> m_valueSetters;
-    QHash<QString, ValueGetter> m_valueGetters;
-
     // AVT
     QSet<HTransportAction> m_transportActions;
     HAvTransportInfo::DrmState m_drmState;
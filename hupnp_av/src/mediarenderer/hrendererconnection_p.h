@@ -33,9 +33,6 @@
 #include "hrendererconnection_info.h"
 #include "../connectionmanager/hconnectioninfo.h"
 
-#include <HUpnpCore/HFunctor>
-
-#include <QtCore/QHash>
 #include <QtCore/QString>
 
 namespace Herqq
@@ -47,9 +44,11 @@ namespace Upnp
 namespace Av
 {
 
-typedef Functor<bool, H_TYPELIST_2(const QString&, const HChannel&)> ValueSetter;
-
 class HRendererConnection;
+class HRendererConnectionPrivate;
+
+typedef bool (HRendererConnectionPrivate::*ValueSetter)(
+    const QString&, const HChannel&);
 
 //
 //
@@ -83,10 +82,11 @@ public:
     HConnectionInfo* m_connectionInfo;
     HAbstractConnectionManagerService* m_service;
     HRendererConnection* q_ptr;
-    QHash<QString, ValueSetter> m_valueSetters;
 
     HRendererConnectionPrivate();
     virtual ~HRendererConnectionPrivate();
+
+    static ValueSetter valueSetter(HRendererConnectionInfo::StateVariable);
 };
 
 }
@@ -21,6 +21,7 @@
 
 #include "havtransport_adapter.h"
 #include "havtransport_adapter_p.h"
+#include "havtransport_codec_p.h"
 
 #include "hduration.h"
 #include "hplaymode.h"
@@ -55,6 +56,8 @@
 #include <HUpnpCore/HClientStateVariable>
 
 #include <QtCore/QUrl>
+#include <QtCore/QTimerEvent>
+#include <QtCore/QXmlStreamReader>
 
 namespace Herqq
 {
@@ -70,7 +73,10 @@ namespace Av
  ******************************************************************************/
 HAvTransportAdapterPrivate::HAvTransportAdapterPrivate() :
     HClientServiceAdapterPrivate(HAvTransportInfo::supportedServiceType()),
-        m_instanceId(0)
+        m_instanceId(0),
+        m_pollInterval(0), m_pollTimer(), m_tickTimer(), m_trackedState(),
+        m_stateEvented(false), m_playSpeed(1), m_position(0),
+        m_trackDuration(0), m_positionAge(), m_pendingPolls(0)
 {
 }
 
@@ -78,6 +84,331 @@ HAvTransportAdapterPrivate::~HAvTransportAdapterPrivate()
 {
 }
 
+namespace
+{
+qint64 toMsecs(const HDuration& duration)
+{
+    qint64 retVal =
+        (duration.hours() * 3600 + duration.minutes() * 60 +
+         duration.seconds()) * 1000;
+
+    if (duration.fractionsOfSecond() < 1)
+    {
+        retVal += static_cast<qint64>(duration.fractionsOfSecond() * 1000);
+    }
+
+    return duration.isPositive() ? retVal : -retVal;
+}
+
+HDuration toDuration(qint64 msecs)
+{
+    qint64 secs = msecs / 1000;
+    return HDuration(QString("%1:%2:%3").arg(
+        QString::number(secs / 3600),
+        QString::number((secs / 60) % 60).rightJustified(2, '0'),
+        QString::number(secs % 60).rightJustified(2, '0')));
+}
+
+// TransportPlaySpeed is either an integer or a fraction, such as "1/2".
+qreal toPlaySpeed(const QString& arg)
+{
+    bool ok = false;
+
+    qint32 index = arg.indexOf('/');
+    if (index < 0)
+    {
+        qreal retVal = arg.toDouble(&ok);
+        return ok ? retVal : 1;
+    }
+
+    qreal dividend = arg.left(index).toDouble(&ok);
+    if (ok)
+    {
+        qreal divisor = arg.mid(index + 1).toDouble(&ok);
+        if (ok && divisor != 0)
+        {
+            return dividend / divisor;
+        }
+    }
+
+    return 1;
+}
+
+// Spreads the polls of adapters started at the same time over the interval.
+qint32 jitter(qint32 interval)
+{
+    return interval - interval / 10 + qrand() % (interval / 5 + 1);
+}
+}
+
+qint64 HAvTransportAdapterPrivate::trackedPosition() const
+{
+    qint64 retVal = m_position;
+    if (isMoving() && m_positionAge.isValid())
+    {
+        retVal += static_cast<qint64>(m_positionAge.elapsed() * m_playSpeed);
+    }
+
+    if (retVal < 0)
+    {
+        retVal = 0;
+    }
+    else if (m_trackDuration > 0 && retVal > m_trackDuration)
+    {
+        retVal = m_trackDuration;
+    }
+
+    return retVal;
+}
+
+void HAvTransportAdapterPrivate::schedulePoll(qint32 delay)
+{
+    H_Q(HAvTransportAdapter);
+    m_pollTimer.start(delay, q);
+}
+
+void HAvTransportAdapterPrivate::poll()
+{
+    if (!m_pollInterval)
+    {
+        return;
+    }
+
+    if (m_pendingPolls > 0)
+    {
+        // the renderer has not responded to the previous poll yet
+        schedulePoll(jitter(m_pollInterval));
+        return;
+    }
+
+    HActionArguments inArgs;
+    if (!m_stateEvented)
+    {
+        HClientAction* action = getAction("GetTransportInfo");
+        if (action)
+        {
+            inArgs = action->info().inputArguments();
+            inArgs.setValue("InstanceID", m_instanceId);
+
+            HClientAdapterOp<HTransportInfo> op = beginInvoke<HTransportInfo>(
+                action, inArgs,
+                HActionInvokeCallback(
+                    this, &HAvTransportAdapterPrivate::transportInfoPolled));
+
+            if (op.returnValue() == UpnpInvocationInProgress)
+            {
+                ++m_pendingPolls;
+            }
+        }
+    }
+
+    if (isMoving() || !m_trackedState.isValid())
+    {
+        HClientAction* action = getAction("GetPositionInfo");
+        if (action)
+        {
+            inArgs = action->info().inputArguments();
+            inArgs.setValue("InstanceID", m_instanceId);
+
+            HClientAdapterOp<HPositionInfo> op = beginInvoke<HPositionInfo>(
+                action, inArgs,
+                HActionInvokeCallback(
+                    this, &HAvTransportAdapterPrivate::positionPolled));
+
+            if (op.returnValue() == UpnpInvocationInProgress)
+            {
+                ++m_pendingPolls;
+            }
+        }
+    }
+
+    if (isMoving() || !m_stateEvented)
+    {
+        schedulePoll(jitter(m_pollInterval));
+    }
+}
+
+void HAvTransportAdapterPrivate::updateTransportState(
+    const HTransportState& state, const QString& speed)
+{
+    H_Q(HAvTransportAdapter);
+
+    bool wasMoving = isMoving();
+
+    m_position = trackedPosition();
+    m_positionAge.restart();
+
+    if (state.isValid())
+    {
+        m_trackedState = state;
+    }
+    if (!speed.isEmpty())
+    {
+        m_playSpeed = toPlaySpeed(speed);
+    }
+
+    if (isMoving())
+    {
+        if (!m_tickTimer.isActive())
+        {
+            m_tickTimer.start(1000, q);
+        }
+        if (!wasMoving)
+        {
+            // the position is extrapolated until it is confirmed by the
+            // renderer soon after the playback has started.
+            schedulePoll(qrand() % 250);
+        }
+    }
+    else
+    {
+        m_tickTimer.stop();
+        if (m_stateEvented)
+        {
+            m_pollTimer.stop();
+        }
+        if (wasMoving)
+        {
+            emit q->positionChanged(q, toDuration(m_position));
+        }
+    }
+}
+
+void HAvTransportAdapterPrivate::updatePosition(qint64 position)
+{
+    H_Q(HAvTransportAdapter);
+
+    m_position = position;
+    m_positionAge.restart();
+
+    emit q->positionChanged(q, toDuration(trackedPosition()));
+}
+
+void HAvTransportAdapterPrivate::processLastChange(const QString& data)
+{
+    QXmlStreamReader reader(data.trimmed());
+
+    if (!reader.readNextStartElement() ||
+        reader.name().compare("Event", Qt::CaseInsensitive) != 0)
+    {
+        return;
+    }
+
+    QString state, speed, position, duration;
+    bool found = false;
+    while(!reader.atEnd() && reader.readNextStartElement())
+    {
+        if (reader.name().compare("InstanceID", Qt::CaseInsensitive) ||
+            reader.attributes().value("val").toString().toUInt() != m_instanceId)
+        {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        found = true;
+        while(!reader.atEnd() && reader.readNextStartElement())
+        {
+            QStringRef name = reader.name();
+            QString value = reader.attributes().value("val").toString();
+
+            if (name == QLatin1String("TransportState"))
+            {
+                state = value;
+            }
+            else if (name == QLatin1String("TransportPlaySpeed"))
+            {
+                speed = value;
+            }
+            else if (name == QLatin1String("RelativeTimePosition"))
+            {
+                position = value;
+            }
+            else if (name == QLatin1String("CurrentTrackDuration"))
+            {
+                duration = value;
+            }
+
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (!found)
+    {
+        return;
+    }
+
+    // the renderer events the transport state, which means that the
+    // transport state does not need to be polled anymore
+    m_stateEvented = true;
+
+    if (!duration.isEmpty())
+    {
+        m_trackDuration = toMsecs(HDuration(duration));
+    }
+    if (!state.isEmpty() || !speed.isEmpty())
+    {
+        updateTransportState(HTransportState(state), speed);
+    }
+    if (!position.isEmpty() && position != "NOT_IMPLEMENTED")
+    {
+        updatePosition(toMsecs(HDuration(position)));
+    }
+}
+
+bool HAvTransportAdapterPrivate::positionPolled(
+    HClientAction*, const HClientActionOp& op)
+{
+    --m_pendingPolls;
+
+    HPositionInfo info;
+    takeOp(op, info);
+
+    if (op.returnValue() != UpnpSuccess || !m_pollInterval)
+    {
+        return false;
+    }
+
+    const HActionArguments& outArgs = op.outputArguments();
+
+    QString relTime = outArgs.value("RelTime").toString();
+    if (relTime.isEmpty() || relTime == "NOT_IMPLEMENTED")
+    {
+        return false;
+    }
+
+    QString trackDuration = outArgs.value("TrackDuration").toString();
+    if (!trackDuration.isEmpty() && trackDuration != "NOT_IMPLEMENTED")
+    {
+        m_trackDuration = toMsecs(HDuration(trackDuration));
+    }
+
+    updatePosition(toMsecs(HDuration(relTime)));
+
+    return false;
+}
+
+bool HAvTransportAdapterPrivate::transportInfoPolled(
+    HClientAction*, const HClientActionOp& op)
+{
+    --m_pendingPolls;
+
+    HTransportInfo info;
+    takeOp(op, info);
+
+    if (op.returnValue() != UpnpSuccess || !m_pollInterval || m_stateEvented)
+    {
+        return false;
+    }
+
+    const HActionArguments& outArgs = op.outputArguments();
+
+    updateTransportState(
+        HTransportState(outArgs.value("CurrentTransportState").toString()),
+        outArgs.value("CurrentSpeed").toString());
+
+    return false;
+}
+
 bool HAvTransportAdapterPrivate::setAVTransportURI(
     HClientAction*, const HClientActionOp& op)
 {
@@ -409,7 +740,34 @@ HAvTransportAdapter::~HAvTransportAdapter()
 void HAvTransportAdapter::lastChange(
     const HClientStateVariable*, const HStateVariableEvent& event)
 {
-    emit lastChangeReceived(this, event.newValue().toString());
+    H_D(HAvTransportAdapter);
+
+    QString data = event.newValue().toString();
+    if (h->m_pollInterval)
+    {
+        h->processLastChange(data);
+    }
+
+    emit lastChangeReceived(this, data);
+}
+
+void HAvTransportAdapter::timerEvent(QTimerEvent* event)
+{
+    H_D(HAvTransportAdapter);
+
+    if (event->timerId() == h->m_pollTimer.timerId())
+    {
+        h->m_pollTimer.stop();
+        h->poll();
+    }
+    else if (event->timerId() == h->m_tickTimer.timerId())
+    {
+        emit positionChanged(this, trackedPosition());
+    }
+    else
+    {
+        HClientServiceAdapter::timerEvent(event);
+    }
 }
 
 bool HAvTransportAdapter::prepareService(HClientService* service)
@@ -424,6 +782,20 @@ bool HAvTransportAdapter::prepareService(HClientService* service)
             SLOT(lastChange(const Herqq::Upnp::HClientStateVariable*,Herqq::Upnp::HStateVariableEvent)));
         Q_ASSERT(ok); Q_UNUSED(ok)
     }
+
+    // the actions that are polled while the position is tracked are encoded
+    // and decoded without the generic SOAP conversions. If the renderer
+    // describes them differently from the specification, the codec is not
+    // taken into use and the actions are invoked as usual.
+    foreach(HClientAction* action, service->actions())
+    {
+        const HActionCodec* codec = HAvTransportCodec::codec(action->info().name());
+        if (codec)
+        {
+            action->setCodec(codec);
+        }
+    }
+
     return true;
 }
 
@@ -535,6 +907,52 @@ HClientAdapterOp<HTransportInfo> HAvTransportAdapter::getTransportInfo()
         inArgs, HActionInvokeCallback(h, &HAvTransportAdapterPrivate::getTransportInfo));
 }
 
+bool HAvTransportAdapter::startPositionTracking(qint32 pollInterval)
+{
+    H_D(HAvTransportAdapter);
+
+    if (!isReady() || !h_ptr->getAction("GetPositionInfo"))
+    {
+        return false;
+    }
+
+    if (pollInterval <= 0)
+    {
+        pollInterval = 5000;
+    }
+
+    bool wasTracking = h->m_pollInterval > 0;
+    h->m_pollInterval = pollInterval;
+
+    if (!wasTracking)
+    {
+        h->schedulePoll(qrand() % pollInterval);
+    }
+
+    return true;
+}
+
+void HAvTransportAdapter::stopPositionTracking()
+{
+    H_D(HAvTransportAdapter);
+
+    h->m_pollInterval = 0;
+    h->m_pollTimer.stop();
+    h->m_tickTimer.stop();
+}
+
+bool HAvTransportAdapter::isTrackingPosition() const
+{
+    const H_D(HAvTransportAdapter);
+    return h->m_pollInterval > 0;
+}
+
+HDuration HAvTransportAdapter::trackedPosition() const
+{
+    const H_D(HAvTransportAdapter);
+    return toDuration(h->trackedPosition());
+}
+
 HClientAdapterOp<HPositionInfo> HAvTransportAdapter::getPositionInfo()
 {
     H_D(HAvTransportAdapter);
@@ -22,6 +22,7 @@
 #ifndef HAVTRANSPORT_ADAPTER_H_
 #define HAVTRANSPORT_ADAPTER_H_
 
+#include <HUpnpAv/HDuration>
 #include <HUpnpAv/HMediaInfo>
 #include <HUpnpAv/HPositionInfo>
 #include <HUpnpAv/HTransportInfo>
@@ -83,6 +84,7 @@ private Q_SLOTS:
 protected:
 
     virtual bool prepareService(HClientService* service);
+    virtual void timerEvent(QTimerEvent*);
 
 public:
 
@@ -410,6 +412,61 @@ public:
         const HUdn& avtUdn, const HResourceType& serviceType,
         const HServiceId& serviceId, const QString& stateVariableValuePairs);
 
+    /*!
+     * \brief Starts tracking the relative time position of the current track.
+     *
+     * Renderers do not event the \c RelativeTimePosition state variable, which
+     * is why the position has to be polled. While the position is tracked,
+     * the instance polls \c GetPositionInfo every \a pollInterval
+     * milliseconds, but only while the transport is playing. Between the polls
+     * the position is extrapolated locally using the \c TransportPlaySpeed
+     * and the positionChanged() signal is emitted once a second.
+     *
+     * If the service sends \c LastChange events, the transport state is
+     * read from them. Otherwise the transport state is polled with
+     * \c GetTransportInfo at the same interval.
+     *
+     * The first poll is delayed by a random fraction of the interval and
+     * every subsequent interval is randomized slightly, so that
+     * the polls of a large number of renderers do not coincide.
+     *
+     * \param pollInterval specifies the polling interval in milliseconds.
+     * Values less than or equal to zero are rejected and instead the default
+     * value of 5 seconds is used.
+     *
+     * \return \e true in case the tracking was started.
+     *
+     * \sa stopPositionTracking(), trackedPosition(), positionChanged()
+     */
+    bool startPositionTracking(qint32 pollInterval = 5000);
+
+    /*!
+     * \brief Stops tracking the position of the current track.
+     *
+     * \sa startPositionTracking()
+     */
+    void stopPositionTracking();
+
+    /*!
+     * \brief Indicates whether the position of the current track is tracked.
+     *
+     * \return \e true when the position of the current track is tracked.
+     *
+     * \sa startPositionTracking()
+     */
+    bool isTrackingPosition() const;
+
+    /*!
+     * \brief Returns the relative time position of the current track
+     * extrapolated to this moment.
+     *
+     * \return The relative time position of the current track
+     * extrapolated to this moment.
+     *
+     * \sa startPositionTracking(), positionChanged()
+     */
+    HDuration trackedPosition() const;
+
 Q_SIGNALS:
 
     /*!
@@ -743,6 +800,22 @@ Q_SIGNALS:
      */
     void lastChangeReceived(
         Herqq::Upnp::Av::HAvTransportAdapter* source, const QString& data);
+
+    /*!
+     * \brief This signal is emitted when the tracked position of the current
+     * track has changed.
+     *
+     * \param source specifies the HAvTransportAdapter instance that
+     * sent the event.
+     *
+     * \param position specifies the relative time position of the current
+     * track, possibly extrapolated from a previously received position.
+     *
+     * \sa startPositionTracking(), trackedPosition()
+     */
+    void positionChanged(
+        Herqq::Upnp::Av::HAvTransportAdapter* source,
+        const Herqq::Upnp::Av::HDuration& position);
 };
 
 }
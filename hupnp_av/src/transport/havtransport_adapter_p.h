@@ -30,8 +30,13 @@
 // change or the file may be removed without of notice.
 //
 
+#include "htransportstate.h"
+
 #include <HUpnpCore/private/hclientservice_adapter_p.h>
 
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+
 namespace Herqq
 {
 
@@ -54,9 +59,53 @@ public:
 
     quint32 m_instanceId;
 
+    //
+    // position tracking
+    //
+
+    qint32 m_pollInterval;
+    // zero when the position is not tracked
+
+    QBasicTimer m_pollTimer;
+    QBasicTimer m_tickTimer;
+
+    HTransportState m_trackedState;
+
+    bool m_stateEvented;
+    // true when the transport state is received in LastChange events,
+    // in which case the transport state does not need to be polled
+
+    qreal m_playSpeed;
+
+    qint64 m_position;
+    qint64 m_trackDuration;
+    // in milliseconds
+
+    QElapsedTimer m_positionAge;
+    // the time elapsed since m_position was last updated
+
+    qint32 m_pendingPolls;
+
     HAvTransportAdapterPrivate();
     virtual ~HAvTransportAdapterPrivate();
 
+    inline bool isMoving() const
+    {
+        return m_trackedState.type() == HTransportState::Playing ||
+               m_trackedState.type() == HTransportState::Recording;
+    }
+
+    qint64 trackedPosition() const;
+
+    void schedulePoll(qint32 delay);
+    void poll();
+    void updateTransportState(const HTransportState&, const QString& speed);
+    void updatePosition(qint64 position);
+    void processLastChange(const QString&);
+
+    bool positionPolled(HClientAction*, const HClientActionOp&);
+    bool transportInfoPolled(HClientAction*, const HClientActionOp&);
+
     bool setAVTransportURI(HClientAction*, const HClientActionOp&);
     bool setNextAVTransportURI(HClientAction*, const HClientActionOp&);
     bool getMediaInfo(HClientAction*, const HClientActionOp&);
@@ -0,0 +1,202 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP Av (HUPnPAv) library.
+ *
+ *  Herqq UPnP Av is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP Av is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Herqq UPnP Av. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "havtransport_codec_p.h"
+
+#include <HUpnpCore/HActionInfo>
+#include <HUpnpCore/HUpnpDataTypes>
+#include <HUpnpCore/HActionArguments>
+#include <HUpnpCore/HStateVariableInfo>
+
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace Av
+{
+
+struct HArgumentLayout
+{
+    const char* m_name;
+
+    bool m_isPlainText;
+    // true when the specification does not constrain the value of the
+    // argument, in which case the text is stored as is. Every other value is
+    // converted and validated by HUPnP against the state variable of the
+    // renderer, since the renderer defines the allowed values of these.
+};
+
+namespace
+{
+const qint32 MaxOutputArguments = 8;
+
+const HArgumentLayout PositionInfoLayout[] =
+{
+    { "Track", false },
+    { "TrackDuration", true },
+    { "TrackMetaData", true },
+    { "TrackURI", true },
+    { "RelTime", true },
+    { "AbsTime", true },
+    { "RelCount", false },
+    { "AbsCount", false },
+    { 0, false }
+};
+
+const HArgumentLayout TransportInfoLayout[] =
+{
+    { "CurrentTransportState", false },
+    { "CurrentTransportStatus", false },
+    { "CurrentSpeed", false },
+    { 0, false }
+};
+
+const HAvTransportCodec PositionInfoCodec("GetPositionInfo", PositionInfoLayout);
+const HAvTransportCodec TransportInfoCodec("GetTransportInfo", TransportInfoLayout);
+}
+
+/*******************************************************************************
+ * HAvTransportCodec
+ ******************************************************************************/
+HAvTransportCodec::HAvTransportCodec(
+    const char* actionName, const HArgumentLayout* outputLayout) :
+        m_actionName(actionName), m_outputLayout(outputLayout)
+{
+}
+
+bool HAvTransportCodec::isCompatible(const HActionInfo& info) const
+{
+    if (info.name() != QLatin1String(m_actionName))
+    {
+        return false;
+    }
+
+    const HActionArguments& inArgs = info.inputArguments();
+    if (inArgs.size() != 1 ||
+        inArgs.constBegin()->name() != QLatin1String("InstanceID") ||
+        inArgs.constBegin()->dataType() != HUpnpDataTypes::ui4)
+    {
+        return false;
+    }
+
+    qint32 i = 0;
+    const HActionArguments& outArgs = info.outputArguments();
+    HActionArguments::const_iterator ci = outArgs.constBegin();
+    for(; ci != outArgs.constEnd(); ++ci, ++i)
+    {
+        const HArgumentLayout& expected = m_outputLayout[i];
+        if (!expected.m_name || ci->name() != QLatin1String(expected.m_name))
+        {
+            return false;
+        }
+
+        if (expected.m_isPlainText &&
+            (ci->dataType() != HUpnpDataTypes::string ||
+             !ci->relatedStateVariable().allowedValueList().isEmpty()))
+        {
+            return false;
+        }
+    }
+
+    return !m_outputLayout[i].m_name;
+}
+
+bool HAvTransportCodec::writeInputArguments(
+    const HActionArguments& inArgs, QXmlStreamWriter& writer) const
+{
+    if (inArgs.size() != 1)
+    {
+        return false;
+    }
+
+    writer.writeTextElement(
+        QLatin1String("InstanceID"), QString::number(inArgs.valueAt(0).toUInt()));
+
+    return true;
+}
+
+bool HAvTransportCodec::readOutputArguments(
+    QXmlStreamReader& reader, HActionArguments* outArgs) const
+{
+    bool read[MaxOutputArguments] = { false };
+    while(reader.readNextStartElement())
+    {
+        qint32 i = 0;
+        for(; m_outputLayout[i].m_name; ++i)
+        {
+            if (reader.name() == QLatin1String(m_outputLayout[i].m_name))
+            {
+                break;
+            }
+        }
+
+        if (!m_outputLayout[i].m_name)
+        {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        QString value = reader.readElementText();
+        if (m_outputLayout[i].m_isPlainText)
+        {
+            setValidatedValue(outArgs, i, value);
+        }
+        else if (!outArgs->setValueAt(i, value))
+        {
+            return false;
+        }
+
+        read[i] = true;
+    }
+
+    for(qint32 i = 0; m_outputLayout[i].m_name; ++i)
+    {
+        if (!read[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const HActionCodec* HAvTransportCodec::codec(const QString& actionName)
+{
+    if (actionName == QLatin1String("GetPositionInfo"))
+    {
+        return &PositionInfoCodec;
+    }
+    else if (actionName == QLatin1String("GetTransportInfo"))
+    {
+        return &TransportInfoCodec;
+    }
+
+    return 0;
+}
+
+}
+}
+}
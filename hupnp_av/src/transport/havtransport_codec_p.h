@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of Herqq UPnP Av (HUPnPAv) library.
+ *
+ *  Herqq UPnP Av is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Herqq UPnP Av is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Herqq UPnP Av. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAVTRANSPORT_CODEC_P_H_
+#define HAVTRANSPORT_CODEC_P_H_
+
+//
+// !! Warning !!
+//
+// This file is not part of public API and it should
+// never be included in client code. The contents of this file may
+// change or the file may be removed without of notice.
+//
+
+#include <HUpnpCore/HActionCodec>
+
+namespace Herqq
+{
+
+namespace Upnp
+{
+
+namespace Av
+{
+
+struct HArgumentLayout;
+
+//
+// Encodes and decodes the SOAP messages of the AVTransport actions that are
+// invoked periodically when the position of a renderer is tracked. These
+// actions take only the InstanceID and the layouts of their output
+// arguments are fixed by the specification.
+//
+// This is written in the form hupnp_scpdgen generates, since the library
+// cannot depend on the tool, which is built after the libraries.
+//
+class HAvTransportCodec :
+    public HActionCodec
+{
+private:
+
+    const char* m_actionName;
+    const HArgumentLayout* m_outputLayout;
+
+public:
+
+    HAvTransportCodec(const char* actionName, const HArgumentLayout* outputLayout);
+
+    virtual bool isCompatible(const HActionInfo&) const;
+
+    virtual bool writeInputArguments(
+        const HActionArguments&, QXmlStreamWriter&) const;
+
+    virtual bool readOutputArguments(
+        QXmlStreamReader&, HActionArguments*) const;
+
+    // returns the codec of GetPositionInfo or GetTransportInfo,
+    // or null in case of any other action
+    static const HActionCodec* codec(const QString& actionName);
+};
+
+}
+}
+}
+
+#endif /* HAVTRANSPORT_CODEC_P_H_ */
@@ -14,6 +14,7 @@ HEADERS += \
     $$SRC_LOC/transport/habstract_avtransport_service_p.h \
     $$SRC_LOC/transport/havtransport_adapter.h \
     $$SRC_LOC/transport/havtransport_adapter_p.h \
+    $$SRC_LOC/transport/havtransport_codec_p.h \
     $$SRC_LOC/transport/havtransport_info.h \
     $$SRC_LOC/transport/hrecordmediumwritestatus.h \
     $$SRC_LOC/transport/hrecordqualitymode.h
@@ -31,6 +32,7 @@ SOURCES += \
     $$SRC_LOC/transport/hdevicecapabilities.cpp \
     $$SRC_LOC/transport/habstract_avtransport_service.cpp \
     $$SRC_LOC/transport/havtransport_adapter.cpp \
+    $$SRC_LOC/transport/havtransport_codec.cpp \
     $$SRC_LOC/transport/havtransport_info.cpp \
     $$SRC_LOC/transport/hrecordmediumwritestatus.cpp \
     $$SRC_LOC/transport/hrecordqualitymode.cpp
@@ -0,0 +1,54 @@
+TEMPLATE = app
+TARGET   = hupnp_scpdgen
+QT      += network xml
+QT      -= gui
+CONFIG  += console warn_on
+
+INCLUDEPATH += ../../hupnp/include \
+               ../../hupnp/lib/qtsoap-2.7-opensource/src
+
+LIBS += -L"../../hupnp/bin" -lHUpnp \
+        -L"../../hupnp/lib/qtsoap-2.7-opensource/lib"
+
+win32 {
+    debug {
+        LIBS += -lQtSolutions_SOAP-2.7d
+    }
+    else {
+        LIBS += -lQtSolutions_SOAP-2.7
+    }
+
+    LIBS += -lws2_32
+
+    QMAKE_POST_LINK += copy ..\\..\\hupnp\\bin\\* bin /Y
+}
+else {
+    LIBS += -lQtSolutions_SOAP-2.7
+    !macx:QMAKE_LFLAGS += -Wl,--rpath=\\\$\$ORIGIN
+
+    QMAKE_POST_LINK += cp -Rf ../../hupnp/bin/* bin
+}
+
+macx {
+  CONFIG -= app_bundle
+}
+
+OBJECTS_DIR = obj
+MOC_DIR = obj
+
+DESTDIR = ./bin
+
+# The service descriptions are read with the description parser of HUPnP,
+# which is compiled in, since the library does not export it.
+HUPNP_SRC = ../../hupnp/src
+
+INCLUDEPATH += $$HUPNP_SRC/devicehosting
+
+HEADERS += \
+    scpd_generator.h \
+    $$HUPNP_SRC/devicehosting/hddoc_parser_p.h
+
+SOURCES += \
+    main.cpp \
+    scpd_generator.cpp \
+    $$HUPNP_SRC/devicehosting/hddoc_parser_p.cpp
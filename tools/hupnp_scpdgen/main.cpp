@@ -0,0 +1,135 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpScpdGen
+ *  used for generating typed action stubs for the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpScpdGen is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpScpdGen is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpScpdGen. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scpd_generator.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QCoreApplication>
+
+namespace
+{
+void printUsage(QTextStream& out)
+{
+    out << "Usage: hupnp_scpdgen [options] SCPD\n"
+           "  -n NAME           the name of the generated classes (required)\n"
+           "  --namespace NS    the namespace of the generated classes, e.g. A::B\n"
+           "  --header FILE     the header file to write\n"
+           "  --source FILE     the source file to write, which includes the header\n"
+           "                    named with --header, or FILE with the suffix .h\n";
+    out.flush();
+}
+
+bool writeFile(const QString& path, const QString& contents, QTextStream& err)
+{
+    QFile file(path);
+    QByteArray data = contents.toUtf8();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(data) != data.size())
+    {
+        err << "Could not write [" << path << "]\n";
+        return false;
+    }
+
+    return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QTextStream err(stderr);
+
+    QString name, nameSpace, headerPath, sourcePath, scpdPath;
+
+    QStringList args = app.arguments();
+    for(qint32 i = 1; i < args.size(); ++i)
+    {
+        QString arg = args.at(i);
+        if (i + 1 >= args.size())
+        {
+            scpdPath = arg;
+            break;
+        }
+
+        QString value = args.at(++i);
+        if (arg == "-n")
+        {
+            name = value;
+        }
+        else if (arg == "--namespace")
+        {
+            nameSpace = value;
+        }
+        else if (arg == "--header")
+        {
+            headerPath = value;
+        }
+        else if (arg == "--source")
+        {
+            sourcePath = value;
+        }
+        else
+        {
+            printUsage(err);
+            return 1;
+        }
+    }
+
+    if (name.isEmpty() || scpdPath.isEmpty() ||
+        (headerPath.isEmpty() && sourcePath.isEmpty()))
+    {
+        printUsage(err);
+        return 1;
+    }
+
+    HScpdGenerator generator(name, nameSpace);
+    if (!generator.load(scpdPath))
+    {
+        err << generator.lastErrorDescription() << "\n";
+        return 2;
+    }
+
+    if (!headerPath.isEmpty() &&
+        !writeFile(headerPath, generator.generateHeader(headerPath), err))
+    {
+        return 2;
+    }
+
+    if (!sourcePath.isEmpty())
+    {
+        QString includedHeader = headerPath;
+        if (includedHeader.isEmpty())
+        {
+            includedHeader = sourcePath.left(sourcePath.lastIndexOf('.')).append(".h");
+        }
+
+        if (!writeFile(sourcePath, generator.generateSource(includedHeader), err))
+        {
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,1377 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpScpdGen
+ *  used for generating typed action stubs for the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpScpdGen is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpScpdGen is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpScpdGen. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scpd_generator.h"
+
+#include <HUpnpCore/HUpnp>
+#include <HUpnpCore/HUpnpDataTypes>
+#include <HUpnpCore/HActionArguments>
+
+#include "hddoc_parser_p.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextStream>
+
+using namespace Herqq::Upnp;
+
+namespace
+{
+const char* const CppKeywords[] =
+{
+    "and", "asm", "auto", "bool", "break", "case", "catch", "char", "class",
+    "const", "continue", "default", "delete", "do", "double", "else", "enum",
+    "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "mutable", "namespace", "new", "not",
+    "operator", "or", "private", "protected", "public", "register", "return",
+    "short", "signed", "sizeof", "static", "struct", "switch", "template",
+    "this", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+    "unsigned", "using", "virtual", "void", "volatile", "while", 0
+};
+
+//
+// The helpers every generated source file contains. The conversions between
+// the C++ types and the text of the SOAP messages are overloaded on the
+// C++ types of the argument structures.
+//
+const char* const SourceHelpers =
+    "struct ArgumentLayout\n"
+    "{\n"
+    "    const char* m_name;\n"
+    "    HUpnpDataTypes::DataType m_dataType;\n"
+    "    const char* const* m_allowedValues;\n"
+    "    const char* m_minimum;\n"
+    "    const char* m_maximum;\n"
+    "    const char* m_step;\n"
+    "};\n\n"
+    "bool hasValues(const QStringList& values, const char* const expected[])\n"
+    "{\n"
+    "    qint32 i = 0;\n"
+    "    for(; expected[i]; ++i)\n"
+    "    {\n"
+    "        if (i >= values.size() || values.at(i) != QString::fromUtf8(expected[i]))\n"
+    "        {\n"
+    "            return false;\n"
+    "        }\n"
+    "    }\n\n"
+    "    return i == values.size();\n"
+    "}\n\n"
+    "//\n"
+    "// The validation of the generated code is correct only if the arguments\n"
+    "// and their state variables are exactly what the code was generated from.\n"
+    "//\n"
+    "bool hasLayout(const HActionArguments& args, const ArgumentLayout layout[])\n"
+    "{\n"
+    "    qint32 i = 0;\n"
+    "    HActionArguments::const_iterator ci = args.constBegin();\n"
+    "    for(; ci != args.constEnd(); ++ci, ++i)\n"
+    "    {\n"
+    "        const ArgumentLayout& expected = layout[i];\n"
+    "        if (!expected.m_name ||\n"
+    "            ci->name() != QString::fromUtf8(expected.m_name) ||\n"
+    "            ci->dataType() != expected.m_dataType)\n"
+    "        {\n"
+    "            return false;\n"
+    "        }\n\n"
+    "        const HStateVariableInfo& info = ci->relatedStateVariable();\n"
+    "        if (expected.m_allowedValues ?\n"
+    "                !hasValues(info.allowedValueList(), expected.m_allowedValues) :\n"
+    "                !info.allowedValueList().isEmpty())\n"
+    "        {\n"
+    "            return false;\n"
+    "        }\n\n"
+    "        if (expected.m_minimum ?\n"
+    "                info.minimumValue().toString() != QLatin1String(expected.m_minimum) ||\n"
+    "                info.maximumValue().toString() != QLatin1String(expected.m_maximum) ||\n"
+    "                info.stepValue().toString() != QLatin1String(expected.m_step) :\n"
+    "                !info.maximumValue().isNull())\n"
+    "        {\n"
+    "            return false;\n"
+    "        }\n"
+    "    }\n\n"
+    "    return !layout[i].m_name;\n"
+    "}\n\n"
+    "inline bool isAllowed(const QString& value, const char* const values[])\n"
+    "{\n"
+    "    QByteArray utf8 = value.toUtf8();\n"
+    "    for(qint32 i = 0; values[i]; ++i)\n"
+    "    {\n"
+    "        if (utf8 == values[i])\n"
+    "        {\n"
+    "            return true;\n"
+    "        }\n"
+    "    }\n\n"
+    "    return false;\n"
+    "}\n\n"
+    "inline bool inRange(qint64 value, qint64 minimum, qint64 maximum, qint64 step)\n"
+    "{\n"
+    "    return value >= minimum && value <= maximum && (value - minimum) % step == 0;\n"
+    "}\n\n"
+    "inline bool inRange(double value, double minimum, double maximum)\n"
+    "{\n"
+    "    return value >= minimum && value <= maximum;\n"
+    "}\n\n"
+    "inline QString toText(quint8 value) { return QString::number(value); }\n"
+    "inline QString toText(quint16 value) { return QString::number(value); }\n"
+    "inline QString toText(quint32 value) { return QString::number(value); }\n"
+    "inline QString toText(qint8 value) { return QString::number(value); }\n"
+    "inline QString toText(qint16 value) { return QString::number(value); }\n"
+    "inline QString toText(qint32 value) { return QString::number(value); }\n"
+    "inline QString toText(float value) { return QString::number(value, 'g', 9); }\n"
+    "inline QString toText(double value) { return QString::number(value, 'g', 17); }\n"
+    "inline QString toText(bool value) { return QLatin1String(value ? \"1\" : \"0\"); }\n"
+    "inline QString toText(const QChar& value) { return QString(value); }\n"
+    "inline QString toText(const QString& value) { return value; }\n"
+    "inline QString toText(const QDate& value) { return value.toString(Qt::ISODate); }\n"
+    "inline QString toText(const QTime& value) { return value.toString(Qt::ISODate); }\n"
+    "inline QString toText(const QDateTime& value) { return value.toString(Qt::ISODate); }\n"
+    "inline QString toText(const QByteArray& value) { return QString::fromUtf8(value); }\n"
+    "inline QString toText(const QUrl& value) { return value.toString(); }\n"
+    "inline QString toText(const QVariant& value) { return value.toString(); }\n\n"
+    "inline bool fromText(const QString& text, quint8* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    quint16 tmp = text.toUShort(&ok);\n"
+    "    *value = static_cast<quint8>(tmp);\n"
+    "    return ok && tmp <= 0xff;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, qint8* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    qint16 tmp = text.toShort(&ok);\n"
+    "    *value = static_cast<qint8>(tmp);\n"
+    "    return ok && tmp >= -128 && tmp <= 127;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, quint16* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toUShort(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, qint16* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toShort(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, quint32* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toUInt(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, qint32* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toInt(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, float* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toFloat(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, double* value)\n"
+    "{\n"
+    "    bool ok = false;\n"
+    "    *value = text.toDouble(&ok);\n"
+    "    return ok;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, bool* value)\n"
+    "{\n"
+    "    if (text == QLatin1String(\"1\") ||\n"
+    "        text.compare(QLatin1String(\"true\"), Qt::CaseInsensitive) == 0 ||\n"
+    "        text.compare(QLatin1String(\"yes\"), Qt::CaseInsensitive) == 0)\n"
+    "    {\n"
+    "        *value = true;\n"
+    "        return true;\n"
+    "    }\n\n"
+    "    *value = false;\n"
+    "    return text == QLatin1String(\"0\") ||\n"
+    "           text.compare(QLatin1String(\"false\"), Qt::CaseInsensitive) == 0 ||\n"
+    "           text.compare(QLatin1String(\"no\"), Qt::CaseInsensitive) == 0;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QChar* value)\n"
+    "{\n"
+    "    *value = text.isEmpty() ? QChar() : text.at(0);\n"
+    "    return text.size() == 1;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QString* value)\n"
+    "{\n"
+    "    *value = text;\n"
+    "    return true;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QDate* value)\n"
+    "{\n"
+    "    *value = QDate::fromString(text, Qt::ISODate);\n"
+    "    return value->isValid();\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QTime* value)\n"
+    "{\n"
+    "    *value = QTime::fromString(text, Qt::ISODate);\n"
+    "    return value->isValid();\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QDateTime* value)\n"
+    "{\n"
+    "    *value = QDateTime::fromString(text, Qt::ISODate);\n"
+    "    return value->isValid();\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QByteArray* value)\n"
+    "{\n"
+    "    *value = text.toUtf8();\n"
+    "    return true;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QUrl* value)\n"
+    "{\n"
+    "    *value = QUrl(text);\n"
+    "    return true;\n"
+    "}\n\n"
+    "inline bool fromText(const QString& text, QVariant* value)\n"
+    "{\n"
+    "    *value = text;\n"
+    "    return true;\n"
+    "}\n\n";
+
+//
+// Returns the specified name as a valid C++ identifier.
+//
+QString identifier(const QString& name)
+{
+    QString retVal;
+    foreach(const QChar& c, name)
+    {
+        bool valid = (c.unicode() < 128 && c.isLetterOrNumber()) || c == '_';
+        retVal.append(valid ? c : QChar('_'));
+    }
+
+    if (retVal.isEmpty() || retVal.at(0).isDigit())
+    {
+        retVal.prepend('_');
+    }
+
+    for(qint32 i = 0; CppKeywords[i]; ++i)
+    {
+        if (retVal == CppKeywords[i])
+        {
+            retVal.append('_');
+            break;
+        }
+    }
+
+    return retVal;
+}
+
+//
+// Returns the name of the method that corresponds to the specified action.
+//
+QString methodName(const QString& actionName)
+{
+    QString retVal = actionName;
+    if (!retVal.isEmpty())
+    {
+        retVal[0] = retVal.at(0).toLower();
+    }
+
+    return identifier(retVal);
+}
+
+//
+// Returns the specified string as a C string literal of its UTF-8 encoding.
+//
+QString cString(const QString& str)
+{
+    QString retVal = "\"";
+    foreach(char c, str.toUtf8())
+    {
+        uchar uc = static_cast<uchar>(c);
+        if (c == '"' || c == '\\')
+        {
+            retVal.append('\\').append(c);
+        }
+        else if (uc < 0x20 || uc >= 0x7f)
+        {
+            retVal.append(QString("\\%1").arg(static_cast<uint>(uc), 3, 8, QChar('0')));
+        }
+        else
+        {
+            retVal.append(c);
+        }
+    }
+
+    return retVal.append('"');
+}
+
+//
+// Returns an expression that creates a QString of the specified string,
+// which is used to compare the names of the elements and the arguments.
+//
+QString stringLiteral(const QString& str)
+{
+    foreach(const QChar& c, str)
+    {
+        if (c.unicode() >= 0x7f)
+        {
+            return QString("QString::fromUtf8(%1)").arg(cString(str));
+        }
+    }
+
+    return QString("QLatin1String(%1)").arg(cString(str));
+}
+
+QString cppType(HUpnpDataTypes::DataType dt)
+{
+    switch(dt)
+    {
+    case HUpnpDataTypes::ui1:
+        return "quint8";
+    case HUpnpDataTypes::ui2:
+        return "quint16";
+    case HUpnpDataTypes::ui4:
+        return "quint32";
+    case HUpnpDataTypes::i1:
+        return "qint8";
+    case HUpnpDataTypes::i2:
+        return "qint16";
+    case HUpnpDataTypes::i4:
+    case HUpnpDataTypes::integer:
+        return "qint32";
+    case HUpnpDataTypes::r4:
+        return "float";
+    case HUpnpDataTypes::r8:
+    case HUpnpDataTypes::number:
+    case HUpnpDataTypes::fixed_14_4:
+    case HUpnpDataTypes::fp:
+        return "double";
+    case HUpnpDataTypes::character:
+        return "QChar";
+    case HUpnpDataTypes::string:
+    case HUpnpDataTypes::uuid:
+        return "QString";
+    case HUpnpDataTypes::date:
+        return "QDate";
+    case HUpnpDataTypes::dateTime:
+    case HUpnpDataTypes::dateTimeTz:
+        return "QDateTime";
+    case HUpnpDataTypes::time:
+    case HUpnpDataTypes::timeTz:
+        return "QTime";
+    case HUpnpDataTypes::boolean:
+        return "bool";
+    case HUpnpDataTypes::bin_base64:
+    case HUpnpDataTypes::bin_hex:
+        return "QByteArray";
+    case HUpnpDataTypes::uri:
+        return "QUrl";
+    default:
+        return "QVariant";
+    }
+}
+
+//
+// Returns the name of the enumerator of the specified data type.
+//
+QString dataTypeEnumerator(HUpnpDataTypes::DataType dt)
+{
+    const char* retVal = "Undefined";
+    switch(dt)
+    {
+    case HUpnpDataTypes::ui1: retVal = "ui1"; break;
+    case HUpnpDataTypes::ui2: retVal = "ui2"; break;
+    case HUpnpDataTypes::ui4: retVal = "ui4"; break;
+    case HUpnpDataTypes::i1: retVal = "i1"; break;
+    case HUpnpDataTypes::i2: retVal = "i2"; break;
+    case HUpnpDataTypes::i4: retVal = "i4"; break;
+    case HUpnpDataTypes::integer: retVal = "integer"; break;
+    case HUpnpDataTypes::r4: retVal = "r4"; break;
+    case HUpnpDataTypes::r8: retVal = "r8"; break;
+    case HUpnpDataTypes::number: retVal = "number"; break;
+    case HUpnpDataTypes::fixed_14_4: retVal = "fixed_14_4"; break;
+    case HUpnpDataTypes::fp: retVal = "fp"; break;
+    case HUpnpDataTypes::character: retVal = "character"; break;
+    case HUpnpDataTypes::string: retVal = "string"; break;
+    case HUpnpDataTypes::date: retVal = "date"; break;
+    case HUpnpDataTypes::dateTime: retVal = "dateTime"; break;
+    case HUpnpDataTypes::dateTimeTz: retVal = "dateTimeTz"; break;
+    case HUpnpDataTypes::time: retVal = "time"; break;
+    case HUpnpDataTypes::timeTz: retVal = "timeTz"; break;
+    case HUpnpDataTypes::boolean: retVal = "boolean"; break;
+    case HUpnpDataTypes::bin_base64: retVal = "bin_base64"; break;
+    case HUpnpDataTypes::bin_hex: retVal = "bin_hex"; break;
+    case HUpnpDataTypes::uri: retVal = "uri"; break;
+    case HUpnpDataTypes::uuid: retVal = "uuid"; break;
+    default:
+        break;
+    }
+
+    return QString("HUpnpDataTypes::%1").arg(retVal);
+}
+
+//
+// Returns the initial value of a member of the specified type, or an empty
+// string if the type has a default constructor.
+//
+QString initialValue(HUpnpDataTypes::DataType dt)
+{
+    if (HUpnpDataTypes::isNumeric(dt))
+    {
+        return "0";
+    }
+    else if (dt == HUpnpDataTypes::boolean)
+    {
+        return "false";
+    }
+
+    return "";
+}
+
+//
+// Returns an expression that converts the specified C++ expression to
+// a QVariant of the type HUPnP uses for the data type.
+//
+QString toVariant(HUpnpDataTypes::DataType dt, const QString& expr)
+{
+    if (HUpnpDataTypes::isInteger(dt))
+    {
+        bool isUnsigned =
+            dt == HUpnpDataTypes::ui1 || dt == HUpnpDataTypes::ui2 ||
+            dt == HUpnpDataTypes::ui4;
+
+        return QString("QVariant(static_cast<%1>(%2))").arg(
+            isUnsigned ? "quint32" : "qint32", expr);
+    }
+    else if (HUpnpDataTypes::isRational(dt))
+    {
+        return QString("QVariant(static_cast<double>(%1))").arg(expr);
+    }
+    else if (dt == HUpnpDataTypes::Undefined)
+    {
+        return expr;
+    }
+
+    return QString("QVariant(%1)").arg(expr);
+}
+
+//
+// Returns an expression that converts the specified QVariant expression to
+// the C++ type of the data type.
+//
+QString fromVariant(HUpnpDataTypes::DataType dt, const QString& expr)
+{
+    switch(dt)
+    {
+    case HUpnpDataTypes::ui1:
+    case HUpnpDataTypes::ui2:
+        return QString("static_cast<%1>(%2.toUInt())").arg(cppType(dt), expr);
+    case HUpnpDataTypes::ui4:
+        return QString("%1.toUInt()").arg(expr);
+    case HUpnpDataTypes::i1:
+    case HUpnpDataTypes::i2:
+        return QString("static_cast<%1>(%2.toInt())").arg(cppType(dt), expr);
+    case HUpnpDataTypes::i4:
+    case HUpnpDataTypes::integer:
+        return QString("%1.toInt()").arg(expr);
+    case HUpnpDataTypes::r4:
+        return QString("static_cast<float>(%1.toDouble())").arg(expr);
+    case HUpnpDataTypes::r8:
+    case HUpnpDataTypes::number:
+    case HUpnpDataTypes::fixed_14_4:
+    case HUpnpDataTypes::fp:
+        return QString("%1.toDouble()").arg(expr);
+    case HUpnpDataTypes::character:
+        return QString("%1.toChar()").arg(expr);
+    case HUpnpDataTypes::string:
+    case HUpnpDataTypes::uuid:
+        return QString("%1.toString()").arg(expr);
+    case HUpnpDataTypes::date:
+        return QString("%1.toDate()").arg(expr);
+    case HUpnpDataTypes::dateTime:
+    case HUpnpDataTypes::dateTimeTz:
+        return QString("%1.toDateTime()").arg(expr);
+    case HUpnpDataTypes::time:
+    case HUpnpDataTypes::timeTz:
+        return QString("%1.toTime()").arg(expr);
+    case HUpnpDataTypes::boolean:
+        return QString("%1.toBool()").arg(expr);
+    case HUpnpDataTypes::bin_base64:
+    case HUpnpDataTypes::bin_hex:
+        return QString("%1.toByteArray()").arg(expr);
+    case HUpnpDataTypes::uri:
+        return QString("%1.toUrl()").arg(expr);
+    default:
+        return expr;
+    }
+}
+
+//
+// Returns the name of the array of the allowed values of an argument.
+//
+QString allowedValuesName(const QString& layoutName, const HActionArgument& arg)
+{
+    return QString("%1%2AllowedValues").arg(layoutName, identifier(arg.name()));
+}
+
+//
+// Returns a condition that is true when the specified C++ expression is a
+// valid value of the argument, or an empty string if every value of the
+// C++ type is valid. The checks are the ones HUPnP runs for the state
+// variable of the argument, with the constraints compiled in.
+//
+QString validation(
+    const HActionArgument& arg, const QString& expr, const QString& layoutName)
+{
+    const HStateVariableInfo& info = arg.relatedStateVariable();
+    HUpnpDataTypes::DataType dt = arg.dataType();
+
+    if (dt == HUpnpDataTypes::string && !info.allowedValueList().isEmpty())
+    {
+        return QString("isAllowed(%1, %2)").arg(
+            expr, allowedValuesName(layoutName, arg));
+    }
+    else if (info.maximumValue().isNull())
+    {
+        return "";
+    }
+    else if (HUpnpDataTypes::isRational(dt))
+    {
+        return QString("inRange(static_cast<double>(%1), %2, %3)").arg(
+            expr,
+            QString::number(info.minimumValue().toDouble(), 'g', 17),
+            QString::number(info.maximumValue().toDouble(), 'g', 17));
+    }
+    else if (HUpnpDataTypes::isNumeric(dt))
+    {
+        qlonglong step = info.stepValue().toLongLong();
+        return QString(
+            "inRange(static_cast<qint64>(%1), Q_INT64_C(%2), Q_INT64_C(%3), Q_INT64_C(%4))").arg(
+                expr,
+                QString::number(info.minimumValue().toLongLong()),
+                QString::number(info.maximumValue().toLongLong()),
+                QString::number(step > 0 ? step : 1));
+    }
+
+    return "";
+}
+
+//
+// Returns the generation-time layout of the specified arguments, against
+// which the arguments are compared at run-time.
+//
+QString layoutArray(const QString& name, const HActionArguments& args)
+{
+    QString retVal;
+    QTextStream out(&retVal);
+
+    for(HActionArguments::const_iterator ci = args.constBegin();
+        ci != args.constEnd(); ++ci)
+    {
+        QStringList values = ci->relatedStateVariable().allowedValueList();
+        if (!values.isEmpty())
+        {
+            out << "const char* const " << allowedValuesName(name, *ci) << "[] =\n"
+                << "{\n";
+
+            foreach(const QString& value, values)
+            {
+                out << "    " << cString(value) << ",\n";
+            }
+
+            out << "    0\n"
+                << "};\n\n";
+        }
+    }
+
+    out << "const ArgumentLayout " << name << "Layout[] =\n"
+        << "{\n";
+
+    for(HActionArguments::const_iterator ci = args.constBegin();
+        ci != args.constEnd(); ++ci)
+    {
+        const HStateVariableInfo& info = ci->relatedStateVariable();
+
+        out << "    { " << cString(ci->name()) << ", "
+            << dataTypeEnumerator(ci->dataType()) << ", "
+            << (info.allowedValueList().isEmpty() ?
+                    QString("0") : allowedValuesName(name, *ci)) << ", ";
+
+        if (info.maximumValue().isNull())
+        {
+            out << "0, 0, 0";
+        }
+        else
+        {
+            out << cString(info.minimumValue().toString()) << ", "
+                << cString(info.maximumValue().toString()) << ", "
+                << cString(info.stepValue().toString());
+        }
+
+        out << " },\n";
+    }
+
+    out << "    { 0, HUpnpDataTypes::Undefined, 0, 0, 0, 0 }\n"
+        << "};\n\n";
+
+    return retVal;
+}
+}
+
+/*******************************************************************************
+ * HScpdGenerator
+ *******************************************************************************/
+HScpdGenerator::HScpdGenerator(const QString& name, const QString& nameSpace) :
+    m_name(identifier(name)),
+    m_namespaces(nameSpace.split("::", QString::SkipEmptyParts)),
+    m_scpdFileName(), m_actions(), m_lastErrorDescription()
+{
+}
+
+HScpdGenerator::~HScpdGenerator()
+{
+}
+
+bool HScpdGenerator::load(const QString& scpdPath)
+{
+    QFile file(scpdPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_lastErrorDescription =
+            QString("Could not open [%1]: %2").arg(scpdPath, file.errorString());
+
+        return false;
+    }
+
+    HDocParser parser("__SCPDGEN__: ", StrictChecks);
+
+    QList<HStateVariableInfo> stateVariables;
+    if (!parser.parseServiceDescription(
+        QString::fromUtf8(file.readAll()), &stateVariables, &m_actions))
+    {
+        m_lastErrorDescription = parser.lastErrorDescription();
+        return false;
+    }
+
+    m_scpdFileName = QFileInfo(scpdPath).fileName();
+    return true;
+}
+
+QString HScpdGenerator::beginNamespaces() const
+{
+    QString retVal;
+    foreach(const QString& nameSpace, m_namespaces)
+    {
+        retVal.append(QString("namespace %1\n{\n\n").arg(nameSpace));
+    }
+
+    return retVal;
+}
+
+QString HScpdGenerator::endNamespaces() const
+{
+    QString retVal;
+    for(qint32 i = 0; i < m_namespaces.size(); ++i)
+    {
+        retVal.append("}\n");
+    }
+
+    return retVal.isEmpty() ? retVal : retVal.append("\n");
+}
+
+QString HScpdGenerator::generateArgumentStruct(
+    const QString& name, const HActionArguments& args) const
+{
+    QString retVal;
+    QTextStream out(&retVal);
+
+    out << "    struct " << name << "\n"
+        << "    {\n";
+
+    QStringList initializers;
+    for(HActionArguments::const_iterator ci = args.constBegin();
+        ci != args.constEnd(); ++ci)
+    {
+        QString member = identifier(ci->name());
+        out << "        " << cppType(ci->dataType()) << " " << member << ";\n";
+        initializers.append(
+            QString("%1(%2)").arg(member, initialValue(ci->dataType())));
+    }
+
+    out << "\n"
+        << "        inline " << name << "() :\n"
+        << "            " << initializers.join(", ") << "\n"
+        << "        {\n"
+        << "        }\n"
+        << "    };\n\n";
+
+    return retVal;
+}
+
+QString HScpdGenerator::generateCodecClass(const HActionInfo& action) const
+{
+    QString actionName = identifier(action.name());
+    QString codecName = actionName + "Codec";
+
+    QStringList structNames;
+    if (!action.inputArguments().isEmpty())
+    {
+        structNames.append(actionName + "In");
+    }
+    if (!action.outputArguments().isEmpty())
+    {
+        structNames.append(actionName + "Out");
+    }
+
+    QString retVal;
+    QTextStream out(&retVal);
+
+    out << "    //\n"
+        << "    // Encodes and decodes the arguments of " << action.name() << ".\n"
+        << "    //\n"
+        << "    class " << codecName << " :\n"
+        << "        public Herqq::Upnp::HActionCodec\n"
+        << "    {\n"
+        << "    public:\n\n"
+        << "        inline " << codecName << "()\n"
+        << "        {\n"
+        << "        }\n\n";
+
+    foreach(const QString& structName, structNames)
+    {
+        out << "        static bool encode(const " << structName
+            << "&, Herqq::Upnp::HActionArguments*);\n"
+            << "        static bool decode(const Herqq::Upnp::HActionArguments&, "
+            << structName << "*);\n";
+    }
+
+    out << (structNames.isEmpty() ? "" : "\n")
+        << "        virtual bool isCompatible(const Herqq::Upnp::HActionInfo&) const;\n\n"
+        << "        virtual bool writeInputArguments(\n"
+        << "            const Herqq::Upnp::HActionArguments&, QXmlStreamWriter&) const;\n\n"
+        << "        virtual bool readOutputArguments(\n"
+        << "            QXmlStreamReader&, Herqq::Upnp::HActionArguments*) const;\n"
+        << "    };\n\n";
+
+    foreach(const QString& structName, structNames)
+    {
+        out << "    inline static bool encode(\n"
+            << "        const " << structName << "& source, Herqq::Upnp::HActionArguments* args)\n"
+            << "    {\n"
+            << "        return " << codecName << "::encode(source, args);\n"
+            << "    }\n\n"
+            << "    inline static bool decode(\n"
+            << "        const Herqq::Upnp::HActionArguments& args, " << structName << "* target)\n"
+            << "    {\n"
+            << "        return " << codecName << "::decode(args, target);\n"
+            << "    }\n\n";
+    }
+
+    return retVal;
+}
+
+QString HScpdGenerator::generateConversions(
+    const QString& codecName, const QString& structName,
+    const HActionArguments& args) const
+{
+    QString retVal;
+    QTextStream out(&retVal);
+
+    out << "bool " << codecName << "::encode(\n"
+        << "    const " << structName << "& source, HActionArguments* args)\n"
+        << "{\n"
+        << "    if (args->size() != " << args.size() << ")\n"
+        << "    {\n"
+        << "        return false;\n"
+        << "    }\n\n";
+
+    QString layoutName = QString(structName).remove(m_name + "::");
+    for(qint32 i = 0; i < args.size(); ++i)
+    {
+        const HActionArgument& arg = args.constBegin()[i];
+        QString condition =
+            validation(arg, "source." + identifier(arg.name()), layoutName);
+
+        if (!condition.isEmpty())
+        {
+            out << "    if (!" << condition << ")\n"
+                << "    {\n"
+                << "        return false;\n"
+                << "    }\n\n";
+        }
+    }
+
+    for(qint32 i = 0; i < args.size(); ++i)
+    {
+        const HActionArgument& arg = args.constBegin()[i];
+        out << "    setValidatedValue(args, " << i << ", "
+            << toVariant(arg.dataType(), "source." + identifier(arg.name()))
+            << ");\n";
+    }
+
+    out << "\n"
+        << "    return true;\n"
+        << "}\n\n"
+        << "bool " << codecName << "::decode(\n"
+        << "    const HActionArguments& args, " << structName << "* target)\n"
+        << "{\n"
+        << "    if (args.size() != " << args.size() << ")\n"
+        << "    {\n"
+        << "        return false;\n"
+        << "    }\n\n";
+
+    for(qint32 i = 0; i < args.size(); ++i)
+    {
+        const HActionArgument& arg = args.constBegin()[i];
+        out << "    target->" << identifier(arg.name()) << " = "
+            << fromVariant(arg.dataType(), QString("args.valueAt(%1)").arg(i))
+            << ";\n";
+    }
+
+    out << "\n"
+        << "    return true;\n"
+        << "}\n\n";
+
+    return retVal;
+}
+
+QString HScpdGenerator::generateCodec(const HActionInfo& action) const
+{
+    QString actionName = identifier(action.name());
+    QString codecName = QString("%1::%2Codec").arg(m_name, actionName);
+
+    const HActionArguments& inArgs = action.inputArguments();
+    const HActionArguments& outArgs = action.outputArguments();
+
+    QString retVal;
+    QTextStream out(&retVal);
+
+    if (!inArgs.isEmpty())
+    {
+        out << generateConversions(
+            codecName, QString("%1::%2In").arg(m_name, actionName), inArgs);
+    }
+    if (!outArgs.isEmpty())
+    {
+        out << generateConversions(
+            codecName, QString("%1::%2Out").arg(m_name, actionName), outArgs);
+    }
+
+    out << "bool " << codecName << "::isCompatible(const HActionInfo& info) const\n"
+        << "{\n"
+        << "    return info.name() == " << stringLiteral(action.name()) << " &&\n"
+        << "           hasLayout(info.inputArguments(), " << actionName << "InLayout) &&\n"
+        << "           hasLayout(info.outputArguments(), " << actionName << "OutLayout);\n"
+        << "}\n\n";
+
+    // The input arguments are written to the request as they are,
+    // since they were validated when they were set.
+
+    out << "bool " << codecName << "::writeInputArguments(\n"
+        << "    const HActionArguments& inArgs, QXmlStreamWriter&"
+        << (inArgs.isEmpty() ? "" : " writer") << ") const\n"
+        << "{\n";
+
+    if (inArgs.isEmpty())
+    {
+        out << "    return inArgs.isEmpty();\n";
+    }
+    else
+    {
+        out << "    if (inArgs.size() != " << inArgs.size() << ")\n"
+            << "    {\n"
+            << "        return false;\n"
+            << "    }\n\n";
+
+        for(qint32 i = 0; i < inArgs.size(); ++i)
+        {
+            const HActionArgument& arg = inArgs.constBegin()[i];
+            out << "    writer.writeTextElement(\n"
+                << "        " << stringLiteral(arg.name()) << ",\n"
+                << "        toText("
+                << fromVariant(arg.dataType(), QString("inArgs.valueAt(%1)").arg(i))
+                << "));\n";
+        }
+
+        out << "\n"
+            << "    return true;\n";
+    }
+
+    out << "}\n\n";
+
+    // The output arguments are read in any order and validated
+    // by the encoding of the structure.
+
+    out << "bool " << codecName << "::readOutputArguments(\n"
+        << "    QXmlStreamReader& reader, HActionArguments* outArgs) const\n"
+        << "{\n";
+
+    if (outArgs.isEmpty())
+    {
+        out << "    while(reader.readNextStartElement())\n"
+            << "    {\n"
+            << "        reader.skipCurrentElement();\n"
+            << "    }\n\n"
+            << "    return outArgs->isEmpty();\n";
+    }
+    else
+    {
+        out << "    " << m_name << "::" << actionName << "Out target;\n"
+            << "    bool read[" << outArgs.size() << "] = { false };\n\n"
+            << "    while(reader.readNextStartElement())\n"
+            << "    {\n";
+
+        for(qint32 i = 0; i < outArgs.size(); ++i)
+        {
+            const HActionArgument& arg = outArgs.constBegin()[i];
+            out << "        " << (i ? "else if" : "if") << " (reader.name() == "
+                << stringLiteral(arg.name()) << ")\n"
+                << "        {\n"
+                << "            read[" << i << "] = fromText(reader.readElementText(), &target."
+                << identifier(arg.name()) << ");\n"
+                << "        }\n";
+        }
+
+        out << "        else\n"
+            << "        {\n"
+            << "            reader.skipCurrentElement();\n"
+            << "        }\n"
+            << "    }\n\n"
+            << "    for(qint32 i = 0; i < " << outArgs.size() << "; ++i)\n"
+            << "    {\n"
+            << "        if (!read[i])\n"
+            << "        {\n"
+            << "            return false;\n"
+            << "        }\n"
+            << "    }\n\n"
+            << "    return encode(target, outArgs);\n";
+    }
+
+    out << "}\n\n";
+
+    return retVal;
+}
+
+QString HScpdGenerator::generateHeader(const QString& headerFileName) const
+{
+    QString guard = identifier(
+        QFileInfo(headerFileName).fileName()).toUpper().append("_");
+
+    QString retVal;
+    QTextStream out(&retVal);
+
+    out << "//\n"
+        << "// This file was generated by hupnp_scpdgen from " << m_scpdFileName << ".\n"
+        << "// Any changes made to this file are lost when it is regenerated.\n"
+        << "//\n\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <HUpnpCore/HActionInfo>\n"
+        << "#include <HUpnpCore/HActionCodec>\n"
+        << "#include <HUpnpCore/HServerService>\n"
+        << "#include <HUpnpCore/HClientActionOp>\n"
+        << "#include <HUpnpCore/HActionArguments>\n"
+        << "#include <HUpnpCore/HClientServiceAdapter>\n"
+        << "#include <HUpnpCore/HActionInvokeCallback>\n\n"
+        << "#include <QtCore/QUrl>\n"
+        << "#include <QtCore/QChar>\n"
+        << "#include <QtCore/QString>\n"
+        << "#include <QtCore/QVariant>\n"
+        << "#include <QtCore/QDateTime>\n"
+        << "#include <QtCore/QByteArray>\n\n"
+        << beginNamespaces();
+
+    // The argument structures and the codecs
+
+    out << "//\n"
+        << "// The argument layouts of the actions of the service and their codecs.\n"
+        << "// The codecs convert the structures to and from HActionArguments by\n"
+        << "// position, validate the values with the checks compiled in from the\n"
+        << "// service description, and encode and decode the SOAP messages of the\n"
+        << "// invocations without the generic conversions.\n"
+        << "//\n"
+        << "class " << m_name << "\n"
+        << "{\n"
+        << "public:\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+        if (!action.inputArguments().isEmpty())
+        {
+            out << generateArgumentStruct(
+                actionName + "In", action.inputArguments());
+        }
+        if (!action.outputArguments().isEmpty())
+        {
+            out << generateArgumentStruct(
+                actionName + "Out", action.outputArguments());
+        }
+
+        out << generateCodecClass(action);
+    }
+
+    out << "    //\n"
+        << "    // Returns false if the specified action is not one of the actions\n"
+        << "    // of the service or its arguments differ from the generated layout.\n"
+        << "    //\n"
+        << "    static bool verify(const Herqq::Upnp::HActionInfo&);\n\n"
+        << "    //\n"
+        << "    // Returns the codec of the specified action, or null if the action\n"
+        << "    // is not one of the actions of the service.\n"
+        << "    //\n"
+        << "    static const Herqq::Upnp::HActionCodec* codec(const QString& actionName);\n"
+        << "};\n\n";
+
+    // The client-side proxy
+
+    out << "//\n"
+        << "// Invokes the actions of a service with the typed arguments. The codecs\n"
+        << "// are set to the actions of the service when the proxy is taken into use.\n"
+        << "// The output arguments of a completed invocation are read with\n"
+        << "// " << m_name << "::decode().\n"
+        << "//\n"
+        << "class " << m_name << "Proxy :\n"
+        << "    public Herqq::Upnp::HClientServiceAdapter\n"
+        << "{\n"
+        << "protected:\n\n"
+        << "    virtual bool prepareService(Herqq::Upnp::HClientService*);\n\n"
+        << "public:\n\n"
+        << "    explicit " << m_name << "Proxy(\n"
+        << "        const Herqq::Upnp::HResourceType& serviceType, QObject* parent = 0);\n\n"
+        << "    virtual ~" << m_name << "Proxy();\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        out << "    Herqq::Upnp::HClientActionOp " << methodName(action.name()) << "(\n";
+        if (!action.inputArguments().isEmpty())
+        {
+            out << "        const " << m_name << "::" << identifier(action.name())
+                << "In& inArgs,\n";
+        }
+        out << "        const Herqq::Upnp::HActionInvokeCallback& callback =\n"
+            << "            Herqq::Upnp::HActionInvokeCallback());\n\n";
+    }
+
+    out << "};\n\n";
+
+    // The server-side skeleton
+
+    out << "//\n"
+        << "// The base class of a service implementation that receives the typed\n"
+        << "// arguments. The device host parses the SOAP requests before the\n"
+        << "// actions are known, so the skeleton uses the codecs only for the\n"
+        << "// positional conversions and the validation of the output arguments.\n"
+        << "// An action that is not overridden returns UpnpOptionalActionNotImplemented.\n"
+        << "//\n"
+        << "class " << m_name << "Skeleton :\n"
+        << "    public Herqq::Upnp::HServerService\n"
+        << "{\n"
+        << "private:\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        out << "    qint32 invoke" << identifier(action.name()) << "(\n"
+            << "        const Herqq::Upnp::HActionArguments&, "
+            << "Herqq::Upnp::HActionArguments*);\n";
+    }
+
+    out << "\n"
+        << "protected:\n\n"
+        << "    " << m_name << "Skeleton();\n\n"
+        << "    virtual HActionInvokes createActionInvokes();\n"
+        << "    virtual bool finalizeInit(QString* errDescription);\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+
+        QStringList params;
+        if (!action.inputArguments().isEmpty())
+        {
+            params.append(QString("const %1::%2In& inArgs").arg(m_name, actionName));
+        }
+        if (!action.outputArguments().isEmpty())
+        {
+            params.append(QString("%1::%2Out* outArgs").arg(m_name, actionName));
+        }
+
+        out << "    virtual qint32 " << methodName(action.name()) << "("
+            << params.join(", ") << ");\n";
+    }
+
+    out << "\n"
+        << "public:\n\n"
+        << "    virtual ~" << m_name << "Skeleton();\n"
+        << "};\n\n"
+        << endNamespaces()
+        << "#endif // " << guard << "\n";
+
+    return retVal;
+}
+
+QString HScpdGenerator::generateSource(const QString& headerFileName) const
+{
+    QString retVal;
+    QTextStream out(&retVal);
+
+    out << "//\n"
+        << "// This file was generated by hupnp_scpdgen from " << m_scpdFileName << ".\n"
+        << "// Any changes made to this file are lost when it is regenerated.\n"
+        << "//\n\n"
+        << "#include \"" << QFileInfo(headerFileName).fileName() << "\"\n\n"
+        << "#include <HUpnpCore/HUpnp>\n"
+        << "#include <HUpnpCore/HClientAction>\n"
+        << "#include <HUpnpCore/HServerAction>\n"
+        << "#include <HUpnpCore/HClientService>\n"
+        << "#include <HUpnpCore/HUpnpDataTypes>\n"
+        << "#include <HUpnpCore/HStateVariableInfo>\n\n"
+        << "#include <QtCore/QStringList>\n"
+        << "#include <QtCore/QXmlStreamReader>\n"
+        << "#include <QtCore/QXmlStreamWriter>\n\n"
+        << "using namespace Herqq::Upnp;\n\n"
+        << beginNamespaces();
+
+    // The generation-time layouts and the conversions
+
+    out << "namespace\n"
+        << "{\n"
+        << SourceHelpers;
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+        out << layoutArray(actionName + "In", action.inputArguments())
+            << layoutArray(actionName + "Out", action.outputArguments());
+    }
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+        out << "const " << m_name << "::" << actionName << "Codec "
+            << actionName << "CodecInstance;\n";
+    }
+
+    out << "}\n\n";
+
+    // The codecs
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        out << generateCodec(action);
+    }
+
+    out << "bool " << m_name << "::verify(const HActionInfo& info)\n"
+        << "{\n"
+        << "    const HActionCodec* actionCodec = codec(info.name());\n"
+        << "    return actionCodec && actionCodec->isCompatible(info);\n"
+        << "}\n\n"
+        << "const HActionCodec* " << m_name << "::codec(const QString& actionName)\n"
+        << "{\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        out << "    if (actionName == " << stringLiteral(action.name()) << ")\n"
+            << "    {\n"
+            << "        return &" << identifier(action.name()) << "CodecInstance;\n"
+            << "    }\n\n";
+    }
+
+    out << "    return 0;\n"
+        << "}\n\n";
+
+    // The proxy
+
+    QString proxy = m_name + "Proxy";
+    out << proxy << "::" << proxy << "(\n"
+        << "    const HResourceType& serviceType, QObject* parent) :\n"
+        << "        HClientServiceAdapter(serviceType, parent)\n"
+        << "{\n"
+        << "}\n\n"
+        << proxy << "::~" << proxy << "()\n"
+        << "{\n"
+        << "}\n\n"
+        << "bool " << proxy << "::prepareService(HClientService* service)\n"
+        << "{\n"
+        << "    foreach(HClientAction* action, service->actions())\n"
+        << "    {\n"
+        << "        const HActionCodec* actionCodec = " << m_name
+        << "::codec(action->info().name());\n"
+        << "        if (!actionCodec || !action->setCodec(actionCodec))\n"
+        << "        {\n"
+        << "            setLastErrorDescription(QString(\n"
+        << "                \"The arguments of action [%1] differ from the generated layout\").arg(\n"
+        << "                    action->info().name()));\n\n"
+        << "            return false;\n"
+        << "        }\n"
+        << "    }\n\n"
+        << "    return true;\n"
+        << "}\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+        bool hasInArgs = !action.inputArguments().isEmpty();
+
+        out << "HClientActionOp " << proxy << "::" << methodName(action.name()) << "(\n";
+        if (hasInArgs)
+        {
+            out << "    const " << m_name << "::" << actionName << "In& inArgs,\n";
+        }
+        out << "    const HActionInvokeCallback& callback)\n"
+            << "{\n"
+            << "    qint32 rc = UpnpUndefinedFailure;\n"
+            << "    HClientAction* action = getAction(" << cString(action.name()) << ", &rc);\n"
+            << "    if (!action)\n"
+            << "    {\n"
+            << "        return HClientActionOp(rc, \"Action [" << action.name()
+            << "] is not available\");\n"
+            << "    }\n\n";
+
+        if (hasInArgs)
+        {
+            out << "    HActionArguments args = action->info().inputArguments();\n"
+                << "    if (!" << m_name << "::" << actionName << "Codec::encode(inArgs, &args))\n"
+                << "    {\n"
+                << "        return HClientActionOp(UpnpInvalidArgs, \"Invalid input arguments\");\n"
+                << "    }\n\n"
+                << "    return action->beginInvoke(args, callback);\n";
+        }
+        else
+        {
+            out << "    return action->beginInvoke(action->info().inputArguments(), callback);\n";
+        }
+
+        out << "}\n\n";
+    }
+
+    // The skeleton
+
+    QString skeleton = m_name + "Skeleton";
+    out << skeleton << "::" << skeleton << "() :\n"
+        << "    HServerService()\n"
+        << "{\n"
+        << "}\n\n"
+        << skeleton << "::~" << skeleton << "()\n"
+        << "{\n"
+        << "}\n\n"
+        << "HServerService::HActionInvokes " << skeleton << "::createActionInvokes()\n"
+        << "{\n"
+        << "    HActionInvokes retVal;\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        out << "    retVal.insert(\n"
+            << "        " << cString(action.name()) << ",\n"
+            << "        HActionInvoke(this, &" << skeleton << "::invoke"
+            << identifier(action.name()) << "));\n\n";
+    }
+
+    out << "    return retVal;\n"
+        << "}\n\n"
+        << "bool " << skeleton << "::finalizeInit(QString* errDescription)\n"
+        << "{\n"
+        << "    foreach(const HServerAction* action, actions())\n"
+        << "    {\n"
+        << "        if (!" << m_name << "::verify(action->info()))\n"
+        << "        {\n"
+        << "            if (errDescription)\n"
+        << "            {\n"
+        << "                *errDescription = QString(\n"
+        << "                    \"The arguments of action [%1] differ from the generated layout\").arg(\n"
+        << "                        action->info().name());\n"
+        << "            }\n\n"
+        << "            return false;\n"
+        << "        }\n"
+        << "    }\n\n"
+        << "    return HServerService::finalizeInit(errDescription);\n"
+        << "}\n\n";
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+        QString codecName = QString("%1::%2Codec").arg(m_name, actionName);
+        bool hasInArgs = !action.inputArguments().isEmpty();
+        bool hasOutArgs = !action.outputArguments().isEmpty();
+
+        out << "qint32 " << skeleton << "::invoke" << actionName << "(\n"
+            << "    const HActionArguments&" << (hasInArgs ? " inArgs" : "")
+            << ", HActionArguments*" << (hasOutArgs ? " outArgs" : "") << ")\n"
+            << "{\n";
+
+        QStringList args;
+        if (hasInArgs)
+        {
+            out << "    " << m_name << "::" << actionName << "In in;\n"
+                << "    if (!" << codecName << "::decode(inArgs, &in))\n"
+                << "    {\n"
+                << "        return UpnpInvalidArgs;\n"
+                << "    }\n\n";
+
+            args.append("in");
+        }
+
+        if (hasOutArgs)
+        {
+            out << "    " << m_name << "::" << actionName << "Out out;\n";
+            args.append("&out");
+        }
+
+        out << "    qint32 retVal = " << methodName(action.name()) << "("
+            << args.join(", ") << ");\n";
+
+        if (hasOutArgs)
+        {
+            out << "    if (retVal == UpnpSuccess && !" << codecName
+                << "::encode(out, outArgs))\n"
+                << "    {\n"
+                << "        return UpnpActionFailed;\n"
+                << "    }\n";
+        }
+
+        out << "\n"
+            << "    return retVal;\n"
+            << "}\n\n";
+    }
+
+    foreach(const HActionInfo& action, m_actions)
+    {
+        QString actionName = identifier(action.name());
+
+        QStringList params;
+        if (!action.inputArguments().isEmpty())
+        {
+            params.append(QString("const %1::%2In&").arg(m_name, actionName));
+        }
+        if (!action.outputArguments().isEmpty())
+        {
+            params.append(QString("%1::%2Out*").arg(m_name, actionName));
+        }
+
+        out << "qint32 " << skeleton << "::" << methodName(action.name()) << "("
+            << params.join(", ") << ")\n"
+            << "{\n"
+            << "    return UpnpOptionalActionNotImplemented;\n"
+            << "}\n\n";
+    }
+
+    out << endNamespaces();
+
+    return retVal;
+}
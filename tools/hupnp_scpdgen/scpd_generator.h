@@ -0,0 +1,100 @@
+/*
+ *  Copyright (C) 2011 Tuomo Penttinen, all rights reserved.
+ *
+ *  Author: Tuomo Penttinen <tp@herqq.org>
+ *
+ *  This file is part of an application named HUpnpScpdGen
+ *  used for generating typed action stubs for the Herqq UPnP (HUPnP) library.
+ *
+ *  HUpnpScpdGen is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  HUpnpScpdGen is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with HUpnpScpdGen. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCPD_GENERATOR_H
+#define SCPD_GENERATOR_H
+
+#include <HUpnpCore/HActionInfo>
+#include <HUpnpCore/HStateVariableInfo>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//
+// Generates typed C++ stubs from a service description (SCPD).
+//
+// For every action the generated code contains structures for the input and
+// output arguments and an HActionCodec that knows the argument layout of the
+// action at compile-time. The codec converts the structures to and from
+// HActionArguments by position, validates the values with the allowed value
+// lists and ranges of the service description compiled in, and writes the
+// SOAP request and reads the SOAP response of an invocation directly from
+// and to the typed values.
+//
+// On top of these the generated code contains a client-side proxy derived
+// from HClientServiceAdapter, which sets the codecs to the actions of the
+// service, and a server-side skeleton derived from HServerService. Both verify
+// once, when they are taken into use, that the service they are bound to has
+// the actions, the argument layouts and the constraints the code was
+// generated from, since the compiled-in validation is correct only then.
+//
+class HScpdGenerator
+{
+Q_DISABLE_COPY(HScpdGenerator)
+
+private:
+
+    QString m_name;
+    QStringList m_namespaces;
+
+    QString m_scpdFileName;
+    QList<Herqq::Upnp::HActionInfo> m_actions;
+
+    QString m_lastErrorDescription;
+
+    QString generateArgumentStruct(
+        const QString& name, const Herqq::Upnp::HActionArguments&) const;
+
+    QString generateCodecClass(const Herqq::Upnp::HActionInfo&) const;
+
+    QString generateConversions(
+        const QString& codecName, const QString& structName,
+        const Herqq::Upnp::HActionArguments&) const;
+
+    QString generateCodec(const Herqq::Upnp::HActionInfo&) const;
+
+    QString beginNamespaces() const;
+    QString endNamespaces() const;
+
+public:
+
+    //
+    // The name is used as the name of the class that contains the argument
+    // structures and as the prefix of the proxy and the skeleton classes.
+    // The namespace may be empty or contain several levels separated by "::".
+    //
+    HScpdGenerator(const QString& name, const QString& nameSpace);
+    ~HScpdGenerator();
+
+    bool load(const QString& scpdPath);
+
+    QString generateHeader(const QString& headerFileName) const;
+    QString generateSource(const QString& headerFileName) const;
+
+    inline QString lastErrorDescription() const
+    {
+        return m_lastErrorDescription;
+    }
+};
+
+#endif // SCPD_GENERATOR_H